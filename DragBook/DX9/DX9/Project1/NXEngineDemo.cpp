@@ -19,6 +19,7 @@
 #include "../../../../engine/Particle/NXSnowParticleSystem.h"
 #include "../../../../engine/entity/NXSky.h"
 #include "../../../../engine/entity/NXSphere.h"
+#include "../../../../engine/render/NXLODSelector.h"
 
 #define KeyDown(key) (GetAsyncKeyState(key) & 0x08000)
 
@@ -27,6 +28,8 @@ NX::NXEngineDemo::NXEngineDemo() {
 	m_pCamera         = nullptr;
 	m_pSky            = nullptr;
 	m_pShere          = nullptr;
+	m_pLODSelector    = nullptr;
+	m_pSnowParticleSystem = nullptr;
 }
 
 NX::NXEngineDemo::~NXEngineDemo() {
@@ -55,6 +58,10 @@ void NX::NXEngineDemo::Render() {
 		renderer.LightColor           = float3(1.f, 0.71f, 0.29f);
 	}
 
+	if (m_pLODSelector) {
+		m_pLODSelector->Select(m_pCamera, m_pCamera);
+	}
+
 	if (m_pTerrain) {
 		m_pTerrain->Render(renderer);
 	}
@@ -130,6 +137,15 @@ void NX::NXEngineDemo::OnInitDX3Succeed() {
 		m_pShere->GetTransform().SetTranslation(4000, 1000, 1000);
 	}
 
+	{//level of detail for the spheres
+		m_pLODSelector = new NX::LODSelector();
+		m_pLODSelector->SetViewportHeight(MAINFRAME_HEIGHT * 1.f).SetPixelError(1.f).SetHysteresis(0.2f).SetTriangleBudget(40000);
+		m_pLODSelector->AddEntity(m_pShere);
+		for (int i = 0; i < NX::ArrayLength(m_pKity); ++i) {
+			m_pLODSelector->AddEntity(m_pKity[i]);
+		}
+	}
+
 	{
 		m_pLeft = new NX::Cube();
 		m_pLeft->GetTransform().SetScale(0.25, 2, m_pTerrain->GetMaxRangeByZAxis()).SetTranslation(-0.125, 1, m_pTerrain->GetMaxRangeByZAxis() * 0.5f);
@@ -155,7 +171,11 @@ void NX::NXEngineDemo::OnInitDX3Succeed() {
 	{//create snow system
 		std::vector<std::string> TextureSet;
 		TextureSet.push_back("EngineResouces/Particle/Snow/particle-snow.png");
-		m_pSnowParticleSystem  = new SnowParticleSystem(m_pCamera, 1.5f, 0.35f, 5000, TextureSet);
+		//particles live within half the radius of the eye, 2 reaches below the feet 1.6 under it and the flakes settle on the terrain
+		SnowParticleSystem *pSnow = new SnowParticleSystem(m_pCamera, 4.f, 0.35f, 20000, TextureSet);
+		pSnow->LoadEmitter("EngineResouces/Particle/Snow/Snow.emitter");
+		pSnow->GetCollider().SetTerrain(m_pTerrain, ParticleCollider::RESPONSE_STICK);
+		m_pSnowParticleSystem  = pSnow;
 	}
 
 	{
@@ -223,4 +243,16 @@ void NX::NXEngineDemo::OnTick(const float fDelta) {
 	for (int i = 0; i < NX::ArrayLength(m_pKity); ++i) {
 		m_pKity[i]->GetTransform().AddRotation(0.f, 0.1f * fDelta * (i + 1), NX::RandFloatInRange(0, 0.01));
 	}
+}
+
+void NX::NXEngineDemo::OnLostDevice() {
+	if (m_pSnowParticleSystem) {
+		m_pSnowParticleSystem->OnLostDevice();
+	}
+}
+
+void NX::NXEngineDemo::OnResetDevice() {
+	if (m_pSnowParticleSystem) {
+		m_pSnowParticleSystem->OnResetDevice();
+	}
 }
\ No newline at end of file
@@ -27,6 +27,8 @@ namespace NX {
 	private:
 		virtual void OnInitDX3Succeed() override;
 		virtual void OnTick(float fDelta) override;
+		virtual void OnLostDevice() override;
+		virtual void OnResetDevice() override;
 
 		inline class PerspectCamera*          GetCamera() { return m_pCamera; }
 		inline class Terrain*                 GetTerrain() { return m_pTerrain; }
@@ -43,6 +45,7 @@ namespace NX {
 		class Sky                   *m_pSky;
 		class Sphere                *m_pShere;
 		class Sphere                *m_pKity[4];
+		class LODSelector           *m_pLODSelector;
 		POINT                        m_CurPos;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,193 @@
+/*
+ *  File:    NXAtlasPacker.cpp
+ *
+ *  author:  张雄(zhang xiong, 1025679612@qq.com)
+ *  date:    2026_10_19
+ *  purpose: rectangle bin packing for texture atlases
+ */
+
+#include <algorithm>
+
+#include "NXAtlasPacker.h"
+#include "../common/NXCore.h"
+#include "../math/NXMath.h"
+
+namespace {
+	struct Segment {
+		int         x;
+		int         y;
+		int         iWidth;
+	};
+
+	struct AtlasSize {
+		int         iWidth;
+		int         iHeight;
+	};
+}
+
+NX::AtlasPacker::AtlasPacker() {
+	m_iPadding = 2;
+	m_iMaxSize = 4096;
+}
+
+NX::AtlasPacker::~AtlasPacker() {
+	/**empty here*/
+}
+
+NX::AtlasPacker& NX::AtlasPacker::SetPadding(const int iPadding) {
+	NXAssert(iPadding >= 0);
+	m_iPadding = iPadding;
+	return *this;
+}
+
+NX::AtlasPacker& NX::AtlasPacker::SetMaxSize(const int iMaxSize) {
+	NXAssert(iMaxSize > 0);
+	m_iMaxSize = iMaxSize;
+	return *this;
+}
+
+bool NX::AtlasPacker::Pack(const std::vector<Rect> &Sizes, std::vector<Rect> &Rects, int &iAtlasWidth, int &iAtlasHeight) const {
+	const int iCount = (int)Sizes.size();
+	Rects.resize(iCount);
+
+	NXInt64 iArea = 0;
+	int iMaxWidth = 1, iMaxHeight = 1;
+	std::vector<int> Order(iCount);
+	for (int i = 0; i < iCount; ++i) {
+		NXAssert(Sizes[i].iWidth >= 0 && Sizes[i].iHeight >= 0);
+		const int w = Sizes[i].iWidth + 2 * m_iPadding, h = Sizes[i].iHeight + 2 * m_iPadding;
+		iArea += (NXInt64)w * h;
+		iMaxWidth  = NXMax(iMaxWidth, w);
+		iMaxHeight = NXMax(iMaxHeight, h);
+		Order[i] = i;
+	}
+	{//tallest first, then widest, the index keeps the order deterministic
+		std::sort(Order.begin(), Order.end(), [&](const int a, const int b) {
+			if (Sizes[a].iHeight != Sizes[b].iHeight) {
+				return Sizes[a].iHeight > Sizes[b].iHeight;
+			}
+			if (Sizes[a].iWidth != Sizes[b].iWidth) {
+				return Sizes[a].iWidth > Sizes[b].iWidth;
+			}
+			return a < b;
+		});
+	}
+
+	//power of two sizes by area, squarer ones first
+	std::vector<AtlasSize> Candidates;
+	for (int w = 1; w <= m_iMaxSize; w <<= 1) {
+		for (int h = 1; h <= m_iMaxSize; h <<= 1) {
+			if (w >= iMaxWidth && h >= iMaxHeight && (NXInt64)w * h >= iArea) {
+				AtlasSize Size = { w, h };
+				Candidates.push_back(Size);
+			}
+		}
+	}
+	std::sort(Candidates.begin(), Candidates.end(), [](const AtlasSize &a, const AtlasSize &b) {
+		const NXInt64 iAreaA = (NXInt64)a.iWidth * a.iHeight, iAreaB = (NXInt64)b.iWidth * b.iHeight;
+		if (iAreaA != iAreaB) {
+			return iAreaA < iAreaB;
+		}
+		const int iSkewA = NXMax(a.iWidth, a.iHeight) / NXMin(a.iWidth, a.iHeight), iSkewB = NXMax(b.iWidth, b.iHeight) / NXMin(b.iWidth, b.iHeight);
+		if (iSkewA != iSkewB) {
+			return iSkewA < iSkewB;
+		}
+		return a.iWidth > b.iWidth;
+	});
+
+	for (size_t i = 0; i < Candidates.size(); ++i) {
+		if (PackInto(Sizes, Order, Candidates[i].iWidth, Candidates[i].iHeight, Rects)) {
+			iAtlasWidth  = Candidates[i].iWidth;
+			iAtlasHeight = Candidates[i].iHeight;
+			return true;
+		}
+	}
+	return false;
+}
+
+bool NX::AtlasPacker::PackInto(const std::vector<Rect> &Sizes, const std::vector<int> &Order, const int iAtlasWidth, const int iAtlasHeight, std::vector<Rect> &Rects) const {
+	std::vector<Segment> Skyline;
+	{
+		Segment Floor = { 0, 0, iAtlasWidth };
+		Skyline.push_back(Floor);
+	}
+
+	for (size_t r = 0; r < Order.size(); ++r) {
+		const int iRect = Order[r];
+		const int w = Sizes[iRect].iWidth + 2 * m_iPadding, h = Sizes[iRect].iHeight + 2 * m_iPadding;
+
+		int iBest = -1, iBestY = 0, iBestTop = iAtlasHeight + 1;
+		for (int i = 0; i < (int)Skyline.size() && Skyline[i].x + w <= iAtlasWidth; ++i) {
+			//the rectangle rests on the highest segment below its span
+			int y = 0;
+			for (int j = i, iCovered = 0; iCovered < w; iCovered += Skyline[j].iWidth, ++j) {
+				y = NXMax(y, Skyline[j].y);
+			}
+			if (y + h <= iAtlasHeight && y + h < iBestTop) {
+				iBest    = i;
+				iBestY   = y;
+				iBestTop = y + h;
+			}
+		}
+		if (iBest < 0) {
+			return false;
+		}
+
+		const int x = Skyline[iBest].x;
+		Rects[iRect].x       = x + m_iPadding;
+		Rects[iRect].y       = iBestY + m_iPadding;
+		Rects[iRect].iWidth  = Sizes[iRect].iWidth;
+		Rects[iRect].iHeight = Sizes[iRect].iHeight;
+
+		{//the new top replaces the segments under its span, the last one may be cut
+			Segment Top = { x, iBestTop, w };
+			Skyline.insert(Skyline.begin() + iBest, Top);
+			const int iRight = x + w;
+			for (int k = iBest + 1; k < (int)Skyline.size() && Skyline[k].x < iRight;) {
+				const int iShrink = iRight - Skyline[k].x;
+				if (iShrink >= Skyline[k].iWidth) {
+					Skyline.erase(Skyline.begin() + k);
+				} else {
+					Skyline[k].x      += iShrink;
+					Skyline[k].iWidth -= iShrink;
+					break;
+				}
+			}
+			for (int k = 0; k + 1 < (int)Skyline.size();) {
+				if (Skyline[k].y == Skyline[k + 1].y) {
+					Skyline[k].iWidth += Skyline[k + 1].iWidth;
+					Skyline.erase(Skyline.begin() + k + 1);
+				} else {
+					++k;
+				}
+			}
+		}
+	}
+	return true;
+}
+
+void NX::AtlasPacker::Blit(const NXUInt32 *pSrc, const int iSrcPitch, const Rect &Dst, const int iPadding, NXUInt32 *pAtlas, const int iAtlasPitch, const int iAtlasHeight) {
+	if (Dst.iWidth <= 0 || Dst.iHeight <= 0) {
+		return;
+	}
+	const int iRowBegin = NXMax(Dst.y - iPadding, 0), iRowEnd = NXMin(Dst.y + Dst.iHeight + iPadding, iAtlasHeight);
+	const int iColBegin = NXMax(Dst.x - iPadding, 0), iColEnd = NXMin(Dst.x + Dst.iWidth + iPadding, iAtlasPitch);
+	for (int y = iRowBegin; y < iRowEnd; ++y) {
+		const NXUInt32 *pSrcRow = pSrc + NXMin(NXMax(y - Dst.y, 0), Dst.iHeight - 1) * iSrcPitch;
+		NXUInt32 *pDstRow = pAtlas + (NXInt64)y * iAtlasPitch;
+		for (int x = iColBegin; x < iColEnd; ++x) {
+			pDstRow[x] = pSrcRow[NXMin(NXMax(x - Dst.x, 0), Dst.iWidth - 1)];
+		}
+	}
+}
+
+void NX::AtlasPacker::GetUVRects(const std::vector<Rect> &Rects, const int iAtlasWidth, const int iAtlasHeight, std::vector<float> &UVRects) {
+	UVRects.resize(Rects.size() * 4);
+	const float fInvWidth = 1.f / iAtlasWidth, fInvHeight = 1.f / iAtlasHeight;
+	for (size_t i = 0; i < Rects.size(); ++i) {
+		UVRects[4 * i + 0] = Rects[i].x * fInvWidth;
+		UVRects[4 * i + 1] = Rects[i].y * fInvHeight;
+		UVRects[4 * i + 2] = (Rects[i].x + Rects[i].iWidth) * fInvWidth;
+		UVRects[4 * i + 3] = (Rects[i].y + Rects[i].iHeight) * fInvHeight;
+	}
+}
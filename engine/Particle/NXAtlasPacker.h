@@ -0,0 +1,68 @@
+/*
+ *  File:    NXAtlasPacker.h
+ *
+ *  author:  张雄(zhang xiong, 1025679612@qq.com)
+ *  date:    2026_10_19
+ *  purpose: rectangle bin packing for texture atlases, on the CPU and without any device. rectangles are
+ *           placed tallest first by a bottom-left skyline: the atlas keeps the top edge of what is placed
+ *           as a list of horizontal segments, every rectangle goes where its top ends lowest. the atlas
+ *           tries power of two sizes from the smallest that could hold the total area up to the maximum.
+ *           a padding ring around every rectangle is filled by Blit with the rectangle's edge texels so
+ *           bilinear filtering and the first mip levels don't bleed between neighbours.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "../common/NXType.h"
+
+namespace NX {
+	class AtlasPacker {
+	public:
+		struct Rect {
+			int         x;
+			int         y;
+			int         iWidth;
+			int         iHeight;
+		};
+
+	public:
+		AtlasPacker();
+		virtual ~AtlasPacker();
+
+	public:
+		/**
+		 *  iPadding: texels of edge around every rectangle
+		 *  iMaxSize: the largest atlas side tried, e.g. the device's MaxTextureWidth
+		 */
+		AtlasPacker& SetPadding(const int iPadding);
+		AtlasPacker& SetMaxSize(const int iMaxSize);
+
+	public:
+		/**
+		 *  Sizes holds the iWidth and iHeight of every rectangle, x and y are ignored. on success Rects
+		 *  receives the placement of each in the same order, the padding outside of it, and the atlas size
+		 *  is returned in iAtlasWidth/iAtlasHeight. false if they don't fit iMaxSize.
+		 */
+		bool  Pack(const std::vector<Rect> &Sizes, std::vector<Rect> &Rects, int &iAtlasWidth, int &iAtlasHeight) const;
+
+		/**
+		 *  copy a Dst.iWidth x Dst.iHeight image to Dst.x/y in the atlas and repeat its edge texels into iPadding
+		 *  texels around it. pitches are in texels.
+		 */
+		static void Blit(const NXUInt32 *pSrc, const int iSrcPitch, const Rect &Dst, const int iPadding, NXUInt32 *pAtlas, const int iAtlasPitch, const int iAtlasHeight);
+
+		/**
+		 *  u0 v0 u1 v1 of every rectangle in an atlas of the given size, 4 floats per rectangle
+		 */
+		static void GetUVRects(const std::vector<Rect> &Rects, const int iAtlasWidth, const int iAtlasHeight, std::vector<float> &UVRects);
+
+	private:
+		bool  PackInto(const std::vector<Rect> &Sizes, const std::vector<int> &Order, const int iAtlasWidth, const int iAtlasHeight, std::vector<Rect> &Rects) const;
+
+	private:
+		int         m_iPadding;
+		int         m_iMaxSize;
+	};
+}
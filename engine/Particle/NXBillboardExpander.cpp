@@ -0,0 +1,254 @@
+/*
+ *  File:    NXBillboardExpander.cpp
+ *
+ *  author:  张雄(zhang xiong, 1025679612@qq.com)
+ *  date:    2026_10_19
+ *  purpose: expand particles into quads on the CPU
+ */
+
+#include "NXBillboardExpander.h"
+#include "NXParticleStorage.h"
+#include "../common/NXCore.h"
+#include "../math/NXAlgorithm.h"
+#include "../math/NXMath.h"
+
+namespace {
+	inline void WriteVertex(NX::Particle::Vertex *pVertex, const float x, const float y, const float z, const float u, const float v, const NXUInt32 color) {
+		pVertex->x     = x;
+		pVertex->y     = y;
+		pVertex->z     = z;
+		pVertex->u     = u;
+		pVertex->v     = v;
+		pVertex->color = color;
+	}
+
+	/**
+	 *  the corners of Particle::FillVertexBuffer, (-x, +y) (+x, +y) (+x, -y) (-x, -y) with the half size
+	 *  already folded into the edges. uv is u0 v0 u1 v1, the whole texture is 0 0 1 1
+	 */
+	inline void WriteQuad(NX::Particle::Vertex *pQuad, const float px, const float py, const float pz, const float ex[3], const float ey[3], const float uv[4], const NXUInt32 color) {
+		const float ax = px - ex[0], ay = py - ex[1], az = pz - ex[2];
+		const float bx = px + ex[0], by = py + ex[1], bz = pz + ex[2];
+		WriteVertex(pQuad + 0, ax + ey[0], ay + ey[1], az + ey[2], uv[0], uv[1], color);
+		WriteVertex(pQuad + 1, bx + ey[0], by + ey[1], bz + ey[2], uv[2], uv[1], color);
+		WriteVertex(pQuad + 2, bx - ey[0], by - ey[1], bz - ey[2], uv[2], uv[3], color);
+		WriteVertex(pQuad + 3, ax - ey[0], ay - ey[1], az - ey[2], uv[0], uv[3], color);
+	}
+
+	const float kWholeTexture[4] = { 0.f, 0.f, 1.f, 1.f };
+
+	/**
+	 *  nullptr or iIntervals + 1 samples over AGE / LIFE_TIME
+	 */
+	struct LifeCurve {
+		const float *pSamples;
+		float       fIntervals;
+		int         iIntervals;
+
+		LifeCurve(const float *_pSamples, const int iSampleCount) {
+			pSamples   = iSampleCount > 1 ? _pSamples : nullptr;
+			iIntervals = iSampleCount - 1;
+			fIntervals = (float)iIntervals;
+		}
+
+		inline float Evaluate(const float fAge, const float fLifeTime) const {
+			const float fSample = NX::NXMin(NX::NXMax(fAge / fLifeTime, 0.f), 1.f) * fIntervals;
+			const int   iSample = NX::NXMin((int)fSample, iIntervals - 1);
+			return pSamples[iSample] + (pSamples[iSample + 1] - pSamples[iSample]) * (fSample - iSample);
+		}
+	};
+
+	struct ParticleStreams {
+		const float *px, *py, *pz, *pSizeX, *pSizeY, *pAge, *pLife;
+		const float *pxc, *pxs, *pyc, *pys, *pzc, *pzs;
+		const NXInt32 *pTextureIndexs;
+		const float *pUVRects;           // nullptr or iUVRectCount u0 v0 u1 v1 by texture index
+		int         iUVRectCount;
+		LifeCurve   SizeCurve;
+		LifeCurve   AlphaCurve;
+
+		ParticleStreams(const NX::ParticleStorage &Particles, const float *_pUVRects, const int _iUVRectCount, const LifeCurve &_SizeCurve, const LifeCurve &_AlphaCurve)
+			: SizeCurve(_SizeCurve), AlphaCurve(_AlphaCurve) {
+			px     = Particles.GetStream(NX::ParticleStorage::POSITION_X);
+			py     = Particles.GetStream(NX::ParticleStorage::POSITION_Y);
+			pz     = Particles.GetStream(NX::ParticleStorage::POSITION_Z);
+			pSizeX = Particles.GetStream(NX::ParticleStorage::SIZE_X);
+			pSizeY = Particles.GetStream(NX::ParticleStorage::SIZE_Y);
+			pAge   = Particles.GetStream(NX::ParticleStorage::AGE);
+			pLife  = Particles.GetStream(NX::ParticleStorage::LIFE_TIME);
+			pxc    = Particles.GetStream(NX::ParticleStorage::ROTOR_X_COS), pxs = Particles.GetStream(NX::ParticleStorage::ROTOR_X_SIN);
+			pyc    = Particles.GetStream(NX::ParticleStorage::ROTOR_Y_COS), pys = Particles.GetStream(NX::ParticleStorage::ROTOR_Y_SIN);
+			pzc    = Particles.GetStream(NX::ParticleStorage::ROTOR_Z_COS), pzs = Particles.GetStream(NX::ParticleStorage::ROTOR_Z_SIN);
+			pTextureIndexs  = Particles.GetTextureIndexs();
+			pUVRects        = _iUVRectCount > 0 ? _pUVRects : nullptr;
+			iUVRectCount    = _iUVRectCount;
+		}
+	};
+
+	/**
+	 *  the quad of particle i, EdgeX/EdgeY are unit edges used when bFreeRotation is false
+	 */
+	inline void WriteParticle(const ParticleStreams &s, const int i, const bool bFreeRotation, const NX::float3 &EdgeX, const NX::float3 &EdgeY, NX::Particle::Vertex *pQuad) {
+		float fScale = .5f;
+		if (s.SizeCurve.pSamples) {
+			fScale *= s.SizeCurve.Evaluate(s.pAge[i], s.pLife[i]);
+		}
+		NXUInt32 color = 0xffffffff;
+		if (s.AlphaCurve.pSamples) {
+			const float fAlpha = NX::NXMin(NX::NXMax(s.AlphaCurve.Evaluate(s.pAge[i], s.pLife[i]), 0.f), 1.f);
+			color = ((NXUInt32)(fAlpha * 255.f + .5f) << 24) | 0x00ffffff;
+		}
+		const float lx = s.pSizeX[i] * fScale, ly = s.pSizeY[i] * fScale;
+		float ex[3], ey[3];
+		if (bFreeRotation) {
+			{//q = rotor x * rotor y * rotor z, see ParticleStorage::GetOrientation
+				const float qw0 = s.pxc[i] * s.pyc[i], qx0 = s.pxs[i] * s.pyc[i], qy0 = s.pxc[i] * s.pys[i], qz0 = s.pxs[i] * s.pys[i];
+				const float w = qw0 * s.pzc[i] - qz0 * s.pzs[i];
+				const float x = qx0 * s.pzc[i] + qy0 * s.pzs[i];
+				const float y = qy0 * s.pzc[i] - qx0 * s.pzs[i];
+				const float z = qw0 * s.pzs[i] + qz0 * s.pzc[i];
+				//the first two columns of the rotation matrix, the rotated local x and y axes
+				const float x2 = x + x, y2 = y + y, z2 = z + z;
+				const float xx = x * x2, yy = y * y2, zz = z * z2;
+				const float xy = x * y2, xz = x * z2, yz = y * z2;
+				const float wx = w * x2, wy = w * y2, wz = w * z2;
+				ex[0] = (1.f - yy - zz) * lx, ex[1] = (xy + wz) * lx,       ex[2] = (xz - wy) * lx;
+				ey[0] = (xy - wz) * ly,       ey[1] = (1.f - xx - zz) * ly, ey[2] = (yz + wx) * ly;
+			}
+		} else {
+			ex[0] = EdgeX.x * lx, ex[1] = EdgeX.y * lx, ex[2] = EdgeX.z * lx;
+			ey[0] = EdgeY.x * ly, ey[1] = EdgeY.y * ly, ey[2] = EdgeY.z * ly;
+		}
+		const float *pUV = s.pUVRects ? s.pUVRects + 4 * NX::NXMin(NX::NXMax(s.pTextureIndexs[i], 0), s.iUVRectCount - 1) : kWholeTexture;
+		WriteQuad(pQuad, s.px[i], s.py[i], s.pz[i], ex, ey, pUV, color);
+	}
+}
+
+NX::BillboardExpander::BillboardExpander() {
+	m_eMode     = MODE_CAMERA_FACING;
+	m_Right     = float3(1.f, 0.f, 0.f);
+	m_Up        = float3(0.f, 1.f, 0.f);
+	m_Front     = float3(0.f, 0.f, 1.f);
+	m_AlignAxis = float3(0.f, 1.f, 0.f);
+	m_pSizeCurve         = nullptr;
+	m_iSizeCurveSamples  = 0;
+	m_pAlphaCurve        = nullptr;
+	m_iAlphaCurveSamples = 0;
+	m_pUVRects          = nullptr;
+	m_iUVRectCount      = 0;
+}
+
+NX::BillboardExpander::~BillboardExpander() {
+	/**empty here*/
+}
+
+NX::BillboardExpander& NX::BillboardExpander::SetMode(const MODE eMode) {
+	m_eMode = eMode;
+	return *this;
+}
+
+NX::BillboardExpander& NX::BillboardExpander::SetCameraAxes(const float3 &Right, const float3 &Up, const float3 &Front) {
+	m_Right = Right;
+	m_Up    = Up;
+	m_Front = Front;
+	return *this;
+}
+
+NX::BillboardExpander& NX::BillboardExpander::SetAlignAxis(const float3 &Axis) {
+	NXAssert(LengthSquare(Axis) > 0.f);
+	m_AlignAxis = GetNormalized(Axis);
+	return *this;
+}
+
+NX::BillboardExpander& NX::BillboardExpander::SetSizeCurve(const float *pSamples, const int iSampleCount) {
+	NXAssert(!pSamples || iSampleCount > 1);
+	m_pSizeCurve        = pSamples;
+	m_iSizeCurveSamples = pSamples ? iSampleCount : 0;
+	return *this;
+}
+
+NX::BillboardExpander& NX::BillboardExpander::SetAlphaCurve(const float *pSamples, const int iSampleCount) {
+	NXAssert(!pSamples || iSampleCount > 1);
+	m_pAlphaCurve        = pSamples;
+	m_iAlphaCurveSamples = pSamples ? iSampleCount : 0;
+	return *this;
+}
+
+NX::BillboardExpander& NX::BillboardExpander::SetUVRects(const float *pUVRects, const int iRectCount) {
+	NXAssert(!pUVRects || iRectCount > 0);
+	m_pUVRects     = pUVRects;
+	m_iUVRectCount = pUVRects ? iRectCount : 0;
+	return *this;
+}
+
+NX::BillboardExpander::MODE NX::BillboardExpander::GetMode() const {
+	return m_eMode;
+}
+
+void NX::BillboardExpander::GetAxisAlignedEdges(float3 &EdgeX, float3 &EdgeY) const {
+	EdgeY = m_AlignAxis;
+	EdgeX = m_Right - m_AlignAxis * Dot(m_Right, m_AlignAxis);
+	if (LengthSquare(EdgeX) < 1e-6f) {//looking along the axis, any edge across it will do
+		EdgeX = Cross(m_AlignAxis, m_Front);
+		if (LengthSquare(EdgeX) < 1e-6f) {
+			EdgeX = Cross(m_AlignAxis, m_Up);
+		}
+	}
+	EdgeX = GetNormalized(EdgeX);
+}
+
+int NX::BillboardExpander::Expand(const ParticleStorage &Particles, const NXUInt8 *pDeadMask, Particle::Vertex *pVertices, const int iMaxQuads, Statistics *pStatistics) const {
+	const int    iCount  = Particles.GetCount();
+	const float  *pAge   = Particles.GetStream(ParticleStorage::AGE);
+	const float  *pLife  = Particles.GetStream(ParticleStorage::LIFE_TIME);
+	const ParticleStreams Streams(Particles, m_pUVRects, m_iUVRectCount, LifeCurve(m_pSizeCurve, m_iSizeCurveSamples), LifeCurve(m_pAlphaCurve, m_iAlphaCurveSamples));
+
+	float3 EdgeX = m_Right, EdgeY = m_Up;
+	if (m_eMode == MODE_AXIS_ALIGNED) {
+		GetAxisAlignedEdges(EdgeX, EdgeY);
+	}
+
+	int iQuadCount = 0, iDeadCount = 0;
+	Particle::Vertex *pQuad = pVertices;
+	for (int i = 0; i < iCount && iQuadCount < iMaxQuads; ++i) {
+		const bool bDead = pDeadMask ? ((pDeadMask[i / ParticleStorage::DEAD_MASK_GROUP] >> (i % ParticleStorage::DEAD_MASK_GROUP)) & 1) != 0 : pAge[i] >= pLife[i];
+		if (bDead) {
+			++iDeadCount;
+			continue;
+		}
+		WriteParticle(Streams, i, m_eMode == MODE_FREE_ROTATION, EdgeX, EdgeY, pQuad);
+		pQuad += 4;
+		++iQuadCount;
+	}
+
+	if (pStatistics) {
+		pStatistics->iQuadCount   = iQuadCount;
+		pStatistics->iDeadCount   = iDeadCount;
+		pStatistics->uVertexBytes = (NXUInt64)iQuadCount * 4 * sizeof(Particle::Vertex);
+	}
+	return iQuadCount;
+}
+
+int NX::BillboardExpander::Expand(const ParticleStorage &Particles, const NXUInt32 *pOrder, const int iOrderCount, Particle::Vertex *pVertices, const int iMaxQuads, Statistics *pStatistics) const {
+	const ParticleStreams Streams(Particles, m_pUVRects, m_iUVRectCount, LifeCurve(m_pSizeCurve, m_iSizeCurveSamples), LifeCurve(m_pAlphaCurve, m_iAlphaCurveSamples));
+
+	float3 EdgeX = m_Right, EdgeY = m_Up;
+	if (m_eMode == MODE_AXIS_ALIGNED) {
+		GetAxisAlignedEdges(EdgeX, EdgeY);
+	}
+
+	const int iQuadCount = NXMin(iOrderCount, iMaxQuads);
+	Particle::Vertex *pQuad = pVertices;
+	for (int k = 0; k < iQuadCount; ++k) {
+		NXAssert((int)pOrder[k] < Particles.GetCount());
+		WriteParticle(Streams, (int)pOrder[k], m_eMode == MODE_FREE_ROTATION, EdgeX, EdgeY, pQuad);
+		pQuad += 4;
+	}
+
+	if (pStatistics) {
+		pStatistics->iQuadCount   = iQuadCount;
+		pStatistics->iDeadCount   = 0;
+		pStatistics->uVertexBytes = (NXUInt64)iQuadCount * 4 * sizeof(Particle::Vertex);
+	}
+	return iQuadCount;
+}
@@ -0,0 +1,89 @@
+/*
+ *  File:    NXBillboardExpander.h
+ *
+ *  author:  张雄(zhang xiong, 1025679612@qq.com)
+ *  date:    2026_10_19
+ *  purpose: expand the live particles of a ParticleStorage into quads on the CPU, written in Particle::Vertex
+ *           layout straight into a locked vertex buffer. every quad has the corners and texcoords of
+ *           Particle::FillVertexBuffer, the texcoords squeezed into the particle texture's rectangle when
+ *           an atlas is set, only its two edge axes depend on the mode. the axes are found once per
+ *           call or, for free rotation, from the storage's incrementally advanced rotors, so there is no trig
+ *           and no matrix per particle. the destination is written front to back and never read.
+ *           the vertex colour is white with the alpha curve's value, opaque without one.
+ */
+
+#pragma once
+
+#include "NXParticle.h"
+#include "../math/NXVector.h"
+#include "../common/NXType.h"
+
+namespace NX {
+	class ParticleStorage;
+
+	class BillboardExpander {
+	public:
+		enum MODE {
+			MODE_CAMERA_FACING,          // the quad lies in the camera's right/up plane
+			MODE_AXIS_ALIGNED,           // the quad's up edge follows the align axis and turns toward the camera around it
+			MODE_FREE_ROTATION,          // the quad follows the particle's ROTATION like Particle::FillVertexBuffer
+		};
+
+		struct Statistics {
+			int         iQuadCount;
+			int         iDeadCount;          // skipped particles
+			NXUInt64    uVertexBytes;        // written to the destination
+		};
+
+	public:
+		BillboardExpander();
+		virtual ~BillboardExpander();
+
+	public:
+		/**
+		 *  Right/Up/Front: the camera's world space axes, MVMatrixController::GetRightAxis and friends
+		 *  Axis: the up edge of MODE_AXIS_ALIGNED quads, normalized by the setter
+		 *  pSamples: iSampleCount evenly spaced scales of the size or values of the alpha over AGE / LIFE_TIME,
+		 *  e.g. a curve of EmitterDefinition. the samples aren't copied, nullptr turns the curve off
+		 *  pUVRects: u0 v0 u1 v1 of every texture index in an atlas, e.g. ParticleAtlas::GetUVRects. indexs
+		 *  past the end use the last rectangle. not copied, nullptr maps every quad to the whole texture
+		 */
+		BillboardExpander& SetMode(const MODE eMode);
+		BillboardExpander& SetCameraAxes(const float3 &Right, const float3 &Up, const float3 &Front);
+		BillboardExpander& SetAlignAxis(const float3 &Axis);
+		BillboardExpander& SetSizeCurve(const float *pSamples, const int iSampleCount);
+		BillboardExpander& SetAlphaCurve(const float *pSamples, const int iSampleCount);
+		BillboardExpander& SetUVRects(const float *pUVRects, const int iRectCount);
+		MODE               GetMode() const;
+
+	public:
+		/**
+		 *  write 4 vertices for every live particle in storage order, at most iMaxQuads quads. pDeadMask is a
+		 *  death mask from ParticleStorage::Integrate, nullptr compares AGE with LIFE_TIME instead.
+		 *  returns the number of quads, quad q uses vertices [4q, 4q + 4).
+		 */
+		int   Expand(const ParticleStorage &Particles, const NXUInt8 *pDeadMask, Particle::Vertex *pVertices, const int iMaxQuads, Statistics *pStatistics = nullptr) const;
+
+		/**
+		 *  write the quads of pOrder[0, iOrderCount) in that order, e.g. ParticleDepthSort::GetOrder for
+		 *  back to front blending. every index must be live, iDeadCount is always 0.
+		 */
+		int   Expand(const ParticleStorage &Particles, const NXUInt32 *pOrder, const int iOrderCount, Particle::Vertex *pVertices, const int iMaxQuads, Statistics *pStatistics = nullptr) const;
+
+	private:
+		void  GetAxisAlignedEdges(float3 &EdgeX, float3 &EdgeY) const;
+
+	private:
+		MODE        m_eMode;
+		float3      m_Right;
+		float3      m_Up;
+		float3      m_Front;
+		float3      m_AlignAxis;
+		const float *m_pSizeCurve;
+		int         m_iSizeCurveSamples;
+		const float *m_pAlphaCurve;
+		int         m_iAlphaCurveSamples;
+		const float *m_pUVRects;
+		int         m_iUVRectCount;
+	};
+}
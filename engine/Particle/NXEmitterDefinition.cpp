@@ -0,0 +1,332 @@
+/*
+ *  File:    NXEmitterDefinition.cpp
+ *
+ *  author:  张雄(zhang xiong, 1025679612@qq.com)
+ *  date:    2026_10_19
+ *  purpose: data driven particle emitter
+ */
+
+#include <cstdio>
+#include <cmath>
+#include <vector>
+
+#include "NXEmitterDefinition.h"
+#include "NXParticleStorage.h"
+#include "../3rdLibs/jsoncpp/json.h"
+#include "../math/NXRandom.h"
+#include "../math/NXMath.h"
+#include "../math/NXNumeric.h"
+#include "../common/NXCore.h"
+#include "../common/NXLog.h"
+
+namespace {
+	bool ReadFloat3(const Json::Value &Node, const char *szName, NX::float3 &Value, std::string &strError) {
+		if (Node.isNull()) {
+			return true;
+		}
+		if (!Node.isArray() || Node.size() != 3 || !Node[0].isNumeric() || !Node[1].isNumeric() || !Node[2].isNumeric()) {
+			strError = std::string(szName) + " must be [x, y, z]";
+			return false;
+		}
+		Value = NX::float3(Node[0].asFloat(), Node[1].asFloat(), Node[2].asFloat());
+		return true;
+	}
+
+	bool ReadFloat(const Json::Value &Node, const char *szName, float &fValue, std::string &strError) {
+		if (Node.isNull()) {
+			return true;
+		}
+		if (!Node.isNumeric()) {
+			strError = std::string(szName) + " must be a number";
+			return false;
+		}
+		fValue = Node.asFloat();
+		return true;
+	}
+
+	/**
+	 *  [min, max] or a single value for both
+	 */
+	bool ReadRange(const Json::Value &Node, const char *szName, float &fMin, float &fMax, std::string &strError) {
+		if (Node.isNull()) {
+			return true;
+		}
+		if (Node.isNumeric()) {
+			fMin = fMax = Node.asFloat();
+			return true;
+		}
+		if (!Node.isArray() || Node.size() != 2 || !Node[0].isNumeric() || !Node[1].isNumeric() || Node[0].asFloat() > Node[1].asFloat()) {
+			strError = std::string(szName) + " must be a number or [min, max] with min <= max";
+			return false;
+		}
+		fMin = Node[0].asFloat();
+		fMax = Node[1].asFloat();
+		return true;
+	}
+
+	/**
+	 *  {"Min" : [x, y, z], "Max" : [x, y, z]} or a single [x, y, z] for both
+	 */
+	bool ReadRange3(const Json::Value &Node, const char *szName, NX::float3 &Min, NX::float3 &Max, std::string &strError) {
+		if (Node.isNull()) {
+			return true;
+		}
+		if (Node.isArray()) {
+			if (!ReadFloat3(Node, szName, Min, strError)) {
+				return false;
+			}
+			Max = Min;
+			return true;
+		}
+		if (!Node.isObject() || !ReadFloat3(Node["Min"], szName, Min, strError) || !ReadFloat3(Node["Max"], szName, Max, strError)) {
+			if (strError.empty()) {
+				strError = std::string(szName) + " must be [x, y, z] or {\"Min\" : [x, y, z], \"Max\" : [x, y, z]}";
+			}
+			return false;
+		}
+		if (Min.x > Max.x || Min.y > Max.y || Min.z > Max.z) {
+			strError = std::string(szName) + " Min must not exceed Max";
+			return false;
+		}
+		return true;
+	}
+
+	bool ReadCurve(const Json::Value &Node, const char *szName, float *pSamples, bool &bConstant, std::string &strError) {
+		if (Node.isNull()) {
+			return true;
+		}
+		if (!Node.isArray() || !Node.size()) {
+			strError = std::string(szName) + " curve must be a list of [time, value] keys";
+			return false;
+		}
+		std::vector<float> Keys;
+		for (Json::ArrayIndex i = 0; i < Node.size(); ++i) {
+			const Json::Value &Key = Node[i];
+			if (!Key.isArray() || Key.size() != 2 || !Key[0].isNumeric() || !Key[1].isNumeric() || (!Keys.empty() && Key[0].asFloat() < Keys[Keys.size() - 2])) {
+				strError = std::string(szName) + " curve keys must be [time, value] with ascending times";
+				return false;
+			}
+			Keys.push_back(Key[0].asFloat());
+			Keys.push_back(Key[1].asFloat());
+		}
+		NX::EmitterDefinition::SampleCurve(&Keys[0], (int)Node.size(), pSamples);
+		bConstant = true;
+		for (int i = 0; i <= NX::EmitterDefinition::CURVE_SAMPLES; ++i) {
+			bConstant &= pSamples[i] == 1.f;
+		}
+		return true;
+	}
+}
+
+NX::EmitterDefinition::EmitterDefinition() {
+	Reset();
+}
+
+NX::EmitterDefinition::~EmitterDefinition() {
+	/**empty here*/
+}
+
+void NX::EmitterDefinition::Reset() {
+	const float3 Zero(0.f, 0.f, 0.f);
+	Parameters &p = m_Parameters;
+	p.eShape              = SHAPE_SPHERE;
+	p.ShapeCenter         = Zero;
+	p.BoxHalfExtents      = float3(1.f, 1.f, 1.f);
+	p.fInnerRadius        = 0.f;
+	p.fOuterRadius        = 1.f;
+	p.fRate               = 0.f;
+	p.iMaxCount           = 0x7FFFFFFF;
+	p.VelocityMin         = p.VelocityMax        = Zero;
+	p.RotationMin         = p.RotationMax        = Zero;
+	p.AngularVelocityMin  = p.AngularVelocityMax = Zero;
+	p.fLifeTimeMin        = p.fLifeTimeMax       = 1.f;
+	p.fSizeMin            = p.fSizeMax           = 0.01f;
+	p.fAspect             = 1.f;
+	p.iTextureMin         = 0;
+	p.iTextureMax         = 0x7FFFFFFF;
+	p.Acceleration        = Zero;
+	p.AngularAcceleration = Zero;
+	p.fDrag               = 0.f;
+	for (int c = 0; c < CURVE_COUNT; ++c) {
+		p.bCurveConstant[c] = true;
+		for (int i = 0; i <= CURVE_SAMPLES; ++i) {
+			p.Curves[c][i] = 1.f;
+		}
+	}
+}
+
+bool NX::EmitterDefinition::LoadFromFile(const std::string &strFilePath) {
+	FILE *pFile = fopen(strFilePath.c_str(), "rb");
+	if (!pFile) {
+		glb_GetLog().logToConsole("Load emitter [file: %s] failed, can't open it", strFilePath.c_str());
+		return false;
+	}
+	std::string strJson;
+	char Buffer[4096];
+	for (size_t uRead = 0; (uRead = fread(Buffer, 1, sizeof(Buffer), pFile)) > 0;) {
+		strJson.append(Buffer, uRead);
+	}
+	fclose(pFile);
+
+	const bool bSucceed = LoadFromString(strJson);
+	glb_GetLog().logToConsole("Load emitter [file: %s] %s", strFilePath.c_str(), bSucceed ? "succeed" : "failed");
+	return bSucceed;
+}
+
+bool NX::EmitterDefinition::LoadFromString(const std::string &strJson) {
+	//resource files are saved with a UTF-8 BOM
+	const size_t uStart = strJson.compare(0, 3, "\xEF\xBB\xBF") == 0 ? 3 : 0;
+	Json::Value Root;
+	Json::Reader reader;
+	if (!reader.parse(strJson.c_str() + uStart, strJson.c_str() + strJson.size(), Root, false)) {
+		glb_GetLog().logToConsole("Parse emitter failed with [error:%s]", reader.getFormattedErrorMessages().c_str());
+		return false;
+	}
+	return Compile(Root);
+}
+
+bool NX::EmitterDefinition::Compile(const Json::Value &Root) {
+	//everything is compiled into a copy, a bad description leaves the current parameters alone
+	EmitterDefinition Compiled(*this);
+	Parameters &p = Compiled.m_Parameters;
+	std::string strError;
+	bool bSucceed = Root.isObject();
+	if (!bSucceed) {
+		strError = "the root must be an object";
+	}
+
+	if (bSucceed && !Root["ResouceType"].isNull() && Root["ResouceType"].asString() != "ParticleEmitter") {
+		strError = "ResouceType must be ParticleEmitter";
+		bSucceed = false;
+	}
+
+	if (bSucceed && !Root["Shape"].isNull()) {
+		const Json::Value &Shape = Root["Shape"];
+		const std::string strType = Shape["Type"].isString() ? Shape["Type"].asString() : std::string("");
+		if (strType == "Point") {
+			p.eShape = SHAPE_POINT;
+		} else if (strType == "Box") {
+			p.eShape = SHAPE_BOX;
+		} else if (strType == "Sphere") {
+			p.eShape = SHAPE_SPHERE;
+		} else {
+			strError = "Shape Type must be Point, Box or Sphere";
+			bSucceed = false;
+		}
+		bSucceed = bSucceed && ReadFloat3(Shape["Center"], "Shape Center", p.ShapeCenter, strError);
+		bSucceed = bSucceed && ReadFloat3(Shape["HalfExtents"], "Shape HalfExtents", p.BoxHalfExtents, strError);
+		bSucceed = bSucceed && ReadRange(Shape["Radius"], "Shape Radius", p.fInnerRadius, p.fOuterRadius, strError);
+		if (bSucceed && p.fInnerRadius < 0.f) {
+			strError = "Shape Radius must not be negative";
+			bSucceed = false;
+		}
+	}
+
+	bSucceed = bSucceed && ReadFloat(Root["Rate"], "Rate", p.fRate, strError);
+	if (bSucceed && !Root["MaxCount"].isNull()) {
+		if (!Root["MaxCount"].isIntegral() || Root["MaxCount"].asInt() < 0) {
+			strError = "MaxCount must be a count";
+			bSucceed = false;
+		} else {
+			p.iMaxCount = Root["MaxCount"].asInt();
+		}
+	}
+	bSucceed = bSucceed && ReadRange3(Root["Velocity"], "Velocity", p.VelocityMin, p.VelocityMax, strError);
+	bSucceed = bSucceed && ReadRange3(Root["Rotation"], "Rotation", p.RotationMin, p.RotationMax, strError);
+	bSucceed = bSucceed && ReadRange3(Root["AngularVelocity"], "AngularVelocity", p.AngularVelocityMin, p.AngularVelocityMax, strError);
+	bSucceed = bSucceed && ReadRange(Root["LifeTime"], "LifeTime", p.fLifeTimeMin, p.fLifeTimeMax, strError);
+	bSucceed = bSucceed && ReadRange(Root["Size"], "Size", p.fSizeMin, p.fSizeMax, strError);
+	bSucceed = bSucceed && ReadFloat(Root["Aspect"], "Aspect", p.fAspect, strError);
+	if (bSucceed && !Root["Texture"].isNull()) {
+		float fMin = 0.f, fMax = 0.f;
+		bSucceed = ReadRange(Root["Texture"], "Texture", fMin, fMax, strError);
+		p.iTextureMin = NXMax((int)fMin, 0);
+		p.iTextureMax = NXMax((int)fMax, p.iTextureMin);
+	}
+
+	if (bSucceed && !Root["Forces"].isNull()) {
+		const Json::Value &Forces = Root["Forces"];
+		float3 Gravity(0.f, 0.f, 0.f), Wind(0.f, 0.f, 0.f);
+		bSucceed = bSucceed && ReadFloat3(Forces["Gravity"], "Forces Gravity", Gravity, strError);
+		bSucceed = bSucceed && ReadFloat3(Forces["Wind"], "Forces Wind", Wind, strError);
+		bSucceed = bSucceed && ReadFloat3(Forces["AngularAcceleration"], "Forces AngularAcceleration", p.AngularAcceleration, strError);
+		bSucceed = bSucceed && ReadFloat(Forces["Drag"], "Forces Drag", p.fDrag, strError);
+		p.Acceleration = Gravity + Wind;
+	}
+
+	if (bSucceed && !Root["Curves"].isNull()) {
+		const Json::Value &Curves = Root["Curves"];
+		bSucceed = ReadCurve(Curves["Size"], "Size", p.Curves[CURVE_SIZE], p.bCurveConstant[CURVE_SIZE], strError);
+		bSucceed = bSucceed && ReadCurve(Curves["Alpha"], "Alpha", p.Curves[CURVE_ALPHA], p.bCurveConstant[CURVE_ALPHA], strError);
+		bSucceed = bSucceed && ReadCurve(Curves["Speed"], "Speed", p.Curves[CURVE_SPEED], p.bCurveConstant[CURVE_SPEED], strError);
+	}
+
+	if (!bSucceed) {
+		glb_GetLog().logToConsole("Compile emitter failed with [error:%s]", strError.c_str());
+		return false;
+	}
+	m_Parameters = p;
+	return true;
+}
+
+NX::EmitterDefinition::Parameters& NX::EmitterDefinition::GetParameters() {
+	return m_Parameters;
+}
+
+const NX::EmitterDefinition::Parameters& NX::EmitterDefinition::GetParameters() const {
+	return m_Parameters;
+}
+
+float NX::EmitterDefinition::EvaluateCurve(const CURVE eCurve, const float fLifeRatio) const {
+	const float *pSamples = m_Parameters.Curves[eCurve];
+	const float  fSample  = NXMin(NXMax(fLifeRatio, 0.f), 1.f) * CURVE_SAMPLES;
+	const int    iSample  = NXMin((int)fSample, CURVE_SAMPLES - 1);
+	return pSamples[iSample] + (pSamples[iSample + 1] - pSamples[iSample]) * (fSample - iSample);
+}
+
+void NX::EmitterDefinition::Spawn(ParticleStorage &Particles, const int i, const float3 &Origin, const int iTextureCount, Random &random) const {
+	const Parameters &p = m_Parameters;
+	const int iTextureMax = NXMax(iTextureCount - 1, 0);
+	const int iTexture = random.IntInRange(NXMin(p.iTextureMin, iTextureMax), NXMin(p.iTextureMax, iTextureMax));
+	const float3 Rotation(random.FloatInRange(p.RotationMin.x, p.RotationMax.x), random.FloatInRange(p.RotationMin.y, p.RotationMax.y), random.FloatInRange(p.RotationMin.z, p.RotationMax.z));
+
+	float3 Position = Origin + p.ShapeCenter;
+	if (p.eShape == SHAPE_BOX) {
+		Position += float3(random.FloatInRange(-p.BoxHalfExtents.x, p.BoxHalfExtents.x), random.FloatInRange(-p.BoxHalfExtents.y, p.BoxHalfExtents.y), random.FloatInRange(-p.BoxHalfExtents.z, p.BoxHalfExtents.z));
+	} else if (p.eShape == SHAPE_SPHERE) {
+		{//uniform direction, the radius by the inverse of the shell's volume so the density is uniform too
+			const float z     = random.FloatInRange(-1.f, 1.f);
+			const float fPhi  = random.FloatInRange(0.f, kf2Pi);
+			const float r0    = p.fInnerRadius * p.fInnerRadius * p.fInnerRadius;
+			const float r1    = p.fOuterRadius * p.fOuterRadius * p.fOuterRadius;
+			const float r     = std::pow(random.FloatInRange(r0, r1), 1.f / 3.f);
+			const float fRing = std::sqrt(NXMax(1.f - z * z, 0.f)) * r;
+			Position += float3(fRing * std::cos(fPhi), z * r, fRing * std::sin(fPhi));
+		}
+	}
+
+	const float3 Velocity(random.FloatInRange(p.VelocityMin.x, p.VelocityMax.x), random.FloatInRange(p.VelocityMin.y, p.VelocityMax.y), random.FloatInRange(p.VelocityMin.z, p.VelocityMax.z));
+	const float3 AngularVelocity(random.FloatInRange(p.AngularVelocityMin.x, p.AngularVelocityMax.x), random.FloatInRange(p.AngularVelocityMin.y, p.AngularVelocityMax.y), random.FloatInRange(p.AngularVelocityMin.z, p.AngularVelocityMax.z));
+	const float fLifeTime = random.FloatInRange(p.fLifeTimeMin, p.fLifeTimeMax);
+	const float fSize = random.FloatInRange(p.fSizeMin, p.fSizeMax);
+
+	Particles.Set(i, Position, Velocity, Rotation, AngularVelocity, fLifeTime, float2(fSize, fSize * p.fAspect), iTexture);
+}
+
+void NX::EmitterDefinition::SampleCurve(const float *pKeys, const int iKeyCount, float *pSamples) {
+	NXAssert(iKeyCount > 0);
+	int iKey = 0;
+	for (int i = 0; i <= CURVE_SAMPLES; ++i) {
+		const float t = (float)i / CURVE_SAMPLES;
+		while (iKey + 1 < iKeyCount && pKeys[2 * (iKey + 1)] <= t) {
+			++iKey;
+		}
+		const float *pKey = pKeys + 2 * iKey;
+		if (t <= pKey[0] || iKey + 1 == iKeyCount) {
+			pSamples[i] = pKey[1];
+		} else {
+			const float *pNext = pKey + 2;
+			pSamples[i] = pKey[1] + (pNext[1] - pKey[1]) * (t - pKey[0]) / (pNext[0] - pKey[0]);
+		}
+	}
+}
@@ -0,0 +1,137 @@
+/*
+ *  File:    NXEmitterDefinition.h
+ *
+ *  author:  张雄(zhang xiong, 1025679612@qq.com)
+ *  date:    2026_10_19
+ *  purpose: data driven particle emitter. a JSON description is compiled once, at load time, into a flat
+ *           Parameters block: plain ranges, the spawn shape as an enum and every curve over lifetime
+ *           sampled into a lookup table. spawning and curve lookups only read that block, there is no
+ *           string or JSON access per particle.
+ *
+ *           the description, every key is optional and keeps the current value, Reset first for the defaults:
+ *           {
+ *               "ResouceType"     : "ParticleEmitter",
+ *               "Shape"           : {"Type" : "Sphere", "Center" : [0, 0, 0], "Radius" : [0.35, 1.5]},
+ *                                   {"Type" : "Box", "Center" : [0, 0, 0], "HalfExtents" : [1, 1, 1]},
+ *                                   {"Type" : "Point", "Center" : [0, 0, 0]},
+ *               "Rate"            : 0,                  particles per second on top of respawns
+ *               "MaxCount"        : 5000,               Rate stops emitting at this count
+ *               "Velocity"        : {"Min" : [-0.3, -0.4, -0.3], "Max" : [0.3, -0.2, 0.3]},
+ *               "Rotation"        : {"Min" : [...], "Max" : [...]},
+ *               "AngularVelocity" : {"Min" : [...], "Max" : [...]},
+ *               "LifeTime"        : [0, 100000],
+ *               "Size"            : [0.005, 0.01],
+ *               "Aspect"          : 1,                  SIZE_Y / SIZE_X
+ *               "Texture"         : [0, 0],             texture index range, clamped to the system's textures
+ *               "Forces"          : {"Gravity" : [0, -9.8, 0], "Wind" : [0, 0, 0], "AngularAcceleration" : [0, 0, 0], "Drag" : 0},
+ *               "Curves"          : {"Size" : [[0, 0], [0.1, 1], [1, 1]], "Alpha" : [[0, 1], [0.8, 1], [1, 0]], "Speed" : [[0, 1], [1, 0.5]]}
+ *           }
+ *           a range is [min, max] or a single value, a curve is [age / life time, value] keys sorted by
+ *           time and linear between them.
+ */
+
+#pragma once
+
+#include <string>
+
+#include "../math/NXVector.h"
+#include "../common/NXType.h"
+
+namespace Json {
+	class Value;
+}
+
+namespace NX {
+	class ParticleStorage;
+	class Random;
+
+	class EmitterDefinition {
+	public:
+		enum SHAPE {
+			SHAPE_POINT,
+			SHAPE_BOX,                   // uniform in Center +- BoxHalfExtents
+			SHAPE_SPHERE,                // uniform in the shell between fInnerRadius and fOuterRadius
+		};
+
+		enum CURVE {
+			CURVE_SIZE,                  // scales SIZE_X and SIZE_Y, applied by BillboardExpander::SetSizeCurve
+			CURVE_ALPHA,                 // the vertex alpha in [0, 1], applied by BillboardExpander::SetAlphaCurve
+			CURVE_SPEED,                 // scales the distance a particle moves each tick, applied by the system's OnTick
+			CURVE_COUNT,
+		};
+
+		enum {
+			CURVE_SAMPLES = 64,          // lookup table intervals, a table has CURVE_SAMPLES + 1 entries
+		};
+
+		struct Parameters {
+			SHAPE       eShape;
+			float3      ShapeCenter;                     // relative to the origin passed to Spawn
+			float3      BoxHalfExtents;
+			float       fInnerRadius;
+			float       fOuterRadius;
+			float       fRate;
+			int         iMaxCount;
+			float3      VelocityMin;
+			float3      VelocityMax;
+			float3      RotationMin;
+			float3      RotationMax;
+			float3      AngularVelocityMin;
+			float3      AngularVelocityMax;
+			float       fLifeTimeMin;
+			float       fLifeTimeMax;
+			float       fSizeMin;
+			float       fSizeMax;
+			float       fAspect;
+			int         iTextureMin;
+			int         iTextureMax;
+			float3      Acceleration;                    // gravity + wind
+			float3      AngularAcceleration;
+			float       fDrag;                           // velocity decays by exp(-fDrag * t)
+			bool        bCurveConstant[CURVE_COUNT];     // every sample is 1, the curve may be skipped
+			float       Curves[CURVE_COUNT][CURVE_SAMPLES + 1];
+		};
+
+	public:
+		EmitterDefinition();
+		virtual ~EmitterDefinition();
+
+	public:
+		/**
+		 *  compile a description on top of the current Parameters, e.g. the ones a system set up in its
+		 *  constructor. on failure the error is logged and the Parameters are left unchanged
+		 */
+		bool  LoadFromFile(const std::string &strFilePath);
+		bool  LoadFromString(const std::string &strJson);
+		bool  Compile(const Json::Value &Root);
+
+		/**
+		 *  back to the defaults: a unit sphere, no forces and constant curves
+		 */
+		void  Reset();
+
+	public:
+		Parameters&        GetParameters();
+		const Parameters&  GetParameters() const;
+
+		/**
+		 *  fLifeRatio is AGE / LIFE_TIME, clamped into [0, 1]
+		 */
+		float  EvaluateCurve(const CURVE eCurve, const float fLifeRatio) const;
+
+		/**
+		 *  overwrite particle i with a fresh one around Origin, all values drawn from random. iTextureCount
+		 *  clamps the texture range.
+		 */
+		void   Spawn(ParticleStorage &Particles, const int i, const float3 &Origin, const int iTextureCount, Random &random) const;
+
+		/**
+		 *  sample keys into a table of CURVE_SAMPLES + 1 values. pKeys holds iKeyCount (time, value) pairs
+		 *  with ascending times, values before the first and after the last key are held.
+		 */
+		static void SampleCurve(const float *pKeys, const int iKeyCount, float *pSamples);
+
+	private:
+		Parameters  m_Parameters;
+	};
+}
@@ -19,15 +19,17 @@ namespace NX {
 	class Particle {
 	public:
 		struct Vertex{
-			Vertex(float _x, float _y, float _z, float _u, float _v) {
+			Vertex(float _x, float _y, float _z, float _u, float _v, NXUInt32 _color = 0xffffffff) {
 				x = _x, y = _y, z = _z;
 				u = _u, v = _v;
+				color = _color;
 			}
 
 			Vertex() = default;
 
 			float x, y, z;     //position
 			float u, v;        //texcoord
+			NXUInt32 color;    //D3DCOLOR, the particle shader multiplies the texture with it
 		};
 
 	public:
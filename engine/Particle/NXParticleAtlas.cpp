@@ -0,0 +1,246 @@
+/*
+ *  File:    NXParticleAtlas.cpp
+ *
+ *  author:  张雄(zhang xiong, 1025679612@qq.com)
+ *  date:    2026_10_19
+ *  purpose: texture atlas of a particle system
+ */
+
+#include <cstdio>
+#include <cstring>
+
+#include "NXParticleAtlas.h"
+#include "../3rdLibs/jsoncpp/json.h"
+#include "../common/NXCore.h"
+#include "../common/NXLog.h"
+#include "../math/NXMath.h"
+
+namespace {
+	bool ReadTextFile(const std::string &strFilePath, std::string &strContent) {
+		FILE *pFile = fopen(strFilePath.c_str(), "rb");
+		if (!pFile) {
+			return false;
+		}
+		char Buffer[4096];
+		for (size_t uRead = 0; (uRead = fread(Buffer, 1, sizeof(Buffer), pFile)) > 0;) {
+			strContent.append(Buffer, uRead);
+		}
+		fclose(pFile);
+		return true;
+	}
+
+	std::string GetDirectory(const std::string &strFilePath) {
+		const size_t uSlash = strFilePath.find_last_of("/\\");
+		return uSlash == std::string::npos ? std::string("") : strFilePath.substr(0, uSlash + 1);
+	}
+
+	/**
+	 *  copy a level 0 image into the atlas texture and let D3DX build the mip chain
+	 */
+	IDirect3DTexture9* CreateAtlasTexture(IDirect3DDevice9 *pDevice, const std::vector<NXUInt32> &Image, const int iWidth, const int iHeight) {
+		IDirect3DTexture9 *pTexture = nullptr;
+		if (FAILED(D3DXCreateTexture(pDevice, iWidth, iHeight, 0, 0, D3DFMT_A8R8G8B8, D3DPOOL_MANAGED, &pTexture))) {
+			return nullptr;
+		}
+		D3DLOCKED_RECT Locked;
+		if (FAILED(pTexture->LockRect(0, &Locked, NULL, 0))) {
+			pTexture->Release();
+			return nullptr;
+		}
+		for (int y = 0; y < iHeight; ++y) {
+			memcpy((char*)Locked.pBits + y * Locked.Pitch, &Image[(size_t)y * iWidth], iWidth * sizeof(NXUInt32));
+		}
+		pTexture->UnlockRect(0);
+		D3DXFilterTexture(pTexture, NULL, 0, D3DX_DEFAULT);
+		return pTexture;
+	}
+}
+
+NX::ParticleAtlas::ParticleAtlas() {
+	m_pTexture = nullptr;
+	m_iWidth   = 0;
+	m_iHeight  = 0;
+}
+
+NX::ParticleAtlas::~ParticleAtlas() {
+	Release();
+}
+
+void NX::ParticleAtlas::Release() {
+	NX::NXSafeRelease(m_pTexture);
+	m_Rects.clear();
+	m_UVRects.clear();
+	m_iWidth  = 0;
+	m_iHeight = 0;
+}
+
+bool NX::ParticleAtlas::Build(IDirect3DDevice9 *pDevice, const std::vector<std::string> &TextureFiles, const int iPadding) {
+	Release();
+	const int iCount = (int)TextureFiles.size();
+	std::vector<IDirect3DTexture9*> Sources(iCount, nullptr);
+	std::vector<AtlasPacker::Rect> Sizes(iCount), Rects;
+	bool bSucceed = true;
+	for (int i = 0; i < iCount && bSucceed; ++i) {
+		//unscaled 32 bit copies the CPU can read
+		if (FAILED(D3DXCreateTextureFromFileEx(pDevice, TextureFiles[i].c_str(), D3DX_DEFAULT_NONPOW2, D3DX_DEFAULT_NONPOW2, 1, 0, D3DFMT_A8R8G8B8, D3DPOOL_SYSTEMMEM, D3DX_FILTER_NONE, D3DX_DEFAULT, 0, NULL, NULL, &Sources[i]))) {
+			glb_GetLog().logToConsole("Build particle atlas failed, can't load texture %s", TextureFiles[i].c_str());
+			bSucceed = false;
+			break;
+		}
+		D3DSURFACE_DESC Desc;
+		Sources[i]->GetLevelDesc(0, &Desc);
+		Sizes[i].x       = 0;
+		Sizes[i].y       = 0;
+		Sizes[i].iWidth  = (int)Desc.Width;
+		Sizes[i].iHeight = (int)Desc.Height;
+	}
+
+	int iWidth = 0, iHeight = 0;
+	if (bSucceed) {
+		D3DCAPS9 Caps;
+		AtlasPacker Packer;
+		Packer.SetPadding(iPadding);
+		if (SUCCEEDED(pDevice->GetDeviceCaps(&Caps))) {
+			Packer.SetMaxSize((int)NXMin(Caps.MaxTextureWidth, Caps.MaxTextureHeight));
+		}
+		bSucceed = Packer.Pack(Sizes, Rects, iWidth, iHeight);
+		if (!bSucceed) {
+			glb_GetLog().logToConsole("Build particle atlas failed, %d textures don't fit the largest texture", iCount);
+		}
+	}
+
+	if (bSucceed) {
+		std::vector<NXUInt32> Image((size_t)iWidth * iHeight, 0);
+		for (int i = 0; i < iCount; ++i) {
+			D3DLOCKED_RECT Locked;
+			if (FAILED(Sources[i]->LockRect(0, &Locked, NULL, D3DLOCK_READONLY))) {
+				bSucceed = false;
+				break;
+			}
+			AtlasPacker::Blit((const NXUInt32*)Locked.pBits, Locked.Pitch / (int)sizeof(NXUInt32), Rects[i], iPadding, &Image[0], iWidth, iHeight);
+			Sources[i]->UnlockRect(0);
+		}
+		m_pTexture = bSucceed ? CreateAtlasTexture(pDevice, Image, iWidth, iHeight) : nullptr;
+		bSucceed = m_pTexture != nullptr;
+		if (!bSucceed) {
+			glb_GetLog().logToConsole("Build particle atlas failed, can't create the %d x %d texture", iWidth, iHeight);
+		}
+	}
+
+	for (int i = 0; i < iCount; ++i) {
+		NX::NXSafeRelease(Sources[i]);
+	}
+	if (bSucceed) {
+		SetRects(Rects, iWidth, iHeight);
+	}
+	return bSucceed;
+}
+
+bool NX::ParticleAtlas::Save(const std::string &strAtlasFilePath, const std::string &strImageFilePath) const {
+	if (!m_pTexture || FAILED(D3DXSaveTextureToFile(strImageFilePath.c_str(), D3DXIFF_PNG, m_pTexture, NULL))) {
+		glb_GetLog().logToConsole("Save particle atlas [file: %s] failed", strImageFilePath.c_str());
+		return false;
+	}
+
+	Json::Value Root;
+	const std::string strDirectory = GetDirectory(strAtlasFilePath);
+	const bool bRelative = !strDirectory.empty() && strImageFilePath.compare(0, strDirectory.size(), strDirectory) == 0;
+	Root["ResouceType"] = "ParticleAtlas";
+	Root["Image"]       = bRelative ? strImageFilePath.substr(strDirectory.size()) : strImageFilePath;
+	Root["Width"]       = m_iWidth;
+	Root["Height"]      = m_iHeight;
+	Json::Value &Rects  = Root["Rects"];
+	Rects = Json::Value(Json::arrayValue);
+	for (size_t i = 0; i < m_Rects.size(); ++i) {
+		Json::Value Rect(Json::arrayValue);
+		Rect.append(m_Rects[i].x);
+		Rect.append(m_Rects[i].y);
+		Rect.append(m_Rects[i].iWidth);
+		Rect.append(m_Rects[i].iHeight);
+		Rects.append(Rect);
+	}
+
+	const std::string strJson = Json::StyledWriter().write(Root);
+	FILE *pFile = fopen(strAtlasFilePath.c_str(), "wb");
+	if (!pFile) {
+		glb_GetLog().logToConsole("Save particle atlas [file: %s] failed", strAtlasFilePath.c_str());
+		return false;
+	}
+	fwrite(strJson.c_str(), 1, strJson.size(), pFile);
+	fclose(pFile);
+	return true;
+}
+
+bool NX::ParticleAtlas::Load(IDirect3DDevice9 *pDevice, const std::string &strAtlasFilePath) {
+	Release();
+	std::string strJson;
+	if (!ReadTextFile(strAtlasFilePath, strJson)) {
+		glb_GetLog().logToConsole("Load particle atlas [file: %s] failed, can't open it", strAtlasFilePath.c_str());
+		return false;
+	}
+
+	//resource files are saved with a UTF-8 BOM
+	const size_t uStart = strJson.compare(0, 3, "\xEF\xBB\xBF") == 0 ? 3 : 0;
+	Json::Value Root;
+	Json::Reader reader;
+	bool bSucceed = reader.parse(strJson.c_str() + uStart, strJson.c_str() + strJson.size(), Root, false) && Root.isObject() &&
+		Root["Image"].isString() && Root["Width"].isIntegral() && Root["Height"].isIntegral() && Root["Rects"].isArray();
+	const int iWidth = bSucceed ? Root["Width"].asInt() : 0, iHeight = bSucceed ? Root["Height"].asInt() : 0;
+	std::vector<AtlasPacker::Rect> Rects(bSucceed ? Root["Rects"].size() : 0);
+	for (Json::ArrayIndex i = 0; i < Rects.size() && bSucceed; ++i) {
+		const Json::Value &Rect = Root["Rects"][i];
+		bSucceed = Rect.isArray() && Rect.size() == 4 && Rect[0].isIntegral() && Rect[1].isIntegral() && Rect[2].isIntegral() && Rect[3].isIntegral();
+		if (bSucceed) {
+			Rects[i].x       = Rect[0].asInt();
+			Rects[i].y       = Rect[1].asInt();
+			Rects[i].iWidth  = Rect[2].asInt();
+			Rects[i].iHeight = Rect[3].asInt();
+			bSucceed = Rects[i].x >= 0 && Rects[i].y >= 0 && Rects[i].x + Rects[i].iWidth <= iWidth && Rects[i].y + Rects[i].iHeight <= iHeight;
+		}
+	}
+	if (!bSucceed) {
+		glb_GetLog().logToConsole("Load particle atlas [file: %s] failed, bad description", strAtlasFilePath.c_str());
+		return false;
+	}
+
+	const std::string strImageFilePath = GetDirectory(strAtlasFilePath) + Root["Image"].asString();
+	D3DXIMAGE_INFO Info;
+	if (FAILED(D3DXCreateTextureFromFileEx(pDevice, strImageFilePath.c_str(), D3DX_DEFAULT_NONPOW2, D3DX_DEFAULT_NONPOW2, D3DX_DEFAULT, 0, D3DFMT_A8R8G8B8, D3DPOOL_MANAGED, D3DX_FILTER_NONE, D3DX_DEFAULT, 0, &Info, NULL, &m_pTexture))) {
+		glb_GetLog().logToConsole("Load particle atlas [file: %s] failed, can't load image %s", strAtlasFilePath.c_str(), strImageFilePath.c_str());
+		return false;
+	}
+	if ((int)Info.Width != iWidth || (int)Info.Height != iHeight) {
+		glb_GetLog().logToConsole("Load particle atlas [file: %s] failed, image is %u x %u", strAtlasFilePath.c_str(), Info.Width, Info.Height);
+		Release();
+		return false;
+	}
+	SetRects(Rects, iWidth, iHeight);
+	return true;
+}
+
+void NX::ParticleAtlas::SetRects(const std::vector<AtlasPacker::Rect> &Rects, const int iWidth, const int iHeight) {
+	m_Rects   = Rects;
+	m_iWidth  = iWidth;
+	m_iHeight = iHeight;
+	AtlasPacker::GetUVRects(m_Rects, m_iWidth, m_iHeight, m_UVRects);
+}
+
+IDirect3DTexture9* NX::ParticleAtlas::GetTexture() const {
+	return m_pTexture;
+}
+
+const float* NX::ParticleAtlas::GetUVRects() const {
+	return m_UVRects.empty() ? nullptr : &m_UVRects[0];
+}
+
+int NX::ParticleAtlas::GetRectCount() const {
+	return (int)m_Rects.size();
+}
+
+int NX::ParticleAtlas::GetWidth() const {
+	return m_iWidth;
+}
+
+int NX::ParticleAtlas::GetHeight() const {
+	return m_iHeight;
+}
@@ -0,0 +1,68 @@
+/*
+ *  File:    NXParticleAtlas.h
+ *
+ *  author:  张雄(zhang xiong, 1025679612@qq.com)
+ *  date:    2026_10_19
+ *  purpose: one texture holding every sprite of a particle system, so particles with different texture
+ *           indexs share a draw call. Build loads the textures, packs them with AtlasPacker and copies
+ *           them into a managed A8R8G8B8 texture with a full mip chain. Save writes the image and an
+ *           .atlas description next to it, Load reads both back so the packing can be done offline.
+ *           the uv rectangle of texture i is GetUVRects()[4i, 4i + 4), for BillboardExpander::SetUVRects.
+ *
+ *           the .atlas description:
+ *           {
+ *               "ResouceType" : "ParticleAtlas",
+ *               "Image"       : "Snow.png",             relative to the .atlas file
+ *               "Width"       : 256,
+ *               "Height"      : 128,
+ *               "Rects"       : [[x, y, width, height], ...]
+ *           }
+ */
+
+#pragma once
+
+#include <d3d9.h>
+#include <d3dx9.h>
+#include <vector>
+#include <string>
+
+#include "NXAtlasPacker.h"
+
+namespace NX {
+	class ParticleAtlas {
+	public:
+		ParticleAtlas();
+		virtual ~ParticleAtlas();
+
+	private:
+		ParticleAtlas(const ParticleAtlas&);
+		ParticleAtlas& operator = (const ParticleAtlas&);
+
+	public:
+		/**
+		 *  pack TextureFiles in this order, texture index i of a particle is TextureFiles[i]. on failure the
+		 *  error is logged and the atlas is empty.
+		 */
+		bool  Build(IDirect3DDevice9 *pDevice, const std::vector<std::string> &TextureFiles, const int iPadding = 2);
+		bool  Save(const std::string &strAtlasFilePath, const std::string &strImageFilePath) const;
+		bool  Load(IDirect3DDevice9 *pDevice, const std::string &strAtlasFilePath);
+		void  Release();
+
+	public:
+		IDirect3DTexture9*  GetTexture() const;
+		const float*        GetUVRects() const;              // u0 v0 u1 v1 per texture, nullptr when empty
+		int                 GetRectCount() const;
+		int                 GetWidth() const;
+		int                 GetHeight() const;
+
+	private:
+		void  SetRects(const std::vector<AtlasPacker::Rect> &Rects, const int iWidth, const int iHeight);
+
+	private:
+		IDirect3DTexture9               *m_pTexture;
+		std::vector<AtlasPacker::Rect>  m_Rects;
+		std::vector<float>              m_UVRects;
+		int                             m_iWidth;
+		int                             m_iHeight;
+	};
+}
@@ -0,0 +1,365 @@
+/*
+ *  File:    NXParticleCollider.cpp
+ *
+ *  author:  张雄(zhang xiong, 1025679612@qq.com)
+ *  date:    2026_10_19
+ *  purpose: collision of particles with terrain and simple primitives
+ */
+
+#include <cmath>
+
+#include "NXParticleCollider.h"
+#include "../entity/NXTerrain.h"
+#include "../entity/NXHeightField.h"
+#include "../common/NXCore.h"
+#include "../math/NXMath.h"
+#include "../math/NXSIMD.h"
+
+namespace {
+	struct Streams {
+		float        *px, *py, *pz;
+		float        *pvx, *pvy, *pvz;
+		float        *pwx, *pwy, *pwz;
+		float        *pAge;
+		const float  *pLifeTime;
+	};
+
+	struct Response {
+		NX::ParticleCollider::RESPONSE eResponse;
+		float        fRestitution;
+		float        fFriction;
+	};
+
+	/**
+	 *  Normal points out of the collider, Offset moves the particle onto its surface
+	 */
+	void Resolve(const Streams &s, const int i, const NX::float3 &Normal, const NX::float3 &Offset, const Response &r, NXUInt8 *pDeadMask) {
+		if (r.eResponse == NX::ParticleCollider::RESPONSE_KILL) {
+			s.pAge[i] = NX::NXMax(s.pAge[i], s.pLifeTime[i]);
+			if (pDeadMask) {
+				pDeadMask[i / NX::ParticleStorage::DEAD_MASK_GROUP] |= (NXUInt8)(1 << (i % NX::ParticleStorage::DEAD_MASK_GROUP));
+			}
+			return;
+		}
+
+		s.px[i] += Offset.x;
+		s.py[i] += Offset.y;
+		s.pz[i] += Offset.z;
+		if (r.eResponse == NX::ParticleCollider::RESPONSE_STICK) {
+			s.pvx[i] = s.pvy[i] = s.pvz[i] = 0.f;
+			s.pwx[i] = s.pwy[i] = s.pwz[i] = 0.f;
+			return;
+		}
+
+		//v = tangent * (1 - friction) - normal * restitution, only while moving into the surface
+		const float fNormalSpeed = s.pvx[i] * Normal.x + s.pvy[i] * Normal.y + s.pvz[i] * Normal.z;
+		if (fNormalSpeed < 0.f) {
+			const float fTangent = 1.f - r.fFriction;
+			const float fNormal  = -fNormalSpeed * (fTangent + r.fRestitution);
+			s.pvx[i] = s.pvx[i] * fTangent + Normal.x * fNormal;
+			s.pvy[i] = s.pvy[i] * fTangent + Normal.y * fNormal;
+			s.pvz[i] = s.pvz[i] * fTangent + Normal.z * fNormal;
+		}
+	}
+
+	struct PlaneTest {
+		float        nx, ny, nz, d;
+
+		bool Inside(const float x, const float y, const float z) const {
+			return nx * x + ny * y + nz * z + d < 0.f;
+		}
+
+		float Contact(const float x, const float y, const float z, NX::float3 &Normal) const {
+			Normal.Set(nx, ny, nz);
+			return -(nx * x + ny * y + nz * z + d);
+		}
+
+#if NX_SIMD_SSE
+		__m128 Inside(const __m128 x, const __m128 y, const __m128 z) const {//same order of operations as the scalar test
+			const __m128 Distance = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(nx), x), _mm_mul_ps(_mm_set1_ps(ny), y)), _mm_mul_ps(_mm_set1_ps(nz), z)), _mm_set1_ps(d));
+			return _mm_cmplt_ps(Distance, _mm_setzero_ps());
+		}
+#endif
+	};
+
+	struct SphereTest {
+		float        cx, cy, cz, r, r2;
+
+		bool Inside(const float x, const float y, const float z) const {
+			const float dx = x - cx, dy = y - cy, dz = z - cz;
+			return dx * dx + dy * dy + dz * dz < r2;
+		}
+
+		float Contact(const float x, const float y, const float z, NX::float3 &Normal) const {
+			const float dx = x - cx, dy = y - cy, dz = z - cz;
+			const float fLength = std::sqrt(dx * dx + dy * dy + dz * dz);
+			if (fLength <= 0.f) {//the center itself, leave upwards
+				Normal.Set(0.f, 1.f, 0.f);
+				return r;
+			}
+			const float fInvLength = 1.f / fLength;
+			Normal.Set(dx * fInvLength, dy * fInvLength, dz * fInvLength);
+			return r - fLength;
+		}
+
+#if NX_SIMD_SSE
+		__m128 Inside(const __m128 x, const __m128 y, const __m128 z) const {
+			const __m128 dx = _mm_sub_ps(x, _mm_set1_ps(cx)), dy = _mm_sub_ps(y, _mm_set1_ps(cy)), dz = _mm_sub_ps(z, _mm_set1_ps(cz));
+			const __m128 Distance2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+			return _mm_cmplt_ps(Distance2, _mm_set1_ps(r2));
+		}
+#endif
+	};
+
+	struct BoxTest {
+		float        x0, y0, z0, x1, y1, z1;
+
+		bool Inside(const float x, const float y, const float z) const {
+			return x > x0 && x < x1 && y > y0 && y < y1 && z > z0 && z < z1;
+		}
+
+		float Contact(const float x, const float y, const float z, NX::float3 &Normal) const {//out through the nearest face, the top one wins ties
+			const float Depths[6] = { y1 - y, y - y0, x1 - x, x - x0, z1 - z, z - z0 };
+			int iFace = 0;
+			for (int k = 1; k < 6; ++k) {
+				if (Depths[k] < Depths[iFace]) {
+					iFace = k;
+				}
+			}
+			const float fSign = (iFace & 1) ? -1.f : 1.f;
+			Normal.Set(iFace / 2 == 1 ? fSign : 0.f, iFace / 2 == 0 ? fSign : 0.f, iFace / 2 == 2 ? fSign : 0.f);
+			return Depths[iFace];
+		}
+
+#if NX_SIMD_SSE
+		__m128 Inside(const __m128 x, const __m128 y, const __m128 z) const {
+			const __m128 InX = _mm_and_ps(_mm_cmpgt_ps(x, _mm_set1_ps(x0)), _mm_cmplt_ps(x, _mm_set1_ps(x1)));
+			const __m128 InY = _mm_and_ps(_mm_cmpgt_ps(y, _mm_set1_ps(y0)), _mm_cmplt_ps(y, _mm_set1_ps(y1)));
+			const __m128 InZ = _mm_and_ps(_mm_cmpgt_ps(z, _mm_set1_ps(z0)), _mm_cmplt_ps(z, _mm_set1_ps(z1)));
+			return _mm_and_ps(_mm_and_ps(InX, InY), InZ);
+		}
+#endif
+	};
+
+	/**
+	 *  indices of the particles in [iBegin, iEnd) inside the collider, iBegin is a multiple of 4
+	 */
+	template<typename TEST>
+	int Detect(const Streams &s, const int iBegin, const int iEnd, const TEST &Test, int *pContacts) {
+		int iContactCount = 0;
+#if NX_SIMD_SSE
+		//the last group may run into the padding, those lanes are masked out
+		for (int i = iBegin; i < iEnd; i += 4) {
+			int iBits = _mm_movemask_ps(Test.Inside(_mm_load_ps(s.px + i), _mm_load_ps(s.py + i), _mm_load_ps(s.pz + i)));
+			iBits &= 0xF >> NX::NXMax(0, i + 4 - iEnd);
+			for (int k = 0; iBits; ++k, iBits >>= 1) {
+				if (iBits & 1) {
+					pContacts[iContactCount++] = i + k;
+				}
+			}
+		}
+#else
+		for (int i = iBegin; i < iEnd; ++i) {
+			if (Test.Inside(s.px[i], s.py[i], s.pz[i])) {
+				pContacts[iContactCount++] = i;
+			}
+		}
+#endif
+		return iContactCount;
+	}
+
+	template<typename TEST>
+	int CollideBlock(const Streams &s, const int iBegin, const int iEnd, const TEST &Test, const Response &r, int *pContacts, NXUInt8 *pDeadMask) {
+		const int iContactCount = Detect(s, iBegin, iEnd, Test, pContacts);
+		for (int j = 0; j < iContactCount; ++j) {
+			const int i = pContacts[j];
+			NX::float3 Normal;
+			const float fDepth = Test.Contact(s.px[i], s.py[i], s.pz[i], Normal);
+			Resolve(s, i, Normal, Normal * fDepth, r, pDeadMask);
+		}
+		return iContactCount;
+	}
+
+	/**
+	 *  particles below the surface inside the field's x/z range are lifted straight onto it. the normal of
+	 *  every contact comes from two more batched queries a quarter cell away, towards the inside of the field.
+	 */
+	int CollideHeightField(const Streams &s, const int iBegin, const int iEnd, const NX::HeightField &Field, const Response &r, int *pContacts, NXUInt8 *pDeadMask) {
+		const int iCount = iEnd - iBegin;
+		const float fMaxX = Field.GetMaxX(), fMaxZ = Field.GetMaxZ();
+		NX_ALIGN(16) float Heights[NX::ParticleCollider::BLOCK_SIZE];
+		Field.GetHeights(s.px + iBegin, s.pz + iBegin, Heights, iCount);
+
+		int iContactCount = 0;
+#if NX_SIMD_SSE
+		const __m128 MaxX = _mm_set1_ps(fMaxX), MaxZ = _mm_set1_ps(fMaxZ), Zero = _mm_setzero_ps();
+		for (int k = 0; k < iCount; k += 4) {
+			const int i = iBegin + k;
+			const __m128 x = _mm_load_ps(s.px + i), y = _mm_load_ps(s.py + i), z = _mm_load_ps(s.pz + i);
+			const __m128 InX = _mm_and_ps(_mm_cmpge_ps(x, Zero), _mm_cmple_ps(x, MaxX));
+			const __m128 InZ = _mm_and_ps(_mm_cmpge_ps(z, Zero), _mm_cmple_ps(z, MaxZ));
+			int iBits = _mm_movemask_ps(_mm_and_ps(_mm_and_ps(InX, InZ), _mm_cmplt_ps(y, _mm_load_ps(Heights + k))));
+			iBits &= 0xF >> NX::NXMax(0, k + 4 - iCount);
+			for (int l = 0; iBits; ++l, iBits >>= 1) {
+				if (iBits & 1) {
+					pContacts[iContactCount++] = i + l;
+				}
+			}
+		}
+#else
+		for (int i = iBegin; i < iEnd; ++i) {
+			if (s.px[i] >= 0.f && s.px[i] <= fMaxX && s.pz[i] >= 0.f && s.pz[i] <= fMaxZ && s.py[i] < Heights[i - iBegin]) {
+				pContacts[iContactCount++] = i;
+			}
+		}
+#endif
+		if (iContactCount == 0) {
+			return 0;
+		}
+
+		NX_ALIGN(16) float Xs[NX::ParticleCollider::BLOCK_SIZE], Zs[NX::ParticleCollider::BLOCK_SIZE];
+		NX_ALIGN(16) float StepXs[NX::ParticleCollider::BLOCK_SIZE], StepZs[NX::ParticleCollider::BLOCK_SIZE];
+		NX_ALIGN(16) float HeightXs[NX::ParticleCollider::BLOCK_SIZE], HeightZs[NX::ParticleCollider::BLOCK_SIZE];
+		const float fStep = 0.25f * NX::NXMin(Field.GetDX(), Field.GetDZ());
+		for (int j = 0; j < iContactCount; ++j) {
+			const int i = pContacts[j];
+			Xs[j] = s.px[i];
+			Zs[j] = s.pz[i];
+			StepXs[j] = Xs[j] + fStep <= fMaxX ? Xs[j] + fStep : Xs[j] - fStep;
+			StepZs[j] = Zs[j] + fStep <= fMaxZ ? Zs[j] + fStep : Zs[j] - fStep;
+		}
+		Field.GetHeights(StepXs, Zs, HeightXs, iContactCount);
+		Field.GetHeights(Xs, StepZs, HeightZs, iContactCount);
+
+		for (int j = 0; j < iContactCount; ++j) {
+			const int i = pContacts[j];
+			const float h  = Heights[i - iBegin];
+			const float gx = (HeightXs[j] - h) / (StepXs[j] - Xs[j]);
+			const float gz = (HeightZs[j] - h) / (StepZs[j] - Zs[j]);
+			const float fInvLength = 1.f / std::sqrt(gx * gx + 1.f + gz * gz);
+			const NX::float3 Normal(-gx * fInvLength, fInvLength, -gz * fInvLength);
+			Resolve(s, i, Normal, NX::float3(0.f, h - s.py[i], 0.f), r, pDeadMask);
+		}
+		return iContactCount;
+	}
+}
+
+NX::ParticleCollider::ParticleCollider() {
+	m_pHeightField         = nullptr;
+	m_eHeightFieldResponse = RESPONSE_KILL;
+	m_fRestitution         = 0.3f;
+	m_fFriction            = 0.2f;
+}
+
+NX::ParticleCollider::~ParticleCollider() {
+	/**empty here*/
+}
+
+NX::ParticleCollider& NX::ParticleCollider::SetTerrain(const Terrain *pTerrain, const RESPONSE eResponse) {
+	return SetHeightField(pTerrain ? &pTerrain->GetHeightField() : nullptr, eResponse);
+}
+
+NX::ParticleCollider& NX::ParticleCollider::SetHeightField(const HeightField *pHeightField, const RESPONSE eResponse) {
+	m_pHeightField         = pHeightField;
+	m_eHeightFieldResponse = eResponse;
+	return *this;
+}
+
+NX::ParticleCollider& NX::ParticleCollider::AddPlane(const Plane &plane, const RESPONSE eResponse) {
+	const float fInvLength = 1.f / NX::Length(plane.GetNormal());
+	PlaneCollider Collider;
+	Collider.nx        = plane.GetNormal().x * fInvLength;
+	Collider.ny        = plane.GetNormal().y * fInvLength;
+	Collider.nz        = plane.GetNormal().z * fInvLength;
+	Collider.d         = plane.GetDistFromOriginal() * fInvLength;
+	Collider.eResponse = eResponse;
+	m_Planes.push_back(Collider);
+	return *this;
+}
+
+NX::ParticleCollider& NX::ParticleCollider::AddSphere(const Sphere &sphere, const RESPONSE eResponse) {
+	NXAssert(sphere.GetRadius() >= 0.f);
+	SphereCollider Collider;
+	Collider.Center    = sphere.GetCenter();
+	Collider.fRadius   = sphere.GetRadius();
+	Collider.eResponse = eResponse;
+	m_Spheres.push_back(Collider);
+	return *this;
+}
+
+NX::ParticleCollider& NX::ParticleCollider::AddAABB(const AABB &aabb, const RESPONSE eResponse) {
+	BoxCollider Collider;
+	Collider.MinPoint  = aabb.GetMinPoint();
+	Collider.MaxPoint  = aabb.GetMaxPoint();
+	Collider.eResponse = eResponse;
+	m_Boxes.push_back(Collider);
+	return *this;
+}
+
+NX::ParticleCollider& NX::ParticleCollider::SetRestitution(const float fRestitution) {
+	NXAssert(fRestitution >= 0.f);
+	m_fRestitution = fRestitution;
+	return *this;
+}
+
+NX::ParticleCollider& NX::ParticleCollider::SetFriction(const float fFriction) {
+	NXAssert(fFriction >= 0.f && fFriction <= 1.f);
+	m_fFriction = fFriction;
+	return *this;
+}
+
+void NX::ParticleCollider::Clear() {
+	m_pHeightField = nullptr;
+	m_Planes.clear();
+	m_Spheres.clear();
+	m_Boxes.clear();
+}
+
+bool NX::ParticleCollider::IsEmpty() const {
+	return !m_pHeightField && m_Planes.empty() && m_Spheres.empty() && m_Boxes.empty();
+}
+
+int NX::ParticleCollider::Collide(ParticleStorage &Particles, NXUInt8 *pDeadMask) const {
+	return Collide(Particles, 0, Particles.GetCount(), pDeadMask);
+}
+
+int NX::ParticleCollider::Collide(ParticleStorage &Particles, const int iBegin, const int iEnd, NXUInt8 *pDeadMask) const {
+	NXAssert(iBegin >= 0 && iBegin <= iEnd && iEnd <= Particles.GetCount());
+	NXAssert(iBegin % ParticleStorage::DEAD_MASK_GROUP == 0);
+	const Streams s = {
+		Particles.GetStream(ParticleStorage::POSITION_X),         Particles.GetStream(ParticleStorage::POSITION_Y),         Particles.GetStream(ParticleStorage::POSITION_Z),
+		Particles.GetStream(ParticleStorage::VELOCITY_X),         Particles.GetStream(ParticleStorage::VELOCITY_Y),         Particles.GetStream(ParticleStorage::VELOCITY_Z),
+		Particles.GetStream(ParticleStorage::ANGULAR_VELOCITY_X), Particles.GetStream(ParticleStorage::ANGULAR_VELOCITY_Y), Particles.GetStream(ParticleStorage::ANGULAR_VELOCITY_Z),
+		Particles.GetStream(ParticleStorage::AGE),                Particles.GetStream(ParticleStorage::LIFE_TIME),
+	};
+
+	//every collider runs over one block while its positions are still in the cache
+	int Contacts[BLOCK_SIZE];
+	int iContactCount = 0;
+	for (int iBlock = iBegin; iBlock < iEnd; iBlock += BLOCK_SIZE) {
+		const int iBlockEnd = NXMin(iBlock + (int)BLOCK_SIZE, iEnd);
+		if (m_pHeightField) {
+			const Response r = { m_eHeightFieldResponse, m_fRestitution, m_fFriction };
+			iContactCount += CollideHeightField(s, iBlock, iBlockEnd, *m_pHeightField, r, Contacts, pDeadMask);
+		}
+		for (size_t k = 0; k < m_Planes.size(); ++k) {
+			const PlaneCollider &c = m_Planes[k];
+			const PlaneTest Test = { c.nx, c.ny, c.nz, c.d };
+			const Response r = { c.eResponse, m_fRestitution, m_fFriction };
+			iContactCount += CollideBlock(s, iBlock, iBlockEnd, Test, r, Contacts, pDeadMask);
+		}
+		for (size_t k = 0; k < m_Spheres.size(); ++k) {
+			const SphereCollider &c = m_Spheres[k];
+			const SphereTest Test = { c.Center.x, c.Center.y, c.Center.z, c.fRadius, c.fRadius * c.fRadius };
+			const Response r = { c.eResponse, m_fRestitution, m_fFriction };
+			iContactCount += CollideBlock(s, iBlock, iBlockEnd, Test, r, Contacts, pDeadMask);
+		}
+		for (size_t k = 0; k < m_Boxes.size(); ++k) {
+			const BoxCollider &c = m_Boxes[k];
+			const BoxTest Test = { c.MinPoint.x, c.MinPoint.y, c.MinPoint.z, c.MaxPoint.x, c.MaxPoint.y, c.MaxPoint.z };
+			const Response r = { c.eResponse, m_fRestitution, m_fFriction };
+			iContactCount += CollideBlock(s, iBlock, iBlockEnd, Test, r, Contacts, pDeadMask);
+		}
+	}
+	return iContactCount;
+}
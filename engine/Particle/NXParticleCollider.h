@@ -0,0 +1,99 @@
+/*
+ *  File:    NXParticleCollider.h
+ *
+ *  author:  张雄(zhang xiong, 1025679612@qq.com)
+ *  date:    2026_10_19
+ *  purpose: collision of particle positions with a terrain height field and lists of planes, spheres and
+ *           boxes. particles are points, the detection runs over the position streams four at a time and
+ *           only the particles found inside a collider are resolved one by one, so a frame without
+ *           contacts costs a few compares per particle and collider. terrain heights are fetched with the
+ *           batched HeightField::GetHeights, BLOCK_SIZE particles per call.
+ *
+ *           planes keep particles on the side their normal points to, spheres and boxes are solid and
+ *           push particles out through the nearest surface. the height field is in terrain space, which is
+ *           the particles' space as long as the terrain is not transformed.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "NXParticleStorage.h"
+#include "../math/NXPlane.h"
+#include "../math/NXSphere.h"
+#include "../math/NXAABB.h"
+#include "../common/NXType.h"
+
+namespace NX {
+	class Terrain;
+	class HeightField;
+
+	class ParticleCollider {
+	public:
+		enum RESPONSE {
+			RESPONSE_BOUNCE,             // pushed out, the normal velocity reflected by the restitution, the tangential one damped by the friction
+			RESPONSE_STICK,              // pushed out, velocity and angular velocity cleared
+			RESPONSE_KILL,               // AGE is raised to LIFE_TIME and the particle joins the death mask
+		};
+
+		enum {
+			BLOCK_SIZE = 256,            // particles per batch of terrain height queries, kept on the stack
+		};
+
+	public:
+		ParticleCollider();
+		virtual ~ParticleCollider();
+
+	public:
+		/**
+		 *  the terrain's height field is referenced, not copied, so later sculpting is seen by the next
+		 *  Collide. nullptr removes the terrain.
+		 */
+		ParticleCollider& SetTerrain(const Terrain *pTerrain, const RESPONSE eResponse);
+		ParticleCollider& SetHeightField(const HeightField *pHeightField, const RESPONSE eResponse);
+		ParticleCollider& AddPlane(const Plane &plane, const RESPONSE eResponse);
+		ParticleCollider& AddSphere(const Sphere &sphere, const RESPONSE eResponse);
+		ParticleCollider& AddAABB(const AABB &aabb, const RESPONSE eResponse);
+		ParticleCollider& SetRestitution(const float fRestitution);    // normal speed kept by a bounce, default 0.3
+		ParticleCollider& SetFriction(const float fFriction);          // tangential speed lost by a bounce, default 0.2
+		void              Clear();
+		bool              IsEmpty() const;
+
+	public:
+		/**
+		 *  resolve particles [iBegin, iEnd) against the terrain, then every plane, sphere and box in the order
+		 *  they were added. the range follows ParticleStorage::Integrate, so workers may collide their own
+		 *  ranges of one storage. killed particles get their bit in pDeadMask set, the other bits are left
+		 *  as they are. returns the number of contacts.
+		 */
+		int   Collide(ParticleStorage &Particles, const int iBegin, const int iEnd, NXUInt8 *pDeadMask = nullptr) const;
+		int   Collide(ParticleStorage &Particles, NXUInt8 *pDeadMask = nullptr) const;
+
+	private:
+		struct PlaneCollider {
+			float       nx, ny, nz, d;   // unit normal, n . p + d < 0 is inside
+			RESPONSE    eResponse;
+		};
+
+		struct SphereCollider {
+			float3      Center;
+			float       fRadius;
+			RESPONSE    eResponse;
+		};
+
+		struct BoxCollider {
+			float3      MinPoint;
+			float3      MaxPoint;
+			RESPONSE    eResponse;
+		};
+
+	private:
+		const HeightField                *m_pHeightField;
+		RESPONSE                         m_eHeightFieldResponse;
+		std::vector<PlaneCollider>       m_Planes;
+		std::vector<SphereCollider>      m_Spheres;
+		std::vector<BoxCollider>         m_Boxes;
+		float                            m_fRestitution;
+		float                            m_fFriction;
+	};
+}
@@ -0,0 +1,284 @@
+/*
+ *  File:    NXParticleDepthSort.cpp
+ *
+ *  author:  张雄(zhang xiong, 1025679612@qq.com)
+ *  date:    2026_10_19
+ *  purpose: back to front particle sort
+ */
+
+#include <cstring>
+
+#include "NXParticleDepthSort.h"
+#include "NXParticleStorage.h"
+#include "../common/NXCore.h"
+#include "../common/NXParallel.h"
+#include "../math/NXMath.h"
+#include "../math/NXAlgorithm.h"
+
+namespace {
+	const NXUInt32 DEAD_KEY = 0xFFFFFFFFu;
+
+	inline bool IsLive(const NXUInt8 *pDeadMask, const float *pAge, const float *pLifeTime, const int i) {
+		if (pDeadMask) {
+			return !((pDeadMask[i / NX::ParticleStorage::DEAD_MASK_GROUP] >> (i % NX::ParticleStorage::DEAD_MASK_GROUP)) & 1);
+		}
+		return pAge[i] < pLifeTime[i];
+	}
+}
+
+NX::ParticleDepthSort::ParticleDepthSort() {
+	m_iWorkerCount       = 1;
+	m_fMaxInsertionMoves = 1.f;
+}
+
+NX::ParticleDepthSort::~ParticleDepthSort() {
+	/**empty here*/
+}
+
+NX::ParticleDepthSort& NX::ParticleDepthSort::SetWorkerCount(const int iWorkerCount) {
+	m_iWorkerCount = iWorkerCount;
+	return *this;
+}
+
+NX::ParticleDepthSort& NX::ParticleDepthSort::SetMaxInsertionMoves(const float fMaxInsertionMoves) {
+	m_fMaxInsertionMoves = NXMax(fMaxInsertionMoves, 0.f);
+	return *this;
+}
+
+int NX::ParticleDepthSort::GetWorkerCount() const {
+	return m_iWorkerCount;
+}
+
+void NX::ParticleDepthSort::Reset() {
+	m_Order.clear();
+}
+
+const NXUInt32* NX::ParticleDepthSort::GetOrder() const {
+	return m_Order.empty() ? nullptr : &m_Order[0];
+}
+
+int NX::ParticleDepthSort::GetOrderCount() const {
+	return (int)m_Order.size();
+}
+
+NXUInt32 NX::ParticleDepthSort::GetSortKey(const float fValue) {
+	NXUInt32 uBits;
+	memcpy(&uBits, &fValue, sizeof(uBits));
+	return (uBits & 0x80000000u) ? ~uBits : (uBits | 0x80000000u);
+}
+
+int NX::ParticleDepthSort::Sort(const ParticleStorage &Particles, const NXUInt8 *pDeadMask, const float3 &Eye, const float3 &Front, Statistics *pStatistics) {
+	const int iCount = Particles.GetCount();
+	int iPartCount = m_iWorkerCount > 0 ? m_iWorkerCount : GetHardwareThreadCount();
+	iPartCount = NXMax(1, NXMin(iPartCount, iCount / (int)MIN_PART_SIZE));
+
+	const int iLiveCount = ComputeKeys(Particles, pDeadMask, Eye, Front, iPartCount);
+	const int iMaxMoves  = (int)NXMin(m_fMaxInsertionMoves * iLiveCount, 2e9f);
+	const int iDescents  = (m_fMaxInsertionMoves > 0.f && (int)m_Order.size() == iLiveCount) ? ReuseOrder(iPartCount) : -1;
+
+	int iMoves = 0, iPasses = 0;
+	const bool bIncremental = iDescents >= 0 && iDescents <= iMaxMoves / INSERTION_DESCENT_RATIO && InsertionSort(iMaxMoves, iMoves);
+	if (!bIncremental) {//from storage order, so equal keys end up by index like the insertion sort leaves them
+		GatherEntries(iPartCount);
+		iPasses = RadixSort(iPartCount);
+	}
+	ExtractOrder(iPartCount);
+
+	if (pStatistics) {
+		pStatistics->iLiveCount      = iLiveCount;
+		pStatistics->iDescents       = iDescents;
+		pStatistics->bIncremental    = bIncremental;
+		pStatistics->iInsertionMoves = iMoves;
+		pStatistics->iRadixPasses    = iPasses;
+	}
+	return iLiveCount;
+}
+
+int NX::ParticleDepthSort::ComputeKeys(const ParticleStorage &Particles, const NXUInt8 *pDeadMask, const float3 &Eye, const float3 &Front, const int iPartCount) {
+	//returns the live count, m_PartCounts holds the live count of every range
+	const int   iCount     = Particles.GetCount();
+	const float *px        = Particles.GetStream(ParticleStorage::POSITION_X);
+	const float *py        = Particles.GetStream(ParticleStorage::POSITION_Y);
+	const float *pz        = Particles.GetStream(ParticleStorage::POSITION_Z);
+	const float *pAge      = Particles.GetStream(ParticleStorage::AGE);
+	const float *pLifeTime = Particles.GetStream(ParticleStorage::LIFE_TIME);
+	m_ParticleKeys.resize(iCount);
+	m_PartCounts.assign(iPartCount, 0);
+	ParallelFor(0, iCount, iPartCount, [&](const int iBegin, const int iEnd, const int iPart) {
+		int iLive = 0;
+		for (int i = iBegin; i < iEnd; ++i) {
+			const float fDepth = (px[i] - Eye.x) * Front.x + (py[i] - Eye.y) * Front.y + (pz[i] - Eye.z) * Front.z;
+			const bool  bLive  = IsLive(pDeadMask, pAge, pLifeTime, i);
+			m_ParticleKeys[i] = bLive ? NXMin(GetSortKey(-fDepth), DEAD_KEY - 1) : DEAD_KEY;//farthest first, only a NaN depth is clamped
+			iLive += bLive;
+		}
+		m_PartCounts[iPart] = iLive;
+	});
+
+	int iLiveCount = 0;
+	for (int p = 0; p < iPartCount; ++p) {
+		iLiveCount += m_PartCounts[p];
+	}
+	return iLiveCount;
+}
+
+int NX::ParticleDepthSort::ReuseOrder(const int iPartCount) {
+	//the previous order holds distinct indexs, if it has as many as there are live particles and each is
+	//still live it is exactly the live set. returns the neighbours out of order, each costs the insertion
+	//sort at least one move, or -1 when the order can't be reused
+	const int iCount = (int)m_ParticleKeys.size();
+	const int iSize  = (int)m_Order.size();
+	if (!iSize) {
+		return -1;
+	}
+	m_PartDescents.assign(iPartCount, 0);
+	m_Entries.resize(iSize);
+	ParallelFor(0, iSize, iPartCount, [&](const int iBegin, const int iEnd, const int iPart) {
+		int iDescents = 0, iInvalid = 0;
+		NXUInt64 uPrevious = 0;
+		for (int k = iBegin; k < iEnd; ++k) {
+			const NXUInt32 i = m_Order[k];
+			const NXUInt32 uKey = i < (NXUInt32)iCount ? m_ParticleKeys[i] : DEAD_KEY;
+			const NXUInt64 uEntry = ((NXUInt64)uKey << 32) | i;
+			iInvalid  += uKey == DEAD_KEY;
+			iDescents += k > iBegin && uPrevious > uEntry;
+			m_Entries[k] = uPrevious = uEntry;
+		}
+		m_PartDescents[iPart] = iInvalid ? -1 : iDescents;
+	});
+
+	int iDescents = 0;
+	for (int p = 0; p < iPartCount; ++p) {
+		if (m_PartDescents[p] < 0) {
+			return -1;
+		}
+		int iBegin, iEnd;
+		GetParallelRange(0, iSize, iPartCount, p, 1, iBegin, iEnd);
+		iDescents += m_PartDescents[p] + (iBegin > 0 && iBegin < iEnd && m_Entries[iBegin - 1] > m_Entries[iBegin]);
+	}
+	return iDescents;
+}
+
+void NX::ParticleDepthSort::GatherEntries(const int iPartCount) {
+	//the live particles in storage order, m_PartCounts still holds the live count of every range
+	const int iCount = (int)m_ParticleKeys.size();
+	int iLiveCount = 0;
+	for (int p = 0; p < iPartCount; ++p) {
+		const int iLive = m_PartCounts[p];
+		m_PartCounts[p] = iLiveCount;
+		iLiveCount += iLive;
+	}
+	m_Entries.resize(iLiveCount);
+	ParallelFor(0, iCount, iPartCount, [&](const int iBegin, const int iEnd, const int iPart) {
+		NXUInt64 *pOut = m_Entries.empty() ? nullptr : &m_Entries[0] + m_PartCounts[iPart];
+		for (int i = iBegin; i < iEnd; ++i) {
+			const NXUInt32 uKey = m_ParticleKeys[i];
+			if (uKey != DEAD_KEY) {
+				*pOut++ = ((NXUInt64)uKey << 32) | (NXUInt32)i;
+			}
+		}
+	});
+}
+
+bool NX::ParticleDepthSort::InsertionSort(const int iMaxMoves, int &iMoves) {
+	const int iSize = (int)m_Entries.size();
+	NXUInt64 *pEntries = iSize ? &m_Entries[0] : nullptr;
+	//entries are unique, comparing the whole entry orders equal keys by index
+	iMoves = 0;
+	for (int i = 1; i < iSize; ++i) {
+		const NXUInt64 uEntry = pEntries[i];
+		if (pEntries[i - 1] < uEntry) {
+			continue;
+		}
+		int j = i;
+		while (j > 0 && pEntries[j - 1] > uEntry) {
+			pEntries[j] = pEntries[j - 1];
+			--j;
+			++iMoves;
+		}
+		pEntries[j] = uEntry;
+		if (iMoves > iMaxMoves) {
+			return false;
+		}
+	}
+	return true;
+}
+
+int NX::ParticleDepthSort::RadixSort(const int iPartCount) {
+	const int iSize = (int)m_Entries.size();
+	if (iSize < 2) {
+		return 0;
+	}
+	m_Scratch.resize(iSize);
+	m_Histograms.resize(iPartCount * RADIX_PASSES * RADIX_SIZE);
+
+	{//one read builds the histograms of every pass
+		ParallelFor(0, iSize, iPartCount, [&](const int iBegin, const int iEnd, const int iPart) {
+			int *pHistograms = &m_Histograms[iPart * RADIX_PASSES * RADIX_SIZE];
+			memset(pHistograms, 0, sizeof(int) * RADIX_PASSES * RADIX_SIZE);
+			for (int k = iBegin; k < iEnd; ++k) {
+				const NXUInt32 uKey = (NXUInt32)(m_Entries[k] >> 32);
+				for (int iPass = 0; iPass < RADIX_PASSES; ++iPass) {
+					++pHistograms[iPass * RADIX_SIZE + ((uKey >> (iPass * RADIX_BITS)) & (RADIX_SIZE - 1))];
+				}
+			}
+		});
+	}
+
+	int iPasses = 0;
+	for (int iPass = 0; iPass < RADIX_PASSES; ++iPass) {
+		const int iShift = 32 + iPass * RADIX_BITS;
+		//a scatter moves entries between ranges, so with several ranges the counts of the later passes
+		//are stale after it and are recounted. a single range always holds every entry.
+		if (iPasses && iPartCount > 1) {
+			ParallelFor(0, iSize, iPartCount, [&](const int iBegin, const int iEnd, const int iPart) {
+				int *pHistogram = &m_Histograms[(iPart * RADIX_PASSES + iPass) * RADIX_SIZE];
+				memset(pHistogram, 0, sizeof(int) * RADIX_SIZE);
+				for (int k = iBegin; k < iEnd; ++k) {
+					++pHistogram[(m_Entries[k] >> iShift) & (RADIX_SIZE - 1)];
+				}
+			});
+		}
+
+		{//digit-major then range-major offsets keep the sort stable
+			bool bSkip = false;
+			int iOffset = 0;
+			for (int d = 0; d < RADIX_SIZE; ++d) {
+				int iDigitCount = 0;
+				for (int p = 0; p < iPartCount; ++p) {
+					int &iSlot = m_Histograms[(p * RADIX_PASSES + iPass) * RADIX_SIZE + d];
+					const int iPartDigitCount = iSlot;
+					iSlot = iOffset;
+					iOffset += iPartDigitCount;
+					iDigitCount += iPartDigitCount;
+				}
+				bSkip |= iDigitCount == iSize;
+			}
+			if (bSkip) {//every key has this digit, the pass wouldn't move anything
+				continue;
+			}
+		}
+
+		const NXUInt64 *pEntries = &m_Entries[0];
+		NXUInt64 *pOut = &m_Scratch[0];
+		ParallelFor(0, iSize, iPartCount, [&](const int iBegin, const int iEnd, const int iPart) {
+			int *pOffsets = &m_Histograms[(iPart * RADIX_PASSES + iPass) * RADIX_SIZE];
+			for (int k = iBegin; k < iEnd; ++k) {
+				const NXUInt64 uEntry = pEntries[k];
+				pOut[pOffsets[(uEntry >> iShift) & (RADIX_SIZE - 1)]++] = uEntry;
+			}
+		});
+		m_Entries.swap(m_Scratch);
+		++iPasses;
+	}
+	return iPasses;
+}
+
+void NX::ParticleDepthSort::ExtractOrder(const int iPartCount) {
+	m_Order.resize(m_Entries.size());
+	ParallelFor(0, (int)m_Entries.size(), iPartCount, [&](const int iBegin, const int iEnd, const int) {
+		for (int k = iBegin; k < iEnd; ++k) {
+			m_Order[k] = (NXUInt32)m_Entries[k];
+		}
+	});
+}
@@ -0,0 +1,102 @@
+/*
+ *  File:    NXParticleDepthSort.h
+ *
+ *  author:  张雄(zhang xiong, 1025679612@qq.com)
+ *  date:    2026_10_19
+ *  purpose: back to front order of the live particles of a ParticleStorage for alpha blending. the view
+ *           depth of every particle is turned into a 32 bit key whose unsigned order is the float order
+ *           in one sequential pass, then packed with the particle index into a 64 bit entry so a scatter
+ *           writes a single stream per digit. the entries are sorted by a stable LSD radix sort with 8 bit
+ *           digits: one read builds the histograms of all passes, then every pass scatters in parallel
+ *           ranges. the result is ordered by (key, index), so it depends neither on the worker count nor on
+ *           earlier frames. the previous frame's order is the input of the next one: when it is still
+ *           nearly sorted an insertion sort with a move budget finishes it instead. scratch memory is kept
+ *           between frames.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "../math/NXVector.h"
+#include "../common/NXType.h"
+
+namespace NX {
+	class ParticleStorage;
+
+	class ParticleDepthSort {
+	public:
+		enum {
+			RADIX_BITS               = 8,
+			RADIX_SIZE               = 1 << RADIX_BITS,
+			RADIX_PASSES             = 32 / RADIX_BITS,
+			MIN_PART_SIZE            = 16384,        // particles per worker range, smaller sorts use fewer workers
+			INSERTION_DESCENT_RATIO  = 8,
+		};
+
+		struct Statistics {
+			int         iLiveCount;
+			int         iDescents;           // neighbours out of order in the previous order, -1 when it couldn't be reused
+			bool        bIncremental;        // the insertion sort finished the previous order
+			int         iInsertionMoves;     // elements shifted by the insertion sort, also when it gave up
+			int         iRadixPasses;        // passes run, passes whose digit is equal for all keys are skipped
+		};
+
+	public:
+		ParticleDepthSort();
+		virtual ~ParticleDepthSort();
+
+	public:
+		/**
+		 *  iWorkerCount: <= 0 means every hardware thread, the order doesn't depend on it
+		 *  fMaxInsertionMoves: the insertion sort gives up after this many moves per particle and the radix
+		 *  sort runs, it isn't tried at all when more than 1 / INSERTION_DESCENT_RATIO of that budget are
+		 *  neighbours out of order. 0 always uses the radix sort
+		 */
+		ParticleDepthSort& SetWorkerCount(const int iWorkerCount);
+		ParticleDepthSort& SetMaxInsertionMoves(const float fMaxInsertionMoves);
+		int                GetWorkerCount() const;
+
+	public:
+		/**
+		 *  sort the live particles by their distance along Front from Eye, farthest first. pDeadMask is a
+		 *  death mask from ParticleStorage::Integrate, nullptr compares AGE with LIFE_TIME instead. returns
+		 *  the number of particles in GetOrder().
+		 */
+		int   Sort(const ParticleStorage &Particles, const NXUInt8 *pDeadMask, const float3 &Eye, const float3 &Front, Statistics *pStatistics = nullptr);
+
+		/**
+		 *  forget the previous order, the next Sort starts from storage order
+		 */
+		void  Reset();
+
+	public:
+		const NXUInt32*     GetOrder() const;
+		int                 GetOrderCount() const;
+
+	public:
+		/**
+		 *  unsigned order of the result is the order of fValue, -0 sorts before +0
+		 */
+		static NXUInt32 GetSortKey(const float fValue);
+
+	private:
+		int   ComputeKeys(const ParticleStorage &Particles, const NXUInt8 *pDeadMask, const float3 &Eye, const float3 &Front, const int iPartCount);
+		int   ReuseOrder(const int iPartCount);
+		void  GatherEntries(const int iPartCount);
+		bool  InsertionSort(const int iMaxMoves, int &iMoves);
+		int   RadixSort(const int iPartCount);
+		void  ExtractOrder(const int iPartCount);
+
+	private:
+		int                     m_iWorkerCount;
+		float                   m_fMaxInsertionMoves;
+		std::vector<NXUInt32>   m_Order;             // particle indexs, the result
+		std::vector<NXUInt32>   m_ParticleKeys;      // key of every particle in storage order, all ones for dead ones
+		std::vector<NXUInt64>   m_Entries;           // key << 32 | particle index
+		std::vector<NXUInt64>   m_Scratch;
+		std::vector<int>        m_Histograms;        // (part * RADIX_PASSES + pass) * RADIX_SIZE + digit, then the scatter offsets
+		std::vector<int>        m_PartCounts;        // live particles of every range
+		std::vector<int>        m_PartDescents;      // of every range of the previous order, -1 when it holds a dead one
+	};
+}
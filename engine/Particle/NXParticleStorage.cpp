@@ -0,0 +1,433 @@
+/*
+ *  File:    NXParticleStorage.cpp
+ *
+ *  author:  张雄(zhang xiong, 1025679612@qq.com)
+ *  date:    2026_10_19
+ *  purpose: structure of arrays particle container
+ */
+
+#include <cmath>
+#include <cstring>
+
+#include "NXParticleStorage.h"
+#include "../common/NXCore.h"
+#include "../math/NXMath.h"
+#include "../math/NXNumeric.h"
+#include "../math/NXSIMD.h"
+
+namespace {
+	inline float WrapAngle(const float fAngle) {//same steps as float3 % kf2Pi
+		return fAngle - NX::kf2Pi * std::floor(fAngle / NX::kf2Pi);
+	}
+
+	inline void TurnRotor(float &c, float &s, const float fHalfStep) {//(c, s) * (cos, sin)(fHalfStep), pulled back to unit length
+		const float h2 = fHalfStep * fHalfStep;
+		const float dc = 1.f - h2 * 0.5f * (1.f - h2 * (1.f / 12.f));
+		const float ds = fHalfStep * (1.f - h2 * (1.f / 6.f) * (1.f - h2 * 0.05f));
+		const float tc = c * dc - s * ds;
+		const float ts = s * dc + c * ds;
+		const float k  = 1.5f - 0.5f * (tc * tc + ts * ts);
+		c = tc * k;
+		s = ts * k;
+	}
+
+	inline int BitCount(NXUInt32 uBits) {
+		uBits = uBits - ((uBits >> 1) & 0x55555555);
+		uBits = (uBits & 0x33333333) + ((uBits >> 2) & 0x33333333);
+		return (int)((((uBits + (uBits >> 4)) & 0x0F0F0F0F) * 0x01010101) >> 24);
+	}
+
+	struct Streams {
+		float *px,  *py,  *pz;
+		float *pvx, *pvy, *pvz;
+		float *prx, *pry, *prz;
+		float *pwx, *pwy, *pwz;
+		float *pAge;
+		const float *pLifeTime;
+		float *pRotors[6];                   //cos, sin of x, y, z
+	};
+
+#if NX_SIMD_SSE
+	struct Constants {
+		__m128 Delta;
+		__m128 dvx, dvy, dvz;                //acceleration * delta
+		__m128 dwx, dwy, dwz;
+		__m128 TwoPi;
+		__m128 HalfDelta;
+	};
+
+	inline __m128 WrapAngle(const __m128 Angle, const __m128 TwoPi) {//division kept so the lanes match WrapAngle bitwise
+		return _mm_sub_ps(Angle, _mm_mul_ps(TwoPi, NX::SIMDFloor(_mm_div_ps(Angle, TwoPi))));
+	}
+
+	inline __m128 Advance(float *pValue, const float *pRate, const __m128 Delta) {
+		return _mm_add_ps(_mm_load_ps(pValue), _mm_mul_ps(_mm_load_ps(pRate), Delta));
+	}
+
+	inline void TurnRotor(float *pc, float *ps, const float *pw, const Constants &c) {//same steps as the scalar TurnRotor
+		const __m128 One = _mm_set1_ps(1.f), Half = _mm_set1_ps(0.5f);
+		const __m128 h   = _mm_mul_ps(_mm_load_ps(pw), c.HalfDelta);
+		const __m128 h2  = _mm_mul_ps(h, h);
+		const __m128 dc  = _mm_sub_ps(One, _mm_mul_ps(_mm_mul_ps(h2, Half), _mm_sub_ps(One, _mm_mul_ps(h2, _mm_set1_ps(1.f / 12.f)))));
+		const __m128 ds  = _mm_mul_ps(h, _mm_sub_ps(One, _mm_mul_ps(_mm_mul_ps(h2, _mm_set1_ps(1.f / 6.f)), _mm_sub_ps(One, _mm_mul_ps(h2, _mm_set1_ps(0.05f))))));
+		const __m128 oc  = _mm_load_ps(pc), os = _mm_load_ps(ps);
+		const __m128 tc  = _mm_sub_ps(_mm_mul_ps(oc, dc), _mm_mul_ps(os, ds));
+		const __m128 ts  = _mm_add_ps(_mm_mul_ps(os, dc), _mm_mul_ps(oc, ds));
+		const __m128 k   = _mm_sub_ps(_mm_set1_ps(1.5f), _mm_mul_ps(Half, _mm_add_ps(_mm_mul_ps(tc, tc), _mm_mul_ps(ts, ts))));
+		_mm_store_ps(pc, _mm_mul_ps(tc, k));
+		_mm_store_ps(ps, _mm_mul_ps(ts, k));
+	}
+
+	inline int Integrate4(const Streams &s, const int i, const Constants &c) {//returns the death bits of particles i..i+3
+		_mm_store_ps(s.px + i, Advance(s.px + i, s.pvx + i, c.Delta));
+		_mm_store_ps(s.py + i, Advance(s.py + i, s.pvy + i, c.Delta));
+		_mm_store_ps(s.pz + i, Advance(s.pz + i, s.pvz + i, c.Delta));
+		_mm_store_ps(s.prx + i, WrapAngle(Advance(s.prx + i, s.pwx + i, c.Delta), c.TwoPi));
+		_mm_store_ps(s.pry + i, WrapAngle(Advance(s.pry + i, s.pwy + i, c.Delta), c.TwoPi));
+		_mm_store_ps(s.prz + i, WrapAngle(Advance(s.prz + i, s.pwz + i, c.Delta), c.TwoPi));
+		TurnRotor(s.pRotors[0] + i, s.pRotors[1] + i, s.pwx + i, c);
+		TurnRotor(s.pRotors[2] + i, s.pRotors[3] + i, s.pwy + i, c);
+		TurnRotor(s.pRotors[4] + i, s.pRotors[5] + i, s.pwz + i, c);
+		_mm_store_ps(s.pvx + i, _mm_add_ps(_mm_load_ps(s.pvx + i), c.dvx));
+		_mm_store_ps(s.pvy + i, _mm_add_ps(_mm_load_ps(s.pvy + i), c.dvy));
+		_mm_store_ps(s.pvz + i, _mm_add_ps(_mm_load_ps(s.pvz + i), c.dvz));
+		_mm_store_ps(s.pwx + i, _mm_add_ps(_mm_load_ps(s.pwx + i), c.dwx));
+		_mm_store_ps(s.pwy + i, _mm_add_ps(_mm_load_ps(s.pwy + i), c.dwy));
+		_mm_store_ps(s.pwz + i, _mm_add_ps(_mm_load_ps(s.pwz + i), c.dwz));
+		const __m128 Age = _mm_add_ps(_mm_load_ps(s.pAge + i), c.Delta);
+		_mm_store_ps(s.pAge + i, Age);
+		return _mm_movemask_ps(_mm_cmpge_ps(Age, _mm_load_ps(s.pLifeTime + i)));
+	}
+#endif
+}
+
+NX::ParticleStorage::ParticleStorage() {
+	m_iCount         = 0;
+	m_iCapacity      = 0;
+	m_iHighWaterMark = 0;
+	m_bGrowable      = true;
+	m_pTextureIndexs = nullptr;
+	m_pBlock         = nullptr;
+	for (int i = 0; i < STREAM_COUNT; ++i) {
+		m_pStreams[i] = nullptr;
+	}
+}
+
+NX::ParticleStorage::~ParticleStorage() {
+	NXAlignedFree(m_pBlock);
+}
+
+void NX::ParticleStorage::Reserve(const int iCapacity) {
+	if (iCapacity > m_iCapacity) {
+		Reallocate(NXAlignCount(iCapacity, STREAM_ALIGNMENT));
+	}
+}
+
+void NX::ParticleStorage::Reallocate(const int iCapacity) {
+	NXAssert(iCapacity >= m_iCount && iCapacity % STREAM_ALIGNMENT == 0);
+	//one spare cache line per stream, power of two capacities would otherwise put the same particle of every
+	//stream into the same cache set and the kernels touch 14 streams at once
+	const size_t uStreamBytes = sizeof(float) * (iCapacity + STREAM_ALIGNMENT);
+	void *pBlock = NXAlignedAlloc(uStreamBytes * (STREAM_COUNT + 1));
+	NXAssert(pBlock);
+	memset(pBlock, 0, uStreamBytes * (STREAM_COUNT + 1));
+
+	char *pBase = (char*)pBlock;
+	for (int i = 0; i < STREAM_COUNT; ++i, pBase += uStreamBytes) {
+		if (m_iCount) {
+			memcpy(pBase, m_pStreams[i], sizeof(float) * m_iCount);
+		}
+		m_pStreams[i] = (float*)pBase;
+	}
+	if (m_iCount) {
+		memcpy(pBase, m_pTextureIndexs, sizeof(NXInt32) * m_iCount);
+	}
+	m_pTextureIndexs = (NXInt32*)pBase;
+
+	NXAlignedFree(m_pBlock);
+	m_pBlock    = pBlock;
+	m_iCapacity = iCapacity;
+}
+
+void NX::ParticleStorage::SetGrowable(const bool bGrowable) {
+	m_bGrowable = bGrowable;
+}
+
+int NX::ParticleStorage::Add(const float3 &Position, const float3 &Velocity, const float3 &Rotation, const float3 &AngularVelocity, const float fLifeTime, const float2 &Size, const int iTextureIndex) {
+	if (m_iCount == m_iCapacity) {
+		if (!m_bGrowable) {
+			return -1;
+		}
+		Reallocate(NXMax(2 * m_iCapacity, (int)STREAM_ALIGNMENT));
+	}
+	const int i = m_iCount++;
+	m_iHighWaterMark = NXMax(m_iHighWaterMark, m_iCount);
+	Set(i, Position, Velocity, Rotation, AngularVelocity, fLifeTime, Size, iTextureIndex);
+	return i;
+}
+
+void NX::ParticleStorage::Set(const int i, const float3 &Position, const float3 &Velocity, const float3 &Rotation, const float3 &AngularVelocity, const float fLifeTime, const float2 &Size, const int iTextureIndex) {
+	NXAssert(i >= 0 && i < m_iCount);
+	m_pStreams[POSITION_X][i]         = Position.x;
+	m_pStreams[POSITION_Y][i]         = Position.y;
+	m_pStreams[POSITION_Z][i]         = Position.z;
+	m_pStreams[VELOCITY_X][i]         = Velocity.x;
+	m_pStreams[VELOCITY_Y][i]         = Velocity.y;
+	m_pStreams[VELOCITY_Z][i]         = Velocity.z;
+	m_pStreams[ROTATION_X][i]         = WrapAngle(Rotation.x);
+	m_pStreams[ROTATION_Y][i]         = WrapAngle(Rotation.y);
+	m_pStreams[ROTATION_Z][i]         = WrapAngle(Rotation.z);
+	m_pStreams[ANGULAR_VELOCITY_X][i] = AngularVelocity.x;
+	m_pStreams[ANGULAR_VELOCITY_Y][i] = AngularVelocity.y;
+	m_pStreams[ANGULAR_VELOCITY_Z][i] = AngularVelocity.z;
+	m_pStreams[AGE][i]                = 0.f;
+	m_pStreams[LIFE_TIME][i]          = fLifeTime;
+	m_pStreams[SIZE_X][i]             = Size.x;
+	m_pStreams[SIZE_Y][i]             = Size.y;
+	m_pTextureIndexs[i]               = iTextureIndex;
+	for (int k = 0; k < 3; ++k) {
+		const float fHalfAngle = m_pStreams[ROTATION_X + k][i] * 0.5f;
+		m_pStreams[ROTOR_X_COS + 2 * k][i] = std::cos(fHalfAngle);
+		m_pStreams[ROTOR_X_SIN + 2 * k][i] = std::sin(fHalfAngle);
+	}
+}
+
+void NX::ParticleStorage::Remove(const int i) {
+	NXAssert(i >= 0 && i < m_iCount);
+	const int iLast = --m_iCount;
+	if (i != iLast) {
+		for (int s = 0; s < STREAM_COUNT; ++s) {
+			m_pStreams[s][i] = m_pStreams[s][iLast];
+		}
+		m_pTextureIndexs[i] = m_pTextureIndexs[iLast];
+	}
+}
+
+void NX::ParticleStorage::Clear() {
+	m_iCount = 0;
+}
+
+int NX::ParticleStorage::Integrate(const float fDelta, const float3 &Acceleration, const float3 &AngularAcceleration, NXUInt8 *pDeadMask) {
+	return Integrate(0, m_iCount, fDelta, Acceleration, AngularAcceleration, pDeadMask);
+}
+
+int NX::ParticleStorage::Integrate(const int iBegin, const int iEnd, const float fDelta, const float3 &Acceleration, const float3 &AngularAcceleration, NXUInt8 *pDeadMask) {
+	NXAssert(iBegin >= 0 && iBegin <= iEnd && iEnd <= m_iCount);
+	NXAssert(iBegin % DEAD_MASK_GROUP == 0 && (iEnd % DEAD_MASK_GROUP == 0 || iEnd == m_iCount));
+	Streams s = {
+		m_pStreams[POSITION_X],         m_pStreams[POSITION_Y],         m_pStreams[POSITION_Z],
+		m_pStreams[VELOCITY_X],         m_pStreams[VELOCITY_Y],         m_pStreams[VELOCITY_Z],
+		m_pStreams[ROTATION_X],         m_pStreams[ROTATION_Y],         m_pStreams[ROTATION_Z],
+		m_pStreams[ANGULAR_VELOCITY_X], m_pStreams[ANGULAR_VELOCITY_Y], m_pStreams[ANGULAR_VELOCITY_Z],
+		m_pStreams[AGE],                m_pStreams[LIFE_TIME],
+		{ m_pStreams[ROTOR_X_COS], m_pStreams[ROTOR_X_SIN], m_pStreams[ROTOR_Y_COS], m_pStreams[ROTOR_Y_SIN], m_pStreams[ROTOR_Z_COS], m_pStreams[ROTOR_Z_SIN] },
+	};
+	int iDeadCount = 0;
+#if NX_SIMD_SSE
+	Constants c;
+	c.Delta = _mm_set1_ps(fDelta);
+	c.dvx   = _mm_set1_ps(Acceleration.x * fDelta);
+	c.dvy   = _mm_set1_ps(Acceleration.y * fDelta);
+	c.dvz   = _mm_set1_ps(Acceleration.z * fDelta);
+	c.dwx   = _mm_set1_ps(AngularAcceleration.x * fDelta);
+	c.dwy   = _mm_set1_ps(AngularAcceleration.y * fDelta);
+	c.dwz   = _mm_set1_ps(AngularAcceleration.z * fDelta);
+	c.TwoPi = _mm_set1_ps(kf2Pi);
+	c.HalfDelta = _mm_set1_ps(fDelta * 0.5f);
+	//the last group may run into the padding, those lanes are integrated too but masked out of the result
+	for (int i = iBegin; i < iEnd; i += DEAD_MASK_GROUP) {
+		NXUInt32 uBits = (NXUInt32)(Integrate4(s, i, c) | (Integrate4(s, i + 4, c) << 4));
+		uBits &= 0xFFu >> NXMax(0, i + DEAD_MASK_GROUP - iEnd);
+		iDeadCount += BitCount(uBits);
+		if (pDeadMask) {
+			pDeadMask[i / DEAD_MASK_GROUP] = (NXUInt8)uBits;
+		}
+	}
+#else
+	const float dvx = Acceleration.x * fDelta,        dvy = Acceleration.y * fDelta,        dvz = Acceleration.z * fDelta;
+	const float dwx = AngularAcceleration.x * fDelta, dwy = AngularAcceleration.y * fDelta, dwz = AngularAcceleration.z * fDelta;
+	const float fHalfDelta = fDelta * 0.5f;
+	for (int i = iBegin; i < iEnd; i += DEAD_MASK_GROUP) {
+		const int iGroupEnd = NXMin(i + (int)DEAD_MASK_GROUP, iEnd);
+		NXUInt32 uBits = 0;
+		for (int j = i; j < iGroupEnd; ++j) {
+			s.px[j]   += s.pvx[j] * fDelta;
+			s.py[j]   += s.pvy[j] * fDelta;
+			s.pz[j]   += s.pvz[j] * fDelta;
+			s.prx[j]   = WrapAngle(s.prx[j] + s.pwx[j] * fDelta);
+			s.pry[j]   = WrapAngle(s.pry[j] + s.pwy[j] * fDelta);
+			s.prz[j]   = WrapAngle(s.prz[j] + s.pwz[j] * fDelta);
+			TurnRotor(s.pRotors[0][j], s.pRotors[1][j], s.pwx[j] * fHalfDelta);
+			TurnRotor(s.pRotors[2][j], s.pRotors[3][j], s.pwy[j] * fHalfDelta);
+			TurnRotor(s.pRotors[4][j], s.pRotors[5][j], s.pwz[j] * fHalfDelta);
+			s.pvx[j]  += dvx;
+			s.pvy[j]  += dvy;
+			s.pvz[j]  += dvz;
+			s.pwx[j]  += dwx;
+			s.pwy[j]  += dwy;
+			s.pwz[j]  += dwz;
+			s.pAge[j] += fDelta;
+			uBits     |= (NXUInt32)(s.pAge[j] >= s.pLifeTime[j]) << (j - i);
+		}
+		iDeadCount += BitCount(uBits);
+		if (pDeadMask) {
+			pDeadMask[i / DEAD_MASK_GROUP] = (NXUInt8)uBits;
+		}
+	}
+#endif
+	return iDeadCount;
+}
+
+int NX::ParticleStorage::IntegrateScalar(const float fDelta, const float3 &Acceleration, const float3 &AngularAcceleration, NXUInt8 *pDeadMask) {
+	float *px  = m_pStreams[POSITION_X],         *py  = m_pStreams[POSITION_Y],         *pz  = m_pStreams[POSITION_Z];
+	float *pvx = m_pStreams[VELOCITY_X],         *pvy = m_pStreams[VELOCITY_Y],         *pvz = m_pStreams[VELOCITY_Z];
+	float *prx = m_pStreams[ROTATION_X],         *pry = m_pStreams[ROTATION_Y],         *prz = m_pStreams[ROTATION_Z];
+	float *pwx = m_pStreams[ANGULAR_VELOCITY_X], *pwy = m_pStreams[ANGULAR_VELOCITY_Y], *pwz = m_pStreams[ANGULAR_VELOCITY_Z];
+	float *pAge = m_pStreams[AGE];
+	const float *pLifeTime = m_pStreams[LIFE_TIME];
+	float *pxc = m_pStreams[ROTOR_X_COS], *pxs = m_pStreams[ROTOR_X_SIN];
+	float *pyc = m_pStreams[ROTOR_Y_COS], *pys = m_pStreams[ROTOR_Y_SIN];
+	float *pzc = m_pStreams[ROTOR_Z_COS], *pzs = m_pStreams[ROTOR_Z_SIN];
+	const float fHalfDelta = fDelta * 0.5f;
+	if (pDeadMask) {
+		memset(pDeadMask, 0, GetDeadMaskSize());
+	}
+	int iDeadCount = 0;
+	//same order as Particle::OnTick, position and rotation move with the old velocities
+	for (int i = 0; i < m_iCount; ++i) {
+		px[i]   += pvx[i] * fDelta;
+		py[i]   += pvy[i] * fDelta;
+		pz[i]   += pvz[i] * fDelta;
+		prx[i]   = WrapAngle(prx[i] + pwx[i] * fDelta);
+		pry[i]   = WrapAngle(pry[i] + pwy[i] * fDelta);
+		prz[i]   = WrapAngle(prz[i] + pwz[i] * fDelta);
+		TurnRotor(pxc[i], pxs[i], pwx[i] * fHalfDelta);
+		TurnRotor(pyc[i], pys[i], pwy[i] * fHalfDelta);
+		TurnRotor(pzc[i], pzs[i], pwz[i] * fHalfDelta);
+		pvx[i]  += Acceleration.x * fDelta;
+		pvy[i]  += Acceleration.y * fDelta;
+		pvz[i]  += Acceleration.z * fDelta;
+		pwx[i]  += AngularAcceleration.x * fDelta;
+		pwy[i]  += AngularAcceleration.y * fDelta;
+		pwz[i]  += AngularAcceleration.z * fDelta;
+		pAge[i] += fDelta;
+		if (pAge[i] >= pLifeTime[i]) {
+			++iDeadCount;
+			if (pDeadMask) {
+				pDeadMask[i / DEAD_MASK_GROUP] |= (NXUInt8)(1 << (i % DEAD_MASK_GROUP));
+			}
+		}
+	}
+	return iDeadCount;
+}
+
+int NX::ParticleStorage::RemoveDead() {
+	const int iCount = m_iCount;
+	const float *pAge = m_pStreams[AGE], *pLifeTime = m_pStreams[LIFE_TIME];
+	for (int i = m_iCount - 1; i >= 0; --i) {//backwards, the particle swapped in has been checked already
+		if (pAge[i] >= pLifeTime[i]) {
+			Remove(i);
+		}
+	}
+	return iCount - m_iCount;
+}
+
+int NX::ParticleStorage::RemoveDead(const NXUInt8 *pDeadMask) {
+	const int iCount = m_iCount;
+	for (int g = (iCount + DEAD_MASK_GROUP - 1) / DEAD_MASK_GROUP - 1; g >= 0; --g) {
+		for (NXUInt32 uBits = pDeadMask[g]; uBits; ) {//highest bit first, what moves in from the end is alive
+			int j = DEAD_MASK_GROUP - 1;
+			while (!(uBits & (1u << j))) {
+				--j;
+			}
+			uBits &= ~(1u << j);
+			Remove(g * DEAD_MASK_GROUP + j);
+		}
+	}
+	return iCount - m_iCount;
+}
+
+int NX::ParticleStorage::GetCount() const {
+	return m_iCount;
+}
+
+int NX::ParticleStorage::GetCapacity() const {
+	return m_iCapacity;
+}
+
+int NX::ParticleStorage::GetHighWaterMark() const {
+	return m_iHighWaterMark;
+}
+
+void NX::ParticleStorage::ResetHighWaterMark() {
+	m_iHighWaterMark = m_iCount;
+}
+
+bool NX::ParticleStorage::IsGrowable() const {
+	return m_bGrowable;
+}
+
+bool NX::ParticleStorage::IsFull() const {
+	return m_iCount == m_iCapacity;
+}
+
+int NX::ParticleStorage::GetDeadMaskSize() const {
+	return (m_iCount + DEAD_MASK_GROUP - 1) / DEAD_MASK_GROUP;
+}
+
+float* NX::ParticleStorage::GetStream(const STREAM eStream) {
+	NXAssert(eStream >= 0 && eStream < STREAM_COUNT);
+	return m_pStreams[eStream];
+}
+
+const float* NX::ParticleStorage::GetStream(const STREAM eStream) const {
+	NXAssert(eStream >= 0 && eStream < STREAM_COUNT);
+	return m_pStreams[eStream];
+}
+
+NXInt32* NX::ParticleStorage::GetTextureIndexs() {
+	return m_pTextureIndexs;
+}
+
+const NXInt32* NX::ParticleStorage::GetTextureIndexs() const {
+	return m_pTextureIndexs;
+}
+
+NX::float3 NX::ParticleStorage::GetPosition(const int i) const {
+	NXAssert(i >= 0 && i < m_iCount);
+	return float3(m_pStreams[POSITION_X][i], m_pStreams[POSITION_Y][i], m_pStreams[POSITION_Z][i]);
+}
+
+NX::float3 NX::ParticleStorage::GetVelocity(const int i) const {
+	NXAssert(i >= 0 && i < m_iCount);
+	return float3(m_pStreams[VELOCITY_X][i], m_pStreams[VELOCITY_Y][i], m_pStreams[VELOCITY_Z][i]);
+}
+
+NX::float3 NX::ParticleStorage::GetRotation(const int i) const {
+	NXAssert(i >= 0 && i < m_iCount);
+	return float3(m_pStreams[ROTATION_X][i], m_pStreams[ROTATION_Y][i], m_pStreams[ROTATION_Z][i]);
+}
+
+NX::float3 NX::ParticleStorage::GetAngularVelocity(const int i) const {
+	NXAssert(i >= 0 && i < m_iCount);
+	return float3(m_pStreams[ANGULAR_VELOCITY_X][i], m_pStreams[ANGULAR_VELOCITY_Y][i], m_pStreams[ANGULAR_VELOCITY_Z][i]);
+}
+
+NX::float2 NX::ParticleStorage::GetSize(const int i) const {
+	NXAssert(i >= 0 && i < m_iCount);
+	return float2(m_pStreams[SIZE_X][i], m_pStreams[SIZE_Y][i]);
+}
+
+NX::Quaternion NX::ParticleStorage::GetOrientation(const int i) const {
+	NXAssert(i >= 0 && i < m_iCount);
+	const float cx = m_pStreams[ROTOR_X_COS][i], sx = m_pStreams[ROTOR_X_SIN][i];
+	const float cy = m_pStreams[ROTOR_Y_COS][i], sy = m_pStreams[ROTOR_Y_SIN][i];
+	const float cz = m_pStreams[ROTOR_Z_COS][i], sz = m_pStreams[ROTOR_Z_SIN][i];
+	const float w = cx * cy, x = sx * cy, y = cx * sy, z = sx * sy;//rotor x * rotor y
+	return Quaternion(w * cz - z * sz, x * cz + y * sz, y * cz - x * sz, w * sz + z * cz);
+}
+
+bool NX::ParticleStorage::IsDead(const int i) const {
+	NXAssert(i >= 0 && i < m_iCount);
+	return m_pStreams[AGE][i] >= m_pStreams[LIFE_TIME][i];
+}
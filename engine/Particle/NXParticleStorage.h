@@ -0,0 +1,152 @@
+/*
+ *  File:    NXParticleStorage.h
+ *
+ *  author:  张雄(zhang xiong, 1025679612@qq.com)
+ *  date:    2026_10_19
+ *  purpose: structure of arrays particle container. every attribute lives in its own cache line aligned
+ *           float array inside one allocation, the arrays are padded to a multiple of STREAM_ALIGNMENT
+ *           elements so SIMD loops may run over the padding. particles are dense in [0, count), removing
+ *           one moves the last particle into its slot.
+ */
+
+#pragma once
+
+#include "../math/NXVector.h"
+#include "../math/NXQuaternion.h"
+#include "../common/NXType.h"
+
+namespace NX {
+	class ParticleStorage {
+	public:
+		enum STREAM {
+			POSITION_X,
+			POSITION_Y,
+			POSITION_Z,
+			VELOCITY_X,
+			VELOCITY_Y,
+			VELOCITY_Z,
+			ROTATION_X,                  // euler angles in radians, kept in [0, 2 pi)
+			ROTATION_Y,
+			ROTATION_Z,
+			ANGULAR_VELOCITY_X,
+			ANGULAR_VELOCITY_Y,
+			ANGULAR_VELOCITY_Z,
+			AGE,                         // seconds since the particle was added
+			LIFE_TIME,                   // the particle is dead once AGE >= LIFE_TIME
+			SIZE_X,
+			SIZE_Y,
+			ROTOR_X_COS,                 // cos and sin of half ROTATION_X, the quaternion about x. Integrate
+			ROTOR_X_SIN,                 // advances the rotors incrementally, no trig per tick
+			ROTOR_Y_COS,
+			ROTOR_Y_SIN,
+			ROTOR_Z_COS,
+			ROTOR_Z_SIN,
+			STREAM_COUNT,
+		};
+
+		enum {
+			STREAM_ALIGNMENT = 16,       // elements, one cache line of floats
+			DEAD_MASK_GROUP  = 8,        // particles per byte of a death mask, also the SIMD kernel's step
+		};
+
+	public:
+		ParticleStorage();
+		virtual ~ParticleStorage();
+
+	private:
+		ParticleStorage(const ParticleStorage&);
+		ParticleStorage& operator = (const ParticleStorage&);
+
+	public:
+		/**
+		 *  make room for iCapacity particles, existing particles are kept
+		 */
+		void  Reserve(const int iCapacity);
+
+		/**
+		 *  a growable storage doubles its arrays when an Add finds them full. a fixed one is a pool: Reserve
+		 *  once, then Add and Remove never allocate and Add returns -1 when the pool is full.
+		 */
+		void  SetGrowable(const bool bGrowable);
+
+		/**
+		 *  append a particle with AGE 0 and return its index, -1 if a fixed storage is full
+		 */
+		int   Add(const float3 &Position, const float3 &Velocity, const float3 &Rotation, const float3 &AngularVelocity, const float fLifeTime, const float2 &Size, const int iTextureIndex);
+
+		/**
+		 *  overwrite particle i in place, AGE restarts at 0
+		 */
+		void  Set(const int i, const float3 &Position, const float3 &Velocity, const float3 &Rotation, const float3 &AngularVelocity, const float fLifeTime, const float2 &Size, const int iTextureIndex);
+
+		/**
+		 *  O(1), the last particle moves into slot i
+		 */
+		void  Remove(const int i);
+		void  Clear();
+
+		/**
+		 *  advance every particle by fDelta with a shared acceleration, rotations wrap into [0, 2 pi).
+		 *  the rotors turn by a short polynomial of the angular step and are renormalized, that holds for
+		 *  steps up to ~0.5 radian per axis.
+		 *  the SSE kernel runs 8 particles per iteration over the stream padding and builds the death mask
+		 *  with compares instead of branches. pDeadMask, if given, receives bit i % 8 of byte i / 8 set for
+		 *  every particle with AGE >= LIFE_TIME afterwards, GetDeadMaskSize() bytes. returns the dead count.
+		 */
+		int   Integrate(const float fDelta, const float3 &Acceleration, const float3 &AngularAcceleration, NXUInt8 *pDeadMask = nullptr);
+
+		/**
+		 *  the same on particles [iBegin, iEnd) only, so several workers can share one storage. iBegin must
+		 *  be a multiple of DEAD_MASK_GROUP and iEnd too unless it is the count, pDeadMask is still indexed
+		 *  from particle 0.
+		 */
+		int   Integrate(const int iBegin, const int iEnd, const float fDelta, const float3 &Acceleration, const float3 &AngularAcceleration, NXUInt8 *pDeadMask = nullptr);
+
+		/**
+		 *  one particle at a time, bitwise equal to the SSE kernel. for validation and benchmarks
+		 */
+		int   IntegrateScalar(const float fDelta, const float3 &Acceleration, const float3 &AngularAcceleration, NXUInt8 *pDeadMask = nullptr);
+
+		/**
+		 *  remove every particle with AGE >= LIFE_TIME, returns the number removed. survivors may change order.
+		 */
+		int   RemoveDead();
+
+		/**
+		 *  the same driven by a death mask from Integrate, whole bytes of living particles are skipped
+		 */
+		int   RemoveDead(const NXUInt8 *pDeadMask);
+
+	public:
+		int           GetCount() const;
+		int           GetCapacity() const;
+		int           GetHighWaterMark() const;          // largest count since construction or ResetHighWaterMark
+		void          ResetHighWaterMark();
+		bool          IsGrowable() const;
+		bool          IsFull() const;
+		int           GetDeadMaskSize() const;
+		float*        GetStream(const STREAM eStream);
+		const float*  GetStream(const STREAM eStream) const;
+		NXInt32*      GetTextureIndexs();
+		const NXInt32*GetTextureIndexs() const;
+		float3        GetPosition(const int i) const;
+		float3        GetVelocity(const int i) const;
+		float3        GetRotation(const int i) const;
+		float3        GetAngularVelocity(const int i) const;
+		float2        GetSize(const int i) const;
+		Quaternion    GetOrientation(const int i) const;     // rotor x * rotor y * rotor z, the rotation of GetMatrixRotateByXYZ(GetRotation(i))
+		bool          IsDead(const int i) const;
+
+	private:
+		void  Reallocate(const int iCapacity);
+
+	private:
+		int           m_iCount;
+		int           m_iCapacity;               // multiple of STREAM_ALIGNMENT
+		int           m_iHighWaterMark;
+		bool          m_bGrowable;
+		float         *m_pStreams[STREAM_COUNT];
+		NXInt32       *m_pTextureIndexs;
+		void          *m_pBlock;                 // every stream, NXAlignedAlloc
+	};
+}
@@ -12,6 +12,7 @@
 
 namespace NX {
 	class Particle;
+	class ParticleStorage;
 
 	class ParticleSystem : public IEntity{
 	public:
@@ -25,13 +26,25 @@ namespace NX {
 
 	public:
 		virtual ParticleSystem&  EmitParticle() = 0;
-		virtual ParticleSystem&  AddParticle(Particle *pParticle) = 0;
-		virtual ParticleSystem&  ResetParticle(Particle *pParticle) = 0;
+		/**
+		 *  copy the particle's state into the system, what is left of its live time becomes the life time
+		 */
+		virtual ParticleSystem&  AddParticle(const Particle &particle) = 0;
+		virtual ParticleSystem&  ResetParticle(const int iParticleIndex) = 0;
+		/**
+		 *  O(1), the last particle takes over iParticleIndex
+		 */
 		virtual ParticleSystem&  RemoveParticle(const int iParticleIndex) = 0;
 
 	public:
 		virtual int GetParticleCount() const = 0;
-		virtual Particle* GetParticle(const int index) = 0;
-		virtual const Particle* GetParticle(const int index) const = 0;
+		/**
+		 *  a snapshot of particle index, writes to it don't reach the system
+		 */
+		virtual Particle GetParticle(const int index) const = 0;
+
+	public://bulk access, one array per attribute over [0, GetParticleCount())
+		virtual ParticleStorage&       GetParticleStorage() = 0;
+		virtual const ParticleStorage& GetParticleStorage() const = 0;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,103 @@
+/*
+ *  File:    NXQuadIndexBuffer.cpp
+ *
+ *  author:  张雄(zhang xiong, 1025679612@qq.com)
+ *  date:    2026_10_19
+ *  purpose: shared quad index buffer
+ */
+
+#include "NXQuadIndexBuffer.h"
+#include "../common/NXCore.h"
+#include "../common/NXLog.h"
+
+NX::QuadIndexBuffer& NX::QuadIndexBuffer::Instance() {
+	static QuadIndexBuffer SharedObject;
+	return SharedObject;
+}
+
+NX::QuadIndexBuffer::QuadIndexBuffer() {
+	m_pIndexBuffer = nullptr;
+	NXClearStruct(m_Statistics);
+}
+
+NX::QuadIndexBuffer::~QuadIndexBuffer() {
+	/**empty here, static destruction runs after the device is gone, DX9Window released the buffer*/
+}
+
+IDirect3DIndexBuffer9* NX::QuadIndexBuffer::Acquire(const int iQuadCount) {
+	if ((m_pIndexBuffer || !m_SystemIndexs.empty()) && iQuadCount <= m_Statistics.iQuadCapacity) {
+		return m_pIndexBuffer;
+	}
+
+	const int iCapacity = GetGrownCapacity(m_Statistics.iQuadCapacity, iQuadCount);
+	const UINT uBytes = (UINT)(sizeof(NXUInt32) * INDEXS_PER_QUAD * iCapacity);
+	if (glb_GetD3DDevice()) {
+		IDirect3DIndexBuffer9 *pIndexBuffer = nullptr;
+		//managed, the indices never change and survive a device reset
+		if (FAILED(glb_GetD3DDevice()->CreateIndexBuffer(uBytes, D3DUSAGE_WRITEONLY, D3DFMT_INDEX32, D3DPOOL_MANAGED, &pIndexBuffer, NULL))) {
+			glb_GetLog().logToConsole("QuadIndexBuffer: create index buffer of %d quads failed", iCapacity);
+			return nullptr;
+		}
+		NXUInt32 *pIndexs = nullptr;
+		if (FAILED(pIndexBuffer->Lock(0, 0, (void**)&pIndexs, 0))) {
+			glb_GetLog().logToConsole("QuadIndexBuffer: lock index buffer failed");
+			NXSafeRelease(pIndexBuffer);
+			return nullptr;
+		}
+		FillQuadIndexs(pIndexs, 0, iCapacity);
+		pIndexBuffer->Unlock();
+		NXSafeRelease(m_pIndexBuffer);
+		m_pIndexBuffer = pIndexBuffer;
+	} else {//tools and tests run without device, the image grows the same way
+		m_SystemIndexs.resize(INDEXS_PER_QUAD * iCapacity);
+		FillQuadIndexs(&m_SystemIndexs[0], 0, iCapacity);
+	}
+
+	m_Statistics.iQuadCapacity        = iCapacity;
+	m_Statistics.uIndexUploadBytes   += uBytes;
+	++m_Statistics.iGrowCount;
+	return m_pIndexBuffer;
+}
+
+const NXUInt32* NX::QuadIndexBuffer::GetSystemIndexs() const {
+	return m_SystemIndexs.empty() ? nullptr : &m_SystemIndexs[0];
+}
+
+void NX::QuadIndexBuffer::AddVertexUpload(const NXUInt64 uBytes) {
+	m_Statistics.uVertexUploadBytes += uBytes;
+}
+
+void NX::QuadIndexBuffer::ResetUploadCounters() {
+	m_Statistics.uIndexUploadBytes  = 0;
+	m_Statistics.uVertexUploadBytes = 0;
+}
+
+void NX::QuadIndexBuffer::Release() {
+	NXSafeRelease(m_pIndexBuffer);
+	std::vector<NXUInt32>().swap(m_SystemIndexs);
+	m_Statistics.iQuadCapacity = 0;
+}
+
+const NX::QuadIndexBuffer::Statistics& NX::QuadIndexBuffer::GetStatistics() const {
+	return m_Statistics;
+}
+
+void NX::QuadIndexBuffer::FillQuadIndexs(NXUInt32 *pIndexs, const int iFirstQuad, const int iQuadCount) {
+	for (int q = iFirstQuad; q < iFirstQuad + iQuadCount; ++q, pIndexs += INDEXS_PER_QUAD) {
+		const NXUInt32 uFirst = (NXUInt32)q * VERTEXS_PER_QUAD;
+		pIndexs[0] = uFirst;
+		pIndexs[1] = uFirst + 1;
+		pIndexs[2] = uFirst + 2;
+		pIndexs[3] = uFirst;
+		pIndexs[4] = uFirst + 2;
+		pIndexs[5] = uFirst + 3;
+	}
+}
+
+int NX::QuadIndexBuffer::GetGrownCapacity(const int iCapacity, const int iQuadCount) {
+	int iResult = iCapacity < MIN_QUAD_CAPACITY ? (int)MIN_QUAD_CAPACITY : iCapacity;
+	while (iResult < iQuadCount) {
+		iResult *= 2;
+	}
+	return iResult;
+}
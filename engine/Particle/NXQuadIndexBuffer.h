@@ -0,0 +1,81 @@
+/*
+ *  File:    NXQuadIndexBuffer.h
+ *
+ *  author:  张雄(zhang xiong, 1025679612@qq.com)
+ *  date:    2026_10_19
+ *  purpose: one process wide index buffer for quad lists, quad q always uses 4q, 4q + 1, 4q + 2, 4q, 4q + 2,
+ *           4q + 3. the indices are written once when the buffer grows and every particle system draws
+ *           with it, so a frame only uploads vertices. grows to the next power of two, never shrinks.
+ *           the upload counters let headless code check what a frame costs: with the 24 byte Particle::Vertex
+ *           a quad uploads 96 vertex bytes, rewriting its 24 index bytes every frame would only add 20%.
+ *           without device, for tools and tests, the indices grow in system memory and count the same.
+ *           the owner of the device calls Release before releasing the device, the singleton itself outlives
+ *           it and never touches D3D on exit.
+ */
+
+#pragma once
+
+#include <d3d9.h>
+#include <vector>
+
+#include "../common/NXType.h"
+
+namespace NX {
+	IDirect3DDevice9 * glb_GetD3DDevice();
+
+	class QuadIndexBuffer {
+	public:
+		enum {
+			INDEXS_PER_QUAD   = 6,
+			VERTEXS_PER_QUAD  = 4,
+			MIN_QUAD_CAPACITY = 1024,
+		};
+
+		struct Statistics {
+			NXUInt64    uIndexUploadBytes;       // written into the shared buffer, only when it grows
+			NXUInt64    uVertexUploadBytes;      // reported by the systems through AddVertexUpload
+			int         iQuadCapacity;
+			int         iGrowCount;
+		};
+
+	public:
+		static QuadIndexBuffer& Instance();
+
+	private:
+		QuadIndexBuffer();
+		QuadIndexBuffer(const QuadIndexBuffer&) = delete;
+		QuadIndexBuffer& operator=(const QuadIndexBuffer&) = delete;
+		~QuadIndexBuffer();
+
+	public:
+		/**
+		 *  the shared D3DFMT_INDEX32 buffer with at least iQuadCount quads, nullptr if it can't be created.
+		 *  the pointer changes when the buffer grows, ask again every frame. always nullptr without device.
+		 */
+		IDirect3DIndexBuffer9*  Acquire(const int iQuadCount);
+		const NXUInt32*         GetSystemIndexs() const;        // the indices grown without device, else nullptr
+		void                    AddVertexUpload(const NXUInt64 uBytes);
+		void                    ResetUploadCounters();
+		/**
+		 *  frees the buffer, call it before the device goes away. the next Acquire creates it again
+		 */
+		void                    Release();
+		const Statistics&       GetStatistics() const;
+
+	public:
+		/**
+		 *  the indices of quads [iFirstQuad, iFirstQuad + iQuadCount)
+		 */
+		static void FillQuadIndexs(NXUInt32 *pIndexs, const int iFirstQuad, const int iQuadCount);
+
+		/**
+		 *  capacity after a request for iQuadCount quads, doubling from MIN_QUAD_CAPACITY
+		 */
+		static int  GetGrownCapacity(const int iCapacity, const int iQuadCount);
+
+	private:
+		IDirect3DIndexBuffer9   *m_pIndexBuffer;
+		std::vector<NXUInt32>   m_SystemIndexs;          // index buffer image without device
+		Statistics              m_Statistics;
+	};
+}
@@ -6,13 +6,18 @@
  *  purpose: define snow particle system
  */
 
+#include <cmath>
+
 #include "NXSnowParticleSystem.h"
 #include "NXParticle.h"
+#include "NXQuadIndexBuffer.h"
 #include "../render/NXCamera.h"
 #include "../render/NXEffectManager.h"
 #include "../render/NXDX9TextureManager.h"
 #include "../math/NXAlgorithm.h"
 #include "../render/NXEngine.h"
+#include "../common/NXParallel.h"
+#include "../common/NXLog.h"
 
 NX::SnowParticleSystem::SnowParticleSystem(const MVMatrixController *pMoveController, const float _fRadius, const float _fIgnoreRadius, const int _ParticleCount, const std::vector<std::string> &_TextureFileSet): m_TextureSet(_TextureFileSet) {
 	m_MoveController      =    const_cast<MVMatrixController*>(pMoveController);
@@ -20,84 +25,113 @@ NX::SnowParticleSystem::SnowParticleSystem(const MVMatrixController *pMoveContro
 	m_fRadiusSquare       =    m_fRadius * m_fRadius;
 	m_fIgnoreRadius       =    _fIgnoreRadius;
 	m_BufferSize          =    0;
-	m_Particles.clear();
+	m_uSeed               =    0;
+	m_iWorkerCount        =    1;
+	m_iRespawnCount       =    0;
+	m_uTickCount          =    0;
+	m_fEmitDebt           =    0.f;
+	m_Random.Seed(m_uSeed, 0);
+	m_Expander.SetMode(BillboardExpander::MODE_FREE_ROTATION);
+
+	{//the built in snow, EngineResouces/Particle/Snow/Snow.emitter ships the rest of it, the radii stay the constructor's
+		EmitterDefinition::Parameters &Snow = m_Emitter.GetParameters();
+		Snow.eShape             = EmitterDefinition::SHAPE_SPHERE;
+		Snow.fInnerRadius       = m_fIgnoreRadius;
+		Snow.fOuterRadius       = m_fRadius;
+		Snow.VelocityMin        = float3(-0.3f, -0.4f, -0.3f);
+		Snow.VelocityMax        = float3(0.3f, -0.2f, 0.3f);
+		Snow.RotationMin        = float3(-kfPi, -kfPi, -kfPi);
+		Snow.RotationMax        = float3(kfPi, kfPi, kfPi);
+		Snow.AngularVelocityMin = float3(-1.f, -1.f, -1.f);
+		Snow.AngularVelocityMax = float3(1.f, 1.f, 1.f);
+		Snow.fLifeTimeMin       = 0.f;
+		Snow.fLifeTimeMax       = 100000.f;
+		Snow.fSizeMin           = 0.005f;
+		Snow.fSizeMax           = 0.01f;
+	}
 
-	m_pIndexBuffer        = nullptr;
 	m_pVertexBuffer       = nullptr;
 	m_pEffect             = nullptr;
 	m_pVertexDesc         = nullptr;
 
-	const char *pszEffectFilePath = "Shaders/DirectX/Particle_Effect.hlsl";
-	m_pEffect = NX::EffectManager::Instance().GetEffect(pszEffectFilePath);
-
 	IDirect3DDevice9 *pDevice = glb_GetD3DDevice();
-
-	D3DVERTEXELEMENT9 VertexDesc[] = {
-		{ 0, CLS_MEM_OFFSET(NX::Particle::Vertex, x), D3DDECLTYPE_FLOAT3, D3DDECLMETHOD_DEFAULT, D3DDECLUSAGE_POSITION, 0 },
-		{ 0, CLS_MEM_OFFSET(NX::Particle::Vertex, u), D3DDECLTYPE_FLOAT2, D3DDECLMETHOD_DEFAULT, D3DDECLUSAGE_TEXCOORD, 0 },
-		D3DDECL_END(),
-	};
-
-	pDevice->CreateVertexDeclaration(VertexDesc, &m_pVertexDesc);
+	if (pDevice) {//tools and tests simulate snow without device, nothing is drawn then
+		const char *pszEffectFilePath = "Shaders/DirectX/Particle_Effect.hlsl";
+		m_pEffect = NX::EffectManager::Instance().GetEffect(pszEffectFilePath);
+
+		D3DVERTEXELEMENT9 VertexDesc[] = {
+			{ 0, CLS_MEM_OFFSET(NX::Particle::Vertex, x), D3DDECLTYPE_FLOAT3, D3DDECLMETHOD_DEFAULT, D3DDECLUSAGE_POSITION, 0 },
+			{ 0, CLS_MEM_OFFSET(NX::Particle::Vertex, u), D3DDECLTYPE_FLOAT2, D3DDECLMETHOD_DEFAULT, D3DDECLUSAGE_TEXCOORD, 0 },
+			{ 0, CLS_MEM_OFFSET(NX::Particle::Vertex, color), D3DDECLTYPE_D3DCOLOR, D3DDECLMETHOD_DEFAULT, D3DDECLUSAGE_COLOR, 0 },
+			D3DDECL_END(),
+		};
+
+		pDevice->CreateVertexDeclaration(VertexDesc, &m_pVertexDesc);
+		if (m_TextureSet.size() > 1) {
+			m_Atlas.Build(pDevice, m_TextureSet);
+		}
+	}
 
 	if (m_MoveController) {
 		GetTransform().SetTranslation(m_MoveController->GetEyePosition());
 	}
 
-	NX::Particle *pParticle = nullptr;
+	m_Particles.Reserve(_ParticleCount);
 	for (int i = 0; i < _ParticleCount; ++i) {
-		pParticle = new Particle();
-		ResetParticle(pParticle);
-		AddParticle(pParticle);
+		EmitParticle();
 	}
 }
 
 NX::SnowParticleSystem::~SnowParticleSystem() {
 	NX::NXSafeRelease(m_pVertexDesc);
 	NX::NXSafeRelease(m_pVertexBuffer);
-	NX::NXSafeRelease(m_pIndexBuffer);
 	NX::NXSafeRelease(m_pEffect);
-
-	for (int i = 0; i < m_Particles.size(); ++i) {
-		delete m_Particles[i];
-	}
-	m_Particles.clear();
 }
 
 
 void NX::SnowParticleSystem::Render(struct RenderParameter &renderer) {
 	UINT uPasses = 0;
-	Particle *pParticle = nullptr;
 	IDirect3DDevice9 *pDevice = renderer.pDXDevice;
 	char *pVB = nullptr;
-	char *pIB = nullptr;
 	int LiveParticleCount = 0;
-	m_pVertexBuffer->Lock(0, 0, (void**)&pVB, D3DLOCK_DISCARD);
-	m_pIndexBuffer->Lock(0, 0, (void**)&pIB, D3DLOCK_DISCARD);
-
-	for (int idx = 0; idx < m_Particles.size(); ++idx) {
-		pParticle = m_Particles[idx];
-		if (!pParticle || pParticle->IsDied()) {
-			continue;
-		}
+	ResizeBuffer(m_Particles.GetHighWaterMark());
+	if (!m_pVertexBuffer || FAILED(m_pVertexBuffer->Lock(0, 0, (void**)&pVB, D3DLOCK_DISCARD))) {
+		return;
+	}
+	const float3 Front = m_MoveController->GetFrontAxis();
+	m_DepthSort.Sort(m_Particles, nullptr, m_MoveController->GetEyePosition(), Front);
+	const EmitterDefinition::Parameters &Emitter = m_Emitter.GetParameters();
+	m_Expander.SetCameraAxes(m_MoveController->GetRightAxis(), m_MoveController->GetUpAxis(), Front);
+	m_Expander.SetSizeCurve(Emitter.bCurveConstant[EmitterDefinition::CURVE_SIZE] ? nullptr : Emitter.Curves[EmitterDefinition::CURVE_SIZE], EmitterDefinition::CURVE_SAMPLES + 1);
+	m_Expander.SetAlphaCurve(Emitter.bCurveConstant[EmitterDefinition::CURVE_ALPHA] ? nullptr : Emitter.Curves[EmitterDefinition::CURVE_ALPHA], EmitterDefinition::CURVE_SAMPLES + 1);
+	m_Expander.SetUVRects(m_Atlas.GetUVRects(), m_Atlas.GetRectCount());
+	LiveParticleCount = m_Expander.Expand(m_Particles, m_DepthSort.GetOrder(), m_DepthSort.GetOrderCount(), (Particle::Vertex*)pVB, m_BufferSize);
+	m_pVertexBuffer->Unlock();
 
-		pVB += pParticle->FillVertexBuffer(pVB);
-		pIB += pParticle->FillIndexBuffer(pIB, LiveParticleCount << 2);
-		++LiveParticleCount;
+	//the indices never change, only the vertices are uploaded
+	QuadIndexBuffer &SharedIndexs = QuadIndexBuffer::Instance();
+	IDirect3DIndexBuffer9 *pIndexBuffer = SharedIndexs.Acquire(LiveParticleCount);
+	SharedIndexs.AddVertexUpload((NXUInt64)LiveParticleCount * QuadIndexBuffer::VERTEXS_PER_QUAD * sizeof(Particle::Vertex));
+	if (!pIndexBuffer || !LiveParticleCount) {
+		return;
 	}
 
-	m_pVertexBuffer->Unlock();
-	m_pIndexBuffer->Unlock();
 	m_pEffect->SetMatrixTranspose(m_pEffect->GetParameterByName(NULL, "VPMatrix"), (D3DXMATRIX*)(&renderer.pProjectController->GetWatchMatrix()));
-	m_pEffect->SetTexture(m_pEffect->GetParameterByName(NULL, "ParticleTexture"), NX::DX9TextureManager::Instance().GetTexture(m_TextureSet[m_Particles[0]->GetTextureIndex()]));
+	{//every texture index in one draw through the atlas, a single texture is bound as it is
+		IDirect3DTexture9 *pTexture = m_Atlas.GetTexture();
+		if (!pTexture && !m_TextureSet.empty()) {
+			pTexture = NX::DX9TextureManager::Instance().GetTexture(m_TextureSet[0]);
+		}
+		m_pEffect->SetTexture(m_pEffect->GetParameterByName(NULL, "ParticleTexture"), pTexture);
+	}
 	m_pEffect->SetTechnique(m_pEffect->GetTechniqueByName("ParticleShader"));
 	m_pEffect->Begin(&uPasses, 0);
 	for (int i = 0; i < uPasses; ++i) {
 		m_pEffect->BeginPass(i);
 		pDevice->SetStreamSource(0, m_pVertexBuffer, 0, sizeof(NX::Particle::Vertex));
-		pDevice->SetIndices(m_pIndexBuffer);
+		pDevice->SetIndices(pIndexBuffer);
 		pDevice->SetVertexDeclaration(m_pVertexDesc);
-		pDevice->DrawIndexedPrimitive(D3DPT_TRIANGLELIST, 0, 0, LiveParticleCount * 6, 0, LiveParticleCount * 2);
+		pDevice->DrawIndexedPrimitive(D3DPT_TRIANGLELIST, 0, 0, LiveParticleCount * QuadIndexBuffer::VERTEXS_PER_QUAD, 0, LiveParticleCount * 2);
 		m_pEffect->EndPass();
 	}
 	m_pEffect->End();
@@ -105,17 +139,62 @@ void NX::SnowParticleSystem::Render(struct RenderParameter &renderer) {
 
 void NX::SnowParticleSystem::OnTick(const float fDeleta) {
 	GetTransform().SetTranslation(m_MoveController->GetEyePosition());
-	Particle *pParticle = nullptr;
-	for (int i = 0; i < m_Particles.size(); ++i) {
-		pParticle = m_Particles[i];
-		if (!pParticle) {
-			continue;
-		} else if (pParticle->IsDied() || !InShpere(pParticle)) {
-			ResetParticle(pParticle);
-		} else {
-			pParticle->OnTick(fDeleta);
+	const int iPartCount = m_iWorkerCount > 0 ? m_iWorkerCount : GetHardwareThreadCount();
+	const NXUInt64 uTickSeed = m_uSeed + m_uTickCount++ * 0x9E3779B97F4A7C15ULL;
+	m_RespawnCounts.assign(iPartCount, 0);
+	m_DeadMask.resize(m_Particles.GetDeadMaskSize() + 1);
+
+	//ranges start on a cache line of every stream and own whole bytes of the death mask, workers never
+	//write the same line and only the respawn counters are merged after the join
+	const EmitterDefinition::Parameters &Emitter = m_Emitter.GetParameters();
+	const float fDragScale = Emitter.fDrag > 0.f ? std::exp(-Emitter.fDrag * fDeleta) : 1.f;
+	ParallelFor(0, m_Particles.GetCount(), iPartCount, [&](const int iBegin, const int iEnd, const int iPart) {
+		if (iBegin >= iEnd) {
+			return;
+		}
+		if (fDragScale != 1.f) {
+			float *pvx = m_Particles.GetStream(ParticleStorage::VELOCITY_X), *pvy = m_Particles.GetStream(ParticleStorage::VELOCITY_Y), *pvz = m_Particles.GetStream(ParticleStorage::VELOCITY_Z);
+			for (int i = iBegin; i < iEnd; ++i) {
+				pvx[i] *= fDragScale, pvy[i] *= fDragScale, pvz[i] *= fDragScale;
+			}
 		}
+		if (!Emitter.bCurveConstant[EmitterDefinition::CURVE_SPEED]) {//Integrate moves by VELOCITY * fDeleta, the curve's part beyond 1 goes first
+			float *px = m_Particles.GetStream(ParticleStorage::POSITION_X), *py = m_Particles.GetStream(ParticleStorage::POSITION_Y), *pz = m_Particles.GetStream(ParticleStorage::POSITION_Z);
+			const float *pvx = m_Particles.GetStream(ParticleStorage::VELOCITY_X), *pvy = m_Particles.GetStream(ParticleStorage::VELOCITY_Y), *pvz = m_Particles.GetStream(ParticleStorage::VELOCITY_Z);
+			const float *pAge = m_Particles.GetStream(ParticleStorage::AGE), *pLife = m_Particles.GetStream(ParticleStorage::LIFE_TIME);
+			for (int i = iBegin; i < iEnd; ++i) {
+				const float fStep = (m_Emitter.EvaluateCurve(EmitterDefinition::CURVE_SPEED, pAge[i] / pLife[i]) - 1.f) * fDeleta;
+				px[i] += pvx[i] * fStep, py[i] += pvy[i] * fStep, pz[i] += pvz[i] * fStep;
+			}
+		}
+		m_Particles.Integrate(iBegin, iEnd, fDeleta, Emitter.Acceleration, Emitter.AngularAcceleration, &m_DeadMask[0]);
+		if (!m_Collider.IsEmpty()) {
+			m_Collider.Collide(m_Particles, iBegin, iEnd, &m_DeadMask[0]);
+		}
+		int iRespawnCount = 0;
+		for (int i = iBegin; i < iEnd; ++i) {
+			const bool bDead = (m_DeadMask[i / ParticleStorage::DEAD_MASK_GROUP] >> (i % ParticleStorage::DEAD_MASK_GROUP)) & 1;
+			if (bDead || !InShpere(i)) {//seeding is two steps of the generator, cheap next to the spawn itself
+				Random random(uTickSeed, 1 + (NXUInt64)i);
+				Respawn(i, random);
+				++iRespawnCount;
+			}
+		}
+		m_RespawnCounts[iPart] = iRespawnCount;
+	}, ParticleStorage::STREAM_ALIGNMENT);
+
+	m_iRespawnCount = 0;
+	for (int i = 0; i < iPartCount; ++i) {
+		m_iRespawnCount += m_RespawnCounts[i];
 	}
+
+	//Rate adds particles until MaxCount or a full pool, no backlog is kept while capped
+	m_fEmitDebt += Emitter.fRate * fDeleta;
+	while (m_fEmitDebt >= 1.f && m_Particles.GetCount() < Emitter.iMaxCount && (m_Particles.IsGrowable() || !m_Particles.IsFull())) {
+		EmitParticle();
+		m_fEmitDebt -= 1.f;
+	}
+	m_fEmitDebt = NXMin(m_fEmitDebt, 1.f);
 }
 
 NX::ENTITY_TYPE  NX::SnowParticleSystem::GetEntityType() {
@@ -124,96 +203,139 @@ NX::ENTITY_TYPE  NX::SnowParticleSystem::GetEntityType() {
 
 
 NX::SnowParticleSystem& NX::SnowParticleSystem::EmitParticle() {
-	Particle * pParticle = new NX::Particle();
-	ResetParticle(pParticle);
-	return AddParticle(pParticle);
+	const float3 Zero(0.f, 0.f, 0.f);
+	const int i = m_Particles.Add(Zero, Zero, Zero, Zero, 0.f, float2(0.f, 0.f), 0);
+	return ResetParticle(i);//-1 when a fixed pool is full
 }
 
-NX::SnowParticleSystem& NX::SnowParticleSystem::AddParticle(Particle *pParticle) {
-	NXAssert(pParticle);
-	if (pParticle) {
-		m_Particles.push_back(pParticle);
-		ResizeBuffer();
-	}
+NX::SnowParticleSystem& NX::SnowParticleSystem::AddParticle(const Particle &particle) {
+	m_Particles.Add(particle.GetPosition(), particle.GetVelocity(), particle.GetRotation(), particle.GetAngularVelocity(), particle.GetLiveTime() - particle.GetTimeElapsed(), particle.GetSize(), particle.GetTextureIndex());
 	return *this;
 }
 
-NX::SnowParticleSystem& NX::SnowParticleSystem::ResetParticle(Particle *pParticle) {
-	if (!pParticle) {
-		return *this;
+NX::SnowParticleSystem& NX::SnowParticleSystem::ResetParticle(const int iParticleIndex) {
+	if (iParticleIndex >= 0 && iParticleIndex < m_Particles.GetCount()) {
+		Respawn(iParticleIndex, m_Random);
 	}
+	return *this;
+}
 
-	int _TextureIndex = RandIntInRange(0, m_TextureSet.size() - 1);
-	float3 _Rotation = float3(RandFloatInRange(-kfPi, kfPi), RandFloatInRange(-kfPi, kfPi), RandFloatInRange(-kfPi, kfPi));
-	float3 _Position;
-	{
-		float u = NX::RandFloatInRange(0, kfPi);
-		float v = NX::RandFloatInRange(0, kf2Pi);
-		float r = NX::RandFloatInRange(m_fIgnoreRadius, m_fRadius);
-		_Position.y = std::cosf(u);
-		_Position.x = std::sinf(u) * std::cosf(v);
-		_Position.z = std::sinf(u) * std::sinf(v);
-		_Position *= r;
-		_Position += GetTransform().GetTranslation();
+void NX::SnowParticleSystem::Respawn(const int iParticleIndex, Random &random) {
+	m_Emitter.Spawn(m_Particles, iParticleIndex, GetTransform().GetTranslation(), (int)m_TextureSet.size(), random);
+}
+
+NX::SnowParticleSystem& NX::SnowParticleSystem::RemoveParticle(const int iParticleIndex) {
+	if (iParticleIndex >= 0 && iParticleIndex < m_Particles.GetCount()) {
+		m_Particles.Remove(iParticleIndex);
 	}
-	float3 _Acceleration = float3(0.f, 0.f, 0.f);
-	float3 _AngularAcceleration = float3(0.f, 0.f, 0.f);
-	float3 _Velocity = float3(RandFloatInRange(-0.3f, 0.3f), -RandFloatInRange(0.2f, 0.4f), RandFloatInRange(-0.3f, 0.3f));
-	float3 _AngularVelocity = float3(RandFloatInRange(-1.f, 1.f), RandFloatInRange(-1.f, 1.f), RandFloatInRange(-1.f, 1.f));
-	float _LiveTime = RandFloatInRange(0.f, 100000.f);
-	float _Size = RandFloatInRange(0.005, 0.01);
+	return *this;
+}
+
+int NX::SnowParticleSystem::GetParticleCount()const {
+	return m_Particles.GetCount();
+}
 
-	pParticle->SetTextureIndex(_TextureIndex).SetRotation(_Rotation).SetPosition(_Position).SetAcceleration(_Acceleration).
-		SetAngularAcceleration(_AngularAcceleration).SetVelocity(_Velocity).SetAngularVelocity(_AngularVelocity).
-		SetLiveTime(_LiveTime).SetSize(float2(_Size, _Size)).SetDied(false);
+NX::Particle NX::SnowParticleSystem::GetParticle(const int index) const {
+	NXAssert(index < m_Particles.GetCount() && index >= 0);
+	const float fAge = m_Particles.GetStream(ParticleStorage::AGE)[index], fLifeTime = m_Particles.GetStream(ParticleStorage::LIFE_TIME)[index];
+	const float3 Zero(0.f, 0.f, 0.f);
+	return Particle(m_Particles.GetTextureIndexs()[index], m_Particles.GetRotation(index), m_Particles.GetPosition(index), Zero, Zero,
+		m_Particles.GetVelocity(index), m_Particles.GetAngularVelocity(index), fLifeTime - fAge, m_Particles.GetSize(index));
+}
+
+NX::ParticleStorage& NX::SnowParticleSystem::GetParticleStorage() {
+	return m_Particles;
+}
+
+const NX::ParticleStorage& NX::SnowParticleSystem::GetParticleStorage() const {
+	return m_Particles;
+}
 
+NX::SnowParticleSystem& NX::SnowParticleSystem::SetSeed(const NXUInt32 uSeed) {
+	m_uSeed = uSeed;
+	m_Random.Seed(m_uSeed, 0);
+	m_uTickCount = 0;
 	return *this;
 }
 
-NX::SnowParticleSystem& NX::SnowParticleSystem::RemoveParticle(const int iParticleIndex) {
-	if (iParticleIndex >= 0 && iParticleIndex < m_Particles.size()) {
-		delete m_Particles[iParticleIndex];
-		m_Particles.erase(m_Particles.begin() + iParticleIndex);
-	}
+NX::SnowParticleSystem& NX::SnowParticleSystem::SetWorkerCount(const int iWorkerCount) {
+	m_iWorkerCount = iWorkerCount;
+	m_DepthSort.SetWorkerCount(iWorkerCount);
 	return *this;
 }
 
-int NX::SnowParticleSystem::GetParticleCount()const {
-	return m_Particles.size();
+NXUInt32 NX::SnowParticleSystem::GetSeed() const {
+	return m_uSeed;
 }
 
-NX::Particle* NX::SnowParticleSystem::GetParticle(const int index) {
-	NXAssert(index < m_Particles.size() &&index >= 0);
-	if (index < m_Particles.size() && index >= 0) {
-		return m_Particles[index];
-	}
-	return index < m_Particles.size() && index >= 0 ? m_Particles[index] : nullptr;
+int NX::SnowParticleSystem::GetWorkerCount() const {
+	return m_iWorkerCount;
 }
 
-const NX::Particle* NX::SnowParticleSystem::GetParticle(const int index) const {
-	NXAssert(index < m_Particles.size() && index >= 0);
-	if (index < m_Particles.size() && index >= 0) {
-		return m_Particles[index];
-	}
-	return index < m_Particles.size() && index >= 0 ? m_Particles[index] : nullptr;
+bool NX::SnowParticleSystem::LoadEmitter(const std::string &strFilePath) {
+	return m_Emitter.LoadFromFile(strFilePath);
 }
 
-bool NX::SnowParticleSystem::InShpere(const Particle *pParticle) {
-	NXAssert(pParticle);
-	if (!pParticle) {
-		return true;
-	}
+bool NX::SnowParticleSystem::LoadAtlas(const std::string &strAtlasFilePath) {
+	return m_Atlas.Load(glb_GetD3DDevice(), strAtlasFilePath);
+}
+
+const NX::ParticleAtlas& NX::SnowParticleSystem::GetAtlas() const {
+	return m_Atlas;
+}
+
+NX::ParticleCollider& NX::SnowParticleSystem::GetCollider() {
+	return m_Collider;
+}
+
+const NX::ParticleCollider& NX::SnowParticleSystem::GetCollider() const {
+	return m_Collider;
+}
+
+NX::EmitterDefinition& NX::SnowParticleSystem::GetEmitter() {
+	return m_Emitter;
+}
+
+const NX::EmitterDefinition& NX::SnowParticleSystem::GetEmitter() const {
+	return m_Emitter;
+}
 
-	return NX::LengthSquare(pParticle->GetPosition() - GetTransform().GetTranslation()) <= m_fRadiusSquare / 4;
+int NX::SnowParticleSystem::GetRespawnCount() const {
+	return m_iRespawnCount;
 }
 
-void NX::SnowParticleSystem::ResizeBuffer() {
-	if (m_BufferSize < m_Particles.size() || m_BufferSize > 2 * m_Particles.size() + 1) {
-		NX::NXSafeRelease(m_pVertexBuffer);
-		NX::NXSafeRelease(m_pIndexBuffer);
-		m_BufferSize = 2 * m_Particles.size() + 1;
-		IDirect3DDevice9 *pDevice = glb_GetD3DDevice();
-		pDevice->CreateIndexBuffer(m_BufferSize * sizeof(int) * 6,                   D3DUSAGE_WRITEONLY, D3DFMT_INDEX32, D3DPOOL_DEFAULT, &m_pIndexBuffer,  NULL);
-		pDevice->CreateVertexBuffer(m_BufferSize * sizeof(NX::Particle::Vertex) * 4, D3DUSAGE_WRITEONLY, 0,              D3DPOOL_DEFAULT, &m_pVertexBuffer, NULL);
+bool NX::SnowParticleSystem::InShpere(const int iParticleIndex) const {
+	return NX::LengthSquare(m_Particles.GetPosition(iParticleIndex) - GetTransform().GetTranslation()) <= m_fRadiusSquare / 4;
+}
+
+void NX::SnowParticleSystem::OnLostDevice() {
+	//the dynamic vertex buffer lives in D3DPOOL_DEFAULT and must be gone before the device resets,
+	//m_BufferSize keeps its capacity so OnResetDevice creates the same size again
+	NX::NXSafeRelease(m_pVertexBuffer);
+}
+
+void NX::SnowParticleSystem::OnResetDevice() {
+	ResizeBuffer(NXMax(m_BufferSize, m_Particles.GetHighWaterMark()));
+}
+
+void NX::SnowParticleSystem::ResizeBuffer(const int iQuadCount) {
+	if (m_pVertexBuffer && m_BufferSize >= iQuadCount) {
+		return;
+	}
+	//doubling toward the high water mark and never shrinking, bursts don't recreate the buffer every frame
+	int iBufferSize = NXMax(m_BufferSize, (int)MIN_BUFFER_SIZE);
+	while (iBufferSize < iQuadCount) {
+		iBufferSize *= 2;
+	}
+	NX::NXSafeRelease(m_pVertexBuffer);
+	m_BufferSize = 0;
+	IDirect3DDevice9 *pDevice = glb_GetD3DDevice();
+	if (!pDevice) {
+		return;
+	}
+	if (FAILED(pDevice->CreateVertexBuffer(iBufferSize * sizeof(NX::Particle::Vertex) * QuadIndexBuffer::VERTEXS_PER_QUAD, D3DUSAGE_DYNAMIC | D3DUSAGE_WRITEONLY, 0, D3DPOOL_DEFAULT, &m_pVertexBuffer, NULL))) {
+		glb_GetLog().logToConsole("SnowParticleSystem: create vertex buffer of %d quads failed", iBufferSize);
+		return;
 	}
+	m_BufferSize = iBufferSize;
 }
\ No newline at end of file
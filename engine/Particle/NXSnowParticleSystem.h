@@ -14,12 +14,24 @@
 #include <string>
 
 #include "NXParticleSystem.h"
+#include "NXParticleStorage.h"
+#include "NXBillboardExpander.h"
+#include "NXParticleDepthSort.h"
+#include "NXEmitterDefinition.h"
+#include "NXParticleAtlas.h"
+#include "NXParticleCollider.h"
+#include "../math/NXRandom.h"
 
 namespace NX {
 	IDirect3DDevice9 * glb_GetD3DDevice();
 	class MVMatrixController;
 
 	class SnowParticleSystem : public ParticleSystem {
+	public:
+		enum {
+			MIN_BUFFER_SIZE = 1024,
+		};
+
 	public:
 		SnowParticleSystem(const MVMatrixController *pMoveController, const float _fRadius, const float _fIgnoreRadius, const int _ParticleCount, const std::vector<std::string> &_TextureFileSet);
 		virtual ~SnowParticleSystem();
@@ -28,33 +40,84 @@ namespace NX {
 		virtual void Render(struct RenderParameter &renderer) override;
 		virtual void OnTick(const float fDeleta) override;
 		virtual ENTITY_TYPE GetEntityType() override;
+		virtual void OnLostDevice() override;
+		virtual void OnResetDevice() override;
 
 	public:
 		virtual SnowParticleSystem& EmitParticle() override;
-		virtual SnowParticleSystem& AddParticle(Particle *pParticle) override;
-		virtual SnowParticleSystem& ResetParticle(Particle *pParticle) override;
-		virtual SnowParticleSystem& RemoveParticle(const int iParticleIndex);
+		virtual SnowParticleSystem& AddParticle(const Particle &particle) override;
+		virtual SnowParticleSystem& ResetParticle(const int iParticleIndex) override;
+		virtual SnowParticleSystem& RemoveParticle(const int iParticleIndex) override;
 
 	public:
 		virtual int GetParticleCount() const override;
-		virtual Particle* GetParticle(const int index) override;
-		virtual const Particle* GetParticle(const int index) const override;
+		virtual Particle GetParticle(const int index) const override;
+		virtual ParticleStorage&       GetParticleStorage() override;
+		virtual const ParticleStorage& GetParticleStorage() const override;
+
+	public:
+		/**
+		 *  OnTick splits the particles into iWorkerCount cache line aligned ranges, <= 0 means every hardware
+		 *  thread. a particle respawned in OnTick draws from the Random stream of its index, seeded by the seed
+		 *  and the number of ticks, so a run is the same for a given seed whatever the worker count. SetSeed
+		 *  restarts the streams and the tick count, the particles that already exist are kept.
+		 */
+		SnowParticleSystem& SetSeed(const NXUInt32 uSeed);
+		SnowParticleSystem& SetWorkerCount(const int iWorkerCount);
+		NXUInt32            GetSeed() const;
+		int                 GetWorkerCount() const;
+		int                 GetRespawnCount() const;    // particles the last OnTick respawned
+
+		/**
+		 *  the emitter every particle is spawned from, built from the constructor's radii until a
+		 *  description is loaded. existing particles keep their values until they respawn.
+		 */
+		bool                      LoadEmitter(const std::string &strFilePath);
+		EmitterDefinition&        GetEmitter();
+		const EmitterDefinition&  GetEmitter() const;
+
+		/**
+		 *  with more than one texture the constructor packs them into an atlas so every texture index is
+		 *  drawn in one call, LoadAtlas replaces it with one packed offline by ParticleAtlas::Save. its rects
+		 *  must follow the order of the texture set.
+		 */
+		bool                      LoadAtlas(const std::string &strAtlasFilePath);
+		const ParticleAtlas&      GetAtlas() const;
+
+		/**
+		 *  OnTick collides every range right after integrating it, killed particles respawn in the same tick
+		 */
+		ParticleCollider&         GetCollider();
+		const ParticleCollider&   GetCollider() const;
 
 	private:
-		bool InShpere(const Particle *pParticle);
-		void ResizeBuffer();
+		bool InShpere(const int iParticleIndex) const;
+		void Respawn(const int iParticleIndex, Random &random);
+		void ResizeBuffer(const int iQuadCount);
 
 	private:
 		float                          m_fRadius;
 		float                          m_fRadiusSquare;
 		float                          m_fIgnoreRadius;
 		class MVMatrixController*      m_MoveController;
-		std::vector<class Particle*>   m_Particles;
-		IDirect3DIndexBuffer9          *m_pIndexBuffer;
+		ParticleStorage                m_Particles;
+		std::vector<NXUInt8>           m_DeadMask;
+		NXUInt32                       m_uSeed;
+		int                            m_iWorkerCount;
+		int                            m_iRespawnCount;
+		Random                         m_Random;           // stream 0, respawns outside OnTick
+		NXUInt64                       m_uTickCount;       // OnTick calls since SetSeed, seeds the streams 1 + particle index
+		std::vector<int>               m_RespawnCounts;    // per range, summed after the workers join
+		BillboardExpander              m_Expander;
+		ParticleDepthSort              m_DepthSort;        // back to front, the order of the last frame seeds the next
+		EmitterDefinition              m_Emitter;
+		float                          m_fEmitDebt;        // particles of the emitter's Rate not emitted yet
 		IDirect3DVertexBuffer9         *m_pVertexBuffer;
 		ID3DXEffect                    *m_pEffect;
 		std::vector<std::string>       m_TextureSet;
-		int                            m_BufferSize;
+		ParticleAtlas                  m_Atlas;            // empty for a single texture
+		ParticleCollider               m_Collider;
+		int                            m_BufferSize;       // quads in m_pVertexBuffer
 		IDirect3DVertexDeclaration9    *m_pVertexDesc;
 	};
 };
\ No newline at end of file
@@ -12,17 +12,20 @@ extern texture  ParticleTexture;
 struct VS_INPUT {
     vector position : POSITION;
     float2 texCoord	: TEXCOORD0;
+    float4 color    : COLOR0;
 };
 
 struct VS_OUTPUT {
     vector position : POSITION;
     float2 texCoord	: TEXCOORD0;
+    float4 color    : COLOR0;
 };
 
 
 struct PS_INTPUT {
     vector position : POSITION;
     float2 texCoord	: TEXCOORD0;
+    float4 color    : COLOR0;
 };
 
 struct PS_OUTPUT {
@@ -40,12 +43,13 @@ VS_OUTPUT VSMain(VS_INPUT input) {
 	VS_OUTPUT o = (VS_OUTPUT)0;
 	o.position  = mul(input.position, VPMatrix);
 	o.texCoord  = input.texCoord;
+	o.color     = input.color;
 	return o;
 }
 
 PS_OUTPUT PSMain(PS_INTPUT input) {
 	PS_OUTPUT o      = (PS_OUTPUT)0;
-	o.color          = tex2D(ParticleSampler, input.texCoord);
+	o.color          = tex2D(ParticleSampler, input.texCoord) * input.color;
 	return o;
 }
 
@@ -14,17 +14,19 @@ extern Matrix ProjectMatrix;    // View  => Project plane
 extern texture RoadTexture;     // road color
 extern texture GrassTexture;    // grass color
 extern texture NormalMap;       // normal map
+extern float4 ChunkParameter;   // first grid row, first grid col, height offset, height scale of the drawn chunk
+extern float2 GridSpacing;      // dx, dz
 
 struct VS_INPUT {
-    vector position : POSITION;
-    float2 texCoord	: TEXCOORD0;
-	float3 Normal   : NORMAL;
+    float4 grid     : TEXCOORD0;  // row and col inside the chunk, octahedral normal (x, z) in [0, 254]
+    float2 height   : POSITION;   // quantized height, occlusion in [0, 255]
 };
 
 struct VS_OUTPUT {
     vector position : POSITION;
     float2 texCoord	: TEXCOORD0;
 	float3 Normal   : NORMAL;
+	float  Occlusion: TEXCOORD1;
 };
 
 
@@ -32,6 +34,7 @@ struct PS_INTPUT {
     vector position : POSITION;
     float2 texCoord	: TEXCOORD0;
 	float3 Normal   : NORMAL;
+	float  Occlusion: TEXCOORD1;
 };
 
 struct PS_OUTPUT {
@@ -52,12 +55,25 @@ sampler2D GrassColorSampler = sampler_state {
 	MipFilter	= LINEAR;
 };
 
+float3 DecodeOctahedral(float2 e) {
+	float2 f = (e - 127.0) / 127.0;
+	float3 n = float3(f.x, 1.0 - abs(f.x) - abs(f.y), f.y);
+	if (n.y < 0) {
+		n.xz = (1.0 - abs(n.zx)) * (n.xz >= 0 ? 1.0 : -1.0);
+	}
+	return normalize(n);
+}
+
 VS_OUTPUT VSMain(VS_INPUT input) {
 	VS_OUTPUT o = (VS_OUTPUT)0;
 	Matrix MV   = mul(ModelMatrix , ViewMatrix);
 	Matrix MVP  = mul(MV, ProjectMatrix);
-	o.position  = mul(input.position, MVP);
-	o.texCoord  = input.texCoord;
+	float2 rc   = ChunkParameter.xy + input.grid.xy;
+	vector position = vector(rc.x * GridSpacing.x, ChunkParameter.z + input.height.x * ChunkParameter.w, rc.y * GridSpacing.y, 1.0);
+	o.position  = mul(position, MVP);
+	o.texCoord  = rc;
+	o.Normal    = mul(DecodeOctahedral(input.grid.zw), (float3x3)ModelMatrix);
+	o.Occlusion = input.height.y / 255.0;
 	return o;
 }
 
@@ -67,7 +83,7 @@ PS_OUTPUT PSMain(PS_INTPUT input) {
 
 	float3 GrassColor= tex2D(GrassColorSampler, input.texCoord);
 
-	o.color.rgb      = (RoadColor *0.9 + GrassColor * 0.1).rgb;
+	o.color.rgb      = (RoadColor *0.9 + GrassColor * 0.1).rgb * input.Occlusion;
 	return o;
 }
 
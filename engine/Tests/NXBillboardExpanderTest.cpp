@@ -0,0 +1,260 @@
+/*
+ *  File:    NXBillboardExpanderTest.cpp
+ *
+ *  author:  张雄(zhang xiong, 1025679612@qq.com)
+ *  date:    2026_10_19
+ *  purpose: BillboardExpander against Particle::FillVertexBuffer of the same particles: free rotation quads are
+ *           the rotated quads of every particle, camera facing and axis aligned quads are the quads of a particle
+ *           turned like the camera, corner order and texcoords included. the order overload writes the same
+ *           quads in the given order, an atlas squeezes the texcoords. NXBillboardExpanderBenchmark times 1M.
+ */
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "NXTestHeader.h"
+#include "../Particle/NXBillboardExpander.h"
+#include "../Particle/NXParticle.h"
+#include "../Particle/NXParticleStorage.h"
+#include "../math/NXAlgorithm.h"
+
+namespace {
+	const float TOLERANCE = 1e-4f;
+
+	/**
+	 *  the same random particles in both layouts, every fifth one dead by age. nothing has ticked so the
+	 *  storage's rotors are the particles' angles
+	 */
+	void Fill(NX::ParticleStorage &Storage, std::vector<NX::Particle> &Particles, const int iCount, const unsigned int uSeed) {
+		std::mt19937 Random(uSeed);
+		std::uniform_real_distribution<float> Unit(-1.f, 1.f), Size(0.2f, 3.f);
+		const NX::float3 Zero(0.f, 0.f, 0.f);
+		Storage.Clear();
+		Storage.Reserve(iCount);
+		Particles.clear();
+		Particles.reserve(iCount);
+		for (int i = 0; i < iCount; ++i) {
+			const NX::float3 Position(Unit(Random) * 50.f, Unit(Random) * 50.f, Unit(Random) * 50.f);
+			const NX::float3 Rotation(Unit(Random) * 3.f, Unit(Random) * 3.f, Unit(Random) * 3.f);
+			const NX::float2 QuadSize(Size(Random), Size(Random));
+			Storage.Add(Position, Zero, Rotation, Zero, 2.f, QuadSize, i % 3);
+			Particles.push_back(NX::Particle(i % 3, Rotation, Position, Zero, Zero, Zero, Zero, 2.f, QuadSize));
+			if (i % 5 == 4) {
+				Storage.GetStream(NX::ParticleStorage::AGE)[i] = 2.f;
+			}
+		}
+	}
+
+	bool SameQuad(const NX::Particle::Vertex *pQuad, const NX::Particle::Vertex *pReference) {
+		bool bSame = true;
+		for (int k = 0; k < 4; ++k) {
+			const NX::Particle::Vertex &a = pQuad[k], &b = pReference[k];
+			bSame = bSame && std::fabs(a.x - b.x) < TOLERANCE && std::fabs(a.y - b.y) < TOLERANCE && std::fabs(a.z - b.z) < TOLERANCE;
+			bSame = bSame && a.u == b.u && a.v == b.v && a.color == b.color;
+		}
+		return bSame;
+	}
+
+	/**
+	 *  the quads of the live particles by FillVertexBuffer, turned by Rotation instead of their own when
+	 *  bOwnRotation is false
+	 */
+	std::vector<NX::Particle::Vertex> GetReferenceQuads(std::vector<NX::Particle> Particles, const NX::ParticleStorage &Storage, const bool bOwnRotation, const NX::float3 &Rotation) {
+		std::vector<NX::Particle::Vertex> Quads;
+		NX::Particle::Vertex Quad[4];
+		for (int i = 0; i < (int)Particles.size(); ++i) {
+			if (Storage.IsDead(i)) {
+				continue;
+			}
+			if (!bOwnRotation) {
+				Particles[i].SetRotation(Rotation);
+			}
+			Particles[i].FillVertexBuffer(Quad);
+			Quads.insert(Quads.end(), Quad, Quad + 4);
+		}
+		return Quads;
+	}
+
+	/**
+	 *  the local x and y axes of a particle turned by Rotation, i.e. the camera's right and up when it's
+	 *  turned the same way
+	 */
+	void GetRotatedAxes(const NX::float3 &Rotation, NX::float3 &Right, NX::float3 &Up) {
+		const NX::float3 Zero(0.f, 0.f, 0.f);
+		NX::Particle::Vertex Quad[4];
+		NX::Particle(0, Rotation, Zero, Zero, Zero, Zero, Zero, 1.f, NX::float2(2.f, 2.f)).FillVertexBuffer(Quad);
+		Right = NX::float3(Quad[1].x - Quad[0].x, Quad[1].y - Quad[0].y, Quad[1].z - Quad[0].z) * .5f;
+		Up    = NX::float3(Quad[0].x - Quad[3].x, Quad[0].y - Quad[3].y, Quad[0].z - Quad[3].z) * .5f;
+	}
+}
+
+NX_TEST(NXBillboardExpanderTest) {
+	const int iCount = 1003;
+	NX::ParticleStorage Storage;
+	std::vector<NX::Particle> Particles;
+	Fill(Storage, Particles, iCount, 43);
+
+	const NX::float3 CameraRotation(0.4f, -1.1f, 0.3f);
+	NX::float3 Right, Up;
+	GetRotatedAxes(CameraRotation, Right, Up);
+	const NX::float3 Front = NX::Cross(Right, Up);
+
+	NX::BillboardExpander Expander;
+	Expander.SetCameraAxes(Right, Up, Front);
+	std::vector<NX::Particle::Vertex> Vertices(iCount * 4);
+	NX::BillboardExpander::Statistics Statistics;
+
+	{//free rotation, every particle's own quad
+		Expander.SetMode(NX::BillboardExpander::MODE_FREE_ROTATION);
+		const std::vector<NX::Particle::Vertex> Reference = GetReferenceQuads(Particles, Storage, true, CameraRotation);
+		const int iQuadCount = Expander.Expand(Storage, nullptr, &Vertices[0], iCount, &Statistics);
+		NX_TEST_CHECK(iQuadCount * 4 == (int)Reference.size() && iQuadCount == iCount - iCount / 5);
+		NX_TEST_CHECK(Statistics.iQuadCount == iQuadCount && Statistics.iDeadCount == iCount / 5);
+		NX_TEST_CHECK(Statistics.uVertexBytes == (NXUInt64)iQuadCount * 4 * sizeof(NX::Particle::Vertex));
+		bool bSame = true;
+		for (int q = 0; q < iQuadCount; ++q) {
+			bSame = bSame && SameQuad(&Vertices[q * 4], &Reference[q * 4]);
+		}
+		NX_TEST_CHECK(bSame);
+
+		//a death mask from a tick of 0 gives the same quads, iMaxQuads stops early
+		std::vector<NXUInt8> DeadMask(Storage.GetDeadMaskSize());
+		Storage.Integrate(0.f, NX::float3(0.f, 0.f, 0.f), NX::float3(0.f, 0.f, 0.f), &DeadMask[0]);
+		std::vector<NX::Particle::Vertex> Masked(iCount * 4);
+		NX_TEST_CHECK(Expander.Expand(Storage, &DeadMask[0], &Masked[0], iCount) == iQuadCount);
+		bool bMasked = true;
+		for (int q = 0; q < iQuadCount; ++q) {
+			bMasked = bMasked && SameQuad(&Masked[q * 4], &Vertices[q * 4]);
+		}
+		NX_TEST_CHECK(bMasked);
+		NX_TEST_CHECK(Expander.Expand(Storage, &DeadMask[0], &Masked[0], 10) == 10);
+	}
+
+	{//camera facing, the quad of a particle turned like the camera
+		Expander.SetMode(NX::BillboardExpander::MODE_CAMERA_FACING);
+		const std::vector<NX::Particle::Vertex> Reference = GetReferenceQuads(Particles, Storage, false, CameraRotation);
+		const int iQuadCount = Expander.Expand(Storage, nullptr, &Vertices[0], iCount);
+		NX_TEST_CHECK(iQuadCount * 4 == (int)Reference.size());
+		bool bSame = true;
+		for (int q = 0; q < iQuadCount; ++q) {
+			bSame = bSame && SameQuad(&Vertices[q * 4], &Reference[q * 4]);
+		}
+		NX_TEST_CHECK(bSame);
+	}
+
+	{//axis aligned along the camera's up is camera facing, along another axis the up edge follows it
+		Expander.SetMode(NX::BillboardExpander::MODE_AXIS_ALIGNED).SetAlignAxis(Up * 3.f);
+		const std::vector<NX::Particle::Vertex> Reference = GetReferenceQuads(Particles, Storage, false, CameraRotation);
+		const int iQuadCount = Expander.Expand(Storage, nullptr, &Vertices[0], iCount);
+		bool bSame = iQuadCount * 4 == (int)Reference.size();
+		for (int q = 0; q < iQuadCount; ++q) {
+			bSame = bSame && SameQuad(&Vertices[q * 4], &Reference[q * 4]);
+		}
+		NX_TEST_CHECK(bSame);
+
+		//the edges of a quad around its particle are the axis and the camera's right with the axis taken out
+		const NX::float3 Axis = NX::GetNormalized(NX::float3(0.f, 1.f, 0.f) + Front * .5f);
+		const NX::float3 EdgeX = NX::GetNormalized(Right - Axis * NX::Dot(Right, Axis));
+		Expander.SetAlignAxis(Axis);
+		NX_TEST_CHECK(Expander.Expand(Storage, nullptr, &Vertices[0], iCount) == iQuadCount);
+		const NX::float3 Zero(0.f, 0.f, 0.f);
+		bool bAligned = true;
+		for (int i = 0, q = 0; i < iCount; ++i) {
+			if (Storage.IsDead(i)) {
+				continue;
+			}
+			NX::Particle::Vertex Local[4];
+			NX::Particle(0, Zero, Zero, Zero, Zero, Zero, Zero, 1.f, Particles[i].GetSize()).FillVertexBuffer(Local);
+			const NX::float3 Position = Storage.GetPosition(i);
+			NX::Particle::Vertex Expected[4];
+			for (int k = 0; k < 4; ++k) {
+				const NX::float3 p = Position + EdgeX * Local[k].x + Axis * Local[k].y;
+				Expected[k] = NX::Particle::Vertex(p.x, p.y, p.z, Local[k].u, Local[k].v);
+			}
+			bAligned = bAligned && SameQuad(&Vertices[q++ * 4], Expected);
+		}
+		NX_TEST_CHECK(bAligned);
+	}
+
+	{//the order overload writes the same quads in the given order, an atlas squeezes the texcoords
+		Expander.SetMode(NX::BillboardExpander::MODE_FREE_ROTATION);
+		std::vector<NXUInt32> Order;
+		for (int i = iCount - 1; i >= 0; --i) {
+			if (!Storage.IsDead(i)) {
+				Order.push_back((NXUInt32)i);
+			}
+		}
+		const std::vector<NX::Particle::Vertex> Reference = GetReferenceQuads(Particles, Storage, true, CameraRotation);
+		const int iOrderCount = (int)Order.size();
+		NX_TEST_CHECK(Expander.Expand(Storage, &Order[0], iOrderCount, &Vertices[0], iCount, &Statistics) == iOrderCount);
+		NX_TEST_CHECK(Statistics.iQuadCount == iOrderCount && Statistics.iDeadCount == 0);
+		bool bSame = true;
+		for (int q = 0; q < iOrderCount; ++q) {
+			bSame = bSame && SameQuad(&Vertices[q * 4], &Reference[(iOrderCount - 1 - q) * 4]);
+		}
+		NX_TEST_CHECK(bSame);
+		NX_TEST_CHECK(Expander.Expand(Storage, &Order[0], iOrderCount, &Vertices[0], 7) == 7);
+
+		//two rectangles, texture index 2 takes the last one
+		const float UVRects[8] = { 0.f, 0.f, .5f, .25f, .5f, .25f, 1.f, 1.f };
+		Expander.SetUVRects(UVRects, 2);
+		Expander.Expand(Storage, &Order[0], iOrderCount, &Vertices[0], iCount);
+		bool bSqueezed = true;
+		for (int q = 0; q < iOrderCount; ++q) {
+			const float *pRect = UVRects + 4 * NX::NXMin(Particles[Order[q]].GetTextureIndex(), 1);
+			for (int k = 0; k < 4; ++k) {
+				const NX::Particle::Vertex &v = Vertices[q * 4 + k], &r = Reference[(iOrderCount - 1 - q) * 4 + k];
+				bSqueezed = bSqueezed && v.u == (r.u == 0.f ? pRect[0] : pRect[2]) && v.v == (r.v == 0.f ? pRect[1] : pRect[3]);
+			}
+		}
+		NX_TEST_CHECK(bSqueezed);
+	}
+}
+
+NX_TEST(NXBillboardExpanderBenchmark) {
+	const int iCount = 1 << 20, iRuns = 4;
+	NX::ParticleStorage Storage;
+	std::vector<NX::Particle> Particles;
+	Fill(Storage, Particles, iCount, 7);
+	std::vector<NXUInt8> DeadMask(Storage.GetDeadMaskSize());
+	Storage.Integrate(0.f, NX::float3(0.f, 0.f, 0.f), NX::float3(0.f, 0.f, 0.f), &DeadMask[0]);
+	std::vector<NXUInt32> Order;
+	for (int i = 0; i < iCount; ++i) {
+		if (!Storage.IsDead(i)) {
+			Order.push_back((NXUInt32)i);
+		}
+	}
+	const int iLiveCount = (int)Order.size();
+	std::vector<NX::Particle::Vertex> Vertices(iCount * 4);
+
+	//what the systems did before, a rotation matrix per live particle
+	int iFilled = 0;
+	const double fFill = NX::Test::GetBestMilliSeconds(iRuns, [&]() {
+		char *pBase = (char *)&Vertices[0];
+		iFilled = 0;
+		for (int i = 0; i < iCount; ++i) {
+			if (!Storage.IsDead(i)) {
+				pBase += Particles[i].FillVertexBuffer(pBase);
+				++iFilled;
+			}
+		}
+	});
+	NX_TEST_CHECK(iFilled == iLiveCount);
+
+	NX::BillboardExpander Expander;
+	double Times[3];
+	const NX::BillboardExpander::MODE Modes[3] = { NX::BillboardExpander::MODE_CAMERA_FACING, NX::BillboardExpander::MODE_AXIS_ALIGNED, NX::BillboardExpander::MODE_FREE_ROTATION };
+	for (int m = 0; m < 3; ++m) {
+		Expander.SetMode(Modes[m]);
+		int iQuadCount = 0;
+		Times[m] = NX::Test::GetBestMilliSeconds(iRuns, [&]() { iQuadCount = Expander.Expand(Storage, &DeadMask[0], &Vertices[0], iCount); });
+		NX_TEST_CHECK(iQuadCount == iLiveCount);
+	}
+	int iOrdered = 0;
+	const double fOrdered = NX::Test::GetBestMilliSeconds(iRuns, [&]() { iOrdered = Expander.Expand(Storage, &Order[0], iLiveCount, &Vertices[0], iCount); });
+	NX_TEST_CHECK(iOrdered == iLiveCount);
+
+	std::printf("%d live of %d particles: FillVertexBuffer %.2f ms, camera facing %.2f ms, axis aligned %.2f ms, free rotation %.2f ms (%.1fx), free rotation in order %.2f ms\n",
+		iLiveCount, iCount, fFill, Times[0], Times[1], Times[2], fFill / Times[2], fOrdered);
+}
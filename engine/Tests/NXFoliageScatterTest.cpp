@@ -0,0 +1,209 @@
+/*
+ *  File:    NXFoliageScatterTest.cpp
+ *
+ *  author:  张雄(zhang xiong, 1025679612@qq.com)
+ *  date:    2026_10_19
+ *  purpose: FoliageScatter over a flat 256 x 256 field of 4 x 4 chunks: instances per square unit match the
+ *           density, a density map thins them where it is low, height limits hold, every instance lies inside
+ *           its chunk's bound and any worker count scatters the same bytes. the first half of a chunk covers it
+ *           evenly. BuildStream keeps exactly the chunks whose bounds are in the frustum and closer than the
+ *           fade end, with the prefix the fade asks for.
+ */
+
+#include <cmath>
+#include <vector>
+
+#include "NXTestHeader.h"
+#include "../entity/NXFoliageScatter.h"
+#include "../entity/NXHeightField.h"
+#include "../entity/NXTerrainQuadTree.h"
+#include "../math/NXMath.h"
+#include "../render/NXCamera.h"
+#include "../render/NXViewFrustum.h"
+
+namespace {
+	const int   SIZE    = 257;                      // 4 x 4 chunks of 64 cells of 1
+	const float DENSITY = 2.f;
+	const float AREA    = (SIZE - 1.f) * (SIZE - 1.f);
+
+	/**
+	 *  distance from Eye to the nearest point of box, BuildStream's fade distance
+	 */
+	float GetDistance(const NX::AABB &box, const NX::float3 &Eye) {
+		const NX::float3 MinPoint = box.GetMinPoint(), MaxPoint = box.GetMaxPoint();
+		const float ex = NX::NXMax(NX::NXMax(MinPoint.x - Eye.x, 0.f), Eye.x - MaxPoint.x);
+		const float ey = NX::NXMax(NX::NXMax(MinPoint.y - Eye.y, 0.f), Eye.y - MaxPoint.y);
+		const float ez = NX::NXMax(NX::NXMax(MinPoint.z - Eye.z, 0.f), Eye.z - MaxPoint.z);
+		return std::sqrt(ex * ex + ey * ey + ez * ez);
+	}
+
+	bool Near(const float a, const float b, const float fTolerance) {
+		return std::fabs(a - b) <= fTolerance;
+	}
+}
+
+NX_TEST(NXFoliageScatterTest) {
+	NX::HeightField Field(SIZE, SIZE, 1.f, 1.f);
+	for (int r = 0; r < SIZE; ++r) {
+		for (int c = 0; c < SIZE; ++c) {
+			Field.SetHeight(r, c, 2.f);
+		}
+	}
+	NX::TerrainQuadTree Tree(SIZE, SIZE, 1.f, 1.f);
+	Tree.Build(Field.GetData(), 1, SIZE);
+	NX_TEST_CHECK(Tree.GetChunkRowCount() == 4 && Tree.GetChunkColCount() == 4);
+
+	NX::FoliageScatter Scatter;
+	Scatter.SetSeed(39).SetDensity(DENSITY).SetScaleLimits(0.5f, 1.5f).SetInstanceHeight(1.f).SetWorkerCount(1);
+	Scatter.Scatter(Field, Tree);
+	const std::vector<NX::FoliageScatter::Chunk> &Chunks = Scatter.GetChunks();
+	const std::vector<NX::FoliageScatter::Instance> &Instances = Scatter.GetInstances();
+
+	{//DENSITY per square unit over the field and in every chunk, one jittered point per grid cell
+		std::printf("density %.1f over %.0f square units: %d instances\n", DENSITY, AREA, Scatter.GetInstanceCount());
+		NX_TEST_CHECK(Near((float)Scatter.GetInstanceCount(), DENSITY * AREA, 0.005f * DENSITY * AREA));
+		bool bEven = true;
+		for (size_t i = 0; i < Chunks.size(); ++i) {
+			bEven = bEven && Near((float)Chunks[i].iInstanceCount, DENSITY * 64.f * 64.f, 0.02f * DENSITY * 64.f * 64.f);
+		}
+		NX_TEST_CHECK(Chunks.size() == 16 && bEven);
+	}
+
+	{//every instance inside its chunk's bound and its cells, or a jitter past them since a grid cell goes to the chunk of its corner
+		const float fSpacing = 1.f / std::sqrt(DENSITY);
+		bool bInside = true;
+		int iFirstInstance = 0;
+		for (int i = 0; i < (int)Chunks.size(); ++i) {
+			const NX::FoliageScatter::Chunk &chunk = Chunks[i];
+			int iFirstRow, iFirstCol, iCellRows, iCellCols;
+			Tree.GetChunkCellRange(i / 4, i % 4, iFirstRow, iFirstCol, iCellRows, iCellCols);
+			bInside = bInside && chunk.iFirstInstance == iFirstInstance;
+			iFirstInstance += chunk.iInstanceCount;
+			const NX::float3 MinPoint = chunk.Bound.GetMinPoint(), MaxPoint = chunk.Bound.GetMaxPoint();
+			for (int k = chunk.iFirstInstance; k < chunk.iFirstInstance + chunk.iInstanceCount; ++k) {
+				NX::float3 Position;
+				float fYaw, fScale;
+				Scatter.Unpack(chunk, Instances[k], Position, fYaw, fScale);
+				bInside = bInside && Position.x >= iFirstRow - 1e-3f && Position.x <= iFirstRow + iCellRows + fSpacing;
+				bInside = bInside && Position.z >= iFirstCol - 1e-3f && Position.z <= iFirstCol + iCellCols + fSpacing;
+				bInside = bInside && Position.x >= MinPoint.x - 1e-3f && Position.x <= MaxPoint.x + 1e-3f && Position.z >= MinPoint.z - 1e-3f && Position.z <= MaxPoint.z + 1e-3f;
+				bInside = bInside && Near(Position.y, 2.f, 1e-3f) && fScale >= 0.5f && fScale <= 1.5f && fYaw >= 0.f && fYaw < 6.2832f;
+			}
+			bInside = bInside && Near(MaxPoint.y - MinPoint.y, 1.5f, 1e-4f);
+		}
+		NX_TEST_CHECK(bInside && iFirstInstance == (int)Instances.size());
+	}
+
+	{//the first half of a chunk covers its four quarters evenly, so the fade's prefix thins without holes
+		bool bEven = true;
+		for (int i = 0; i < (int)Chunks.size(); ++i) {
+			const NX::FoliageScatter::Chunk &chunk = Chunks[i];
+			const float fMidX = (i / 4) * 64.f + 32.f, fMidZ = (i % 4) * 64.f + 32.f;
+			int Quarters[4] = { 0, 0, 0, 0 };
+			const int iHalf = chunk.iInstanceCount / 2;
+			for (int k = chunk.iFirstInstance; k < chunk.iFirstInstance + iHalf; ++k) {
+				NX::float3 Position;
+				float fYaw, fScale;
+				Scatter.Unpack(chunk, Instances[k], Position, fYaw, fScale);
+				++Quarters[(Position.x >= fMidX ? 2 : 0) + (Position.z >= fMidZ ? 1 : 0)];
+			}
+			for (int q = 0; q < 4; ++q) {
+				bEven = bEven && Quarters[q] > iHalf / 5 && Quarters[q] < iHalf * 3 / 10;
+			}
+		}
+		NX_TEST_CHECK(bEven);
+	}
+
+	{//any worker count, the same bytes, another seed, other ones
+		NX::FoliageScatter Parallel;
+		Parallel.SetSeed(39).SetDensity(DENSITY).SetScaleLimits(0.5f, 1.5f).SetInstanceHeight(1.f).SetWorkerCount(0);
+		Parallel.Scatter(Field, Tree);
+		NX_TEST_CHECK(Parallel.GetInstances().size() == Instances.size() && NX::Test::SameBits(&Parallel.GetInstances()[0], &Instances[0], (int)Instances.size()));
+		Parallel.SetSeed(40).Scatter(Field, Tree);
+		NX_TEST_CHECK(!(Parallel.GetInstances().size() == Instances.size() && NX::Test::SameBits(&Parallel.GetInstances()[0], &Instances[0], (int)Instances.size())));
+	}
+
+	{//a density map rising from 0 at x = 0 to 255 at x = 256 leaves a quarter of the instances in the low half
+		const NXUInt8 Ramp[4] = { 0, 0, 255, 255 };
+		NX::FoliageScatter Thinned;
+		Thinned.SetSeed(39).SetDensity(DENSITY).SetDensityMap(Ramp, 2, 2);
+		Thinned.Scatter(Field, Tree);
+		const std::vector<NX::FoliageScatter::Chunk> &RampChunks = Thinned.GetChunks();
+		int iLowHalf = 0;
+		for (int i = 0; i < 8; ++i) {//chunk rows 0 and 1 are x < 128
+			iLowHalf += RampChunks[i].iInstanceCount;
+		}
+		NX_TEST_CHECK(Near((float)Thinned.GetInstanceCount(), 0.5f * DENSITY * AREA, 0.02f * DENSITY * AREA));
+		NX_TEST_CHECK(Near((float)iLowHalf, 0.25f * Thinned.GetInstanceCount(), 0.02f * Thinned.GetInstanceCount()));
+
+		//and a height range that leaves out the flat field's height leaves nothing
+		Thinned.SetDensityMap(nullptr, 0, 0).SetHeightLimits(3.f, 10.f).Scatter(Field, Tree);
+		NX_TEST_CHECK(Thinned.GetInstanceCount() == 0 && Thinned.GetChunks().size() == 16);
+	}
+
+	//at the low x border, looking along +x and to the side, the high z chunks stay out of the frustum
+	const NX::float3 Eye(-10.f, 30.f, 64.f);
+	NX::PerspectCamera Camera(Eye, NX::float3(128.f, 0.f, 64.f), NX::float3(0.f, 1.f, 0.f), 50.f, 16.f / 9.f, 0.5f, 2000.f);
+	const NX::ViewFrustum Frustum(Camera.GetWatchMatrix());
+	std::vector<NX::FoliageScatter::Instance> Stream;
+	std::vector<NX::FoliageScatter::Batch> Batches;
+
+	{//no fade: the chunks whose bound is visible, whole, in chunk order
+		NX::FoliageScatter::StreamParameter Parameter = { Eye, 0.f, 0.f };
+		NX::FoliageScatter::Statistics Statistics;
+		Scatter.BuildStream(Frustum, Parameter, Stream, Batches, &Statistics);
+		std::vector<int> Expected;
+		for (int i = 0; i < (int)Chunks.size(); ++i) {
+			if (Frustum.Visible(Chunks[i].Bound)) {
+				Expected.push_back(i);
+			}
+		}
+		NX_TEST_CHECK(!Expected.empty() && Expected.size() < Chunks.size());
+		NX_TEST_CHECK(Batches.size() == Expected.size());
+		bool bSame = Batches.size() == Expected.size();
+		int iStream = 0;
+		for (size_t b = 0; b < Batches.size() && bSame; ++b) {
+			const NX::FoliageScatter::Chunk &chunk = Chunks[Expected[b]];
+			bSame = Batches[b].iChunk == Expected[b] && Batches[b].iFirstInstance == iStream && Batches[b].iInstanceCount == chunk.iInstanceCount;
+			bSame = bSame && NX::Test::SameBits(&Stream[iStream], &Instances[chunk.iFirstInstance], chunk.iInstanceCount);
+			iStream += chunk.iInstanceCount;
+		}
+		NX_TEST_CHECK(bSame && iStream == (int)Stream.size());
+		NX_TEST_CHECK(Statistics.iVisibleChunks == (int)Expected.size() && Statistics.iCulledChunks == 16 - (int)Expected.size());
+		NX_TEST_CHECK(Statistics.iStreamInstances == (int)Stream.size() && Statistics.uStreamBytes == Stream.size() * 8);
+		std::printf("%d of 16 chunks visible, %d instances, %llu bytes streamed\n", Statistics.iVisibleChunks, Statistics.iStreamInstances, (unsigned long long)Statistics.uStreamBytes);
+	}
+
+	{//fading from 60 to 150: beyond the end dropped, before the start whole, between a prefix shrinking linearly
+		NX::FoliageScatter::StreamParameter Parameter = { Eye, 60.f, 150.f };
+		NX::FoliageScatter::Statistics Statistics;
+		Scatter.BuildStream(Frustum, Parameter, Stream, Batches, &Statistics);
+		std::vector<NX::FoliageScatter::Batch> Expected;
+		int iStream = 0, iWhole = 0, iPartial = 0, iDropped = 0;
+		for (int i = 0; i < (int)Chunks.size(); ++i) {
+			const float fDistance = GetDistance(Chunks[i].Bound, Eye);
+			if (fDistance >= 150.f) {
+				iDropped += Frustum.Visible(Chunks[i].Bound);
+				continue;
+			}
+			if (!Frustum.Visible(Chunks[i].Bound)) {
+				continue;
+			}
+			const int iCount = fDistance <= 60.f ? Chunks[i].iInstanceCount : (int)std::ceil(Chunks[i].iInstanceCount * (150.f - fDistance) / 90.f);
+			iWhole   += iCount == Chunks[i].iInstanceCount;
+			iPartial += iCount < Chunks[i].iInstanceCount;
+			const NX::FoliageScatter::Batch batch = { i, iStream, iCount };
+			Expected.push_back(batch);
+			iStream += iCount;
+		}
+		NX_TEST_CHECK(iWhole > 0 && iPartial > 0 && iDropped > 0);
+		bool bSame = Batches.size() == Expected.size() && iStream == (int)Stream.size();
+		for (size_t b = 0; b < Batches.size() && bSame; ++b) {
+			bSame = Batches[b].iChunk == Expected[b].iChunk && Batches[b].iFirstInstance == Expected[b].iFirstInstance && Batches[b].iInstanceCount == Expected[b].iInstanceCount;
+			bSame = bSame && NX::Test::SameBits(&Stream[Batches[b].iFirstInstance], &Instances[Chunks[Batches[b].iChunk].iFirstInstance], Batches[b].iInstanceCount);
+		}
+		NX_TEST_CHECK(bSame);
+		NX_TEST_CHECK(Statistics.iVisibleChunks == (int)Expected.size() && Statistics.iCulledChunks == 16 - (int)Expected.size());
+		std::printf("fading from 60 to 150: %d chunks whole, %d thinned, %d dropped, %d instances\n", iWhole, iPartial, iDropped, Statistics.iStreamInstances);
+	}
+}
@@ -0,0 +1,86 @@
+/*
+ *  File:    NXHeightFieldGeneratorTest.cpp
+ *
+ *  author:  张雄(zhang xiong, 1025679612@qq.com)
+ *  date:    2026_10_19
+ *  purpose: HeightFieldGenerator writes the same bits with 1, 2 and every hardware worker, for a region as for
+ *           the whole field and as Sample at the grid points, and prints its throughput.
+ */
+
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+#include "NXTestHeader.h"
+#include "../entity/NXHeightField.h"
+#include "../entity/NXHeightFieldGenerator.h"
+
+NX_TEST(NXHeightFieldGeneratorTest) {
+	const NX::HeightFieldGenerator::FRACTAL_TYPE Types[] = {
+		NX::HeightFieldGenerator::FRACTAL_FBM, NX::HeightFieldGenerator::FRACTAL_RIDGED, NX::HeightFieldGenerator::FRACTAL_DOMAIN_WARPED,
+	};
+	const char *szTypeNames[] = { "fbm", "ridged", "domain warped" };
+
+	//an odd col count leaves a scalar tail after the SSE columns of every row
+	const int iRowCount = 513, iColCount = 515, iGridCount = iRowCount * iColCount;
+	for (int t = 0; t < 3; ++t) {
+		NX::HeightFieldGenerator Generator;
+		Generator.SetType(Types[t]).SetSeed(0x1025u).SetOctaves(7).SetFrequency(0.013f).SetAmplitude(40.f).SetBaseHeight(-5.f).SetWarpStrength(2.5f);
+
+		NX::HeightField Single(iRowCount, iColCount, 0.5f, 0.75f);
+		const auto Start = std::chrono::steady_clock::now();
+		Generator.SetWorkerCount(1).Generate(Single);
+		const double fMilliSeconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - Start).count();
+		std::printf("%s: %.1f ms on one worker, %.1f million heights a second\n", szTypeNames[t], fMilliSeconds, iGridCount / fMilliSeconds / 1000.0);
+
+		bool bFinite = true;
+		for (int i = 0; i < iGridCount; ++i) {
+			bFinite = bFinite && std::isfinite(Single.GetData()[i]);
+		}
+		NX_TEST_CHECK(bFinite);
+
+		{//worker counts only change who computes a row
+			const int Workers[] = { 2, 3, 0 };
+			for (int i = 0; i < 3; ++i) {
+				NX::HeightField Field(iRowCount, iColCount, 0.5f, 0.75f);
+				const auto WorkerStart = std::chrono::steady_clock::now();
+				Generator.SetWorkerCount(Workers[i]).Generate(Field);
+				const double fWorkerMilliSeconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - WorkerStart).count();
+				std::printf("    %d workers: %.1f ms\n", Workers[i], fWorkerMilliSeconds);
+				NX_TEST_CHECK(NX::Test::SameBits(Field.GetData(), Single.GetData(), iGridCount));
+			}
+		}
+
+		{//a region gives the whole field's values, whatever its column alignment
+			NX::HeightField Field(iRowCount, iColCount, 0.5f, 0.75f);
+			const int r0 = 31, c0 = 3, r1 = 300, c1 = 402;
+			Generator.SetWorkerCount(0).Generate(Field, r0, c0, r1, c1);
+			bool bSame = true;
+			for (int r = 0; r < iRowCount; ++r) {
+				for (int c = 0; c < iColCount; ++c) {
+					const bool bInside = r >= r0 && r <= r1 && c >= c0 && c <= c1;
+					const float fExpected = bInside ? Single.GetHeight(r, c) : 0.f;
+					bSame = bSame && NX::Test::SameBits(&Field.GetData()[r * iColCount + c], &fExpected, 1);
+				}
+			}
+			NX_TEST_CHECK(bSame);
+		}
+
+		{//Sample at a grid point is the generated height
+			bool bSame = true;
+			for (int r = 0; r < iRowCount; r += 7) {
+				for (int c = 0; c < iColCount; c += 5) {
+					const float h = Generator.Sample((float)r * Single.GetDX(), (float)c * Single.GetDZ());
+					bSame = bSame && NX::Test::SameBits(&h, &Single.GetData()[r * iColCount + c], 1);
+				}
+			}
+			NX_TEST_CHECK(bSame);
+		}
+
+		{//another seed gives another field
+			NX::HeightField Field(iRowCount, iColCount, 0.5f, 0.75f);
+			NX::HeightFieldGenerator(Generator).SetSeed(0x1026u).Generate(Field);
+			NX_TEST_CHECK(!NX::Test::SameBits(Field.GetData(), Single.GetData(), iGridCount));
+		}
+	}
+}
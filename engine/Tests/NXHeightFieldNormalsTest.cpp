@@ -0,0 +1,135 @@
+/*
+ *  File:    NXHeightFieldNormalsTest.cpp
+ *
+ *  author:  张雄(zhang xiong, 1025679612@qq.com)
+ *  date:    2026_10_19
+ *  purpose: HeightFieldNormals against plain double precision central differences, and the same bits for
+ *           any part count and for a region compared with the whole field. NXHeightFieldNormalsBenchmark
+ *           times a 4097x4097 grid and an incremental brush sized region on it.
+ */
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "NXTestHeader.h"
+#include "../entity/NXHeightField.h"
+#include "../entity/NXHeightFieldNormals.h"
+#include "../math/NXMath.h"
+
+namespace {
+	/**
+	 *  gradient with one-sided differences on the border, normal (-gx, 1, -gz) and tangent (1, gx, 0)
+	 */
+	void GetReference(const NX::HeightField &Field, const int r, const int c, double Normal[3], double Tangent[3]) {
+		const int rm = NX::NXMax(r - 1, 0), rp = NX::NXMin(r + 1, Field.GetRowCount() - 1);
+		const int cm = NX::NXMax(c - 1, 0), cp = NX::NXMin(c + 1, Field.GetColCount() - 1);
+		const double gx = ((double)Field.GetHeight(rp, c) - Field.GetHeight(rm, c)) / ((rp - rm) * (double)Field.GetDX());
+		const double gz = ((double)Field.GetHeight(r, cp) - Field.GetHeight(r, cm)) / ((cp - cm) * (double)Field.GetDZ());
+		const double n = std::sqrt(gx * gx + gz * gz + 1.0), t = std::sqrt(gx * gx + 1.0);
+		Normal[0]  = -gx / n, Normal[1]  = 1.0 / n, Normal[2]  = -gz / n;
+		Tangent[0] = 1.0 / t, Tangent[1] = gx / t,  Tangent[2] = 0.0;
+	}
+
+	int GetReferenceCode(const double Normal[3]) {
+		const double s = std::fabs(Normal[0]) + Normal[1] + std::fabs(Normal[2]);
+		return (int)(Normal[0] / s * 127.0 + 127.5) | ((int)(Normal[2] / s * 127.0 + 127.5) << 8);
+	}
+}
+
+NX_TEST(NXHeightFieldNormalsTest) {
+	std::mt19937 Random(7);
+	std::uniform_real_distribution<float> HeightRange(-3.f, 3.f);
+
+	//an odd col count leaves a scalar tail after the SSE columns of every row
+	NX::HeightField Field(131, 203, 0.5f, 0.8f);
+	for (int r = 0; r < Field.GetRowCount(); ++r) {
+		for (int c = 0; c < Field.GetColCount(); ++c) {
+			Field.SetHeight(r, c, HeightRange(Random) + 0.05f * r);
+		}
+	}
+	const int iGridCount = Field.GetRowCount() * Field.GetColCount();
+
+	std::vector<NX::float3> Normals(iGridCount), Tangents(iGridCount);
+	std::vector<NXUInt16>   Codes(iGridCount);
+	NX::HeightFieldNormals::Compute(Field, &Normals[0], &Tangents[0], 1);
+	NX::HeightFieldNormals::ComputeEncoded(Field, &Codes[0], 1);
+
+	{//against the reference
+		double fMaxNormalError = 0.0, fMaxTangentError = 0.0;
+		int iMaxCodeError = 0;
+		for (int r = 0; r < Field.GetRowCount(); ++r) {
+			for (int c = 0; c < Field.GetColCount(); ++c) {
+				double Normal[3], Tangent[3];
+				GetReference(Field, r, c, Normal, Tangent);
+				const NX::float3 &n = Normals[r * Field.GetColCount() + c], &t = Tangents[r * Field.GetColCount() + c];
+				fMaxNormalError  = NX::NXMax(fMaxNormalError, NX::NXMax(std::fabs(n.x - Normal[0]), NX::NXMax(std::fabs(n.y - Normal[1]), std::fabs(n.z - Normal[2]))));
+				fMaxTangentError = NX::NXMax(fMaxTangentError, NX::NXMax(std::fabs(t.x - Tangent[0]), NX::NXMax(std::fabs(t.y - Tangent[1]), std::fabs(t.z - Tangent[2]))));
+				const int iCode = GetReferenceCode(Normal), iGot = Codes[r * Field.GetColCount() + c];
+				iMaxCodeError = NX::NXMax(iMaxCodeError, NX::NXMax(std::abs((iCode & 0xff) - (iGot & 0xff)), std::abs((iCode >> 8) - (iGot >> 8))));
+			}
+		}
+		std::printf("largest normal error %g, tangent error %g, code error %d\n", fMaxNormalError, fMaxTangentError, iMaxCodeError);
+		NX_TEST_CHECK(fMaxNormalError < 1e-5);
+		NX_TEST_CHECK(fMaxTangentError < 1e-5);
+		NX_TEST_CHECK(iMaxCodeError <= 1);
+	}
+
+	{//part counts only change who computes a row
+		const int Parts[] = { 2, 3, 8, 0 };
+		for (int i = 0; i < 4; ++i) {
+			std::vector<NX::float3> PartNormals(iGridCount), PartTangents(iGridCount);
+			std::vector<NXUInt16>   PartCodes(iGridCount);
+			NX::HeightFieldNormals::Compute(Field, &PartNormals[0], &PartTangents[0], Parts[i]);
+			NX::HeightFieldNormals::ComputeEncoded(Field, &PartCodes[0], Parts[i]);
+			NX_TEST_CHECK(NX::Test::SameBits(&PartNormals[0], &Normals[0], iGridCount));
+			NX_TEST_CHECK(NX::Test::SameBits(&PartTangents[0], &Tangents[0], iGridCount));
+			NX_TEST_CHECK(NX::Test::SameBits(&PartCodes[0], &Codes[0], iGridCount));
+		}
+	}
+
+	{//a region gives the whole field's values and leaves everything else alone
+		const NX::float3 Marker(-7.f, -7.f, -7.f);
+		std::vector<NX::float3> RegionNormals(iGridCount, Marker);
+		const int r0 = 17, c0 = 1, r1 = 130, c1 = 106;
+		NX::HeightFieldNormals::Compute(Field, r0, c0, r1, c1, &RegionNormals[0], nullptr);
+		bool bSame = true;
+		for (int r = 0; r < Field.GetRowCount(); ++r) {
+			for (int c = 0; c < Field.GetColCount(); ++c) {
+				const int i = r * Field.GetColCount() + c;
+				const bool bInside = r >= r0 && r <= r1 && c >= c0 && c <= c1;
+				bSame = bSame && NX::Test::SameBits(&RegionNormals[i], bInside ? &Normals[i] : &Marker, 1);
+			}
+		}
+		NX_TEST_CHECK(bSame);
+	}
+}
+
+NX_TEST(NXHeightFieldNormalsBenchmark) {
+	const int iSize = 4097, iRuns = 3;
+	NX::HeightField Field(iSize, iSize, 1.f, 1.f);
+	for (int r = 0; r < iSize; ++r) {
+		for (int c = 0; c < iSize; ++c) {
+			Field.SetHeight(r, c, 20.f * std::sin(r * 0.013f) * std::cos(c * 0.021f));
+		}
+	}
+	const int iGridCount = iSize * iSize;
+
+	std::vector<NX::float3> Normals(iGridCount), Tangents(iGridCount);
+	std::vector<NXUInt16>   Codes(iGridCount), PartCodes(iGridCount);
+	const double fOne     = NX::Test::GetBestMilliSeconds(iRuns, [&]() { NX::HeightFieldNormals::Compute(Field, &Normals[0], &Tangents[0], 1); });
+	const double fAll     = NX::Test::GetBestMilliSeconds(iRuns, [&]() { NX::HeightFieldNormals::Compute(Field, &Normals[0], &Tangents[0]); });
+	const double fEncoded = NX::Test::GetBestMilliSeconds(iRuns, [&]() { NX::HeightFieldNormals::ComputeEncoded(Field, &Codes[0], 1); });
+	const double fEncodedAll = NX::Test::GetBestMilliSeconds(iRuns, [&]() { NX::HeightFieldNormals::ComputeEncoded(Field, &PartCodes[0]); });
+	NX_TEST_CHECK(NX::Test::SameBits(&PartCodes[0], &Codes[0], iGridCount));
+
+	//a 64x64 brush touches 66x66 normals
+	std::vector<NX::float3> RegionNormals(Normals);
+	const int r0 = 2000, c0 = 1000, r1 = r0 + 65, c1 = c0 + 65;
+	const double fRegion = NX::Test::GetBestMilliSeconds(100, [&]() { NX::HeightFieldNormals::Compute(Field, r0, c0, r1, c1, &RegionNormals[0], nullptr); });
+	NX_TEST_CHECK(NX::Test::SameBits(&RegionNormals[0], &Normals[0], iGridCount));
+
+	std::printf("%dx%d normals and tangents: %.1f ms on one part, %.1f ms on every hardware thread\n", iSize, iSize, fOne, fAll);
+	std::printf("%dx%d encoded normals: %.1f ms on one part, %.1f ms on every hardware thread\n", iSize, iSize, fEncoded, fEncodedAll);
+	std::printf("66x66 region: %.3f ms\n", fRegion);
+}
@@ -0,0 +1,108 @@
+/*
+ *  File:    NXHeightFieldOcclusionTest.cpp
+ *
+ *  author:  张雄(zhang xiong, 1025679612@qq.com)
+ *  date:    2026_10_19
+ *  purpose: HeightFieldOcclusion on a straight ridge against the closed form horizon, worker count independence,
+ *           and BakeRegion giving a whole Bake's bytes inside the region and leaving everything else alone.
+ */
+
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+#include "NXTestHeader.h"
+#include "../entity/NXHeightField.h"
+#include "../entity/NXHeightFieldOcclusion.h"
+#include "../math/NXMath.h"
+
+namespace {
+	const int   SIZE         = 65;
+	const int   RIDGE_FIRST  = 30, RIDGE_LAST = 34;   // rows of the ridge top, it runs along every col
+	const float RIDGE_HEIGHT = 10.f;
+
+	/**
+	 *  8 directions on flat ground at distance D in front of the ridge: straight at it the top edge is D away,
+	 *  the two diagonals see it D * sqrt(2) away, the other five look over flat ground
+	 */
+	int GetRidgeByte(const float D) {
+		const float fStraight = RIDGE_HEIGHT / std::sqrt(D * D + RIDGE_HEIGHT * RIDGE_HEIGHT);
+		const float fDiagonal = RIDGE_HEIGHT / std::sqrt(2.f * D * D + RIDGE_HEIGHT * RIDGE_HEIGHT);
+		return (int)((5.f + (1.f - fStraight) + 2.f * (1.f - fDiagonal)) / 8.f * 255.f + 0.5f);
+	}
+}
+
+NX_TEST(NXHeightFieldOcclusionTest) {
+	NX::HeightField Field(SIZE, SIZE, 1.f, 1.f);
+	for (int r = 0; r < SIZE; ++r) {
+		for (int c = 0; c < SIZE; ++c) {
+			Field.SetHeight(r, c, r >= RIDGE_FIRST && r <= RIDGE_LAST ? RIDGE_HEIGHT : 0.f);
+		}
+	}
+	const int iGridCount = SIZE * SIZE, iMid = SIZE / 2;
+
+	NX::HeightFieldOcclusion Baker;
+	Baker.SetDirectionCount(8).SetWorkerCount(1);
+	std::vector<NXUInt8> Occlusion(iGridCount);
+	Baker.Bake(Field, &Occlusion[0]);
+
+	{//the top sees nothing above it, flat ground in front of both faces matches the closed form
+		NX_TEST_CHECK(Occlusion[RIDGE_FIRST * SIZE + iMid] == 255);
+		NX_TEST_CHECK(Occlusion[(RIDGE_FIRST + RIDGE_LAST) / 2 * SIZE + iMid] == 255);
+		int iMaxError = 0;
+		for (int D = 4; D <= 24; D += 4) {
+			const int iExpected = GetRidgeByte((float)D);
+			iMaxError = NX::NXMax(iMaxError, std::abs(Occlusion[(RIDGE_FIRST - D) * SIZE + iMid] - iExpected));
+			iMaxError = NX::NXMax(iMaxError, std::abs(Occlusion[(RIDGE_LAST + D) * SIZE + iMid] - iExpected));
+		}
+		std::printf("largest difference to the closed form ridge horizon: %d\n", iMaxError);
+		NX_TEST_CHECK(iMaxError <= 1);
+	}
+
+	{//occlusion deepens towards the ridge foot on both sides and is the same along the ridge
+		bool bMonotonic = true, bUniform = true;
+		for (int r = 1; r < RIDGE_FIRST - 1; ++r) {
+			bMonotonic = bMonotonic && Occlusion[(r + 1) * SIZE + iMid] <= Occlusion[r * SIZE + iMid];
+			bMonotonic = bMonotonic && Occlusion[(SIZE - 2 - r) * SIZE + iMid] <= Occlusion[(SIZE - 1 - r) * SIZE + iMid];
+		}
+		for (int c = 24; c <= 40; ++c) {
+			bUniform = bUniform && Occlusion[(RIDGE_FIRST - 8) * SIZE + c] == Occlusion[(RIDGE_FIRST - 8) * SIZE + iMid];
+		}
+		NX_TEST_CHECK(bMonotonic);
+		NX_TEST_CHECK(bUniform);
+		NX_TEST_CHECK(Occlusion[(RIDGE_FIRST - 1) * SIZE + iMid] < Occlusion[(RIDGE_FIRST - 8) * SIZE + iMid]);
+	}
+
+	{//the worker count only changes who sweeps a line
+		std::vector<NXUInt8> PartOcclusion(iGridCount);
+		Baker.SetWorkerCount(4).Bake(Field, &PartOcclusion[0]);
+		NX_TEST_CHECK(NX::Test::SameBits(&PartOcclusion[0], &Occlusion[0], iGridCount));
+		Baker.SetWorkerCount(1);
+	}
+
+	{//a region bake after an edit writes a whole bake's bytes inside and nothing outside
+		for (int r = 10; r <= 14; ++r) {
+			for (int c = 44; c <= 50; ++c) {
+				Field.SetHeight(r, c, 6.f);
+			}
+		}
+		std::vector<NXUInt8> Whole(iGridCount), Region(Occlusion);
+		Baker.Bake(Field, &Whole[0]);
+		const int r0 = 3, c0 = 37, r1 = 21, c1 = 57;
+		Baker.BakeRegion(Field, r0, c0, r1, c1, &Region[0]);
+		bool bSame = true;
+		for (int r = 0; r < SIZE; ++r) {
+			for (int c = 0; c < SIZE; ++c) {
+				const bool bInside = r >= r0 && r <= r1 && c >= c0 && c <= c1;
+				bSame = bSame && Region[r * SIZE + c] == (bInside ? Whole : Occlusion)[r * SIZE + c];
+			}
+		}
+		NX_TEST_CHECK(bSame);
+		NX_TEST_CHECK(Whole[16 * SIZE + 47] < Occlusion[16 * SIZE + 47]);
+
+		//regions hanging over the border are clipped, the whole field as a region is a Bake
+		std::vector<NXUInt8> Clipped(iGridCount);
+		Baker.BakeRegion(Field, -20, -20, SIZE + 20, SIZE + 20, &Clipped[0]);
+		NX_TEST_CHECK(NX::Test::SameBits(&Clipped[0], &Whole[0], iGridCount));
+	}
+}
@@ -0,0 +1,118 @@
+/*
+ *  File:    NXHeightFieldQueryTest.cpp
+ *
+ *  author:  张雄(zhang xiong, 1025679612@qq.com)
+ *  date:    2026_10_19
+ *  purpose: HeightField::GetHeight and the batched GetHeights against the barycentric solve the terrain used
+ *           before the closed form, plus scalar/batch agreement on border, out of range and NaN coordinates.
+ */
+
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "NXTestHeader.h"
+#include "../entity/NXHeightField.h"
+#include "../math/NXAlgorithm.h"
+#include "../math/NXMath.h"
+
+namespace {
+	/**
+	 *  solve for the barycentric weights of the mesh triangle under (x, z), the pre closed form terrain query
+	 */
+	float GetReferenceHeight(const NX::HeightField &Field, const float x, const float z) {
+		const float dx = Field.GetDX(), dz = Field.GetDZ();
+		const int   r  = NX::NXMin((int)(x / dx), Field.GetRowCount() - 2), c = NX::NXMin((int)(z / dz), Field.GetColCount() - 2);
+		const float dr = x - r * dx, dc = z - c * dz;
+		const NX::float3 A((r + 1) * dx, Field.GetHeight(r + 1, c), c * dz), C(r * dx, Field.GetHeight(r, c + 1), (c + 1) * dz);
+		const NX::float3 B = dr / dx + dc / dz >= 1.f ? NX::float3((r + 1) * dx, Field.GetHeight(r + 1, c + 1), (c + 1) * dz) : NX::float3(r * dx, Field.GetHeight(r, c), c * dz);
+
+		NX::Matrix<float, 2, 2> M;
+		NX::float2 V;
+		M[0][0] = A.x - C.x, M[0][1] = B.x - C.x;
+		M[1][0] = A.z - C.z, M[1][1] = B.z - C.z;
+		V[0] = x - C.x, V[1] = z - C.z;
+		const NX::float2 w = NX::SolveEquation(M, V).second;
+		return w[0] * A.y + w[1] * B.y + (1.f - w[0] - w[1]) * C.y;
+	}
+
+	void CheckBatchMatchesScalar(const NX::HeightField &Field, const std::vector<float> &Xs, const std::vector<float> &Zs) {
+		const int iCount = (int)Xs.size();
+		std::vector<float> Batch(iCount), Scalar(iCount);
+		Field.GetHeights(&Xs[0], &Zs[0], &Batch[0], iCount);
+		for (int i = 0; i < iCount; ++i) {
+			Scalar[i] = Field.GetHeight(Xs[i], Zs[i]);
+		}
+		NX_TEST_CHECK(NX::Test::SameBits(&Batch[0], &Scalar[0], iCount));
+	}
+}
+
+NX_TEST(NXHeightFieldQueryTest) {
+	std::mt19937 Random(20261019);
+	std::uniform_real_distribution<float> HeightRange(-20.f, 20.f);
+
+	//non-square with unequal spacing, so a swapped row/col stride or dx/dz shows up
+	NX::HeightField Field(97, 161, 0.75f, 1.25f);
+	for (int r = 0; r < Field.GetRowCount(); ++r) {
+		for (int c = 0; c < Field.GetColCount(); ++c) {
+			Field.SetHeight(r, c, HeightRange(Random));
+		}
+	}
+
+	{//inside the field: closed form against the solve, batch against scalar bit for bit
+		const int iCount = 200003;   // not a multiple of 4, the batch tail goes through the scalar path
+		std::uniform_real_distribution<float> XRange(0.f, Field.GetMaxX()), ZRange(0.f, Field.GetMaxZ());
+		std::vector<float> Xs(iCount), Zs(iCount);
+		float fMaxError = 0.f;
+		for (int i = 0; i < iCount; ++i) {
+			Xs[i] = XRange(Random), Zs[i] = ZRange(Random);
+			fMaxError = NX::NXMax(fMaxError, NX::NXAbs(Field.GetHeight(Xs[i], Zs[i]) - GetReferenceHeight(Field, Xs[i], Zs[i])));
+		}
+		std::printf("largest difference to the barycentric solve: %g\n", fMaxError);
+		NX_TEST_CHECK(fMaxError < 2e-3f);
+		CheckBatchMatchesScalar(Field, Xs, Zs);
+	}
+
+	{//grid points return their own height
+		float fMaxError = 0.f;
+		for (int r = 0; r < Field.GetRowCount(); ++r) {
+			for (int c = 0; c < Field.GetColCount(); ++c) {
+				fMaxError = NX::NXMax(fMaxError, NX::NXAbs(Field.GetHeight(r * Field.GetDX(), c * Field.GetDZ()) - Field.GetHeight(r, c)));
+			}
+		}
+		NX_TEST_CHECK(fMaxError < 1e-3f);
+	}
+
+	{//outside the field clamps to the border
+		std::uniform_real_distribution<float> XRange(-50.f, Field.GetMaxX() + 50.f), ZRange(-50.f, Field.GetMaxZ() + 50.f);
+		std::vector<float> Xs(4099), Zs(4099);
+		bool bClamped = true;
+		for (size_t i = 0; i < Xs.size(); ++i) {
+			Xs[i] = XRange(Random), Zs[i] = ZRange(Random);
+			const float x = NX::NXMin(NX::NXMax(Xs[i], 0.f), Field.GetMaxX()), z = NX::NXMin(NX::NXMax(Zs[i], 0.f), Field.GetMaxZ());
+			bClamped = bClamped && NX::NXAbs(Field.GetHeight(Xs[i], Zs[i]) - Field.GetHeight(x, z)) < 1e-3f;
+		}
+		NX_TEST_CHECK(bClamped);
+		CheckBatchMatchesScalar(Field, Xs, Zs);
+	}
+
+	{//NaN and infinities never index outside the grid
+		const float fNaN = std::numeric_limits<float>::quiet_NaN(), fInf = std::numeric_limits<float>::infinity();
+		const float Special[] = { fNaN, -fNaN, fInf, -fInf, 0.f, -0.f, 1e30f, -1e30f };
+		std::vector<float> Xs, Zs;
+		for (int i = 0; i < 8; ++i) {
+			for (int j = 0; j < 8; ++j) {
+				Xs.push_back(Special[i]), Zs.push_back(Special[j]);
+			}
+		}
+		bool bFinite = true;
+		for (size_t i = 0; i < Xs.size(); ++i) {
+			bFinite = bFinite && std::isfinite(Field.GetHeight(Xs[i], Zs[i]));
+		}
+		NX_TEST_CHECK(bFinite);
+		NX_TEST_CHECK(Field.GetHeight(fNaN, fNaN) == Field.GetHeight(0, 0));
+		NX_TEST_CHECK(Field.GetHeight(fInf, fNaN) == Field.GetHeight(Field.GetRowCount() - 1, 0));
+		CheckBatchMatchesScalar(Field, Xs, Zs);
+	}
+}
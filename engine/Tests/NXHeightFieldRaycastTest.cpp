@@ -0,0 +1,138 @@
+/*
+ *  File:    NXHeightFieldRaycastTest.cpp
+ *
+ *  author:  张雄(zhang xiong, 1025679612@qq.com)
+ *  date:    2026_10_19
+ *  purpose: HeightFieldRaycast's pyramid walk against the brute force answer, hits on heights raised after
+ *           the tree was built and only widened with ExpandBounds, and sight lines between surface points.
+ *           NXHeightFieldRaycastBenchmark times the walk against brute force on a 513x513 field.
+ */
+
+#include <random>
+#include <vector>
+
+#include "NXTestHeader.h"
+#include "../entity/NXHeightField.h"
+#include "../entity/NXHeightFieldGenerator.h"
+#include "../entity/NXHeightFieldRaycast.h"
+#include "../entity/NXTerrainQuadTree.h"
+#include "../math/NXMath.h"
+
+NX_TEST(NXHeightFieldRaycastTest) {
+	std::mt19937 Random(37);
+	std::uniform_real_distribution<float> Unit(0.f, 1.f);
+
+	const int N = 257;
+	NX::HeightField Field(N, N, 1.f, 1.f);
+	NX::HeightFieldGenerator().SetSeed(5).SetType(NX::HeightFieldGenerator::FRACTAL_RIDGED).SetAmplitude(30.f).SetFrequency(0.01f).Generate(Field);
+	NX::TerrainQuadTree Tree(N, N, 1.f, 1.f, 32);
+	Tree.Build(Field.GetData(), 1, N);
+	const NX::HeightFieldRaycast Raycast(Field, Tree);
+	const float fSize = (float)(N - 1);
+
+	{//pyramid walk against brute force, steep, grazing and vertical rays
+		int iMismatches = 0, iHits = 0;
+		for (int i = 0; i < 3000; ++i) {
+			const NX::float3 Origin(Unit(Random) * fSize, 35.f + Unit(Random) * 25.f, Unit(Random) * fSize);
+			NX::float3 Direction = NX::float3(Unit(Random) * fSize, Unit(Random) * 60.f - 30.f, Unit(Random) * fSize) - Origin;
+			if (i % 5 == 0) {
+				Direction = NX::float3(Unit(Random) * 2.f - 1.f, -0.05f, Unit(Random) * 2.f - 1.f);
+			}
+			if (i % 17 == 0) {
+				Direction = NX::float3(0.f, -1.f, 0.f);
+			}
+			NX::HeightFieldRaycast::Hit Fast, Slow;
+			const bool bFast = Raycast.Intersect(Origin, Direction, 1e30f, Fast), bSlow = Raycast.IntersectBruteForce(Origin, Direction, 1e30f, Slow);
+			iHits += bFast ? 1 : 0;
+			if (bFast != bSlow || (bFast && NX::NXAbs(Fast.fT - Slow.fT) > 1e-4f * (1.f + Slow.fT))) {
+				++iMismatches;
+			}
+		}
+		std::printf("%d hits, %d mismatches against brute force\n", iHits, iMismatches);
+		NX_TEST_CHECK(iHits > 0);
+		NX_TEST_CHECK(iMismatches == 0);
+	}
+
+	{//a raised column is hit once its bounds are widened, without rebuilding the chunks
+		const int Cells[][2] = { { 100, 100 }, { 64, 64 }, { 0, 200 }, { 256, 256 } };   // inside, on chunk corners and on the border
+		for (int i = 0; i < 4; ++i) {
+			const int r = Cells[i][0], c = Cells[i][1];
+			Field.SetHeight(r, c, 500.f);
+			Tree.ExpandBounds(r, c, 500.f);
+			//a flat ray well above the old terrain, aimed straight through the peak
+			const NX::float3 Origin(r * 1.f, 400.f, -10.f), Direction(0.f, 0.f, 1.f);
+			NX::HeightFieldRaycast::Hit Fast, Slow;
+			const bool bFast = Raycast.Intersect(Origin, Direction, 1e30f, Fast), bSlow = Raycast.IntersectBruteForce(Origin, Direction, 1e30f, Slow);
+			NX_TEST_CHECK(bSlow);
+			NX_TEST_CHECK(bFast && NX::NXAbs(Fast.fT - Slow.fT) <= 1e-4f * (1.f + Slow.fT));
+		}
+	}
+
+	{//points on the surface see each other unless terrain rises between them, the part count changes nothing
+		const int iCount = 20000;
+		std::vector<NX::float3> From(iCount), To(iCount);
+		for (int i = 0; i < iCount; ++i) {
+			From[i] = NX::float3(Unit(Random) * fSize, 0.f, Unit(Random) * fSize);
+			To[i]   = NX::float3(Unit(Random) * fSize, 0.f, Unit(Random) * fSize);
+			From[i].y = Field.GetHeight(From[i].x, From[i].z);
+			To[i].y   = Field.GetHeight(To[i].x, To[i].z);
+		}
+		std::vector<NXUInt8> Visible(iCount), PartVisible(iCount);
+		Raycast.TestVisibility(&From[0], &To[0], iCount, &Visible[0], 1);
+		Raycast.TestVisibility(&From[0], &To[0], iCount, &PartVisible[0], 4);
+		NX_TEST_CHECK(NX::Test::SameBits(&Visible[0], &PartVisible[0], iCount));
+
+		//a point always sees itself and its close neighbour on the same triangle
+		NXUInt8 bSelf = 0, bNeighbour = 0;
+		const NX::float3 A(10.3f, Field.GetHeight(10.3f, 20.2f), 20.2f), B(10.4f, Field.GetHeight(10.4f, 20.25f), 20.25f);
+		Raycast.TestVisibility(&A, &A, 1, &bSelf, 1);
+		Raycast.TestVisibility(&A, &B, 1, &bNeighbour, 1);
+		NX_TEST_CHECK(bSelf == 1);
+		NX_TEST_CHECK(bNeighbour == 1);
+
+		//over the peak raised above, the sight line is blocked
+		NXUInt8 bBlocked = 1;
+		const NX::float3 C(100.f, Field.GetHeight(100.f, 80.f), 80.f), D(100.f, Field.GetHeight(100.f, 120.f), 120.f);
+		Raycast.TestVisibility(&C, &D, 1, &bBlocked, 1);
+		NX_TEST_CHECK(bBlocked == 0);
+	}
+}
+
+NX_TEST(NXHeightFieldRaycastBenchmark) {
+	std::mt19937 Random(73);
+	std::uniform_real_distribution<float> Unit(0.f, 1.f);
+
+	const int N = 513, iRayCount = 200;
+	NX::HeightField Field(N, N, 1.f, 1.f);
+	NX::HeightFieldGenerator().SetSeed(11).SetType(NX::HeightFieldGenerator::FRACTAL_FBM).SetAmplitude(60.f).SetFrequency(0.004f).Generate(Field);
+	NX::TerrainQuadTree Tree(N, N, 1.f, 1.f, 32);
+	Tree.Build(Field.GetData(), 1, N);
+	const NX::HeightFieldRaycast Raycast(Field, Tree);
+	const float fSize = (float)(N - 1);
+
+	//picking rays from above the terrain towards random ground points, the usual mouse pick
+	std::vector<NX::float3> Origins(iRayCount), Directions(iRayCount);
+	for (int i = 0; i < iRayCount; ++i) {
+		Origins[i]    = NX::float3(Unit(Random) * fSize, 80.f + Unit(Random) * 40.f, Unit(Random) * fSize);
+		Directions[i] = NX::float3(Unit(Random) * fSize, 0.f, Unit(Random) * fSize) - Origins[i];
+	}
+
+	int iFastHits = 0, iSlowHits = 0;
+	const double fFast = NX::Test::GetBestMilliSeconds(20, [&]() {
+		iFastHits = 0;
+		for (int i = 0; i < iRayCount; ++i) {
+			NX::HeightFieldRaycast::Hit Result;
+			iFastHits += Raycast.Intersect(Origins[i], Directions[i], 1e30f, Result) ? 1 : 0;
+		}
+	});
+	const double fSlow = NX::Test::GetBestMilliSeconds(1, [&]() {
+		iSlowHits = 0;
+		for (int i = 0; i < iRayCount; ++i) {
+			NX::HeightFieldRaycast::Hit Result;
+			iSlowHits += Raycast.IntersectBruteForce(Origins[i], Directions[i], 1e30f, Result) ? 1 : 0;
+		}
+	});
+	std::printf("%d rays on %dx%d: pyramid walk %.3f ms, brute force %.1f ms, %.0fx\n", iRayCount, N, N, fFast, fSlow, fSlow / NX::NXMax(fFast, 1e-3));
+	NX_TEST_CHECK(iFastHits == iSlowHits);
+	NX_TEST_CHECK(iFastHits > 0);
+}
@@ -0,0 +1,121 @@
+/*
+ *  File:    NXMeshOptimizerTest.cpp
+ *
+ *  author:  张雄(zhang xiong, 1025679612@qq.com)
+ *  date:    2026_10_19
+ *  purpose: MeshOptimizer on a regular grid: the reordered triangle list lowers the simulated ACMR from row
+ *           order and from a shuffled order and keeps every triangle with its winding, the fetch order numbers
+ *           vertices by first use and moves them along, and 16 bit chunks rebuild the same triangles.
+ */
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "NXTestHeader.h"
+#include "../render/NXMeshOptimizer.h"
+
+namespace {
+	const int QUADS = 100;                    // QUADS x QUADS cells, (QUADS + 1)^2 vertices
+
+	std::vector<NXUInt32> GetGridIndexs() {
+		std::vector<NXUInt32> Indexs;
+		for (int r = 0; r < QUADS; ++r) {
+			for (int c = 0; c < QUADS; ++c) {
+				const NXUInt32 i00 = r * (QUADS + 1) + c, i01 = i00 + 1, i10 = i00 + QUADS + 1, i11 = i10 + 1;
+				const NXUInt32 Quad[6] = { i00, i01, i10, i10, i01, i11 };
+				Indexs.insert(Indexs.end(), Quad, Quad + 6);
+			}
+		}
+		return Indexs;
+	}
+
+	/**
+	 *  triangles rotated to start at their smallest index and sorted, the same for any order of the list
+	 *  that keeps every triangle's winding
+	 */
+	std::vector<NXUInt64> GetTriangleSet(const NXUInt32 *pIndexs, const int iIndexCount) {
+		std::vector<NXUInt64> Triangles;
+		for (int t = 0; t < iIndexCount / 3; ++t) {
+			const NXUInt32 *p = pIndexs + t * 3;
+			const int k = p[0] < p[1] ? (p[0] < p[2] ? 0 : 2) : (p[1] < p[2] ? 1 : 2);
+			Triangles.push_back(((NXUInt64)p[k] << 42) | ((NXUInt64)p[(k + 1) % 3] << 21) | p[(k + 2) % 3]);
+		}
+		std::sort(Triangles.begin(), Triangles.end());
+		return Triangles;
+	}
+}
+
+NX_TEST(NXMeshOptimizerTest) {
+	const int iVertexCount = (QUADS + 1) * (QUADS + 1);
+	const std::vector<NXUInt32> Grid = GetGridIndexs();
+	const int iIndexCount = (int)Grid.size();
+	const std::vector<NXUInt64> GridTriangles = GetTriangleSet(&Grid[0], iIndexCount);
+
+	{//rows longer than the cache transform every vertex about twice, a shuffled list nearly three times a triangle
+		std::vector<NXUInt32> Shuffled(Grid);
+		std::vector<int> Order(iIndexCount / 3);
+		for (int t = 0; t < (int)Order.size(); ++t) {
+			Order[t] = t;
+		}
+		std::shuffle(Order.begin(), Order.end(), std::mt19937(34));
+		for (int t = 0; t < (int)Order.size(); ++t) {
+			std::copy(&Grid[Order[t] * 3], &Grid[Order[t] * 3] + 3, &Shuffled[t * 3]);
+		}
+
+		const std::vector<NXUInt32> *Inputs[2] = { &Grid, &Shuffled };
+		for (int n = 0; n < 2; ++n) {
+			std::vector<NXUInt32> Indexs(*Inputs[n]);
+			const NX::MeshOptimizer::CacheStatistics Before = NX::MeshOptimizer::AnalyzeVertexCache(&Indexs[0], iIndexCount, iVertexCount);
+			NX::MeshOptimizer::OptimizeVertexCache(&Indexs[0], iIndexCount, iVertexCount);
+			const NX::MeshOptimizer::CacheStatistics After = NX::MeshOptimizer::AnalyzeVertexCache(&Indexs[0], iIndexCount, iVertexCount);
+			std::printf("%dx%d grid in %s order: ACMR %.3f -> %.3f, ATVR %.3f -> %.3f\n", QUADS, QUADS, n ? "shuffled" : "row",
+				Before.fACMR, After.fACMR, Before.fATVR, After.fATVR);
+
+			NX_TEST_CHECK(Before.iTriangleCount == QUADS * QUADS * 2 && Before.iVertexCount == iVertexCount);
+			NX_TEST_CHECK(After.iTriangleCount == Before.iTriangleCount && After.iVertexCount == Before.iVertexCount);
+			NX_TEST_CHECK(After.fACMR < Before.fACMR && After.fACMR < 0.8f);
+			NX_TEST_CHECK(After.fATVR < Before.fATVR);
+			NX_TEST_CHECK(GetTriangleSet(&Indexs[0], iIndexCount) == GridTriangles);
+		}
+	}
+
+	{//the fetch order numbers vertices by first use and carries their data along
+		std::vector<NXUInt32> Indexs(Grid), Vertexs(iVertexCount), Remap;
+		for (int v = 0; v < iVertexCount; ++v) {
+			Vertexs[v] = (NXUInt32)v;
+		}
+		NX::MeshOptimizer::OptimizeVertexCache(&Indexs[0], iIndexCount, iVertexCount);
+		const std::vector<NXUInt32> Reordered(Indexs);
+		NX_TEST_CHECK(NX::MeshOptimizer::OptimizeVertexFetch(&Vertexs[0], sizeof(NXUInt32), iVertexCount, &Indexs[0], iIndexCount, &Remap) == iVertexCount);
+
+		bool bFirstUse = true, bMoved = true;
+		NXUInt32 uNext = 0;
+		for (int i = 0; i < iIndexCount; ++i) {
+			bFirstUse = bFirstUse && Indexs[i] <= uNext;
+			uNext = std::max(uNext, Indexs[i] + 1);
+			bMoved = bMoved && Vertexs[Indexs[i]] == Reordered[i] && Remap[Reordered[i]] == Indexs[i];
+		}
+		NX_TEST_CHECK(bFirstUse);
+		NX_TEST_CHECK(bMoved);
+	}
+
+	{//16 bit chunks of at most 1000 vertices draw the same triangles
+		std::vector<NX::MeshOptimizer::Chunk> Chunks;
+		std::vector<NXUInt16> Indexs16;
+		std::vector<NXUInt32> Sources, Rebuilt;
+		NX::MeshOptimizer::SplitIndex16(&Grid[0], iIndexCount, iVertexCount, Chunks, Indexs16, Sources, 1000);
+		bool bFits = true;
+		for (size_t k = 0; k < Chunks.size(); ++k) {
+			const NX::MeshOptimizer::Chunk &Chunk = Chunks[k];
+			bFits = bFits && Chunk.iVertexCount <= 1000;
+			for (int i = 0; i < Chunk.iPrimitiveCount * 3; ++i) {
+				const NXUInt16 uLocal = Indexs16[Chunk.iStartIndex + i];
+				bFits = bFits && uLocal < Chunk.iVertexCount;
+				Rebuilt.push_back(Sources[Chunk.iBaseVertex + uLocal]);
+			}
+		}
+		NX_TEST_CHECK(Chunks.size() > 1 && bFits);
+		NX_TEST_CHECK(Rebuilt == Grid);
+	}
+}
@@ -0,0 +1,121 @@
+/*
+ *  File:    NXNoiseTest.cpp
+ *
+ *  author:  张雄(zhang xiong, 1025679612@qq.com)
+ *  date:    2026_10_19
+ *  purpose: NX::Noise batches against its scalar entry points bit for bit for every noise type, dimension
+ *           and fractal, single octaves inside [-1, 1], and the shared lattice hash of NXHash.h.
+ */
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "NXTestHeader.h"
+#include "../math/NXHash.h"
+#include "../math/NXMath.h"
+#include "../math/NXNoise.h"
+
+NX_TEST(NXNoiseTest) {
+	std::mt19937 Random(50);
+	std::uniform_real_distribution<float> Range(-300.f, 300.f);
+
+	const int iCount = 20003;   // not a multiple of 4, the batch tail goes through the scalar path
+	std::vector<float> Xs(iCount), Ys(iCount), Zs(iCount), Ws(iCount);
+	for (int i = 0; i < iCount; ++i) {
+		Xs[i] = Range(Random), Ys[i] = Range(Random), Zs[i] = Range(Random), Ws[i] = Range(Random);
+	}
+
+	NX::Noise Noise(1234);
+	Noise.SetOctaves(5);
+	const NX::Noise::NOISE_TYPE Types[] = { NX::Noise::NOISE_SIMPLEX, NX::Noise::NOISE_VALUE, NX::Noise::NOISE_GRADIENT };
+	for (int t = 0; t < 3; ++t) {
+		const NX::Noise::NOISE_TYPE eType = Types[t];
+		std::vector<float> Batch(iCount), Scalar(iCount);
+		float fLargest = 0.f;
+
+		//single octave, every dimension
+		for (int d = 2; d <= 4; ++d) {
+			if (d == 2) {
+				Noise.Sample(eType, &Xs[0], &Ys[0], &Batch[0], iCount);
+			} else if (d == 3) {
+				Noise.Sample(eType, &Xs[0], &Ys[0], &Zs[0], &Batch[0], iCount);
+			} else {
+				Noise.Sample(eType, &Xs[0], &Ys[0], &Zs[0], &Ws[0], &Batch[0], iCount);
+			}
+			for (int i = 0; i < iCount; ++i) {
+				Scalar[i] = d == 2 ? Noise.Sample(eType, Xs[i], Ys[i]) : (d == 3 ? Noise.Sample(eType, Xs[i], Ys[i], Zs[i]) : Noise.Sample(eType, Xs[i], Ys[i], Zs[i], Ws[i]));
+				fLargest = NX::NXMax(fLargest, std::fabs(Scalar[i]));
+			}
+			NX_TEST_CHECK(NX::Test::SameBits(&Batch[0], &Scalar[0], iCount));
+		}
+		std::printf("type %d: largest single octave value %g\n", t, fLargest);
+		NX_TEST_CHECK(fLargest <= 1.f && fLargest > 0.5f);
+
+		//fBm, every dimension
+		for (int d = 2; d <= 4; ++d) {
+			if (d == 2) {
+				Noise.Fbm(eType, &Xs[0], &Ys[0], &Batch[0], iCount);
+			} else if (d == 3) {
+				Noise.Fbm(eType, &Xs[0], &Ys[0], &Zs[0], &Batch[0], iCount);
+			} else {
+				Noise.Fbm(eType, &Xs[0], &Ys[0], &Zs[0], &Ws[0], &Batch[0], iCount);
+			}
+			for (int i = 0; i < iCount; ++i) {
+				Scalar[i] = d == 2 ? Noise.Fbm(eType, Xs[i], Ys[i]) : (d == 3 ? Noise.Fbm(eType, Xs[i], Ys[i], Zs[i]) : Noise.Fbm(eType, Xs[i], Ys[i], Zs[i], Ws[i]));
+			}
+			NX_TEST_CHECK(NX::Test::SameBits(&Batch[0], &Scalar[0], iCount));
+		}
+
+		//2D fractals
+		Noise.Ridged(eType, &Xs[0], &Ys[0], &Batch[0], iCount);
+		for (int i = 0; i < iCount; ++i) {
+			Scalar[i] = Noise.Ridged(eType, Xs[i], Ys[i]);
+		}
+		NX_TEST_CHECK(NX::Test::SameBits(&Batch[0], &Scalar[0], iCount));
+		Noise.Warp(eType, &Xs[0], &Ys[0], 2.f, &Batch[0], iCount);
+		for (int i = 0; i < iCount; ++i) {
+			Scalar[i] = Noise.Warp(eType, Xs[i], Ys[i], 2.f);
+		}
+		NX_TEST_CHECK(NX::Test::SameBits(&Batch[0], &Scalar[0], iCount));
+	}
+
+	{//curl
+		std::vector<float> Cx(iCount), Cy(iCount), Cz(iCount);
+		Noise.Curl(&Xs[0], &Ys[0], &Zs[0], &Cx[0], &Cy[0], &Cz[0], iCount);
+		bool bSame = true;
+		for (int i = 0; i < iCount; ++i) {
+			const NX::float3 c = Noise.Curl(NX::float3(Xs[i], Ys[i], Zs[i]));
+			bSame = bSame && NX::Test::SameBits(&c.x, &Cx[i], 1) && NX::Test::SameBits(&c.y, &Cy[i], 1) && NX::Test::SameBits(&c.z, &Cz[i], 1);
+		}
+		NX_TEST_CHECK(bSame);
+	}
+
+	{//another seed gives another field
+		const NX::Noise Other(1235);
+		int iSame = 0;
+		for (int i = 0; i < 1000; ++i) {
+			iSame += Other.Sample(NX::Noise::NOISE_GRADIENT, Xs[i], Ys[i]) == Noise.Sample(NX::Noise::NOISE_GRADIENT, Xs[i], Ys[i]) ? 1 : 0;
+		}
+		NX_TEST_CHECK(iSame < 10);
+	}
+
+#if NX_SIMD_SSE
+	{//the SSE lattice hash is the scalar one in every lane
+		bool bSame = true;
+		for (int i = 0; i < 1000; ++i) {
+			const NXUInt32 ix = (NXUInt32)Random(), iy = (NXUInt32)Random(), iz = (NXUInt32)Random(), iw = (NXUInt32)Random(), uSeed = (NXUInt32)Random();
+			NX_ALIGN(16) NXUInt32 Lanes[3][4];
+			_mm_store_si128((__m128i*)Lanes[0], NX::HashLattice(_mm_set1_epi32((int)ix), _mm_set1_epi32((int)iy), _mm_set1_epi32((int)uSeed)));
+			_mm_store_si128((__m128i*)Lanes[1], NX::HashLattice(_mm_set1_epi32((int)ix), _mm_set1_epi32((int)iy), _mm_set1_epi32((int)iz), _mm_set1_epi32((int)uSeed)));
+			_mm_store_si128((__m128i*)Lanes[2], NX::HashLattice(_mm_set1_epi32((int)ix), _mm_set1_epi32((int)iy), _mm_set1_epi32((int)iz), _mm_set1_epi32((int)iw), _mm_set1_epi32((int)uSeed)));
+			for (int l = 0; l < 4; ++l) {
+				bSame = bSame && Lanes[0][l] == NX::HashLattice(ix, iy, uSeed);
+				bSame = bSame && Lanes[1][l] == NX::HashLattice(ix, iy, iz, uSeed);
+				bSame = bSame && Lanes[2][l] == NX::HashLattice(ix, iy, iz, iw, uSeed);
+			}
+		}
+		NX_TEST_CHECK(bSame);
+	}
+#endif
+}
@@ -0,0 +1,82 @@
+/*
+ *  File:    NXOcclusionCullerTest.cpp
+ *
+ *  author:  张雄(zhang xiong, 1025679612@qq.com)
+ *  date:    2026_10_19
+ *  purpose: OcclusionCuller without device, a wall in front of the camera is rasterized and boxes fully behind
+ *           it are rejected while boxes in front of it, beside it or crossing the near plane stay visible. one
+ *           worker and four give the same depth buffer.
+ */
+
+#include <vector>
+
+#include "NXTestHeader.h"
+#include "../math/NXAABB.h"
+#include "../math/NXAlgorithm.h"
+#include "../render/NXCamera.h"
+#include "../render/NXOcclusionCuller.h"
+
+namespace {
+	const int   WIDTH = 160, HEIGHT = 96;
+	const float WALL_Z = 10.f, WALL_HALF = 4.f;
+
+	/**
+	 *  a square wall of two triangles facing the camera, WALL_Z in front of it
+	 */
+	void RenderWall(NX::OcclusionCuller &Culler, const NX::float4x4 &ViewProjectMatrix) {
+		const NX::float3 Vertexs[4] = {
+			NX::float3(-WALL_HALF,  WALL_HALF, WALL_Z), NX::float3(WALL_HALF,  WALL_HALF, WALL_Z),
+			NX::float3( WALL_HALF, -WALL_HALF, WALL_Z), NX::float3(-WALL_HALF, -WALL_HALF, WALL_Z),
+		};
+		const NXUInt32 Indexs[6] = { 0, 1, 2, 0, 2, 3 };
+		Culler.BeginFrame(ViewProjectMatrix);
+		Culler.AddOccluder(Vertexs, 4, Indexs, 6, NX::GetIdentityMatrix<float, 4>());
+		Culler.RenderOccluders();
+	}
+}
+
+NX_TEST(NXOcclusionCullerTest) {
+	NX::PerspectCamera Camera(NX::float3(0.f, 0.f, 0.f), NX::float3(0.f, 0.f, 1.f), NX::float3(0.f, 1.f, 0.f), 60.f, WIDTH * 1.f / HEIGHT, 0.1f, 1000.f);
+	const NX::float4x4 ViewProjectMatrix = Camera.GetWatchMatrix();
+	NX::OcclusionCuller Culler(WIDTH, HEIGHT, 1);
+	RenderWall(Culler, ViewProjectMatrix);
+
+	{//the wall covers the middle of the screen at its depth, the corners keep the far plane
+		const float *pDepth = Culler.GetDepthBuffer();
+		const float fCenter = pDepth[HEIGHT / 2 * WIDTH + WIDTH / 2];
+		NX_TEST_CHECK(fCenter > 0.f && fCenter < 1.f);
+		NX_TEST_CHECK(pDepth[0] == 1.f && pDepth[HEIGHT * WIDTH - 1] == 1.f);
+		NX_TEST_CHECK(Culler.GetStatistics().iOccluderTriangles == 2 && Culler.GetStatistics().iRasterizedTriangles == 2);
+
+		int iLevelWidth = 0, iLevelHeight = 0;
+		const float *pTop = Culler.GetHiZLevel(Culler.GetHiZLevelCount() - 1, iLevelWidth, iLevelHeight);
+		NX_TEST_CHECK(iLevelWidth == 1 && iLevelHeight == 1 && pTop[0] == 1.f);
+	}
+
+	{//only boxes completely behind the wall are occluded
+		const NX::AABB Boxes[] = {
+			NX::AABB(NX::float3(-1.f, -1.f, 20.f),  NX::float3(1.f, 1.f, 22.f)),        // behind the middle
+			NX::AABB(NX::float3(-4.f, -4.f, 30.f),  NX::float3(4.f, 4.f, 31.f)),        // farther behind, a third of the wall's shadow
+			NX::AABB(NX::float3(-1.f, -1.f, 5.f),   NX::float3(1.f, 1.f, 6.f)),         // in front of the wall
+			NX::AABB(NX::float3(-1.f, -1.f, 9.f),   NX::float3(1.f, 1.f, 12.f)),        // through the wall
+			NX::AABB(NX::float3(6.f, -1.f, 20.f),   NX::float3(10.f, 1.f, 22.f)),       // behind but sticking out beside it
+			NX::AABB(NX::float3(-1.f, -1.f, -1.f),  NX::float3(1.f, 1.f, 40.f)),        // around the eye, crosses the near plane
+			NX::AABB(NX::float3(-1.f, -1.f, -30.f), NX::float3(1.f, 1.f, -20.f)),       // behind the camera
+			NX::AABB(NX::float3(200.f, -1.f, 20.f), NX::float3(210.f, 1.f, 22.f)),      // off screen
+		};
+		const bool Expected[] = { true, true, false, false, false, false, false, false };
+		const int  iBoxCount  = (int)(sizeof(Boxes) / sizeof(Boxes[0]));
+		bool Occluded[iBoxCount];
+		Culler.TestOcclusion(Boxes, iBoxCount, Occluded);
+		for (int i = 0; i < iBoxCount; ++i) {
+			NX_TEST_CHECK(Occluded[i] == Expected[i]);
+			NX_TEST_CHECK(Culler.IsOccluded(Boxes[i]) == Expected[i]);
+		}
+	}
+
+	{//tiles are shared out between workers, the depth is the same
+		NX::OcclusionCuller Parts(WIDTH, HEIGHT, 4);
+		RenderWall(Parts, ViewProjectMatrix);
+		NX_TEST_CHECK(NX::Test::SameBits(Parts.GetDepthBuffer(), Culler.GetDepthBuffer(), WIDTH * HEIGHT));
+	}
+}
@@ -0,0 +1,183 @@
+/*
+ *  File:    NXParticleColliderTest.cpp
+ *
+ *  author:  张雄(zhang xiong, 1025679612@qq.com)
+ *  date:    2026_10_19
+ *  purpose: ParticleCollider against a flat and a sloped height field: exactly the particles below the surface
+ *           inside the field are contacts, stick lifts them onto it and stops them, bounce reflects them about
+ *           the slope's normal and kill marks them dead where they are. particles above the surface or beside
+ *           the field are left alone bit for bit, split ranges give the same streams as one call.
+ */
+
+#include <cmath>
+#include <vector>
+
+#include "NXTestHeader.h"
+#include "../Particle/NXParticleCollider.h"
+#include "../Particle/NXParticleStorage.h"
+#include "../entity/NXHeightField.h"
+
+namespace {
+	const int   SIZE = 33;                       // 32 x 32 cells of 1
+	const int   GRID = 41;                       // GRID x GRID particles over the field and beyond its borders
+	const float OFFSETS[4] = { -0.5f, 0.25f, -0.01f, 1.f };
+	const NX::float3 VELOCITY(0.3f, -1.f, 0.2f);
+
+	/**
+	 *  y = fSlope * x + 1 on every grid point
+	 */
+	void BuildField(NX::HeightField &Field, const float fSlope) {
+		for (int r = 0; r < SIZE; ++r) {
+			for (int c = 0; c < SIZE; ++c) {
+				Field.SetHeight(r, c, fSlope * r + 1.f);
+			}
+		}
+	}
+
+	/**
+	 *  particle k is OFFSETS[k % 4] above or below the surface, the x/z grid reaches 2 past every border
+	 */
+	void Fill(NX::ParticleStorage &Storage, const float fSlope) {
+		Storage.Clear();
+		Storage.Reserve(GRID * GRID);
+		for (int a = 0; a < GRID; ++a) {
+			for (int b = 0; b < GRID; ++b) {
+				const float x = -2.f + 0.9f * a, z = -1.95f + 0.9f * b;
+				const NX::float3 Position(x, fSlope * x + 1.f + OFFSETS[(a * GRID + b) % 4], z);
+				Storage.Add(Position, VELOCITY, NX::float3(0.f, 0.f, 0.f), NX::float3(1.f, 1.f, 1.f), 10.f, NX::float2(1.f, 1.f), 0);
+			}
+		}
+	}
+
+	bool IsContact(const NX::ParticleStorage &Storage, const int i) {
+		const NX::float3 Position = Storage.GetPosition(i);
+		return Position.x >= 0.f && Position.x <= SIZE - 1.f && Position.z >= 0.f && Position.z <= SIZE - 1.f && OFFSETS[i % 4] < 0.f;
+	}
+
+	std::vector<float> GetStreams(const NX::ParticleStorage &Storage) {
+		std::vector<float> Values;
+		for (int s = 0; s < NX::ParticleStorage::STREAM_COUNT; ++s) {
+			const float *pStream = Storage.GetStream((NX::ParticleStorage::STREAM)s);
+			Values.insert(Values.end(), pStream, pStream + Storage.GetCount());
+		}
+		return Values;
+	}
+
+	/**
+	 *  every stream of particle i the same as before the collision
+	 */
+	bool Untouched(const NX::ParticleStorage &Storage, const std::vector<float> &Before, const int i) {
+		bool bSame = true;
+		for (int s = 0; s < NX::ParticleStorage::STREAM_COUNT; ++s) {
+			const float fValue = Storage.GetStream((NX::ParticleStorage::STREAM)s)[i];
+			bSame = bSame && NX::Test::SameBits(&fValue, &Before[s * Storage.GetCount() + i], 1);
+		}
+		return bSame;
+	}
+
+	bool Near(const float a, const float b) {
+		return std::fabs(a - b) < 1e-4f;
+	}
+}
+
+NX_TEST(NXParticleColliderTest) {
+	const float Slopes[2] = { 0.f, 0.5f };
+	for (int n = 0; n < 2; ++n) {
+		const float fSlope = Slopes[n];
+		NX::HeightField Field(SIZE, SIZE, 1.f, 1.f);
+		BuildField(Field, fSlope);
+		const float fInvLength = 1.f / std::sqrt(fSlope * fSlope + 1.f);
+		const NX::float3 Normal(-fSlope * fInvLength, fInvLength, 0.f);
+
+		NX::ParticleStorage Storage;
+		Fill(Storage, fSlope);
+		const int iCount = Storage.GetCount();
+		int iExpected = 0;
+		for (int i = 0; i < iCount; ++i) {
+			iExpected += IsContact(Storage, i);
+		}
+		NX_TEST_CHECK(iExpected > 0 && iExpected < iCount / 2);
+		const std::vector<float> Before = GetStreams(Storage);
+
+		{//stick, lifted straight onto the surface and stopped
+			NX::ParticleCollider Collider;
+			Collider.SetHeightField(&Field, NX::ParticleCollider::RESPONSE_STICK);
+			NX_TEST_CHECK(!Collider.IsEmpty());
+			NX_TEST_CHECK(Collider.Collide(Storage) == iExpected);
+			bool bStuck = true, bUntouched = true;
+			for (int i = 0; i < iCount; ++i) {
+				if (!IsContact(Storage, i)) {
+					bUntouched = bUntouched && Untouched(Storage, Before, i);
+					continue;
+				}
+				const NX::float3 Position = Storage.GetPosition(i), Velocity = Storage.GetVelocity(i), AngularVelocity = Storage.GetAngularVelocity(i);
+				bStuck = bStuck && Position.x == Before[NX::ParticleStorage::POSITION_X * iCount + i] && Position.z == Before[NX::ParticleStorage::POSITION_Z * iCount + i];
+				bStuck = bStuck && Near(Position.y, fSlope * Position.x + 1.f) && Position.y == Field.GetHeight(Position.x, Position.z);
+				bStuck = bStuck && Velocity == NX::float3(0.f, 0.f, 0.f) && AngularVelocity == NX::float3(0.f, 0.f, 0.f);
+			}
+			NX_TEST_CHECK(bStuck);
+			NX_TEST_CHECK(bUntouched);
+
+			//on the surface is not below it
+			NX_TEST_CHECK(Collider.Collide(Storage) == 0);
+		}
+
+		{//bounce, the normal speed reflected by the restitution, the tangential one damped by the friction
+			Fill(Storage, fSlope);
+			NX::ParticleCollider Collider;
+			Collider.SetHeightField(&Field, NX::ParticleCollider::RESPONSE_BOUNCE).SetRestitution(0.5f).SetFriction(0.25f);
+			NX_TEST_CHECK(Collider.Collide(Storage) == iExpected);
+			const float fNormalSpeed = VELOCITY.x * Normal.x + VELOCITY.y * Normal.y + VELOCITY.z * Normal.z;
+			const NX::float3 Expected = VELOCITY * 0.75f - Normal * (fNormalSpeed * (0.75f + 0.5f));
+			bool bBounced = true, bUntouched = true;
+			for (int i = 0; i < iCount; ++i) {
+				if (!IsContact(Storage, i)) {
+					bUntouched = bUntouched && Untouched(Storage, Before, i);
+					continue;
+				}
+				const NX::float3 Position = Storage.GetPosition(i), Velocity = Storage.GetVelocity(i);
+				bBounced = bBounced && Near(Position.y, fSlope * Position.x + 1.f);
+				bBounced = bBounced && Near(Velocity.x, Expected.x) && Near(Velocity.y, Expected.y) && Near(Velocity.z, Expected.z);
+				bBounced = bBounced && Near(Velocity.x * Normal.x + Velocity.y * Normal.y + Velocity.z * Normal.z, -0.5f * fNormalSpeed);
+				bBounced = bBounced && Storage.GetAngularVelocity(i) == NX::float3(1.f, 1.f, 1.f);
+			}
+			NX_TEST_CHECK(fNormalSpeed < 0.f);
+			NX_TEST_CHECK(bBounced);
+			NX_TEST_CHECK(bUntouched);
+		}
+
+		{//kill, aged out in place and added to the death mask, split ranges do the same
+			Fill(Storage, fSlope);
+			NX::ParticleCollider Collider;
+			Collider.SetHeightField(&Field, NX::ParticleCollider::RESPONSE_KILL);
+			std::vector<NXUInt8> DeadMask(Storage.GetDeadMaskSize(), 0);
+			NX_TEST_CHECK(Collider.Collide(Storage, &DeadMask[0]) == iExpected);
+			bool bKilled = true;
+			for (int i = 0; i < iCount; ++i) {
+				const bool bDead = ((DeadMask[i / NX::ParticleStorage::DEAD_MASK_GROUP] >> (i % NX::ParticleStorage::DEAD_MASK_GROUP)) & 1) != 0;
+				bKilled = bKilled && bDead == IsContact(Storage, i) && Storage.IsDead(i) == bDead;
+				bKilled = bKilled && NX::Test::SameBits(&Storage.GetStream(NX::ParticleStorage::POSITION_Y)[i], &Before[NX::ParticleStorage::POSITION_Y * iCount + i], 1);
+			}
+			NX_TEST_CHECK(bKilled);
+
+			const std::vector<float> Whole = GetStreams(Storage);
+			Fill(Storage, fSlope);
+			std::vector<NXUInt8> SplitMask(Storage.GetDeadMaskSize(), 0);
+			const int iSplit = 100 * NX::ParticleStorage::DEAD_MASK_GROUP;
+			NX_TEST_CHECK(Collider.Collide(Storage, 0, iSplit, &SplitMask[0]) + Collider.Collide(Storage, iSplit, iCount, &SplitMask[0]) == iExpected);
+			NX_TEST_CHECK(GetStreams(Storage) == Whole);
+			NX_TEST_CHECK(SplitMask == DeadMask);
+		}
+	}
+
+	{//without colliders nothing happens, Clear forgets the height field
+		NX::HeightField Field(SIZE, SIZE, 1.f, 1.f);
+		BuildField(Field, 0.f);
+		NX::ParticleStorage Storage;
+		Fill(Storage, 0.f);
+		NX::ParticleCollider Collider;
+		NX_TEST_CHECK(Collider.IsEmpty() && Collider.Collide(Storage) == 0);
+		Collider.SetHeightField(&Field, NX::ParticleCollider::RESPONSE_STICK).Clear();
+		NX_TEST_CHECK(Collider.IsEmpty() && Collider.Collide(Storage) == 0);
+	}
+}
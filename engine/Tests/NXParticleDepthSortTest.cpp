@@ -0,0 +1,183 @@
+/*
+ *  File:    NXParticleDepthSortTest.cpp
+ *
+ *  author:  张雄(zhang xiong, 1025679612@qq.com)
+ *  date:    2026_10_19
+ *  purpose: ParticleDepthSort against std::stable_sort of the live particles by depth key, on whole number
+ *           positions so many depths tie and equal keys have to stay in index order. the radix sort with one
+ *           and several ranges, the insertion sort finishing the previous order, and the radix sort taking
+ *           over when the previous order names a dead particle. NXParticleDepthSortBenchmark times 1M.
+ */
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "NXTestHeader.h"
+#include "../Particle/NXParticleDepthSort.h"
+#include "../Particle/NXParticleStorage.h"
+#include "../common/NXParallel.h"
+#include "../math/NXMath.h"
+
+namespace {
+	const NX::float3 EYE(3.5f, 10.f, -2.f), FRONT(0.6f, 0.f, 0.8f);
+
+	/**
+	 *  the first iStill particles keep still on a 41 x 41 x 41 grid so many of them share a depth, the others
+	 *  move from anywhere in the same box
+	 */
+	void Fill(NX::ParticleStorage &Storage, const int iCount, const int iStill, const unsigned int uSeed) {
+		std::mt19937 Random(uSeed);
+		std::uniform_int_distribution<int> Grid(-20, 20);
+		std::uniform_real_distribution<float> Unit(-1.f, 1.f), Life(0.5f, 4.f);
+		Storage.Clear();
+		Storage.Reserve(iCount);
+		for (int i = 0; i < iCount; ++i) {
+			const bool bStill = i < iStill;
+			const NX::float3 Position = bStill ? NX::float3((float)Grid(Random), (float)Grid(Random), (float)Grid(Random)) : NX::float3(Unit(Random), Unit(Random), Unit(Random)) * 20.f;
+			const NX::float3 Velocity = bStill ? NX::float3(0.f, 0.f, 0.f) : NX::float3(Unit(Random), Unit(Random), Unit(Random));
+			Storage.Add(Position, Velocity, NX::float3(0.f, 0.f, 0.f), NX::float3(0.f, 0.f, 0.f), Life(Random), NX::float2(1.f, 1.f), 0);
+		}
+	}
+
+	/**
+	 *  a short step of the positions without aging, the same particles stay alive
+	 */
+	void Move(NX::ParticleStorage &Storage, const float fDelta) {
+		for (int s = 0; s < 3; ++s) {
+			float *pPosition = Storage.GetStream((NX::ParticleStorage::STREAM)(NX::ParticleStorage::POSITION_X + s));
+			const float *pVelocity = Storage.GetStream((NX::ParticleStorage::STREAM)(NX::ParticleStorage::VELOCITY_X + s));
+			for (int i = 0; i < Storage.GetCount(); ++i) {
+				pPosition[i] += pVelocity[i] * fDelta;
+			}
+		}
+	}
+
+	/**
+	 *  the live particles in index order, stable sorted farthest first with the key Sort gives them
+	 */
+	std::vector<NXUInt32> GetReferenceOrder(const NX::ParticleStorage &Storage) {
+		const float *px = Storage.GetStream(NX::ParticleStorage::POSITION_X);
+		const float *py = Storage.GetStream(NX::ParticleStorage::POSITION_Y);
+		const float *pz = Storage.GetStream(NX::ParticleStorage::POSITION_Z);
+		std::vector<NXUInt32> Order, Keys(Storage.GetCount());
+		for (int i = 0; i < Storage.GetCount(); ++i) {
+			const float fDepth = (px[i] - EYE.x) * FRONT.x + (py[i] - EYE.y) * FRONT.y + (pz[i] - EYE.z) * FRONT.z;
+			Keys[i] = NX::ParticleDepthSort::GetSortKey(-fDepth);
+			if (!Storage.IsDead(i)) {
+				Order.push_back((NXUInt32)i);
+			}
+		}
+		std::stable_sort(Order.begin(), Order.end(), [&](const NXUInt32 a, const NXUInt32 b) { return Keys[a] < Keys[b]; });
+		return Order;
+	}
+
+	bool SameOrder(const NX::ParticleDepthSort &Sorter, const std::vector<NXUInt32> &Reference) {
+		return Sorter.GetOrderCount() == (int)Reference.size() && (Reference.empty() || NX::Test::SameBits(Sorter.GetOrder(), &Reference[0], (int)Reference.size()));
+	}
+}
+
+NX_TEST(NXParticleDepthSortKeyTest) {
+	const float Values[] = { -1e30f, -1.f, -1e-40f, -0.f, 0.f, 1e-40f, 1.f, 1e30f };
+	bool bIncreasing = true;
+	for (int i = 1; i < (int)(sizeof(Values) / sizeof(Values[0])); ++i) {
+		bIncreasing = bIncreasing && NX::ParticleDepthSort::GetSortKey(Values[i - 1]) < NX::ParticleDepthSort::GetSortKey(Values[i]);
+	}
+	NX_TEST_CHECK(bIncreasing);
+}
+
+NX_TEST(NXParticleDepthSortTest) {
+	//4 ranges of MIN_PART_SIZE and a bit, a third of the particles die in the first tick
+	const int iCount = 4 * NX::ParticleDepthSort::MIN_PART_SIZE + 1234;
+	NX::ParticleStorage Storage;
+	Fill(Storage, iCount, iCount / 2, 46);
+	std::vector<NXUInt8> DeadMask(Storage.GetDeadMaskSize());
+	Storage.Integrate(1.f, NX::float3(0.f, 0.f, 0.f), NX::float3(0.f, 0.f, 0.f), &DeadMask[0]);
+	const std::vector<NXUInt32> Reference = GetReferenceOrder(Storage);
+	NX_TEST_CHECK(!Reference.empty() && (int)Reference.size() < iCount);
+
+	{//the radix sort, from the death mask or from the ages, with one range or four
+		NX::ParticleDepthSort Sorter;
+		NX::ParticleDepthSort::Statistics Statistics;
+		for (int iWorkers = 1; iWorkers <= 4; iWorkers += 3) {
+			Sorter.SetWorkerCount(iWorkers).SetMaxInsertionMoves(0.f);
+			NX_TEST_CHECK(Sorter.Sort(Storage, &DeadMask[0], EYE, FRONT, &Statistics) == (int)Reference.size());
+			NX_TEST_CHECK(SameOrder(Sorter, Reference));
+			NX_TEST_CHECK(!Statistics.bIncremental && Statistics.iDescents == -1 && Statistics.iRadixPasses > 0);
+			NX_TEST_CHECK(Statistics.iLiveCount == (int)Reference.size());
+
+			Sorter.Sort(Storage, nullptr, EYE, FRONT);
+			NX_TEST_CHECK(SameOrder(Sorter, Reference));
+		}
+	}
+
+	{//the next tick reuses the order and the insertion sort finishes it, still stable
+		NX::ParticleDepthSort Sorter;
+		NX::ParticleDepthSort::Statistics Statistics;
+		Sorter.SetWorkerCount(4).SetMaxInsertionMoves(1.f);
+		Sorter.Sort(Storage, &DeadMask[0], EYE, FRONT, &Statistics);
+		NX_TEST_CHECK(!Statistics.bIncremental && Statistics.iDescents == -1);
+
+		Move(Storage, 0.001f);
+		const std::vector<NXUInt32> Moved = GetReferenceOrder(Storage);
+		NX_TEST_CHECK(Moved.size() == Reference.size());
+		Sorter.Sort(Storage, &DeadMask[0], EYE, FRONT, &Statistics);
+		NX_TEST_CHECK(SameOrder(Sorter, Moved));
+		NX_TEST_CHECK(Statistics.bIncremental && Statistics.iDescents > 0 && Statistics.iInsertionMoves >= Statistics.iDescents);
+		NX_TEST_CHECK(Statistics.iRadixPasses == 0);
+
+		//a sorted order takes no moves, one range gives the same order
+		Sorter.SetWorkerCount(1).Sort(Storage, &DeadMask[0], EYE, FRONT, &Statistics);
+		NX_TEST_CHECK(SameOrder(Sorter, Moved));
+		NX_TEST_CHECK(Statistics.bIncremental && Statistics.iDescents == 0 && Statistics.iInsertionMoves == 0);
+
+		//a particle of the previous order died, the live set changed and the radix sort runs
+		const int iVictim = (int)Moved[Moved.size() / 2];
+		Storage.GetStream(NX::ParticleStorage::AGE)[iVictim] = Storage.GetStream(NX::ParticleStorage::LIFE_TIME)[iVictim];
+		Storage.Integrate(0.f, NX::float3(0.f, 0.f, 0.f), NX::float3(0.f, 0.f, 0.f), &DeadMask[0]);
+		Sorter.Sort(Storage, &DeadMask[0], EYE, FRONT, &Statistics);
+		NX_TEST_CHECK(SameOrder(Sorter, GetReferenceOrder(Storage)));
+		NX_TEST_CHECK(!Statistics.bIncremental && Statistics.iLiveCount == (int)Moved.size() - 1);
+
+		//after Reset the previous order is gone
+		Sorter.Reset();
+		Sorter.Sort(Storage, &DeadMask[0], EYE, FRONT, &Statistics);
+		NX_TEST_CHECK(SameOrder(Sorter, GetReferenceOrder(Storage)));
+		NX_TEST_CHECK(Statistics.iDescents == -1);
+	}
+}
+
+NX_TEST(NXParticleDepthSortBenchmark) {
+	const int iCount = 1 << 20, iRuns = 6;
+	NX::ParticleStorage Storage, Moved;
+	Fill(Storage, iCount, 0, 7);
+	std::vector<NXUInt8> DeadMask(Storage.GetDeadMaskSize());
+	Storage.Integrate(0.6f, NX::float3(0.f, -1.f, 0.f), NX::float3(0.f, 0.f, 0.f), &DeadMask[0]);
+	Fill(Moved, iCount, 0, 7);
+	std::vector<NXUInt8> MovedMask(Moved.GetDeadMaskSize());
+	Moved.Integrate(0.6f, NX::float3(0.f, -1.f, 0.f), NX::float3(0.f, 0.f, 0.f), &MovedMask[0]);
+	Move(Moved, 1e-5f);
+	const std::vector<NXUInt32> Reference = GetReferenceOrder(Storage), MovedReference = GetReferenceOrder(Moved);
+
+	NX::ParticleDepthSort Sorter;
+	Sorter.SetWorkerCount(0);
+	const double fReference = NX::Test::GetBestMilliSeconds(2, [&]() { GetReferenceOrder(Storage); });
+
+	Sorter.SetMaxInsertionMoves(0.f);
+	const double fRadix = NX::Test::GetBestMilliSeconds(iRuns, [&]() { Sorter.Sort(Storage, &DeadMask[0], EYE, FRONT); });
+	NX_TEST_CHECK(SameOrder(Sorter, Reference));
+
+	//one tick apart, every sort starts from the other one's order
+	NX::ParticleDepthSort::Statistics Statistics;
+	int iRun = 0;
+	Sorter.SetMaxInsertionMoves(1.f);
+	const double fIncremental = NX::Test::GetBestMilliSeconds(iRuns, [&]() {
+		const bool bMoved = (iRun++ & 1) != 0;
+		Sorter.Sort(bMoved ? Moved : Storage, bMoved ? &MovedMask[0] : &DeadMask[0], EYE, FRONT, &Statistics);
+	});
+	NX_TEST_CHECK(SameOrder(Sorter, (iRun & 1) ? Reference : MovedReference));
+	NX_TEST_CHECK(Statistics.bIncremental);
+
+	std::printf("%d live of %d particles, %d workers: radix %.2f ms, one tick later %.2f ms with %d descents and %d moves, keys and std::stable_sort %.2f ms\n",
+		(int)Reference.size(), iCount, NX::GetHardwareThreadCount(), fRadix, fIncremental, Statistics.iDescents, Statistics.iInsertionMoves, fReference);
+}
@@ -0,0 +1,178 @@
+/*
+ *  File:    NXParticleStorageTest.cpp
+ *
+ *  author:  张雄(zhang xiong, 1025679612@qq.com)
+ *  date:    2026_10_19
+ *  purpose: ParticleStorage's SSE Integrate against IntegrateScalar bit for bit, streams, death masks and dead
+ *           counts, for counts around the 8 particle group so the masked tail is covered, and for split ranges.
+ *           NXParticleIntegrateBenchmark times both on 4096 particles in cache and on 1M particles.
+ *           NXParticleStorageBenchmark times 1M particles against the std::vector<Particle*> they replaced.
+ */
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "NXTestHeader.h"
+#include "../Particle/NXParticle.h"
+#include "../Particle/NXParticleStorage.h"
+#include "../math/NXMath.h"
+
+namespace {
+	void Fill(NX::ParticleStorage &Storage, const int iCount, const unsigned int uSeed) {
+		std::mt19937 Random(uSeed);
+		std::uniform_real_distribution<float> Unit(-1.f, 1.f), Life(0.1f, 2.f);
+		Storage.Clear();
+		Storage.Reserve(iCount);
+		for (int i = 0; i < iCount; ++i) {
+			const NX::float3 Position(Unit(Random) * 50.f, Unit(Random) * 50.f, Unit(Random) * 50.f);
+			const NX::float3 Velocity(Unit(Random) * 3.f, Unit(Random) * 3.f, Unit(Random) * 3.f);
+			const NX::float3 Rotation(Unit(Random) * 6.f + 3.f, Unit(Random) * 3.f + 3.f, Unit(Random) + 3.f);
+			const NX::float3 AngularVelocity(Unit(Random) * 5.f, Unit(Random) * 5.f, Unit(Random) * 5.f);
+			Storage.Add(Position, Velocity, Rotation, AngularVelocity, Life(Random), NX::float2(1.f, 1.f), i % 4);
+		}
+	}
+
+	bool SameParticles(const NX::ParticleStorage &A, const NX::ParticleStorage &B) {
+		if (A.GetCount() != B.GetCount()) {
+			return false;
+		}
+		bool bSame = true;
+		for (int s = 0; s < NX::ParticleStorage::STREAM_COUNT; ++s) {
+			const NX::ParticleStorage::STREAM eStream = (NX::ParticleStorage::STREAM)s;
+			bSame = bSame && NX::Test::SameBits(A.GetStream(eStream), B.GetStream(eStream), A.GetCount());
+		}
+		return bSame && NX::Test::SameBits(A.GetTextureIndexs(), B.GetTextureIndexs(), A.GetCount());
+	}
+}
+
+NX_TEST(NXParticleIntegrateTest) {
+	const NX::float3 Gravity(0.3f, -9.8f, 0.1f), AngularAcceleration(0.5f, -0.25f, 0.125f);
+	const int Counts[] = { 1, 5, 7, 8, 9, 13, 15, 16, 17, 31, 1003 };
+	for (int n = 0; n < (int)(sizeof(Counts) / sizeof(Counts[0])); ++n) {
+		const int iCount = Counts[n];
+		NX::ParticleStorage Simd, Scalar, Split;
+		Fill(Simd, iCount, 41 + iCount), Fill(Scalar, iCount, 41 + iCount), Fill(Split, iCount, 41 + iCount);
+		std::vector<NXUInt8> SimdMask(Simd.GetDeadMaskSize()), ScalarMask(Scalar.GetDeadMaskSize()), SplitMask(Split.GetDeadMaskSize());
+
+		//ages run past most life times, the last ticks see every particle dead
+		bool bSame = true;
+		for (int t = 0; t < 48; ++t) {
+			const int iSimdDead   = Simd.Integrate(0.05f, Gravity, AngularAcceleration, &SimdMask[0]);
+			const int iScalarDead = Scalar.IntegrateScalar(0.05f, Gravity, AngularAcceleration, &ScalarMask[0]);
+			const int iMiddle     = iCount / 2 / NX::ParticleStorage::DEAD_MASK_GROUP * NX::ParticleStorage::DEAD_MASK_GROUP;
+			const int iSplitDead  = Split.Integrate(0, iMiddle, 0.05f, Gravity, AngularAcceleration, &SplitMask[0]) + Split.Integrate(iMiddle, iCount, 0.05f, Gravity, AngularAcceleration, &SplitMask[0]);
+			bSame = bSame && iSimdDead == iScalarDead && iSplitDead == iScalarDead;
+			bSame = bSame && NX::Test::SameBits(&SimdMask[0], &ScalarMask[0], (int)SimdMask.size()) && NX::Test::SameBits(&SplitMask[0], &ScalarMask[0], (int)SplitMask.size());
+			bSame = bSame && SameParticles(Simd, Scalar) && SameParticles(Split, Scalar);
+		}
+		NX_TEST_CHECK(bSame);
+
+		//the mask and IsDead agree, nothing is set past the count
+		bool bMaskMatches = true;
+		for (int i = 0; i < (int)SimdMask.size() * NX::ParticleStorage::DEAD_MASK_GROUP; ++i) {
+			const bool bMasked = (SimdMask[i / NX::ParticleStorage::DEAD_MASK_GROUP] >> (i % NX::ParticleStorage::DEAD_MASK_GROUP)) & 1;
+			bMaskMatches = bMaskMatches && bMasked == (i < iCount && Simd.IsDead(i));
+		}
+		NX_TEST_CHECK(bMaskMatches);
+		NX_TEST_CHECK(Simd.RemoveDead(&SimdMask[0]) == iCount && Simd.GetCount() == 0);
+	}
+}
+
+NX_TEST(NXParticleIntegrateBenchmark) {
+	const NX::float3 Gravity(0.f, -9.8f, 0.f), AngularAcceleration(0.f, 0.f, 0.f);
+	const int Counts[] = { 4096, 1 << 20 };
+	for (int n = 0; n < (int)(sizeof(Counts) / sizeof(Counts[0])); ++n) {
+		//4096 particles stay in cache, 1M stream from memory
+		const int iCount = Counts[n], iRuns = iCount < 65536 ? 200 : 10;
+		NX::ParticleStorage Simd, Scalar;
+		Fill(Simd, iCount, 7), Fill(Scalar, iCount, 7);
+		std::vector<NXUInt8> SimdMask(Simd.GetDeadMaskSize()), ScalarMask(Scalar.GetDeadMaskSize());
+
+		int iSimdDead = 0, iScalarDead = 0;
+		const double fSimd   = NX::Test::GetBestMilliSeconds(iRuns, [&]() { iSimdDead = Simd.Integrate(0.016f, Gravity, AngularAcceleration, &SimdMask[0]); });
+		const double fScalar = NX::Test::GetBestMilliSeconds(iRuns, [&]() { iScalarDead = Scalar.IntegrateScalar(0.016f, Gravity, AngularAcceleration, &ScalarMask[0]); });
+		std::printf("%d particles: Integrate %.3f ms, IntegrateScalar %.3f ms, %.1fx\n", iCount, fSimd, fScalar, fScalar / NX::NXMax(fSimd, 1e-4));
+
+		NX_TEST_CHECK(iSimdDead == iScalarDead);
+		NX_TEST_CHECK(NX::Test::SameBits(&SimdMask[0], &ScalarMask[0], (int)SimdMask.size()));
+		NX_TEST_CHECK(SameParticles(Simd, Scalar));
+	}
+}
+
+NX_TEST(NXParticleStorageBenchmark) {
+	const int iCount = 1 << 20, iTicks = 30;
+	const float fDelta = 0.016f;
+	const NX::float3 Gravity(0.f, -9.8f, 0.f), AngularAcceleration(0.f, 0.f, 0.f);
+	std::mt19937 Random(40);
+	std::uniform_real_distribution<float> Unit(-1.f, 1.f), Angle(0.f, 6.f), Life(0.1f, 2.f);
+
+	//the same particles both ways, angles already wrapped so both start from the same rotation
+	std::vector<NX::Particle*> Particles(iCount);
+	NX::ParticleStorage Storage;
+	Storage.Reserve(iCount);
+	for (int i = 0; i < iCount; ++i) {
+		const NX::float3 Position(Unit(Random) * 50.f, Unit(Random) * 50.f, Unit(Random) * 50.f);
+		const NX::float3 Velocity(Unit(Random) * 3.f, Unit(Random) * 3.f, Unit(Random) * 3.f);
+		const NX::float3 Rotation(Angle(Random), Angle(Random), Angle(Random));
+		const NX::float3 AngularVelocity(Unit(Random) * 5.f, Unit(Random) * 5.f, Unit(Random) * 5.f);
+		const float fLifeTime = iTicks * fDelta + Life(Random);
+		Particles[i] = new NX::Particle(i % 4, Rotation, Position, Gravity, AngularAcceleration, Velocity, AngularVelocity, fLifeTime, NX::float2(1.f, 1.f));
+		Storage.Add(Position, Velocity, Rotation, AngularVelocity, fLifeTime, NX::float2(1.f, 1.f), i % 4);
+	}
+
+	{//a tick, every particle lives through all of them so both integrate the same steps
+		std::vector<NXUInt8> DeadMask(Storage.GetDeadMaskSize());
+		double fPointer = 1e30, fScalar = 1e30, fSimd = 1e30;
+		auto TickPointers = [&]() {
+			for (int i = 0; i < iCount; ++i) {
+				Particles[i]->OnTick(fDelta);
+			}
+		};
+		for (int t = 0; t < iTicks; t += 3) {//each timed tick is caught up on by the other ones untimed
+			fPointer = NX::NXMin(fPointer, NX::Test::GetBestMilliSeconds(1, TickPointers));
+			Storage.IntegrateScalar(fDelta, Gravity, AngularAcceleration, &DeadMask[0]);
+			fScalar = NX::NXMin(fScalar, NX::Test::GetBestMilliSeconds(1, [&]() { Storage.IntegrateScalar(fDelta, Gravity, AngularAcceleration, &DeadMask[0]); }));
+			TickPointers();
+			fSimd = NX::NXMin(fSimd, NX::Test::GetBestMilliSeconds(1, [&]() { Storage.Integrate(fDelta, Gravity, AngularAcceleration, &DeadMask[0]); }));
+			TickPointers();
+		}
+		std::printf("%d particles a tick: std::vector<Particle*> %.2f ms, IntegrateScalar %.2f ms (%.1fx), Integrate %.2f ms (%.1fx)\n",
+			iCount, fPointer, fScalar, fPointer / NX::NXMax(fScalar, 1e-3), fSimd, fPointer / NX::NXMax(fSimd, 1e-3));
+
+		bool bSame = true;
+		for (int i = 0; i < iCount; ++i) {
+			const NX::float3 Position = Storage.GetPosition(i), Rotation = Storage.GetRotation(i);
+			bSame = bSame && NX::Test::SameBits(&Particles[i]->GetPosition().x, &Position.x, 3) && NX::Test::SameBits(&Particles[i]->GetRotation().x, &Rotation.x, 3);
+		}
+		NX_TEST_CHECK(bSame);
+	}
+
+	{//a late tick kills a few percent, swap removes by the mask against erasing the pointers
+		const float fLate = 0.15f;
+		std::vector<NXUInt8> DeadMask(Storage.GetDeadMaskSize());
+		const int iDead = Storage.Integrate(fLate, Gravity, AngularAcceleration, &DeadMask[0]);
+		for (int i = 0; i < iCount; ++i) {
+			Particles[i]->OnTick(fLate);
+		}
+		int iRemoved = 0;
+		const double fSwap = NX::Test::GetBestMilliSeconds(1, [&]() { iRemoved = Storage.RemoveDead(&DeadMask[0]); });
+		const double fErase = NX::Test::GetBestMilliSeconds(1, [&]() {
+			Particles.erase(std::remove_if(Particles.begin(), Particles.end(), [](NX::Particle *pParticle) {
+				const bool bDied = pParticle->IsDied();
+				if (bDied) {
+					delete pParticle;
+				}
+				return bDied;
+			}), Particles.end());
+		});
+		std::printf("%d of %d dead removed: RemoveDead %.2f ms, std::remove_if and delete %.2f ms\n", iRemoved, iCount, fSwap, fErase);
+		NX_TEST_CHECK(iRemoved == iDead && iDead > 0 && Storage.GetCount() == (int)Particles.size());
+	}
+
+	const double fStorageBytes = (double)Storage.GetCapacity() * (NX::ParticleStorage::STREAM_COUNT * sizeof(float) + sizeof(NXInt32)) / iCount;
+	std::printf("bytes a particle: ParticleStorage %.1f, std::vector<Particle*> %d\n", fStorageBytes, (int)(sizeof(NX::Particle) + sizeof(NX::Particle*)));
+	for (int i = 0; i < (int)Particles.size(); ++i) {
+		delete Particles[i];
+	}
+}
@@ -0,0 +1,111 @@
+/*
+ *  File:    NXQuadIndexBufferTest.cpp
+ *
+ *  author:  张雄(zhang xiong, 1025679612@qq.com)
+ *  date:    2026_10_19
+ *  purpose: QuadIndexBuffer without device: the quad indices of Particle::FillIndexBuffer, two systems drawing
+ *           different counts every frame share one buffer that only grows to the next power of two, frames
+ *           after the growth upload no index, and the indices a per frame rewrite would add are a fifth of it.
+ */
+
+#include <vector>
+
+#include "NXTestHeader.h"
+#include "../Particle/NXParticle.h"
+#include "../Particle/NXQuadIndexBuffer.h"
+
+namespace {
+	const int FRAMES = 100;
+
+	/**
+	 *  the quads two systems draw in frame f, the first one grows over the frames, the second keeps its count
+	 */
+	int GetQuadCount(const int iSystem, const int f) {
+		return iSystem == 0 ? 3000 + 300 * f : 6000;
+	}
+
+	/**
+	 *  what Snow::Render does with the shared buffer
+	 */
+	void DrawFrame(const int f) {
+		NX::QuadIndexBuffer &SharedIndexs = NX::QuadIndexBuffer::Instance();
+		for (int s = 0; s < 2; ++s) {
+			const int iQuadCount = GetQuadCount(s, f);
+			SharedIndexs.Acquire(iQuadCount);
+			SharedIndexs.AddVertexUpload((NXUInt64)iQuadCount * NX::QuadIndexBuffer::VERTEXS_PER_QUAD * sizeof(NX::Particle::Vertex));
+		}
+	}
+}
+
+NX_TEST(NXQuadIndexBufferTest) {
+	{//the indices and capacities of a quad list
+		std::vector<NXUInt32> Indexs(NX::QuadIndexBuffer::INDEXS_PER_QUAD * 3);
+		NX::QuadIndexBuffer::FillQuadIndexs(&Indexs[0], 5, 3);
+		bool bSame = true;
+		for (int q = 0; q < 3; ++q) {
+			int Reference[NX::QuadIndexBuffer::INDEXS_PER_QUAD];
+			NX::Particle().FillIndexBuffer(Reference, (5 + q) * NX::QuadIndexBuffer::VERTEXS_PER_QUAD);
+			for (int k = 0; k < NX::QuadIndexBuffer::INDEXS_PER_QUAD; ++k) {
+				bSame = bSame && Indexs[q * NX::QuadIndexBuffer::INDEXS_PER_QUAD + k] == (NXUInt32)Reference[k];
+			}
+		}
+		NX_TEST_CHECK(bSame);
+		NX_TEST_CHECK(NX::QuadIndexBuffer::GetGrownCapacity(0, 1) == NX::QuadIndexBuffer::MIN_QUAD_CAPACITY);
+		NX_TEST_CHECK(NX::QuadIndexBuffer::GetGrownCapacity(1024, 1025) == 2048);
+		NX_TEST_CHECK(NX::QuadIndexBuffer::GetGrownCapacity(2048, 100) == 2048);
+		NX_TEST_CHECK(NX::QuadIndexBuffer::GetGrownCapacity(0, 40000) == 65536);
+	}
+
+	NX::QuadIndexBuffer &SharedIndexs = NX::QuadIndexBuffer::Instance();
+	SharedIndexs.Release();
+	SharedIndexs.ResetUploadCounters();
+	const int iGrowCount = SharedIndexs.GetStatistics().iGrowCount;
+
+	{//two systems share it, it grows to 4096 and 8192 in the first frame and twice more, never shrinks
+		NXUInt64 uQuads = 0;
+		bool bGrowOnly = true;
+		int iCapacity = 0;
+		for (int f = 0; f < FRAMES; ++f) {
+			DrawFrame(f);
+			uQuads += GetQuadCount(0, f) + GetQuadCount(1, f);
+			bGrowOnly = bGrowOnly && SharedIndexs.GetStatistics().iQuadCapacity >= iCapacity;
+			iCapacity = SharedIndexs.GetStatistics().iQuadCapacity;
+		}
+		const NX::QuadIndexBuffer::Statistics &Statistics = SharedIndexs.GetStatistics();
+		NX_TEST_CHECK(bGrowOnly);
+		NX_TEST_CHECK(Statistics.iQuadCapacity == 32768 && Statistics.iGrowCount - iGrowCount == 4);
+		NX_TEST_CHECK(Statistics.uIndexUploadBytes == (NXUInt64)sizeof(NXUInt32) * NX::QuadIndexBuffer::INDEXS_PER_QUAD * (4096 + 8192 + 16384 + 32768));
+		NX_TEST_CHECK(Statistics.uVertexUploadBytes == uQuads * NX::QuadIndexBuffer::VERTEXS_PER_QUAD * sizeof(NX::Particle::Vertex));
+
+		std::vector<NXUInt32> Indexs(NX::QuadIndexBuffer::INDEXS_PER_QUAD * Statistics.iQuadCapacity);
+		NX::QuadIndexBuffer::FillQuadIndexs(&Indexs[0], 0, Statistics.iQuadCapacity);
+		NX_TEST_CHECK(SharedIndexs.Acquire(1) == nullptr && SharedIndexs.GetSystemIndexs());
+		NX_TEST_CHECK(NX::Test::SameBits(SharedIndexs.GetSystemIndexs(), &Indexs[0], (int)Indexs.size()));
+
+		//every quad uploads 4 vertices, rewriting its 6 indices too would be 20% of the frame, not half
+		const NXUInt64 uRewrite = uQuads * NX::QuadIndexBuffer::INDEXS_PER_QUAD * sizeof(NXUInt32);
+		const double fRewriteShare = (double)uRewrite / (double)(Statistics.uVertexUploadBytes + uRewrite);
+		const double fGrowShare = (double)Statistics.uIndexUploadBytes / (double)(Statistics.uVertexUploadBytes + Statistics.uIndexUploadBytes);
+		std::printf("%d frames of two systems, %llu quads: %llu vertex bytes, %llu index bytes grown, per frame index rewrites would be %.1f%%, growth is %.2f%%\n",
+			FRAMES, (unsigned long long)uQuads, (unsigned long long)Statistics.uVertexUploadBytes, (unsigned long long)Statistics.uIndexUploadBytes, fRewriteShare * 100., fGrowShare * 100.);
+		NX_TEST_CHECK(fRewriteShare > 0.199 && fRewriteShare < 0.201);
+		NX_TEST_CHECK(fGrowShare < 0.01);
+	}
+
+	{//a frame after the growth uploads vertices only
+		SharedIndexs.ResetUploadCounters();
+		DrawFrame(FRAMES - 1);
+		const NX::QuadIndexBuffer::Statistics &Statistics = SharedIndexs.GetStatistics();
+		NX_TEST_CHECK(Statistics.uIndexUploadBytes == 0 && Statistics.iGrowCount - iGrowCount == 4);
+		NX_TEST_CHECK(Statistics.uVertexUploadBytes == (NXUInt64)(GetQuadCount(0, FRAMES - 1) + GetQuadCount(1, FRAMES - 1)) * NX::QuadIndexBuffer::VERTEXS_PER_QUAD * sizeof(NX::Particle::Vertex));
+	}
+
+	{//Release forgets the buffer, the next request grows it from scratch
+		SharedIndexs.Release();
+		NX_TEST_CHECK(SharedIndexs.GetStatistics().iQuadCapacity == 0 && !SharedIndexs.GetSystemIndexs());
+		SharedIndexs.Acquire(10);
+		NX_TEST_CHECK(SharedIndexs.GetStatistics().iQuadCapacity == NX::QuadIndexBuffer::MIN_QUAD_CAPACITY && SharedIndexs.GetStatistics().iGrowCount - iGrowCount == 5);
+		SharedIndexs.Release();
+		SharedIndexs.ResetUploadCounters();
+	}
+}
@@ -0,0 +1,91 @@
+/*
+ *  File:    NXSnowParticleSystemTest.cpp
+ *
+ *  author:  张雄(zhang xiong, 1025679612@qq.com)
+ *  date:    2026_10_19
+ *  purpose: SnowParticleSystem without device, set up like the demo over a flat height field with a walking
+ *           camera: one worker and several give the same particles bit for bit and the same respawn counts
+ *           every tick, another seed gives other ones, and flakes reach the ground and stick to it.
+ */
+
+#include <string>
+#include <vector>
+
+#include "NXTestHeader.h"
+#include "../Particle/NXSnowParticleSystem.h"
+#include "../Particle/NXParticleStorage.h"
+#include "../entity/NXHeightField.h"
+#include "../render/NXCamera.h"
+
+namespace {
+	const int   TICKS = 120;
+
+	struct Run {
+		std::vector<float>   Streams;
+		std::vector<NXInt32> TextureIndexs;
+		std::vector<int>     RespawnCounts;      // per tick
+		int                  iStuckCount;        // resting on the ground at the end
+	};
+
+	/**
+	 *  the demo's snow, radius 4 around an eye 1.6 above the ground, ticked at 60 fps while walking
+	 */
+	Run Simulate(const NX::HeightField &Field, const NXUInt32 uSeed, const int iWorkerCount) {
+		NX::PerspectCamera Camera(NX::float3(3.f, 1.6f, 3.f), NX::float3(4.f, 0.6f, 4.f), NX::float3(0.f, 1.f, 0.f), 75.f, 16.f / 9.f, 0.01f, 1000.f);
+		const std::vector<std::string> TextureSet(1, "EngineResouces/Particle/Snow/particle-snow.png");
+		NX::SnowParticleSystem Snow(&Camera, 4.f, 0.35f, 20000, TextureSet);
+		Snow.SetSeed(uSeed).SetWorkerCount(iWorkerCount);
+		Snow.GetCollider().SetHeightField(&Field, NX::ParticleCollider::RESPONSE_STICK);
+
+		Run Result;
+		for (int t = 0; t < TICKS; ++t) {
+			Camera.MoveFront(0.01f);
+			Snow.OnTick(1.f / 60.f);
+			Result.RespawnCounts.push_back(Snow.GetRespawnCount());
+		}
+
+		const NX::ParticleStorage &Particles = Snow.GetParticleStorage();
+		for (int s = 0; s < NX::ParticleStorage::STREAM_COUNT; ++s) {
+			const float *pStream = Particles.GetStream((NX::ParticleStorage::STREAM)s);
+			Result.Streams.insert(Result.Streams.end(), pStream, pStream + Particles.GetCount());
+		}
+		Result.TextureIndexs.assign(Particles.GetTextureIndexs(), Particles.GetTextureIndexs() + Particles.GetCount());
+		Result.iStuckCount = 0;
+		for (int i = 0; i < Particles.GetCount(); ++i) {
+			Result.iStuckCount += Particles.GetPosition(i).y == 0.f && Particles.GetVelocity(i) == NX::float3(0.f, 0.f, 0.f);
+		}
+		return Result;
+	}
+
+	bool SameRun(const Run &A, const Run &B) {
+		return A.Streams.size() == B.Streams.size() && NX::Test::SameBits(&A.Streams[0], &B.Streams[0], (int)A.Streams.size())
+			&& A.TextureIndexs == B.TextureIndexs && A.RespawnCounts == B.RespawnCounts && A.iStuckCount == B.iStuckCount;
+	}
+}
+
+NX_TEST(NXSnowParticleSystemTest) {
+	NX::HeightField Field(65, 65, 0.1f, 0.1f);          // flat at 0, 6.4 x 6.4 around the walk
+	const Run One = Simulate(Field, 42, 1);
+
+	{//the demo's flakes keep respawning and settle on the ground
+		int iRespawnCount = 0;
+		for (int t = 0; t < TICKS; ++t) {
+			iRespawnCount += One.RespawnCounts[t];
+		}
+		std::printf("20000 flakes, %d ticks: %d respawns, %d resting on the ground\n", TICKS, iRespawnCount, One.iStuckCount);
+		NX_TEST_CHECK(iRespawnCount > 0);
+		NX_TEST_CHECK(One.iStuckCount > 0);
+	}
+
+	{//any number of workers gives the same run, all hardware threads included
+		const int Workers[] = { 2, 3, 4, 0 };
+		for (int k = 0; k < (int)(sizeof(Workers) / sizeof(Workers[0])); ++k) {
+			NX_TEST_CHECK(SameRun(Simulate(Field, 42, Workers[k]), One));
+		}
+	}
+
+	{//another seed, other flakes
+		const Run Other = Simulate(Field, 43, 1);
+		NX_TEST_CHECK(Other.Streams.size() == One.Streams.size() && !NX::Test::SameBits(&Other.Streams[0], &One.Streams[0], (int)One.Streams.size()));
+	}
+}
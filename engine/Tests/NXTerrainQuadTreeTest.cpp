@@ -0,0 +1,152 @@
+/*
+ *  File:    NXTerrainQuadTreeTest.cpp
+ *
+ *  author:  张雄(zhang xiong, 1025679612@qq.com)
+ *  date:    2026_10_19
+ *  purpose: TerrainQuadTree::Select for a fixed camera over generated hills against a chunk by chunk reference:
+ *           every chunk whose own box is in the frustum and nothing else, the coarsest level within the pixel
+ *           error lowered until neighbours are one level apart, and the stitch masks towards coarser ones.
+ */
+
+#include <cmath>
+#include <vector>
+
+#include "NXTestHeader.h"
+#include "../entity/NXHeightField.h"
+#include "../entity/NXHeightFieldGenerator.h"
+#include "../entity/NXTerrainQuadTree.h"
+#include "../math/NXMath.h"
+#include "../render/NXCamera.h"
+#include "../render/NXViewFrustum.h"
+
+namespace {
+	const int   SIZE            = 513;              // 8 x 8 chunks of 64 cells
+	const float VIEWPORT_HEIGHT = 720.f;
+
+	/**
+	 *  level per chunk, -1 when culled, (chunk row, chunk col) row-major
+	 */
+	std::vector<int> GetReferenceLODs(const NX::TerrainQuadTree &Tree, const NX::ViewFrustum &Frustum, const NX::TerrainQuadTree::SelectParameter &Parameter) {
+		const int iRows = Tree.GetChunkRowCount(), iCols = Tree.GetChunkColCount();
+		std::vector<int> LODs(iRows * iCols, -1);
+		for (int cr = 0; cr < iRows; ++cr) {
+			for (int cc = 0; cc < iCols; ++cc) {
+				NX::AABB box = Tree.GetChunkAABB(cr, cc);
+				if (!Frustum.Visible(box)) {
+					continue;
+				}
+				const NX::float3 MinPoint = box.GetMinPoint(), MaxPoint = box.GetMaxPoint();
+				const float ex = NX::NXMax(NX::NXMax(MinPoint.x - Parameter.Eye.x, 0.f), Parameter.Eye.x - MaxPoint.x);
+				const float ey = NX::NXMax(NX::NXMax(MinPoint.y - Parameter.Eye.y, 0.f), Parameter.Eye.y - MaxPoint.y);
+				const float ez = NX::NXMax(NX::NXMax(MinPoint.z - Parameter.Eye.z, 0.f), Parameter.Eye.z - MaxPoint.z);
+				const float fScale = Parameter.fErrorScale / NX::NXMax(std::sqrt(ex * ex + ey * ey + ez * ez), 1e-4f);
+				int iLOD = Parameter.iMinLOD;
+				while (iLOD < Parameter.iMaxLOD && Tree.GetChunkError(cr, cc, iLOD + 1) * fScale <= Parameter.fPixelError) {
+					++iLOD;
+				}
+				LODs[cr * iCols + cc] = iLOD;
+			}
+		}
+
+		//lower every level above a selected neighbour's plus one until nothing changes
+		for (bool bChanged = true; bChanged; ) {
+			bChanged = false;
+			for (int cr = 0; cr < iRows; ++cr) {
+				for (int cc = 0; cc < iCols; ++cc) {
+					int &iLOD = LODs[cr * iCols + cc];
+					const int Neighbours[4][2] = { { cr - 1, cc }, { cr + 1, cc }, { cr, cc - 1 }, { cr, cc + 1 } };
+					for (int n = 0; n < 4 && iLOD >= 0; ++n) {
+						const int r = Neighbours[n][0], c = Neighbours[n][1];
+						const int iNeighbour = r >= 0 && r < iRows && c >= 0 && c < iCols ? LODs[r * iCols + c] : -1;
+						if (iNeighbour >= 0 && iLOD > iNeighbour + 1) {
+							iLOD = iNeighbour + 1;
+							bChanged = true;
+						}
+					}
+				}
+			}
+		}
+		return LODs;
+	}
+}
+
+NX_TEST(NXTerrainQuadTreeSelectTest) {
+	NX::HeightField Field(SIZE, SIZE, 1.f, 1.f);
+	NX::HeightFieldGenerator().SetSeed(28).SetAmplitude(30.f).SetFrequency(0.01f).Generate(Field);
+	NX::TerrainQuadTree Tree(SIZE, SIZE, 1.f, 1.f);
+	Tree.Build(Field.GetData(), 1, SIZE);
+	NX_TEST_CHECK(Tree.GetChunkRowCount() == 8 && Tree.GetChunkColCount() == 8 && Tree.GetLODCount() == 7);
+
+	//at the low x border, looking along +x over the middle cols, tilted down
+	const NX::float3 Eye(-10.f, 60.f, 256.f);
+	NX::PerspectCamera Camera(Eye, NX::float3(256.f, 0.f, 256.f), NX::float3(0.f, 1.f, 0.f), 50.f, 16.f / 9.f, 0.5f, 2000.f);
+	const NX::ViewFrustum Frustum(Camera.GetWatchMatrix());
+
+	NX::TerrainQuadTree::SelectParameter Parameter;
+	Parameter.Eye         = Eye;
+	Parameter.fErrorScale = 0.5f * VIEWPORT_HEIGHT * Camera.GetProjectMatrix().m_Element[1][1];
+	Parameter.fPixelError = 2.f;
+	Parameter.iMinLOD     = 0;
+	Parameter.iMaxLOD     = Tree.GetLODCount() - 1;
+
+	std::vector<NX::TerrainQuadTree::ChunkSelection> Selections;
+	Tree.Select(Frustum, Parameter, Selections);
+	const std::vector<int> LODs = GetReferenceLODs(Tree, Frustum, Parameter);
+	const int iCols = Tree.GetChunkColCount();
+
+	{//the chunks and levels of the reference, in chunk order
+		int iExpected = 0;
+		for (size_t i = 0; i < LODs.size(); ++i) {
+			iExpected += LODs[i] >= 0;
+		}
+		NX_TEST_CHECK((int)Selections.size() == iExpected);
+		NX_TEST_CHECK(iExpected > 0 && iExpected < (int)LODs.size());
+		NX_TEST_CHECK(Tree.GetStatistics().iSelectedChunks == iExpected && Tree.GetStatistics().iCulledNodes > 0);
+
+		bool bSame = true, bOrdered = true, bWithinError = true;
+		for (size_t i = 0; i < Selections.size(); ++i) {
+			const NX::TerrainQuadTree::ChunkSelection &s = Selections[i];
+			bSame = bSame && LODs[s.iChunkRow * iCols + s.iChunkCol] == s.iLOD;
+			bOrdered = bOrdered && (i == 0 || Selections[i - 1].iChunkRow * iCols + Selections[i - 1].iChunkCol < s.iChunkRow * iCols + s.iChunkCol);
+			bWithinError = bWithinError && s.fScreenError <= Parameter.fPixelError;
+		}
+		NX_TEST_CHECK(bSame);
+		NX_TEST_CHECK(bOrdered);
+		NX_TEST_CHECK(bWithinError);
+	}
+
+	{//chunks just ahead draw every cell, the far side is coarser, the corners at the eye's side are out of view
+		NX_TEST_CHECK(LODs[1 * iCols + 3] == 0 && LODs[1 * iCols + 4] == 0);
+		NX_TEST_CHECK(LODs[7 * iCols + 3] == 2 && LODs[7 * iCols + 4] == 2);
+		NX_TEST_CHECK(LODs[0 * iCols + 0] < 0 && LODs[0 * iCols + 7] < 0 && LODs[1 * iCols + 0] < 0 && LODs[1 * iCols + 7] < 0);
+	}
+
+	{//stitch masks name exactly the coarser selected neighbours
+		bool bStitched = true;
+		for (size_t i = 0; i < Selections.size(); ++i) {
+			const NX::TerrainQuadTree::ChunkSelection &s = Selections[i];
+			const int cr = s.iChunkRow, cc = s.iChunkCol;
+			int iMask = 0;
+			iMask |= cr > 0                            && LODs[(cr - 1) * iCols + cc] > s.iLOD ? NX::TerrainQuadTree::STITCH_ROW_MIN : 0;
+			iMask |= cr < Tree.GetChunkRowCount() - 1  && LODs[(cr + 1) * iCols + cc] > s.iLOD ? NX::TerrainQuadTree::STITCH_ROW_MAX : 0;
+			iMask |= cc > 0                            && LODs[cr * iCols + cc - 1]   > s.iLOD ? NX::TerrainQuadTree::STITCH_COL_MIN : 0;
+			iMask |= cc < iCols - 1                    && LODs[cr * iCols + cc + 1]   > s.iLOD ? NX::TerrainQuadTree::STITCH_COL_MAX : 0;
+			bStitched = bStitched && s.iStitchMask == iMask;
+		}
+		NX_TEST_CHECK(bStitched);
+	}
+
+	{//a level range clamps the choice, a second call forgets the first one's levels
+		Parameter.iMinLOD = 2;
+		Parameter.iMaxLOD = 3;
+		Tree.Select(Frustum, Parameter, Selections);
+		const std::vector<int> Clamped = GetReferenceLODs(Tree, Frustum, Parameter);
+		bool bClamped = true;
+		for (size_t i = 0; i < Selections.size(); ++i) {
+			const NX::TerrainQuadTree::ChunkSelection &s = Selections[i];
+			bClamped = bClamped && s.iLOD >= 2 && s.iLOD <= 3 && Clamped[s.iChunkRow * iCols + s.iChunkCol] == s.iLOD;
+		}
+		NX_TEST_CHECK(bClamped);
+		NX_TEST_CHECK(Tree.GetStatistics().iSelectedChunks == (int)Selections.size());
+	}
+}
@@ -0,0 +1,241 @@
+/*
+ *  File:    NXTerrainStreamerTest.cpp
+ *
+ *  author:  张雄(zhang xiong, 1025679612@qq.com)
+ *  date:    2026_10_19
+ *  purpose: HeightFieldTileFile written from a HeightField and from a generator reads back every sample with
+ *           the repeated border, and Open rejects files whose header or size don't match. TerrainStreamer with
+ *           a cache of four tiles evicts the least recently used tile that the frame doesn't need, touched
+ *           tiles stay, and a load is dropped when every slot was used this frame. resident heights are the
+ *           field's.
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "NXTestHeader.h"
+#include "../entity/NXHeightField.h"
+#include "../entity/NXHeightFieldGenerator.h"
+#include "../entity/NXHeightFieldTileFile.h"
+#include "../entity/NXTerrainStreamer.h"
+#include "../math/NXMath.h"
+
+namespace {
+	const char *TILE_FILE   = "NXTerrainStreamerTest.tiles";
+	const char *COPY_FILE   = "NXTerrainStreamerTest.copy.tiles";
+	const char *BROKEN_FILE = "NXTerrainStreamerTest.broken.tiles";
+
+	std::vector<char> ReadBytes(const char *szFilePath) {
+		std::vector<char> Bytes;
+		FILE *pFile = fopen(szFilePath, "rb");
+		if (pFile) {
+			fseek(pFile, 0, SEEK_END);
+			Bytes.resize(ftell(pFile));
+			fseek(pFile, 0, SEEK_SET);
+			if (!Bytes.empty() && fread(&Bytes[0], Bytes.size(), 1, pFile) != 1) {
+				Bytes.clear();
+			}
+			fclose(pFile);
+		}
+		return Bytes;
+	}
+
+	void WriteBytes(const char *szFilePath, const std::vector<char> &Bytes, const size_t uSize) {
+		FILE *pFile = fopen(szFilePath, "wb");
+		if (pFile) {
+			fwrite(&Bytes[0], uSize, 1, pFile);
+			fclose(pFile);
+		}
+	}
+
+	/**
+	 *  Open on a copy of Bytes with the header changed by Corrupt, iTruncate bytes cut off the end
+	 */
+	template<typename T>
+	bool OpenBroken(const std::vector<char> &Bytes, const T &Corrupt, const size_t uTruncate = 0) {
+		std::vector<char> Broken(Bytes);
+		Corrupt(*(NX::HeightFieldTileFile::Header*)&Broken[0]);
+		WriteBytes(BROKEN_FILE, Broken, Broken.size() - uTruncate);
+		NX::HeightFieldTileFile File;
+		const bool bOpened = File.Open(BROKEN_FILE);
+		return bOpened || File.IsOpen();
+	}
+
+	/**
+	 *  eye over the middle of tile (tr, tc) of a field with 1 x 1 cells
+	 */
+	NX::float3 GetTileCenter(const int tr, const int tc, const int iTileCells) {
+		return NX::float3((tr + 0.5f) * iTileCells, 0.f, (tc + 0.5f) * iTileCells);
+	}
+
+	/**
+	 *  exactly the tiles of Tiles are resident, tile (tr, tc) is tr * 10 + tc
+	 */
+	bool ResidentTiles(const NX::TerrainStreamer &Streamer, const std::vector<int> &Tiles) {
+		const NX::HeightFieldTileFile::Header &header = Streamer.GetFile().GetHeader();
+		int iResident = 0;
+		for (size_t i = 0; i < Tiles.size(); ++i) {
+			iResident += Streamer.IsResident(Tiles[i] / 10, Tiles[i] % 10);
+		}
+		int iTotal = 0;
+		for (int tr = 0; tr < header.iTileRowCount; ++tr) {
+			for (int tc = 0; tc < header.iTileColCount; ++tc) {
+				iTotal += Streamer.IsResident(tr, tc);
+			}
+		}
+		return iResident == (int)Tiles.size() && iTotal == iResident && Streamer.GetStatistics().iResidentTiles == iTotal;
+	}
+}
+
+NX_TEST(NXHeightFieldTileFileTest) {
+	//neither side a multiple of the tile, the last tiles repeat the border
+	const int iTileCells = 16;
+	NX::HeightField Field(100, 130, 0.5f, 0.75f);
+	NX::HeightFieldGenerator().SetSeed(32).SetAmplitude(20.f).SetFrequency(0.05f).Generate(Field);
+	NX_TEST_CHECK(NX::HeightFieldTileFile::Write(TILE_FILE, Field, iTileCells));
+
+	{//the header and every sample of every tile
+		NX::HeightFieldTileFile File;
+		NX_TEST_CHECK(File.Open(TILE_FILE) && File.IsOpen());
+		const NX::HeightFieldTileFile::Header &header = File.GetHeader();
+		NX_TEST_CHECK(header.uMagic == NX::HeightFieldTileFile::MAGIC && header.uVersion == NX::HeightFieldTileFile::VERSION);
+		NX_TEST_CHECK(header.iRowCount == 100 && header.iColCount == 130 && header.fDX == 0.5f && header.fDZ == 0.75f);
+		NX_TEST_CHECK(header.iTileCells == iTileCells && header.iTileRowCount == 7 && header.iTileColCount == 9);
+		NX_TEST_CHECK(File.GetTileSampleCount() == (iTileCells + 1) * (iTileCells + 1));
+
+		bool bSame = true;
+		for (int tr = 0; tr < header.iTileRowCount; ++tr) {
+			for (int tc = 0; tc < header.iTileColCount; ++tc) {
+				const float *pTile = File.GetTileData(tr, tc);
+				for (int r = 0; r <= iTileCells; ++r) {
+					for (int c = 0; c <= iTileCells; ++c) {
+						const int gr = NX::NXMin(tr * iTileCells + r, 99), gc = NX::NXMin(tc * iTileCells + c, 129);
+						bSame = bSame && pTile[r * (iTileCells + 1) + c] == Field.GetHeight(gr, gc);
+					}
+				}
+			}
+		}
+		NX_TEST_CHECK(bSame);
+		File.Close();
+		NX_TEST_CHECK(!File.IsOpen());
+	}
+
+	{//the generator overload writes the same bytes, asked for one tile's rows and cols at a time
+		int iCalls = 0;
+		bool bInside = true;
+		NX_TEST_CHECK(NX::HeightFieldTileFile::Write(COPY_FILE, 100, 130, 0.5f, 0.75f, iTileCells, [&](int r0, int c0, int iRows, int iCols, float *pOut) {
+			++iCalls;
+			bInside = bInside && r0 + iRows <= 100 && c0 + iCols <= 130 && iRows <= iTileCells + 1 && iCols <= iTileCells + 1;
+			for (int r = 0; r < iRows; ++r) {
+				for (int c = 0; c < iCols; ++c) {
+					pOut[r * iCols + c] = Field.GetHeight(r0 + r, c0 + c);
+				}
+			}
+		}));
+		NX_TEST_CHECK(iCalls == 7 * 9 && bInside);
+		NX_TEST_CHECK(ReadBytes(COPY_FILE) == ReadBytes(TILE_FILE));
+	}
+
+	{//headers that don't describe the file are refused
+		typedef NX::HeightFieldTileFile::Header Header;
+		const std::vector<char> Bytes = ReadBytes(TILE_FILE);
+		NX_TEST_CHECK(Bytes.size() == sizeof(Header) + 7 * 9 * (iTileCells + 1) * (iTileCells + 1) * sizeof(float));
+		NX_TEST_CHECK(OpenBroken(Bytes, [](Header &) {}));
+		NX_TEST_CHECK(!OpenBroken(Bytes, [](Header &h) { h.uMagic ^= 1; }));
+		NX_TEST_CHECK(!OpenBroken(Bytes, [](Header &h) { h.uVersion += 1; }));
+		NX_TEST_CHECK(!OpenBroken(Bytes, [](Header &h) { h.iRowCount = 1; }));
+		NX_TEST_CHECK(!OpenBroken(Bytes, [](Header &h) { h.iTileCells = 0; }));
+		NX_TEST_CHECK(!OpenBroken(Bytes, [](Header &h) { h.iTileCells = 1 << 20; }));
+		NX_TEST_CHECK(!OpenBroken(Bytes, [](Header &h) { h.iTileRowCount += 1; }));
+		NX_TEST_CHECK(!OpenBroken(Bytes, [](Header &h) { h.iTileColCount -= 1; }));
+		NX_TEST_CHECK(!OpenBroken(Bytes, [](Header &h) { h.iColCount += 64; }));
+		NX_TEST_CHECK(!OpenBroken(Bytes, [](Header &) {}, sizeof(float)));
+		NX_TEST_CHECK(!OpenBroken(Bytes, [](Header &) {}, Bytes.size() - sizeof(Header) + 1));
+
+		NX::HeightFieldTileFile File;
+		NX_TEST_CHECK(!File.Open("NXTerrainStreamerTest.missing.tiles") && !File.IsOpen());
+		NX::TerrainStreamer Streamer;
+		WriteBytes(BROKEN_FILE, Bytes, Bytes.size() - 1);
+		NX_TEST_CHECK(!Streamer.Open(BROKEN_FILE));
+	}
+
+	std::remove(TILE_FILE);
+	std::remove(COPY_FILE);
+	std::remove(BROKEN_FILE);
+}
+
+NX_TEST(NXTerrainStreamerTest) {
+	//8 x 8 tiles of 4 x 4 cells, a cache of 4 and only the camera's own tile wanted
+	const int iTileCells = 4;
+	NX::HeightField Field(33, 33, 1.f, 1.f);
+	NX::HeightFieldGenerator().SetSeed(32).SetAmplitude(10.f).SetFrequency(0.1f).Generate(Field);
+	NX_TEST_CHECK(NX::HeightFieldTileFile::Write(TILE_FILE, Field, iTileCells));
+
+	NX::TerrainStreamer Streamer(4, 0, 0);
+	NX_TEST_CHECK(Streamer.Open(TILE_FILE));
+	const NX::TerrainStreamer::Statistics &Statistics = Streamer.GetStatistics();
+
+	{//one tile a frame fills the cache, the camera's tile answers like the field
+		const int Tiles[4][2] = { { 0, 0 }, { 0, 1 }, { 3, 5 }, { 7, 7 } };
+		for (int k = 0; k < 4; ++k) {
+			Streamer.Update(GetTileCenter(Tiles[k][0], Tiles[k][1], iTileCells));
+			Streamer.Flush();
+		}
+		NX_TEST_CHECK(ResidentTiles(Streamer, { 0, 1, 35, 77 }));
+		NX_TEST_CHECK(Statistics.uLoads == 4 && Statistics.uEvictions == 0 && Statistics.uPrefetchLoads == 0);
+
+		bool bSame = true;
+		for (float x = 28.f; x <= 32.f; x += 0.37f) {
+			for (float z = 28.f; z <= 32.f; z += 0.41f) {
+				float fHeight = 0.f;
+				bSame = bSame && Streamer.GetHeight(x, z, fHeight) && fHeight == Field.GetHeight(x, z);
+			}
+		}
+		NX_TEST_CHECK(bSame);
+		NX_TEST_CHECK(Statistics.uHits > 0 && Statistics.uMisses == 0);
+	}
+
+	{//frames 1 to 4 used 00, 01, 35 and 77, frame 5 uses 01 again, so 00 is the oldest and goes first
+		Streamer.Update(GetTileCenter(0, 1, iTileCells));
+		Streamer.Update(GetTileCenter(2, 2, iTileCells));
+		Streamer.Flush();
+		NX_TEST_CHECK(ResidentTiles(Streamer, { 1, 35, 77, 22 }));
+		NX_TEST_CHECK(Statistics.uEvictions == 1);
+
+		//35 is touched in frame 6, 77 of frame 4 is the oldest now, then 01 of frame 5
+		NX_TEST_CHECK(Streamer.GetTile(3, 5) != nullptr);
+		Streamer.Update(GetTileCenter(4, 4, iTileCells));
+		Streamer.Flush();
+		NX_TEST_CHECK(ResidentTiles(Streamer, { 1, 35, 22, 44 }));
+		Streamer.Update(GetTileCenter(6, 0, iTileCells));
+		Streamer.Flush();
+		NX_TEST_CHECK(ResidentTiles(Streamer, { 35, 22, 44, 60 }));
+		NX_TEST_CHECK(Statistics.uEvictions == 3 && Statistics.uLoads == 7 && Statistics.uDroppedLoads == 0);
+	}
+
+	{//every slot used this frame, a missed tile is loaded and dropped, the next frame takes it
+		const int iFrameTiles[4][2] = { { 3, 5 }, { 2, 2 }, { 4, 4 }, { 6, 0 } };
+		for (int k = 0; k < 4; ++k) {
+			NX_TEST_CHECK(Streamer.GetTile(iFrameTiles[k][0], iFrameTiles[k][1]) != nullptr);
+		}
+		float fHeight = 0.f;
+		NX_TEST_CHECK(!Streamer.GetHeight(0.5f, 0.5f, fHeight) && Statistics.uMisses == 1);
+		Streamer.Flush();
+		NX_TEST_CHECK(Statistics.uDroppedLoads == 1 && !Streamer.IsResident(0, 0));
+		NX_TEST_CHECK(ResidentTiles(Streamer, { 35, 22, 44, 60 }));
+
+		//the camera stays at 60 and 35, 44 are touched again, the miss replaces 22, the only tile of the last frame
+		Streamer.Update(GetTileCenter(6, 0, iTileCells));
+		NX_TEST_CHECK(Streamer.GetTile(3, 5) && Streamer.GetTile(4, 4));
+		NX_TEST_CHECK(!Streamer.GetHeight(0.5f, 0.5f, fHeight) && Statistics.uMisses == 2);
+		Streamer.Flush();
+		NX_TEST_CHECK(Streamer.GetHeight(0.5f, 0.5f, fHeight) && fHeight == Field.GetHeight(0.5f, 0.5f));
+		NX_TEST_CHECK(ResidentTiles(Streamer, { 0, 35, 44, 60 }));
+		NX_TEST_CHECK(Statistics.uEvictions == 4 && Statistics.uLoads == 8 && Statistics.uDroppedLoads == 1 && Statistics.iPendingRequests == 0);
+	}
+
+	Streamer.Close();
+	std::remove(TILE_FILE);
+}
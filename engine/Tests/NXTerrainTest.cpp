@@ -0,0 +1,162 @@
+/*
+ *  File:    NXTerrainTest.cpp
+ *
+ *  author:  张雄(zhang xiong, 1025679612@qq.com)
+ *  date:    2026_10_19
+ *  purpose: Terrain without device, its vertices flush to system memory. bytes per grid point of heights plus
+ *           octahedral normals against the old 32 byte Vertex, an idle terrain uploads nothing, an edit uploads once. NXTerrainSculptBenchmark times brush strokes with the flush of the following frame
+ *           and checks which chunks get their level errors rebuilt.
+ */
+
+#include <cmath>
+#include <vector>
+
+#include "NXTestHeader.h"
+#include "../entity/NXHeightField.h"
+#include "../entity/NXHeightFieldGenerator.h"
+#include "../entity/NXTerrain.h"
+#include "../entity/NXTerrainBrush.h"
+#include "../entity/NXTerrainQuadTree.h"
+#include "../math/NXAlgorithm.h"
+
+namespace {
+	/**
+	 *  level errors of every chunk and level equal to a tree built from scratch on the same heights
+	 */
+	bool SameErrors(const NX::TerrainQuadTree &Tree, const NX::TerrainQuadTree &Fresh) {
+		bool bSame = true;
+		for (int cr = 0; cr < Tree.GetChunkRowCount(); ++cr) {
+			for (int cc = 0; cc < Tree.GetChunkColCount(); ++cc) {
+				for (int l = 0; l < Tree.GetLODCount(); ++l) {
+					bSame = bSame && Tree.GetChunkError(cr, cc, l) == Fresh.GetChunkError(cr, cc, l);
+				}
+			}
+		}
+		return bSame;
+	}
+}
+
+NX_TEST(NXTerrainMemoryTest) {
+	const int N = 1025;
+	NX::Terrain terrain(N, N, 1.f, 1.f, "");
+	terrain.Generate(NX::HeightFieldGenerator().SetSeed(31).SetAmplitude(40.f).SetFrequency(0.004f));
+	const NX::Terrain::MemoryStatistics Statistics = terrain.GetMemoryStatistics();
+	const double fGridCount = (double)N * N;
+
+	{//a Vertex in system memory and one in the vertex buffer before, height, normal, occlusion and a CompactVertex now
+		NX_TEST_CHECK(sizeof(NX::Terrain::Vertex) == 32 && sizeof(NX::Terrain::CompactVertex) == 8);
+		const double fLegacy = Statistics.uLegacyBytes / fGridCount;
+		const double fCompact = (Statistics.uCPUBytes + Statistics.uVertexBufferBytes) / fGridCount;
+		std::printf("%dx%d terrain: %.2f bytes per grid point before, %.2f now (%.2f system memory, %.2f vertex buffer), %.1f KB of index patterns\n",
+			N, N, fLegacy, fCompact, Statistics.uCPUBytes / fGridCount, Statistics.uVertexBufferBytes / fGridCount, Statistics.uIndexBufferBytes / 1024.0);
+		NX_TEST_CHECK(fLegacy == 64.0);
+		NX_TEST_CHECK(Statistics.uCPUBytes == (NXUInt64)N * N * (sizeof(float) + sizeof(NXUInt16) + sizeof(NXUInt8)));
+
+		//16 x 16 chunks of 65 x 65 vertices, the border rows and cols are stored by both chunks
+		NX_TEST_CHECK(Statistics.uVertexBufferBytes == 16ull * 16 * 65 * 65 * sizeof(NX::Terrain::CompactVertex));
+		NX_TEST_CHECK(fCompact < 16.0 && fLegacy / fCompact > 4.0);
+		NX_TEST_CHECK(Statistics.uIndexBufferBytes > 0);
+	}
+
+	{//heights come back exactly, normals within the 16 bit octahedral precision
+		const NX::Terrain &Const = terrain;
+		float fMinCos = 1.f;
+		bool bHeights = true;
+		for (int r = 0; r < N; r += 37) {
+			for (int c = 0; c < N; c += 41) {
+				const NX::float3 Normal = NX::GetNormalized(NX::float3(std::sin(r * 0.1f), 1.5f + std::cos(c * 0.07f), std::sin((r + c) * 0.05f)));
+				terrain.SetNormal(r, c, Normal);
+				const NX::Terrain::Vertex v = Const.GetVertex(r, c);
+				fMinCos = NX::NXMin(fMinCos, v.nx * Normal.x + v.ny * Normal.y + v.nz * Normal.z);
+				bHeights = bHeights && v.y == terrain.GetHeightField().GetHeight(r, c);
+			}
+		}
+		std::printf("largest normal error after encoding: %.3f degrees\n", std::acos(NX::NXMin(fMinCos, 1.f)) * 180.f / 3.14159265f);
+		NX_TEST_CHECK(bHeights);
+		NX_TEST_CHECK(fMinCos > std::cos(1.f * 3.14159265f / 180.f));
+	}
+}
+
+NX_TEST(NXTerrainIdleUploadTest) {
+	const int N = 257;
+	NX::Terrain terrain(N, N, 1.f, 1.f, "");
+	terrain.Generate(NX::HeightFieldGenerator().SetSeed(29).SetAmplitude(20.f).SetFrequency(0.01f));
+	terrain.FlushDirtyRegions();
+	const NXUInt64 uFilled = terrain.GetUploadStatistics().uTotalBytes;
+	NX_TEST_CHECK(uFilled >= (NXUInt64)N * N * sizeof(NX::Terrain::CompactVertex));
+
+	{//frames without edits lock nothing and copy nothing
+		bool bIdle = true;
+		for (int i = 0; i < 10; ++i) {
+			terrain.OnTick(0.016f);
+			terrain.FlushDirtyRegions();
+			bIdle = bIdle && terrain.GetUploadStatistics().iFrameLocks == 0 && terrain.GetUploadStatistics().uFrameBytes == 0;
+		}
+		NX_TEST_CHECK(bIdle);
+		NX_TEST_CHECK(terrain.GetUploadStatistics().uTotalBytes == uFilled);
+	}
+
+	{//an edit uploads in the next frame only, at most the 4 chunks sharing the vertex
+		terrain.SetHeight(100, 100, terrain.GetHeightField().GetHeight(100, 100) + 5.f);
+		terrain.FlushDirtyRegions();
+		const NX::Terrain::UploadStatistics Edited = terrain.GetUploadStatistics();
+		NX_TEST_CHECK(Edited.iFrameLocks > 0 && Edited.uFrameBytes > 0);
+		NX_TEST_CHECK(Edited.uFrameBytes <= 4ull * 65 * 65 * sizeof(NX::Terrain::CompactVertex));
+		NX_TEST_CHECK(Edited.uTotalBytes == uFilled + Edited.uFrameBytes);
+
+		terrain.FlushDirtyRegions();
+		NX_TEST_CHECK(terrain.GetUploadStatistics().iFrameLocks == 0 && terrain.GetUploadStatistics().uFrameBytes == 0);
+	}
+}
+
+NX_TEST(NXTerrainSculptBenchmark) {
+	const int N = 1025;
+	NX::Terrain terrain(N, N, 1.f, 1.f, "");
+	terrain.Generate(NX::HeightFieldGenerator().SetSeed(3).SetAmplitude(40.f).SetFrequency(0.004f));
+	terrain.FlushDirtyRegions();
+
+	NX::TerrainBrush Brush;
+	Brush.SetMode(NX::TerrainBrush::BRUSH_RAISE).SetRadius(16.f).SetStrength(0.5f).SetHardness(0.5f);
+
+	{//a drag across the terrain, every stroke followed by the flush of the next frame
+		const int iStrokeCount = 200;
+		double fTotal = 0.0, fWorst = 0.0;
+		NXUInt64 uLargestUpload = 0;
+		for (int i = 0; i < iStrokeCount; ++i) {
+			const float x = 200.f + 3.f * i, z = 500.f + 100.f * std::sin(i * 0.05f);
+			const double fStroke = NX::Test::GetBestMilliSeconds(1, [&]() {
+				terrain.Sculpt(Brush, x, z);
+				terrain.FlushDirtyRegions();
+			});
+			fTotal += fStroke;
+			fWorst  = NX::NXMax(fWorst, fStroke);
+			uLargestUpload = NX::NXMax(uLargestUpload, terrain.GetUploadStatistics().uFrameBytes);
+		}
+		std::printf("%d strokes of radius 16 on %dx%d: %.3f ms on average, %.3f ms at worst, at most %llu bytes uploaded\n",
+			iStrokeCount, N, N, fTotal / iStrokeCount, fWorst, (unsigned long long)uLargestUpload);
+
+		//rows under the brush and the normal ring around it, a new quantization range takes the whole chunk, at most 4 chunks
+		NX_TEST_CHECK(uLargestUpload > 0);
+		NX_TEST_CHECK(uLargestUpload <= 4ull * 65 * 65 * sizeof(NX::Terrain::CompactVertex));
+
+		NX::TerrainQuadTree Fresh(N, N, 1.f, 1.f);
+		Fresh.Build(terrain.GetHeightField().GetData(), 1, N);
+		NX_TEST_CHECK(SameErrors(terrain.GetQuadTree(), Fresh));
+	}
+
+	{//a normal edit uploads its rows but keeps the level errors, a height edit rebuilds them
+		const int r = 700, c = 700;
+		terrain.GetHeightField().SetHeight(r, c, terrain.GetHeightField().GetHeight(r, c) + 100.f);
+		NX::TerrainQuadTree Fresh(N, N, 1.f, 1.f);
+		Fresh.Build(terrain.GetHeightField().GetData(), 1, N);
+
+		terrain.SetNormal(r, c, NX::float3(0.f, 1.f, 0.f));
+		terrain.FlushDirtyRegions();
+		NX_TEST_CHECK(terrain.GetUploadStatistics().iFrameLocks > 0);
+		NX_TEST_CHECK(!SameErrors(terrain.GetQuadTree(), Fresh));
+
+		terrain.MarkDirty(r, c, r, c);
+		terrain.FlushDirtyRegions();
+		NX_TEST_CHECK(SameErrors(terrain.GetQuadTree(), Fresh));
+	}
+}
@@ -0,0 +1,88 @@
+/*
+ *  File:    NXTestHeader.h
+ *
+ *  author:  张雄(zhang xiong, 1025679612@qq.com)
+ *  date:    2026_10_19
+ *  purpose: minimal checks for the engine tests. every NX*Test.cpp in this folder registers its cases with
+ *           NX_TEST, NXTestMain.cpp runs them all, or the ones named on its command line. the NXEngineTests
+ *           project next to the demo builds them with the engine sources they use.
+ *
+ *           a failed check prints its file, line and expression, the program returns 1 when any check failed.
+ *           benchmarks print their timings and only check results, a debug build times nothing useful.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace NX {
+	namespace Test {
+		inline int& GetFailureCount() {
+			static int iFailures = 0;
+			return iFailures;
+		}
+
+		inline bool Check(const bool bPassed, const char *szExpression, const char *szFileName, const int iLine) {
+			if (!bPassed) {
+				std::printf("%s(%d): check failed: %s\n", szFileName, iLine, szExpression);
+				++GetFailureCount();
+			}
+			return bPassed;
+		}
+
+		/**
+		 *  bitwise equality, tells 0 from -0 and compares NaN payloads
+		 */
+		template<typename T>
+		inline bool SameBits(const T *pA, const T *pB, const int iCount) {
+			return std::memcmp(pA, pB, sizeof(T) * iCount) == 0;
+		}
+
+		/**
+		 *  the fastest of iRuns calls of Function in milliseconds, the first call warms the caches
+		 */
+		template<typename T>
+		inline double GetBestMilliSeconds(const int iRuns, const T &Function) {
+			double fBest = 1e30;
+			for (int i = 0; i < iRuns; ++i) {
+				const auto Start = std::chrono::steady_clock::now();
+				Function();
+				const double fMilliSeconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - Start).count();
+				fBest = fMilliSeconds < fBest ? fMilliSeconds : fBest;
+			}
+			return fBest;
+		}
+
+		typedef void (*CaseFunction)();
+
+		struct Case {
+			const char      *szName;
+			CaseFunction    pFunction;
+		};
+
+		inline std::vector<Case>& GetCases() {
+			static std::vector<Case> Cases;
+			return Cases;
+		}
+
+		struct Registrar {
+			Registrar(const char *szName, CaseFunction pFunction) {
+				const Case TestCase = { szName, pFunction };
+				GetCases().push_back(TestCase);
+			}
+		};
+	}
+}
+
+#define NX_TEST_CHECK(expr) NX::Test::Check(!!(expr), #expr, __FILE__, __LINE__)
+
+/**
+ *  NX_TEST(NXFooTest) { ... } defines and registers a test case
+ */
+#define NX_TEST(Name) \
+	static void Name(); \
+	static const NX::Test::Registrar Name##Registrar(#Name, Name); \
+	static void Name()
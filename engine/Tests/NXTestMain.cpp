@@ -0,0 +1,52 @@
+/*
+ *  File:    NXTestMain.cpp
+ *
+ *  author:  张雄(zhang xiong, 1025679612@qq.com)
+ *  date:    2026_10_19
+ *  purpose: runs every registered engine test, or only the ones named on the command line
+ */
+
+#include <cstring>
+#include <d3d9.h>
+
+#include "NXTestHeader.h"
+
+#pragma comment(lib, "d3d9.lib")
+#pragma comment(lib, "d3dx9.lib")
+
+namespace NX {
+	class DX9Window;
+
+	/**
+	 *  the tests run without window, entities see no device and keep their data in system memory
+	 */
+	DX9Window* glb_GetD3DWindow() {
+		return nullptr;
+	}
+
+	IDirect3DDevice9 * glb_GetD3DDevice() {
+		return nullptr;
+	}
+}
+
+int main(int argc, char **argv) {
+	int iRunCount = 0, iFailedCount = 0;
+	for (const NX::Test::Case &TestCase : NX::Test::GetCases()) {
+		bool bSelected = argc < 2;
+		for (int i = 1; i < argc && !bSelected; ++i) {
+			bSelected = std::strcmp(argv[i], TestCase.szName) == 0;
+		}
+		if (!bSelected) {
+			continue;
+		}
+
+		const int iFailuresBefore = NX::Test::GetFailureCount();
+		TestCase.pFunction();
+		const bool bPassed = NX::Test::GetFailureCount() == iFailuresBefore;
+		std::printf("%s: %s\n", TestCase.szName, bPassed ? "passed" : "FAILED");
+		++iRunCount;
+		iFailedCount += bPassed ? 0 : 1;
+	}
+	std::printf("%d of %d tests passed\n", iRunCount - iFailedCount, iRunCount);
+	return iFailedCount || !iRunCount ? 1 : 0;
+}
@@ -10,6 +10,8 @@
 #include "NXDX9Window.h"
 #include "../common/NXLog.h"
 #include "../System/NXSystem.h"
+#include "../Particle/NXQuadIndexBuffer.h"
+#include "../render/NXEffectManager.h"
 
 #pragma comment(lib, "d3d9.lib")
 #pragma comment(lib, "d3dx9.lib")
@@ -27,6 +29,9 @@ NX::DX9Window::DX9Window() {
 }
 
 NX::DX9Window::~DX9Window() {
+	//shared resources go before the device that created them
+	NX::QuadIndexBuffer::Instance().Release();
+
 	if (m_pDevice) {
 		m_pDevice->Release();
 	}
@@ -115,6 +120,10 @@ WPARAM NX::DX9Window::MessageLoop() {
 			NXUInt64 uNowTickedTime = NX::System::Instance().GetMillSecondsFromSystemStart();
 			OnTick((uNowTickedTime - uPreTickedTime) * .001f);
 			uPreTickedTime = uNowTickedTime;
+			if (!RestoreDevice()) {
+				::Sleep(50);
+				continue;
+			}
 			PreRender();
 			Render();
 			PostRender();
@@ -131,6 +140,35 @@ void NX::DX9Window::OnTick(const float	uDelta) {
 	
 }
 
+void NX::DX9Window::OnLostDevice() {
+
+}
+
+void NX::DX9Window::OnResetDevice() {
+
+}
+
+bool NX::DX9Window::RestoreDevice() {
+	const HRESULT hr = m_pDevice->TestCooperativeLevel();
+	if (hr == D3D_OK) {
+		return true;
+	}
+	if (hr != D3DERR_DEVICENOTRESET) {//still lost, nothing can be drawn
+		return false;
+	}
+
+	OnLostDevice();
+	NX::EffectManager::Instance().OnLostDevice();
+	if (FAILED(m_pDevice->Reset(&m_D3dParameter))) {
+		glb_GetLog().logToConsole("Reset D3DDevice failed");
+		return false;
+	}
+	NX::EffectManager::Instance().OnResetDevice();
+	OnResetDevice();
+	glb_GetLog().logToConsole("Reset D3DDevice succeed");
+	return true;
+}
+
 NX::DX9Window* NX::glb_GetD3DWindow() {
 	return pD3DWindow;
 }
@@ -35,6 +35,15 @@ namespace NX {
 	private:
 		virtual void OnInitDX3Succeed();
 		virtual void OnTick(const float	fDelta);
+		/**
+		 *  around IDirect3DDevice9::Reset, release and create again what lives in D3DPOOL_DEFAULT
+		 */
+		virtual void OnLostDevice();
+		virtual void OnResetDevice();
+		/**
+		 *  false while the device is lost, resets it once it can be reset
+		 */
+		bool RestoreDevice();
 
 	public:
 		inline IDirect3D9*				GetD3D9(){return m_pD3D9;}
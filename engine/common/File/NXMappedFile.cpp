@@ -0,0 +1,115 @@
+/*
+ *  File:     NXMappedFile.cpp
+ *  Author:   张雄
+ *  Date:     2026_10_19
+ *  Purpose:  read-only memory mapped disk file
+ */
+
+#include "NXMappedFile.h"
+#include "../NXPlatform.h"
+
+#if defined(PLATFORM_WINDOWS)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+NX::MappedFile::MappedFile(){
+    m_pData     = NULL;
+    m_uSize     = 0;
+    m_hFile     = NULL;
+    m_hMapping  = NULL;
+}
+
+NX::MappedFile::~MappedFile(){
+    Close();
+}
+
+bool NX::MappedFile::Open(const std::string &strDiskFilePath){
+    Close();
+#if defined(PLATFORM_WINDOWS)
+    do{
+        HANDLE hFile = CreateFileA(strDiskFilePath.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, NULL);
+        if(hFile == INVALID_HANDLE_VALUE){
+            break;
+        }
+        m_hFile = hFile;
+        LARGE_INTEGER Size;
+        if(!GetFileSizeEx(hFile, &Size) || Size.QuadPart <= 0 || (NXUInt64)Size.QuadPart > (NXUInt64)(SIZE_T)-1){
+            break;
+        }
+        HANDLE hMapping = CreateFileMappingA(hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+        if(hMapping == NULL){
+            break;
+        }
+        m_hMapping = hMapping;
+        m_pData    = (const NXUInt8*)MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+        if(m_pData == NULL){
+            break;
+        }
+        m_uSize    = (NXUInt64)Size.QuadPart;
+        return true;
+    }while(false);
+#else
+    do{
+        const int fd = open(strDiskFilePath.c_str(), O_RDONLY);
+        if(fd < 0){
+            break;
+        }
+        m_hFile = (void*)(intptr_t)(fd + 1);
+        struct stat Status;
+        if(fstat(fd, &Status) != 0 || Status.st_size <= 0){
+            break;
+        }
+        void *pData = mmap(NULL, (size_t)Status.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        if(pData == MAP_FAILED){
+            break;
+        }
+        m_pData = (const NXUInt8*)pData;
+        m_uSize = (NXUInt64)Status.st_size;
+        return true;
+    }while(false);
+#endif
+    Close();
+    return false;
+}
+
+void NX::MappedFile::Close(){
+#if defined(PLATFORM_WINDOWS)
+    if(m_pData){
+        UnmapViewOfFile(m_pData);
+    }
+    if(m_hMapping){
+        CloseHandle((HANDLE)m_hMapping);
+    }
+    if(m_hFile){
+        CloseHandle((HANDLE)m_hFile);
+    }
+#else
+    if(m_pData){
+        munmap((void*)m_pData, (size_t)m_uSize);
+    }
+    if(m_hFile){// stored as fd + 1 so that 0 means closed
+        close((int)(intptr_t)m_hFile - 1);
+    }
+#endif
+    m_pData     = NULL;
+    m_uSize     = 0;
+    m_hFile     = NULL;
+    m_hMapping  = NULL;
+}
+
+bool NX::MappedFile::IsOpen() const{
+    return m_pData != NULL;
+}
+
+const NXUInt8* NX::MappedFile::GetData() const{
+    return m_pData;
+}
+
+NXUInt64 NX::MappedFile::GetSize() const{
+    return m_uSize;
+}
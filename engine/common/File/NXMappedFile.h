@@ -0,0 +1,43 @@
+/*
+ *  File:     NXMappedFile.h
+ *  Author:   张雄
+ *  Date:     2026_10_19
+ *  Purpose:  read-only memory mapped disk file, pages are faulted in by the OS on first touch
+ */
+
+#pragma once
+
+#include <string>
+#include "../NXType.h"
+
+namespace NX {
+    class MappedFile{
+    public:
+        MappedFile();
+        virtual ~MappedFile();
+
+    public:
+        /**
+         *  map the whole file read-only, a previously opened file is closed first
+         *  <return value>
+         *  false: the file is missing, empty or can't be mapped (e.g. larger than the address space)
+         */
+        bool Open(const std::string &strDiskFilePath);
+        void Close();
+        bool IsOpen() const;
+
+    public:
+        const NXUInt8* GetData() const;
+        NXUInt64       GetSize() const;
+
+    private:
+        MappedFile(const MappedFile&);
+        MappedFile& operator = (const MappedFile&);
+
+    private:
+        const NXUInt8*   m_pData;
+        NXUInt64         m_uSize;
+        void*            m_hFile;       // HANDLE on windows, file descriptor elsewhere
+        void*            m_hMapping;    // HANDLE on windows, unused elsewhere
+    };
+}
@@ -0,0 +1,170 @@
+/*
+ *  File:     NXParallel.cpp
+ *  Author:   张雄
+ *  Date:     2026_10_19
+ *  Purpose:  a persistent worker pool and a deterministic parallel-for built on top of it
+ */
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <vector>
+
+#include "NXParallel.h"
+#include "NXCore.h"
+
+namespace {
+    /**
+     *  workers are created once and sleep between jobs, so per frame dispatch only costs a wake up
+     */
+    class WorkerPool {
+    public:
+        WorkerPool(): m_pJob(nullptr), m_JobCount(0), m_NextJob(0), m_Completed(0), m_Active(0), m_Generation(0), m_bQuit(false) {
+            const int iWorkerCount = NX::GetHardwareThreadCount() - 1;
+            for (int i = 0; i < iWorkerCount; ++i) {
+                m_Workers.push_back(std::thread(&WorkerPool::WorkerMain, this));
+            }
+        }
+
+        ~WorkerPool() {
+            {
+                std::lock_guard<std::mutex> Guard(m_Lock);
+                m_bQuit = true;
+            }
+            m_WakeUp.notify_all();
+            for (size_t i = 0; i < m_Workers.size(); ++i) {
+                m_Workers[i].join();
+            }
+        }
+
+        static WorkerPool& Instance() {
+            static WorkerPool SharedObject;
+            return SharedObject;
+        }
+
+    public:
+        void Run(const int iJobCount, const std::function<void(int)> &Job) {
+            std::lock_guard<std::mutex> RunGuard(m_RunLock);
+            {
+                std::lock_guard<std::mutex> Guard(m_Lock);
+                m_pJob      = &Job;
+                m_JobCount  = iJobCount;
+                m_NextJob   = 0;
+                m_Completed = 0;
+                ++m_Generation;
+            }
+            m_WakeUp.notify_all();
+
+            Drain(&Job, iJobCount);
+
+            std::unique_lock<std::mutex> Guard(m_Lock);
+            m_Done.wait(Guard, [&]() { return m_Completed == m_JobCount && m_Active == 0; });
+            m_pJob = nullptr;
+        }
+
+        static bool& InsideJob() {
+            static thread_local bool bInsideJob = false;
+            return bInsideJob;
+        }
+
+    private:
+        void Drain(const std::function<void(int)> *pJob, const int iJobCount) {
+            InsideJob() = true;
+            int iJob;
+            while ((iJob = m_NextJob.fetch_add(1)) < iJobCount) {
+                (*pJob)(iJob);
+                if (m_Completed.fetch_add(1) + 1 == iJobCount) {
+                    std::lock_guard<std::mutex> Guard(m_Lock);
+                    m_Done.notify_all();
+                }
+            }
+            InsideJob() = false;
+        }
+
+        void WorkerMain() {
+            NXUInt64 uSeenGeneration = 0;
+            for (;;) {
+                const std::function<void(int)> *pJob = nullptr;
+                int iJobCount = 0;
+                {
+                    std::unique_lock<std::mutex> Guard(m_Lock);
+                    m_WakeUp.wait(Guard, [&]() { return m_bQuit || (m_pJob && m_Generation != uSeenGeneration); });
+                    if (m_bQuit) {
+                        return;
+                    }
+                    uSeenGeneration = m_Generation;
+                    pJob            = m_pJob;
+                    iJobCount       = m_JobCount;
+                    ++m_Active;
+                }
+
+                Drain(pJob, iJobCount);
+
+                {
+                    std::lock_guard<std::mutex> Guard(m_Lock);
+                    --m_Active;
+                }
+                m_Done.notify_all();
+            }
+        }
+
+    private:
+        std::vector<std::thread>              m_Workers;
+        std::mutex                            m_RunLock;
+        std::mutex                            m_Lock;
+        std::condition_variable               m_WakeUp;
+        std::condition_variable               m_Done;
+        const std::function<void(int)>        *m_pJob;
+        int                                   m_JobCount;
+        std::atomic<int>                      m_NextJob;
+        std::atomic<int>                      m_Completed;
+        int                                   m_Active;
+        NXUInt64                              m_Generation;
+        bool                                  m_bQuit;
+    };
+}
+
+int NX::GetHardwareThreadCount() {
+    const int iCount = (int)std::thread::hardware_concurrency();
+    return iCount > 0 ? iCount : 1;
+}
+
+void NX::GetParallelRange(const int iBegin, const int iEnd, const int iPartCount, const int iPartIndex, const int iAlignment, int &iRangeBegin, int &iRangeEnd) {
+    NXAssert(iPartCount > 0 && iPartIndex >= 0 && iPartIndex < iPartCount && iAlignment > 0);
+    const NXInt64 iTotal  = iEnd - iBegin;
+    const NXInt64 iBlocks = (iTotal + iAlignment - 1) / iAlignment;
+    iRangeBegin = iBegin + (int)(iBlocks * iPartIndex / iPartCount) * iAlignment;
+    iRangeEnd   = iBegin + (int)(iBlocks * (iPartIndex + 1) / iPartCount) * iAlignment;
+    if (iRangeBegin > iEnd) {
+        iRangeBegin = iEnd;
+    }
+    if (iRangeEnd > iEnd) {
+        iRangeEnd = iEnd;
+    }
+}
+
+void NX::ParallelFor(const int iBegin, const int iEnd, int iPartCount, const std::function<void(int, int, int)> &Func, const int iAlignment) {
+    if (iEnd <= iBegin) {
+        return;
+    }
+    if (iPartCount <= 0) {
+        iPartCount = GetHardwareThreadCount();
+    }
+
+    auto RunPart = [&](int iPart) {
+        int iRangeBegin, iRangeEnd;
+        GetParallelRange(iBegin, iEnd, iPartCount, iPart, iAlignment, iRangeBegin, iRangeEnd);
+        if (iRangeBegin < iRangeEnd) {
+            Func(iRangeBegin, iRangeEnd, iPart);
+        }
+    };
+
+    if (iPartCount == 1 || WorkerPool::InsideJob()) {
+        for (int i = 0; i < iPartCount; ++i) {
+            RunPart(i);
+        }
+        return;
+    }
+    WorkerPool::Instance().Run(iPartCount, RunPart);
+}
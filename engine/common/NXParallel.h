@@ -0,0 +1,39 @@
+/*
+ *  File:     NXParallel.h
+ *  Author:   张雄
+ *  Date:     2026_10_19
+ *  Purpose:  a persistent worker pool and a deterministic parallel-for built on top of it
+ */
+
+#ifndef __ZX_NXENGINE_PARALLEL_H__
+#define __ZX_NXENGINE_PARALLEL_H__
+
+#include <functional>
+
+namespace NX {
+    /**
+     *  number of hardware threads, at least 1
+     */
+    int GetHardwareThreadCount();
+
+    /**
+     *  split [iBegin, iEnd) into iPartCount contiguous ranges of (almost) equal size and call
+     *  Func(iRangeBegin, iRangeEnd, iPartIndex) once per range. ranges only depend on
+     *  (iBegin, iEnd, iPartCount), so results stay deterministic whatever thread runs a range.
+     *  the caller thread takes part in the work and the call returns when every range is done.
+     *  nested calls from inside a range run serially on the calling thread.
+     *
+     *  <parameter>
+     *  iPartCount: number of ranges, <= 0 means GetHardwareThreadCount()
+     *  iAlignment: every range boundary except iEnd is a multiple of iAlignment away from iBegin,
+     *              use it to keep ranges on separate cache lines
+     */
+    void ParallelFor(const int iBegin, const int iEnd, int iPartCount, const std::function<void(int, int, int)> &Func, const int iAlignment = 1);
+
+    /**
+     *  the [begin, end) range ParallelFor gives to part iPartIndex
+     */
+    void GetParallelRange(const int iBegin, const int iEnd, const int iPartCount, const int iPartIndex, const int iAlignment, int &iRangeBegin, int &iRangeEnd);
+}
+
+#endif //!__ZX_NXENGINE_PARALLEL_H__
@@ -0,0 +1,99 @@
+/*
+ *  File:    NXChunkDirtyRegion.cpp
+ *
+ *  author:  张雄(zhang xiong, 1025679612@qq.com)
+ *  date:    2026_10_19
+ *  purpose: dirty row spans per chunk
+ */
+
+#include "NXChunkDirtyRegion.h"
+#include "../common/NXCore.h"
+#include "../math/NXMath.h"
+
+NX::ChunkDirtyRegion::ChunkDirtyRegion(const int iRowCount, const int iColCount, const int iChunkCells) {
+	NXAssert(iRowCount > 1 && iColCount > 1 && iChunkCells > 0);
+	m_iRowCount        = iRowCount;
+	m_iColCount        = iColCount;
+	m_iChunkCells      = iChunkCells;
+	m_iChunkRowCount   = (iRowCount - 1 + iChunkCells - 1) / iChunkCells;
+	m_iChunkColCount   = (iColCount - 1 + iChunkCells - 1) / iChunkCells;
+	m_FirstRow.resize(m_iChunkRowCount * m_iChunkColCount, -1);
+	m_LastRow.resize(m_iChunkRowCount * m_iChunkColCount, -1);
+}
+
+NX::ChunkDirtyRegion::~ChunkDirtyRegion() {
+	/**empty here*/
+}
+
+void NX::ChunkDirtyRegion::Mark(const int _r0, const int _c0, const int _r1, const int _c1) {
+	const int r0 = NXMax(_r0, 0), r1 = NXMin(_r1, m_iRowCount - 1);
+	const int c0 = NXMax(_c0, 0), c1 = NXMin(_c1, m_iColCount - 1);
+	if (r0 > r1 || c0 > c1) {
+		return;
+	}
+
+	//a border vertex also lives in the previous chunk, hence the -1 before dividing
+	const int cr0 = NXMax(0, (r0 - 1) / m_iChunkCells), cr1 = NXMin(m_iChunkRowCount - 1, r1 / m_iChunkCells);
+	const int cc0 = NXMax(0, (c0 - 1) / m_iChunkCells), cc1 = NXMin(m_iChunkColCount - 1, c1 / m_iChunkCells);
+	for (int cr = cr0; cr <= cr1; ++cr) {
+		const int iFirst = cr * m_iChunkCells, iLast = NXMin(iFirst + m_iChunkCells, m_iRowCount - 1);
+		if (r1 < iFirst || r0 > iLast) {
+			continue;
+		}
+		for (int cc = cc0; cc <= cc1; ++cc) {
+			const int iFirstCol = cc * m_iChunkCells, iLastCol = NXMin(iFirstCol + m_iChunkCells, m_iColCount - 1);
+			if (c1 < iFirstCol || c0 > iLastCol) {
+				continue;
+			}
+			MarkChunk(cr, cc, NXMax(r0, iFirst) - iFirst, NXMin(r1, iLast) - iFirst);
+		}
+	}
+}
+
+void NX::ChunkDirtyRegion::MarkChunk(const int iChunkRow, const int iChunkCol, const int r0, const int r1) {
+	const int iChunk = iChunkRow * m_iChunkColCount + iChunkCol;
+	if (m_FirstRow[iChunk] < 0) {
+		m_FirstRow[iChunk] = r0;
+		m_LastRow[iChunk]  = r1;
+		m_DirtyChunks.push_back(iChunk);
+	} else {
+		m_FirstRow[iChunk] = NXMin(m_FirstRow[iChunk], r0);
+		m_LastRow[iChunk]  = NXMax(m_LastRow[iChunk], r1);
+	}
+}
+
+void NX::ChunkDirtyRegion::MarkAll() {
+	Mark(0, 0, m_iRowCount - 1, m_iColCount - 1);
+}
+
+void NX::ChunkDirtyRegion::Clear() {
+	for (size_t i = 0; i < m_DirtyChunks.size(); ++i) {
+		m_FirstRow[m_DirtyChunks[i]] = -1;
+		m_LastRow[m_DirtyChunks[i]]  = -1;
+	}
+	m_DirtyChunks.clear();
+}
+
+bool NX::ChunkDirtyRegion::IsEmpty() const {
+	return m_DirtyChunks.empty();
+}
+
+const std::vector<int>& NX::ChunkDirtyRegion::GetDirtyChunks() const {
+	return m_DirtyChunks;
+}
+
+void NX::ChunkDirtyRegion::GetDirtyRows(const int iChunk, int &iFirstRow, int &iLastRow) const {
+	iFirstRow = m_FirstRow[iChunk];
+	iLastRow  = m_LastRow[iChunk];
+}
+
+int NX::ChunkDirtyRegion::GetPendingVertexCount() const {
+	int iCount = 0;
+	for (size_t i = 0; i < m_DirtyChunks.size(); ++i) {
+		const int iChunk    = m_DirtyChunks[i];
+		const int iChunkCol = iChunk % m_iChunkColCount;
+		const int iCellCols = NXMin(m_iChunkCells, m_iColCount - 1 - iChunkCol * m_iChunkCells);
+		iCount += (m_LastRow[iChunk] - m_FirstRow[iChunk] + 1) * (iCellCols + 1);
+	}
+	return iCount;
+}
@@ -0,0 +1,62 @@
+/*
+ *  File:    NXChunkDirtyRegion.h
+ *
+ *  author:  张雄(zhang xiong, 1025679612@qq.com)
+ *  date:    2026_10_19
+ *  purpose: collect edited vertex rectangles of a chunked grid and coalesce them into one
+ *           dirty row span per chunk, so a frame uploads each touched chunk with a single lock
+ */
+
+#pragma once
+
+#include <vector>
+
+namespace NX {
+	class ChunkDirtyRegion {
+	public:
+		/**
+		 *  same chunk layout as TerrainQuadTree: iChunkCells x iChunkCells cells per chunk,
+		 *  vertices on a chunk border are stored by both chunks
+		 */
+		ChunkDirtyRegion(const int iRowCount, const int iColCount, const int iChunkCells);
+		virtual ~ChunkDirtyRegion();
+
+	public:
+		/**
+		 *  mark vertex rows [r0, r1] and cols [c0, c1] (inclusive) dirty, the rect is clamped to the grid
+		 */
+		void  Mark(const int r0, const int c0, const int r1, const int c1);
+		void  MarkAll();
+		void  Clear();
+		bool  IsEmpty() const;
+
+	public:
+		/**
+		 *  chunk indexs (chunk row * chunk col count + chunk col) in the order they were first marked
+		 */
+		const std::vector<int>& GetDirtyChunks() const;
+
+		/**
+		 *  dirty vertex rows of one chunk, local to the chunk, inclusive
+		 */
+		void  GetDirtyRows(const int iChunk, int &iFirstRow, int &iLastRow) const;
+
+		/**
+		 *  vertices a flush would upload: whole chunk rows of every dirty span
+		 */
+		int   GetPendingVertexCount() const;
+
+	private:
+		void  MarkChunk(const int iChunkRow, const int iChunkCol, const int r0, const int r1);
+
+	private:
+		int                     m_iRowCount;
+		int                     m_iColCount;
+		int                     m_iChunkCells;
+		int                     m_iChunkRowCount;
+		int                     m_iChunkColCount;
+		std::vector<int>        m_FirstRow;       // per chunk, -1 when clean
+		std::vector<int>        m_LastRow;
+		std::vector<int>        m_DirtyChunks;
+	};
+}
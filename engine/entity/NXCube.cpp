@@ -12,6 +12,7 @@
 #include "../render/NXCamera.h"
 #include "../render/NXEngine.h"
 #include "../render/NXEffectManager.h"
+#include "../render/NXMeshOptimizer.h"
 
 struct NX::Cube::Vertex{
 	Vertex(float _x, float _y, float _z, float _u, float _v):x(_x), y(_y), z(_z), u(_u), v(_v) {
@@ -39,6 +40,7 @@ struct NX::Cube::Vertex{
 
 NX::Cube::Cube(const std::string &_TextureFilePath, const Size3D &_size) :m_Size(_size), m_TextureFilePath(_TextureFilePath) {
 	m_pVertexBuffer       = nullptr;
+	m_pIndexBuffer        = nullptr;
 	m_pVertexDesc         = nullptr;
 	m_pEffect             = NX::EffectManager::Instance().GetEffect("Shaders/DirectX/Cube3D_Effect.hlsl");
 	{
@@ -51,10 +53,27 @@ NX::Cube::Cube(const std::string &_TextureFilePath, const Size3D &_size) :m_Size
 		};
 		pWindow->GetD3D9Device()->CreateVertexDeclaration(VertexDesc, &m_pVertexDesc);
 	}
+
+	{//the uvs follow the scale so the vertices are rebuilt every frame, the 6 faces share one static triangle list
+		NXUInt16 Indexs[36];
+		for (int j = 0; j < 6; ++j) {
+			const NXUInt16 Face[] = { 0, 1, 2, 2, 1, 3 };
+			for (int k = 0; k < 6; ++k) {
+				Indexs[j * 6 + k] = (NXUInt16)(j * 4 + Face[k]);
+			}
+		}
+		MeshOptimizer::OptimizeVertexCache(Indexs, 36, 24);
+		glb_GetD3DWindow()->GetD3D9Device()->CreateIndexBuffer(sizeof(Indexs), D3DUSAGE_WRITEONLY, D3DFMT_INDEX16, D3DPOOL_DEFAULT, &m_pIndexBuffer, NULL);
+		void *pBase = NULL;
+		m_pIndexBuffer->Lock(0, 0, &pBase, D3DLOCK_DISCARD);
+		memcpy(pBase, Indexs, sizeof(Indexs));
+		m_pIndexBuffer->Unlock();
+	}
 }
 
 NX::Cube::~Cube() {
 	NX::NXSafeRelease(m_pVertexBuffer);
+	NX::NXSafeRelease(m_pIndexBuffer);
 	NX::NXSafeRelease(m_pEffect);
 }
 
@@ -120,10 +139,9 @@ void NX::Cube::Render(struct RenderParameter &renderer) {
 		m_pEffect->Begin(&uPasses, 0);
 		for (int i = 0; i < uPasses; ++i) {
 			pWindow->GetD3D9Device()->SetStreamSource(0, m_pVertexBuffer, 0, sizeof(Vertex));
+			pWindow->GetD3D9Device()->SetIndices(m_pIndexBuffer);
 			m_pEffect->BeginPass(i);
-			for(int j = 0; j < 6; ++j){
-				pWindow->GetD3D9Device()->DrawPrimitive(D3DPT_TRIANGLESTRIP, j * 4, 2);
-			}
+			pWindow->GetD3D9Device()->DrawIndexedPrimitive(D3DPT_TRIANGLELIST, 0, 0, 24, 0, 12);
 			m_pEffect->EndPass();
 		}
 		m_pEffect->End();
@@ -36,6 +36,7 @@ namespace NX {
 	private:
 		Size3D				           m_Size;
 		IDirect3DVertexBuffer9         *m_pVertexBuffer;
+		IDirect3DIndexBuffer9          *m_pIndexBuffer;
 		IDirect3DVertexDeclaration9    *m_pVertexDesc;
 		ID3DXEffect                    *m_pEffect;
 		std::string                    m_TextureFilePath;
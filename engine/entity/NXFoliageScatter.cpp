@@ -0,0 +1,305 @@
+/*
+ *  File:    NXFoliageScatter.cpp
+ *
+ *  author:  张雄(zhang xiong, 1025679612@qq.com)
+ *  date:    2026_10_19
+ *  purpose: foliage instance scattering and per frame streams
+ */
+
+#include <cmath>
+#include <cfloat>
+#include <algorithm>
+
+#include "NXFoliageScatter.h"
+#include "NXHeightField.h"
+#include "NXTerrainQuadTree.h"
+#include "../common/NXCore.h"
+#include "../common/NXParallel.h"
+#include "../math/NXHash.h"
+#include "../math/NXMath.h"
+#include "../render/NXViewFrustum.h"
+
+namespace {
+	const float PI = 3.14159265358979f;
+
+	struct Candidate {
+		NX::float3  Position;
+		NXUInt32    uOrder;
+		NXUInt8     Yaw;
+		NXUInt8     Scale;
+	};
+}
+
+NX::FoliageScatter::FoliageScatter() {
+	m_uSeed            = 0;
+	m_fDensity         = 1.f;
+	m_fMinNormalY      = 0.7f;
+	m_fMaxNormalY      = 1.f;
+	m_fMinHeight       = -FLT_MAX;
+	m_fMaxHeight       = FLT_MAX;
+	m_fMinScale        = 1.f;
+	m_fMaxScale        = 1.f;
+	m_fInstanceHeight  = 1.f;
+	m_iWorkerCount     = 0;
+	m_iDensityRows     = 0;
+	m_iDensityCols     = 0;
+}
+
+NX::FoliageScatter::~FoliageScatter() {
+	/**empty here*/
+}
+
+NX::FoliageScatter& NX::FoliageScatter::SetSeed(const NXUInt32 uSeed) {
+	m_uSeed = uSeed;
+	return *this;
+}
+
+NX::FoliageScatter& NX::FoliageScatter::SetDensity(const float fDensity) {
+	m_fDensity = NXMax(fDensity, 0.f);
+	return *this;
+}
+
+NX::FoliageScatter& NX::FoliageScatter::SetSlopeLimits(const float fMinNormalY, const float fMaxNormalY) {
+	m_fMinNormalY = fMinNormalY;
+	m_fMaxNormalY = fMaxNormalY;
+	return *this;
+}
+
+NX::FoliageScatter& NX::FoliageScatter::SetHeightLimits(const float fMinHeight, const float fMaxHeight) {
+	m_fMinHeight = fMinHeight;
+	m_fMaxHeight = fMaxHeight;
+	return *this;
+}
+
+NX::FoliageScatter& NX::FoliageScatter::SetScaleLimits(const float fMinScale, const float fMaxScale) {
+	m_fMinScale = fMinScale;
+	m_fMaxScale = fMaxScale;
+	return *this;
+}
+
+NX::FoliageScatter& NX::FoliageScatter::SetInstanceHeight(const float fInstanceHeight) {
+	m_fInstanceHeight = NXMax(fInstanceHeight, 0.f);
+	return *this;
+}
+
+NX::FoliageScatter& NX::FoliageScatter::SetWorkerCount(const int iWorkerCount) {
+	m_iWorkerCount = iWorkerCount;
+	return *this;
+}
+
+NX::FoliageScatter& NX::FoliageScatter::SetDensityMap(const NXUInt8 *pDensity, const int iRows, const int iCols) {
+	if (!pDensity || iRows <= 0 || iCols <= 0) {
+		m_DensityMap.clear();
+		m_iDensityRows = m_iDensityCols = 0;
+		return *this;
+	}
+	m_DensityMap.assign(pDensity, pDensity + iRows * iCols);
+	m_iDensityRows = iRows;
+	m_iDensityCols = iCols;
+	return *this;
+}
+
+NXUInt32 NX::FoliageScatter::GetSeed() const {
+	return m_uSeed;
+}
+
+float NX::FoliageScatter::GetDensity() const {
+	return m_fDensity;
+}
+
+int NX::FoliageScatter::GetWorkerCount() const {
+	return m_iWorkerCount;
+}
+
+void NX::FoliageScatter::Scatter(const HeightField &Field, const TerrainQuadTree &Tree) {
+	const int iChunkRows = Tree.GetChunkRowCount(), iChunkCols = Tree.GetChunkColCount();
+	{//Tree must cover exactly Field's cells
+		int iFirstRow, iFirstCol, iCellRows, iCellCols;
+		Tree.GetChunkCellRange(iChunkRows - 1, iChunkCols - 1, iFirstRow, iFirstCol, iCellRows, iCellCols);
+		NXAssert(iFirstRow + iCellRows == Field.GetRowCount() - 1 && iFirstCol + iCellCols == Field.GetColCount() - 1);
+	}
+	std::vector<Chunk> Chunks(iChunkRows * iChunkCols);
+	std::vector<std::vector<Instance>> ChunkInstances(Chunks.size());
+	ParallelFor(0, (int)Chunks.size(), m_iWorkerCount, [&](int iBegin, int iEnd, int) {
+		for (int i = iBegin; i < iEnd; ++i) {
+			ScatterChunk(Field, Tree, i / iChunkCols, i % iChunkCols, Chunks[i], ChunkInstances[i]);
+		}
+	});
+
+	{//pack the chunks back to back
+		size_t uCount = 0;
+		for (size_t i = 0; i < Chunks.size(); ++i) {
+			uCount += ChunkInstances[i].size();
+		}
+		m_Instances.clear();
+		m_Instances.reserve(uCount);
+		for (size_t i = 0; i < Chunks.size(); ++i) {
+			Chunks[i].iFirstInstance = (int)m_Instances.size();
+			Chunks[i].iInstanceCount = (int)ChunkInstances[i].size();
+			m_Instances.insert(m_Instances.end(), ChunkInstances[i].begin(), ChunkInstances[i].end());
+		}
+		m_Chunks.swap(Chunks);
+	}
+}
+
+void NX::FoliageScatter::ScatterChunk(const HeightField &Field, const TerrainQuadTree &Tree, const int iChunkRow, const int iChunkCol, Chunk &chunk, std::vector<Instance> &Instances) const {
+	int iFirstRow, iFirstCol, iCellRows, iCellCols;
+	Tree.GetChunkCellRange(iChunkRow, iChunkCol, iFirstRow, iFirstCol, iCellRows, iCellCols);
+	const float dx = Field.GetDX(), dz = Field.GetDZ();
+	const float x0 = iFirstRow * dx, x1 = (iFirstRow + iCellRows) * dx, z0 = iFirstCol * dz, z1 = (iFirstCol + iCellCols) * dz;
+	Instances.clear();
+	chunk.Bound = AABB(float3(x0, 0.f, z0), float3(x0, 0.f, z0));
+	chunk.Ranges[0] = chunk.Ranges[1] = chunk.Ranges[2] = GetQuantizeRange(0.f, 0.f);
+	if (m_fDensity <= 0.f) {
+		return;
+	}
+
+	//jittered grid in world space, a grid cell belongs to the chunk holding its corner
+	const float fSpacing = 1.f / std::sqrt(m_fDensity);
+	const int   i0 = (int)std::ceil(x0 / fSpacing), i1 = (int)std::ceil(x1 / fSpacing);
+	const int   j0 = (int)std::ceil(z0 / fSpacing), j1 = (int)std::ceil(z1 / fSpacing);
+	const int   iLastRow = Field.GetRowCount() - 1, iLastCol = Field.GetColCount() - 1;
+	std::vector<Candidate> Candidates;
+	for (int i = i0; i < i1; ++i) {
+		for (int j = j0; j < j1; ++j) {
+			//every random choice of a candidate is a hash of its cell, so the scatter doesn't depend on which chunk or thread visits it
+			const NXUInt32 h0 = HashLattice(i, j, m_uSeed), h1 = HashLattice(h0, j, m_uSeed), h2 = HashLattice(h1, i, m_uSeed);
+			const float x = (i + HashToUnitFloat(h0)) * fSpacing, z = (j + HashToUnitFloat(h1)) * fSpacing;
+			if (x >= Field.GetMaxX() || z >= Field.GetMaxZ()) {
+				continue;
+			}
+			if (HashToUnitFloat(h2) >= SampleDensity(Field, x, z)) {
+				continue;
+			}
+
+			{//slope of the triangle under (x, z), same split as the mesh
+				const int   r = NXMin((int)(x / dx), iLastRow - 1), c = NXMin((int)(z / dz), iLastCol - 1);
+				const float u = x / dx - r, v = z / dz - c;
+				const float h00 = Field.GetHeight(r, c), h01 = Field.GetHeight(r, c + 1), h10 = Field.GetHeight(r + 1, c), h11 = Field.GetHeight(r + 1, c + 1);
+				const float gx = (u + v <= 1.f ? h10 - h00 : h11 - h01) / dx, gz = (u + v <= 1.f ? h01 - h00 : h11 - h10) / dz;
+				const float fNormalY = 1.f / std::sqrt(1.f + gx * gx + gz * gz);
+				if (fNormalY < m_fMinNormalY || fNormalY > m_fMaxNormalY) {
+					continue;
+				}
+			}
+			const float y = Field.GetHeight(x, z);
+			if (y < m_fMinHeight || y > m_fMaxHeight) {
+				continue;
+			}
+
+			const NXUInt32 h3 = HashLattice(h2, i ^ j, m_uSeed);
+			Candidate candidate;
+			candidate.Position = float3(x, y, z);
+			candidate.uOrder   = HashLattice(h3, i, j);
+			candidate.Yaw      = (NXUInt8)(h3 & 0xff);
+			candidate.Scale    = (NXUInt8)((h3 >> 8) & 0xff);
+			Candidates.push_back(candidate);
+		}
+	}
+	if (Candidates.empty()) {
+		return;
+	}
+
+	//random order, any prefix of the chunk is then an even subsample
+	std::sort(Candidates.begin(), Candidates.end(), [](const Candidate &a, const Candidate &b) {
+		return a.uOrder < b.uOrder;
+	});
+
+	float3 MinPoint(FLT_MAX, FLT_MAX, FLT_MAX), MaxPoint(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+	for (size_t i = 0; i < Candidates.size(); ++i) {
+		const float3 &p = Candidates[i].Position;
+		MinPoint = float3(NXMin(MinPoint.x, p.x), NXMin(MinPoint.y, p.y), NXMin(MinPoint.z, p.z));
+		MaxPoint = float3(NXMax(MaxPoint.x, p.x), NXMax(MaxPoint.y, p.y), NXMax(MaxPoint.z, p.z));
+	}
+	chunk.Ranges[0] = GetQuantizeRange(MinPoint.x, MaxPoint.x);
+	chunk.Ranges[1] = GetQuantizeRange(MinPoint.y, MaxPoint.y);
+	chunk.Ranges[2] = GetQuantizeRange(MinPoint.z, MaxPoint.z);
+	chunk.Bound     = AABB(MinPoint, float3(MaxPoint.x, MaxPoint.y + m_fInstanceHeight * NXMax(m_fMinScale, m_fMaxScale), MaxPoint.z));
+
+	Instances.resize(Candidates.size());
+	for (size_t i = 0; i < Candidates.size(); ++i) {
+		Instance &instance = Instances[i];
+		instance.x     = QuantizeToInt16(Candidates[i].Position.x, chunk.Ranges[0]);
+		instance.y     = QuantizeToInt16(Candidates[i].Position.y, chunk.Ranges[1]);
+		instance.z     = QuantizeToInt16(Candidates[i].Position.z, chunk.Ranges[2]);
+		instance.Yaw   = Candidates[i].Yaw;
+		instance.Scale = Candidates[i].Scale;
+	}
+}
+
+float NX::FoliageScatter::SampleDensity(const HeightField &Field, const float x, const float z) const {
+	if (m_DensityMap.empty()) {
+		return 1.f;
+	}
+	const float u = NXMax(0.f, NXMin(x / Field.GetMaxX(), 1.f)) * (m_iDensityRows - 1);
+	const float v = NXMax(0.f, NXMin(z / Field.GetMaxZ(), 1.f)) * (m_iDensityCols - 1);
+	const int   r = NXMin((int)u, NXMax(m_iDensityRows - 2, 0)), c = NXMin((int)v, NXMax(m_iDensityCols - 2, 0));
+	const int   r1 = NXMin(r + 1, m_iDensityRows - 1), c1 = NXMin(c + 1, m_iDensityCols - 1);
+	const float fu = u - r, fv = v - c;
+	const float d0 = m_DensityMap[r * m_iDensityCols + c] + (m_DensityMap[r * m_iDensityCols + c1] - m_DensityMap[r * m_iDensityCols + c]) * fv;
+	const float d1 = m_DensityMap[r1 * m_iDensityCols + c] + (m_DensityMap[r1 * m_iDensityCols + c1] - m_DensityMap[r1 * m_iDensityCols + c]) * fv;
+	return (d0 + (d1 - d0) * fu) * (1.f / 255.f);
+}
+
+void NX::FoliageScatter::BuildStream(const ViewFrustum &Frustum, const StreamParameter &Parameter, std::vector<Instance> &Stream, std::vector<Batch> &Batches, Statistics *pStatistics) const {
+	Stream.clear();
+	Batches.clear();
+	int iVisibleChunks = 0, iCulledChunks = 0;
+	const bool bFade = Parameter.fFadeEnd > 0.f;
+	for (size_t i = 0; i < m_Chunks.size(); ++i) {
+		const Chunk &chunk = m_Chunks[i];
+		if (chunk.iInstanceCount == 0) {
+			continue;
+		}
+
+		int iCount = chunk.iInstanceCount;
+		if (bFade) {//distance from the eye to the nearest point of the bound
+			const float ex = NXMax(NXMax(chunk.Bound.m_vMinPoint.x - Parameter.Eye.x, Parameter.Eye.x - chunk.Bound.m_vMaxPoint.x), 0.f);
+			const float ey = NXMax(NXMax(chunk.Bound.m_vMinPoint.y - Parameter.Eye.y, Parameter.Eye.y - chunk.Bound.m_vMaxPoint.y), 0.f);
+			const float ez = NXMax(NXMax(chunk.Bound.m_vMinPoint.z - Parameter.Eye.z, Parameter.Eye.z - chunk.Bound.m_vMaxPoint.z), 0.f);
+			const float fDistance = std::sqrt(ex * ex + ey * ey + ez * ez);
+			if (fDistance >= Parameter.fFadeEnd) {
+				++iCulledChunks;
+				continue;
+			}
+			if (fDistance > Parameter.fFadeStart) {
+				const float fKeep = (Parameter.fFadeEnd - fDistance) / NXMax(Parameter.fFadeEnd - Parameter.fFadeStart, 1e-6f);
+				iCount = (int)std::ceil(iCount * fKeep);
+			}
+		}
+		if (!Frustum.Visible(chunk.Bound)) {
+			++iCulledChunks;
+			continue;
+		}
+
+		++iVisibleChunks;
+		Batch batch = { (int)i, (int)Stream.size(), iCount };
+		Batches.push_back(batch);
+		Stream.insert(Stream.end(), m_Instances.begin() + chunk.iFirstInstance, m_Instances.begin() + chunk.iFirstInstance + iCount);
+	}
+
+	if (pStatistics) {
+		pStatistics->iVisibleChunks   = iVisibleChunks;
+		pStatistics->iCulledChunks    = iCulledChunks;
+		pStatistics->iStreamInstances = (int)Stream.size();
+		pStatistics->uStreamBytes     = Stream.size() * sizeof(Instance);
+	}
+}
+
+int NX::FoliageScatter::GetInstanceCount() const {
+	return (int)m_Instances.size();
+}
+
+const std::vector<NX::FoliageScatter::Chunk>& NX::FoliageScatter::GetChunks() const {
+	return m_Chunks;
+}
+
+const std::vector<NX::FoliageScatter::Instance>& NX::FoliageScatter::GetInstances() const {
+	return m_Instances;
+}
+
+void NX::FoliageScatter::Unpack(const Chunk &chunk, const Instance &instance, float3 &Position, float &fYaw, float &fScale) const {
+	Position = float3(DequantizeFromInt16(instance.x, chunk.Ranges[0]), DequantizeFromInt16(instance.y, chunk.Ranges[1]), DequantizeFromInt16(instance.z, chunk.Ranges[2]));
+	fYaw     = instance.Yaw * (2.f * PI / 256.f);
+	fScale   = m_fMinScale + (m_fMaxScale - m_fMinScale) * instance.Scale * (1.f / 255.f);
+}
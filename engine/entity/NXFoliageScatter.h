@@ -0,0 +1,134 @@
+/*
+ *  File:    NXFoliageScatter.h
+ *
+ *  author:  张雄(zhang xiong, 1025679612@qq.com)
+ *  date:    2026_10_19
+ *  purpose: scatter grass and foliage instances over a HeightField and stream the visible ones every frame.
+ *           candidates come from a jittered grid, a density map, slope and height limits thin them out.
+ *           instances are packed into 8 bytes and stored chunk by chunk with the TerrainQuadTree chunk
+ *           layout, each chunk in random order so any prefix is an even subsample for distance thinning.
+ *           culling works on whole chunks against the ViewFrustum and copies the surviving ranges into
+ *           one compact stream. no D3D in here.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "../math/NXVector.h"
+#include "../math/NXAABB.h"
+#include "../math/NXQuantize.h"
+#include "../common/NXType.h"
+
+namespace NX {
+	class HeightField;
+	class TerrainQuadTree;
+	class ViewFrustum;
+
+	class FoliageScatter {
+	public:
+		struct Instance {
+			NXInt16     x, y, z;             // QuantizeToInt16 with the chunk's ranges
+			NXUInt8     Yaw;                 // rotation around +y in 1/256 turns
+			NXUInt8     Scale;               // lerp of the scale limits
+		};
+
+		struct Chunk {
+			AABB            Bound;           // instance positions grown by the instance height
+			QuantizeRange   Ranges[3];       // x, y, z
+			int             iFirstInstance;
+			int             iInstanceCount;
+		};
+
+		/**
+		 *  the part of the stream that belongs to one chunk, dequantize with the chunk's ranges
+		 */
+		struct Batch {
+			int         iChunk;
+			int         iFirstInstance;      // into the stream
+			int         iInstanceCount;
+		};
+
+		struct StreamParameter {
+			float3      Eye;                 // in terrain space
+			float       fFadeStart;          // chunks closer than this keep every instance
+			float       fFadeEnd;            // chunks further than this are dropped, density falls linearly between, <= 0 never fades
+		};
+
+		struct Statistics {
+			int         iVisibleChunks;
+			int         iCulledChunks;       // outside the frustum or past fFadeEnd
+			int         iStreamInstances;
+			NXUInt64    uStreamBytes;
+		};
+
+	public:
+		FoliageScatter();
+		virtual ~FoliageScatter();
+
+	public:
+		/**
+		 *  fDensity: instances per square unit where the density map is 1
+		 *  fMinNormalY/fMaxNormalY: slope limits as the y of the surface normal, 1 is flat
+		 *  fMinHeight/fMaxHeight: height limits
+		 *  fMinScale/fMaxScale: uniform scale picked per instance
+		 *  fInstanceHeight: height of an unscaled instance, grows the chunk bounds
+		 *  iWorkerCount: <= 0 means every hardware thread, the result doesn't depend on it
+		 */
+		FoliageScatter& SetSeed(const NXUInt32 uSeed);
+		FoliageScatter& SetDensity(const float fDensity);
+		FoliageScatter& SetSlopeLimits(const float fMinNormalY, const float fMaxNormalY);
+		FoliageScatter& SetHeightLimits(const float fMinHeight, const float fMaxHeight);
+		FoliageScatter& SetScaleLimits(const float fMinScale, const float fMaxScale);
+		FoliageScatter& SetInstanceHeight(const float fInstanceHeight);
+		FoliageScatter& SetWorkerCount(const int iWorkerCount);
+		/**
+		 *  iRows x iCols bytes stretched over the whole field, row i along x, 255 keeps every candidate.
+		 *  an empty map means 255 everywhere.
+		 */
+		FoliageScatter& SetDensityMap(const NXUInt8 *pDensity, const int iRows, const int iCols);
+		NXUInt32        GetSeed() const;
+		float           GetDensity() const;
+		int             GetWorkerCount() const;
+
+	public:
+		/**
+		 *  replace every instance, chunks follow Tree's layout which must match Field. for a Terrain pass
+		 *  GetHeightField() and GetQuadTree(). chunks are scattered in parallel.
+		 */
+		void  Scatter(const HeightField &Field, const TerrainQuadTree &Tree);
+
+		/**
+		 *  cull the chunks and copy the visible instances into Stream, Batches says which chunk every range
+		 *  came from. both vectors are reused between frames.
+		 */
+		void  BuildStream(const ViewFrustum &Frustum, const StreamParameter &Parameter, std::vector<Instance> &Stream, std::vector<Batch> &Batches, Statistics *pStatistics = nullptr) const;
+
+	public:
+		int                          GetInstanceCount() const;
+		const std::vector<Chunk>&    GetChunks() const;
+		const std::vector<Instance>& GetInstances() const;
+		void                         Unpack(const Chunk &chunk, const Instance &instance, float3 &Position, float &fYaw, float &fScale) const;
+
+	private:
+		void  ScatterChunk(const HeightField &Field, const TerrainQuadTree &Tree, const int iChunkRow, const int iChunkCol, Chunk &chunk, std::vector<Instance> &Instances) const;
+		float SampleDensity(const HeightField &Field, const float x, const float z) const;
+
+	private:
+		NXUInt32                m_uSeed;
+		float                   m_fDensity;
+		float                   m_fMinNormalY;
+		float                   m_fMaxNormalY;
+		float                   m_fMinHeight;
+		float                   m_fMaxHeight;
+		float                   m_fMinScale;
+		float                   m_fMaxScale;
+		float                   m_fInstanceHeight;
+		int                     m_iWorkerCount;
+		std::vector<NXUInt8>    m_DensityMap;
+		int                     m_iDensityRows;
+		int                     m_iDensityCols;
+		std::vector<Chunk>      m_Chunks;            // chunk row * chunk col count + chunk col
+		std::vector<Instance>   m_Instances;         // chunk-major
+	};
+}
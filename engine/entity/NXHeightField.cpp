@@ -0,0 +1,126 @@
+/*
+ *  File:    NXHeightField.cpp
+ *
+ *  author:  张雄(zhang xiong, 1025679612@qq.com)
+ *  date:    2026_10_19
+ *  purpose: compact height grid and fast height queries
+ */
+
+#include <cmath>
+
+#include "NXHeightField.h"
+#include "../common/NXCore.h"
+#include "../math/NXMath.h"
+#include "../math/NXSIMD.h"
+
+NX::HeightField::HeightField(const int iRowCount, const int iColCount, const float dx, const float dz) {
+	NXAssert(iRowCount > 1 && iColCount > 1 && dx > 0.f && dz > 0.f);
+	m_iRowCount   = iRowCount;
+	m_iColCount   = iColCount;
+	m_dx          = dx;
+	m_dz          = dz;
+	m_fInvDX      = 1.f / dx;
+	m_fInvDZ      = 1.f / dz;
+	m_Heights.resize(iRowCount * iColCount, 0.f);
+}
+
+NX::HeightField::~HeightField() {
+	/**empty here*/
+}
+
+int NX::HeightField::GetRowCount() const {
+	return m_iRowCount;
+}
+
+int NX::HeightField::GetColCount() const {
+	return m_iColCount;
+}
+
+float NX::HeightField::GetDX() const {
+	return m_dx;
+}
+
+float NX::HeightField::GetDZ() const {
+	return m_dz;
+}
+
+float NX::HeightField::GetMaxX() const {
+	return m_dx * (m_iRowCount - 1);
+}
+
+float NX::HeightField::GetMaxZ() const {
+	return m_dz * (m_iColCount - 1);
+}
+
+float* NX::HeightField::GetData() {
+	return &m_Heights[0];
+}
+
+const float* NX::HeightField::GetData() const {
+	return &m_Heights[0];
+}
+
+float NX::HeightField::GetHeight(const int r, const int c) const {
+	NXAssert(r >= 0 && r < m_iRowCount && c >= 0 && c < m_iColCount);
+	return m_Heights[r * m_iColCount + c];
+}
+
+NX::HeightField& NX::HeightField::SetHeight(const int r, const int c, const float h) {
+	NXAssert(r >= 0 && r < m_iRowCount && c >= 0 && c < m_iColCount);
+	m_Heights[r * m_iColCount + c] = h;
+	return *this;
+}
+
+float NX::HeightField::GetHeight(const float x, const float z) const {
+	//grid coordinates clamped to the field, the last row/col reuses the previous cell with a fraction of 1.
+	//NaN fails the compares and lands on row/col 0 like maxps does in GetHeights, it must never reach the index
+	const float sr = x * m_fInvDX, sc = z * m_fInvDZ;
+	const float fr = sr > 0.f ? NXMin(sr, (float)(m_iRowCount - 1)) : 0.f;
+	const float fc = sc > 0.f ? NXMin(sc, (float)(m_iColCount - 1)) : 0.f;
+	const int   r  = NXMin((int)fr, m_iRowCount - 2);
+	const int   c  = NXMin((int)fc, m_iColCount - 2);
+	const float u  = fr - r, v = fc - c;
+
+	const float *p  = &m_Heights[r * m_iColCount + c];
+	const float h00 = p[0], h01 = p[1], h10 = p[m_iColCount], h11 = p[m_iColCount + 1];
+	if (u + v <= 1.f) {
+		return h00 + u * (h10 - h00) + v * (h01 - h00);
+	}
+	return h11 + (1.f - u) * (h01 - h11) + (1.f - v) * (h10 - h11);
+}
+
+void NX::HeightField::GetHeights(const float *pXs, const float *pZs, float *pOut, const int iCount) const {
+	int i = 0;
+#if NX_SIMD_SSE
+	const __m128  InvDX  = _mm_set1_ps(m_fInvDX), InvDZ = _mm_set1_ps(m_fInvDZ);
+	const __m128  MaxR   = _mm_set1_ps((float)(m_iRowCount - 1)), MaxC = _mm_set1_ps((float)(m_iColCount - 1));
+	const __m128i LastR  = _mm_set1_epi32(m_iRowCount - 2), LastC = _mm_set1_epi32(m_iColCount - 2);
+	const __m128  Zero   = _mm_setzero_ps(), One = _mm_set1_ps(1.f);
+	const float  *pData  = &m_Heights[0];
+	for (; i + 4 <= iCount; i += 4) {
+		const __m128 fr = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(pXs + i), InvDX), Zero), MaxR);
+		const __m128 fc = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(pZs + i), InvDZ), Zero), MaxC);
+		__m128i r = _mm_cvttps_epi32(fr), c = _mm_cvttps_epi32(fc);
+		r = _mm_sub_epi32(r, _mm_and_si128(_mm_cmpgt_epi32(r, LastR), _mm_sub_epi32(r, LastR)));   // min(r, rows - 2)
+		c = _mm_sub_epi32(c, _mm_and_si128(_mm_cmpgt_epi32(c, LastC), _mm_sub_epi32(c, LastC)));
+		const __m128 u = _mm_sub_ps(fr, _mm_cvtepi32_ps(r));
+		const __m128 v = _mm_sub_ps(fc, _mm_cvtepi32_ps(c));
+
+		NX_ALIGN(16) int   Rows[4], Cols[4];
+		NX_ALIGN(16) float H00[4], H01[4], H10[4], H11[4];
+		_mm_store_si128((__m128i*)Rows, r);
+		_mm_store_si128((__m128i*)Cols, c);
+		for (int k = 0; k < 4; ++k) {//no gather in SSE2, fetch the four corners per lane
+			const float *p = pData + Rows[k] * m_iColCount + Cols[k];
+			H00[k] = p[0], H01[k] = p[1], H10[k] = p[m_iColCount], H11[k] = p[m_iColCount + 1];
+		}
+		const __m128 h00 = _mm_load_ps(H00), h01 = _mm_load_ps(H01), h10 = _mm_load_ps(H10), h11 = _mm_load_ps(H11);
+		const __m128 Lower = _mm_add_ps(_mm_add_ps(h00, _mm_mul_ps(u, _mm_sub_ps(h10, h00))), _mm_mul_ps(v, _mm_sub_ps(h01, h00)));
+		const __m128 Upper = _mm_add_ps(_mm_add_ps(h11, _mm_mul_ps(_mm_sub_ps(One, u), _mm_sub_ps(h01, h11))), _mm_mul_ps(_mm_sub_ps(One, v), _mm_sub_ps(h10, h11)));
+		_mm_storeu_ps(pOut + i, SIMDSelect(_mm_cmple_ps(_mm_add_ps(u, v), One), Lower, Upper));
+	}
+#endif
+	for (; i < iCount; ++i) {
+		pOut[i] = GetHeight(pXs[i], pZs[i]);
+	}
+}
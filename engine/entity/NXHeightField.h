@@ -0,0 +1,55 @@
+/*
+ *  File:    NXHeightField.h
+ *
+ *  author:  张雄(zhang xiong, 1025679612@qq.com)
+ *  date:    2026_10_19
+ *  purpose: a compact height-only grid with closed form height queries, vertex (r, c) lies at (r * dx, h, c * dz)
+ *           and every cell is split along the (r, c + 1) - (r + 1, c) diagonal like the terrain mesh
+ */
+
+#pragma once
+
+#include <vector>
+
+namespace NX {
+	class HeightField {
+	public:
+		HeightField(const int iRowCount, const int iColCount, const float dx, const float dz);
+		virtual ~HeightField();
+
+	public:
+		int           GetRowCount() const;
+		int           GetColCount() const;
+		float         GetDX() const;
+		float         GetDZ() const;
+		float         GetMaxX() const;
+		float         GetMaxZ() const;
+		float*        GetData();
+		const float*  GetData() const;
+
+	public:
+		float         GetHeight(const int r, const int c) const;
+		HeightField&  SetHeight(const int r, const int c, const float h);
+
+		/**
+		 *  height of the surface at (x, z), positions outside the field are clamped to its border and NaN
+		 *  coordinates to its first row/col
+		 */
+		float         GetHeight(const float x, const float z) const;
+
+		/**
+		 *  pOut[i] = GetHeight(pXs[i], pZs[i]) for i in [0, iCount), four queries per SSE step,
+		 *  results are identical to the scalar path
+		 */
+		void          GetHeights(const float *pXs, const float *pZs, float *pOut, const int iCount) const;
+
+	private:
+		int                      m_iRowCount;
+		int                      m_iColCount;
+		float                    m_dx;
+		float                    m_dz;
+		float                    m_fInvDX;
+		float                    m_fInvDZ;
+		std::vector<float>       m_Heights;    // row-major, m_iColCount per row
+	};
+}
@@ -0,0 +1,187 @@
+/*
+ *  File:    NXHeightFieldDelta.cpp
+ *
+ *  author:  张雄(zhang xiong, 1025679612@qq.com)
+ *  date:    2026_10_19
+ *  purpose: run-length encoded height edits and their undo/redo history
+ */
+
+#include <cstring>
+#include <algorithm>
+
+#include "NXHeightFieldDelta.h"
+#include "NXHeightField.h"
+#include "../common/NXCore.h"
+
+NX::HeightFieldDelta::HeightFieldDelta() {
+	Clear();
+}
+
+NX::HeightFieldDelta::~HeightFieldDelta() {
+	/**empty here*/
+}
+
+void NX::HeightFieldDelta::Record(const HeightField &Field, const int r0, const int c0, const int r1, const int c1, const float *pBefore, const int iBeforeStride) {
+	NXAssert(r0 >= 0 && c0 >= 0 && r1 < Field.GetRowCount() && c1 < Field.GetColCount() && r0 <= r1 && c0 <= c1);
+	Clear();
+	m_r0 = r0, m_c0 = c0, m_r1 = r1, m_c1 = c1;
+
+	const int iCols = c1 - c0 + 1;
+	bool bChanged = false;
+	int  iRun = 0;
+	auto Flush = [&]() {
+		while (iRun > 0xffff) {//a run too long for 16 bits continues after an empty run of the other kind
+			m_Runs.push_back(0xffff);
+			m_Runs.push_back(0);
+			iRun -= 0xffff;
+		}
+		m_Runs.push_back((NXUInt16)iRun);
+		iRun = 0;
+	};
+	for (int r = r0; r <= r1; ++r) {
+		const float *pAfter = Field.GetData() + r * Field.GetColCount() + c0, *pOld = pBefore + (r - r0) * iBeforeStride;
+		for (int c = 0; c < iCols; ++c) {
+			NXUInt32 a, b;
+			memcpy(&a, pOld + c, sizeof(a));
+			memcpy(&b, pAfter + c, sizeof(b));
+			if ((a != b) != bChanged) {
+				Flush();
+				bChanged = !bChanged;
+			}
+			if (bChanged) {
+				m_Before.push_back(pOld[c]);
+				m_After.push_back(pAfter[c]);
+			}
+			++iRun;
+		}
+	}
+	Flush();
+
+	if (m_Before.empty()) {
+		Clear();
+	}
+}
+
+void NX::HeightFieldDelta::Undo(HeightField &Field) const {
+	Write(Field, m_Before);
+}
+
+void NX::HeightFieldDelta::Redo(HeightField &Field) const {
+	Write(Field, m_After);
+}
+
+void NX::HeightFieldDelta::Write(HeightField &Field, const std::vector<float> &Values) const {
+	if (IsEmpty()) {
+		return;
+	}
+	const int iCols = m_c1 - m_c0 + 1, iColCount = Field.GetColCount();
+	float *pData = Field.GetData();
+	const float *pValue = &Values[0];
+	int i = 0;
+	for (size_t k = 0; k < m_Runs.size(); ++k) {
+		if (k & 1) {
+			for (int n = m_Runs[k]; n > 0; --n, ++i) {
+				pData[(m_r0 + i / iCols) * iColCount + m_c0 + i % iCols] = *pValue++;
+			}
+		} else {
+			i += m_Runs[k];
+		}
+	}
+}
+
+void NX::HeightFieldDelta::GetRegion(int &r0, int &c0, int &r1, int &c1) const {
+	r0 = m_r0, c0 = m_c0, r1 = m_r1, c1 = m_c1;
+}
+
+bool NX::HeightFieldDelta::IsEmpty() const {
+	return m_Runs.empty();
+}
+
+size_t NX::HeightFieldDelta::GetByteSize() const {
+	return sizeof(*this) + m_Runs.size() * sizeof(NXUInt16) + (m_Before.size() + m_After.size()) * sizeof(float);
+}
+
+void NX::HeightFieldDelta::Clear() {
+	m_r0 = m_c0 = 0;
+	m_r1 = m_c1 = -1;
+	m_Runs.clear();
+	m_Before.clear();
+	m_After.clear();
+}
+
+void NX::HeightFieldDelta::Swap(HeightFieldDelta &rhs) {
+	std::swap(m_r0, rhs.m_r0), std::swap(m_c0, rhs.m_c0);
+	std::swap(m_r1, rhs.m_r1), std::swap(m_c1, rhs.m_c1);
+	m_Runs.swap(rhs.m_Runs);
+	m_Before.swap(rhs.m_Before);
+	m_After.swap(rhs.m_After);
+}
+
+NX::HeightFieldEditHistory::HeightFieldEditHistory(const size_t uMaxBytes) {
+	m_uMaxBytes = uMaxBytes;
+	m_uBytes    = 0;
+}
+
+NX::HeightFieldEditHistory::~HeightFieldEditHistory() {
+	/**empty here*/
+}
+
+void NX::HeightFieldEditHistory::Push(HeightFieldDelta &Delta) {
+	if (Delta.IsEmpty()) {
+		return;
+	}
+	for (size_t i = 0; i < m_Redo.size(); ++i) {
+		m_uBytes -= m_Redo[i].GetByteSize();
+	}
+	m_Redo.clear();
+
+	m_Undo.push_back(HeightFieldDelta());
+	m_Undo.back().Swap(Delta);
+	m_uBytes += m_Undo.back().GetByteSize();
+	while (m_uBytes > m_uMaxBytes && m_Undo.size() > 1) {
+		m_uBytes -= m_Undo.front().GetByteSize();
+		m_Undo.pop_front();
+	}
+}
+
+bool NX::HeightFieldEditHistory::Undo(HeightField &Field, int &r0, int &c0, int &r1, int &c1) {
+	if (m_Undo.empty()) {
+		return false;
+	}
+	m_Redo.push_back(HeightFieldDelta());
+	m_Redo.back().Swap(m_Undo.back());
+	m_Undo.pop_back();
+	m_Redo.back().Undo(Field);
+	m_Redo.back().GetRegion(r0, c0, r1, c1);
+	return true;
+}
+
+bool NX::HeightFieldEditHistory::Redo(HeightField &Field, int &r0, int &c0, int &r1, int &c1) {
+	if (m_Redo.empty()) {
+		return false;
+	}
+	m_Undo.push_back(HeightFieldDelta());
+	m_Undo.back().Swap(m_Redo.back());
+	m_Redo.pop_back();
+	m_Undo.back().Redo(Field);
+	m_Undo.back().GetRegion(r0, c0, r1, c1);
+	return true;
+}
+
+int NX::HeightFieldEditHistory::GetUndoCount() const {
+	return (int)m_Undo.size();
+}
+
+int NX::HeightFieldEditHistory::GetRedoCount() const {
+	return (int)m_Redo.size();
+}
+
+size_t NX::HeightFieldEditHistory::GetByteSize() const {
+	return m_uBytes;
+}
+
+void NX::HeightFieldEditHistory::Clear() {
+	m_Undo.clear();
+	m_Redo.clear();
+	m_uBytes = 0;
+}
@@ -0,0 +1,89 @@
+/*
+ *  File:    NXHeightFieldDelta.h
+ *
+ *  author:  张雄(zhang xiong, 1025679612@qq.com)
+ *  date:    2026_10_19
+ *  purpose: undoable height edits. a delta keeps the before and after value of every changed height in
+ *           the edited rectangle, run-length encoded so the untouched corners of a round brush cost two
+ *           bytes per run. undo and redo write the recorded values back instead of reversing the edit, so
+ *           the round trip is bitwise exact and heights written meanwhile by other means can't turn into
+ *           garbage, they are simply replaced inside the changed cells.
+ */
+
+#pragma once
+
+#include <deque>
+#include <vector>
+
+#include "../common/NXType.h"
+
+namespace NX {
+	class HeightField;
+
+	class HeightFieldDelta {
+	public:
+		HeightFieldDelta();
+		virtual ~HeightFieldDelta();
+
+	public:
+		/**
+		 *  pBefore holds rows [r0, r1] x cols [c0, c1] as they were before the edit (row-major, iBeforeStride
+		 *  floats per row), Field holds them after it
+		 */
+		void   Record(const HeightField &Field, const int r0, const int c0, const int r1, const int c1, const float *pBefore, const int iBeforeStride);
+
+		/**
+		 *  write the before/after values of the changed heights into Field
+		 */
+		void   Undo(HeightField &Field) const;
+		void   Redo(HeightField &Field) const;
+
+		void   GetRegion(int &r0, int &c0, int &r1, int &c1) const;
+		bool   IsEmpty() const;
+		size_t GetByteSize() const;
+		void   Clear();
+		void   Swap(HeightFieldDelta &rhs);
+
+	private:
+		void   Write(HeightField &Field, const std::vector<float> &Values) const;
+
+	private:
+		int                      m_r0, m_c0, m_r1, m_c1;
+		std::vector<NXUInt16>    m_Runs;      // alternating counts of unchanged and changed heights, row-major over the rectangle
+		std::vector<float>       m_Before;    // every changed height before the edit
+		std::vector<float>       m_After;     // and after it
+	};
+
+	class HeightFieldEditHistory {
+	public:
+		/**
+		 *  the oldest deltas are dropped once the recorded ones take more than uMaxBytes
+		 */
+		HeightFieldEditHistory(const size_t uMaxBytes = 32 << 20);
+		virtual ~HeightFieldEditHistory();
+
+	public:
+		/**
+		 *  take over Delta (it is left empty) and forget everything that could be redone
+		 */
+		void   Push(HeightFieldDelta &Delta);
+
+		/**
+		 *  apply the newest delta backwards/forwards, the touched region is returned for the normal and
+		 *  bound refresh, false when there is nothing to undo/redo
+		 */
+		bool   Undo(HeightField &Field, int &r0, int &c0, int &r1, int &c1);
+		bool   Redo(HeightField &Field, int &r0, int &c0, int &r1, int &c1);
+
+		int    GetUndoCount() const;
+		int    GetRedoCount() const;
+		size_t GetByteSize() const;
+		void   Clear();
+
+	private:
+		size_t                           m_uMaxBytes;
+		size_t                           m_uBytes;
+		std::deque<HeightFieldDelta>     m_Undo;
+		std::vector<HeightFieldDelta>    m_Redo;
+	};
+}
@@ -0,0 +1,197 @@
+/*
+ *  File:    NXHeightFieldGenerator.cpp
+ *
+ *  author:  张雄(zhang xiong, 1025679612@qq.com)
+ *  date:    2026_10_19
+ *  purpose: procedural fractal heightfields
+ */
+
+#include <algorithm>
+#include <vector>
+
+#include "NXHeightFieldGenerator.h"
+#include "NXHeightField.h"
+#include "../common/NXCore.h"
+#include "../common/NXParallel.h"
+#include "../math/NXMath.h"
+#include "../math/NXNoise.h"
+
+namespace {
+	/**
+	 *  fractal of the generator's type, scaled and offset to heights. the layers of the domain warp are
+	 *  the noise's fields, the fBm and ridged fractals use its first one
+	 */
+	float Evaluate(const NX::HeightFieldGenerator &Generator, const NX::Noise &noise, const float x, const float y) {
+		float f;
+		switch (Generator.GetType()) {
+		case NX::HeightFieldGenerator::FRACTAL_RIDGED:
+			f = noise.Ridged(NX::Noise::NOISE_GRADIENT, x, y);
+			break;
+		case NX::HeightFieldGenerator::FRACTAL_DOMAIN_WARPED:
+			f = noise.Warp(NX::Noise::NOISE_GRADIENT, x, y, Generator.GetWarpStrength());
+			break;
+		default:
+			f = noise.Fbm(NX::Noise::NOISE_GRADIENT, x, y);
+			break;
+		}
+		return Generator.GetBaseHeight() + Generator.GetAmplitude() * f;
+	}
+
+	void Evaluate(const NX::HeightFieldGenerator &Generator, const NX::Noise &noise, const float *pXs, const float *pYs, float *pOut, const int iCount) {
+		switch (Generator.GetType()) {
+		case NX::HeightFieldGenerator::FRACTAL_RIDGED:
+			noise.Ridged(NX::Noise::NOISE_GRADIENT, pXs, pYs, pOut, iCount);
+			break;
+		case NX::HeightFieldGenerator::FRACTAL_DOMAIN_WARPED:
+			noise.Warp(NX::Noise::NOISE_GRADIENT, pXs, pYs, Generator.GetWarpStrength(), pOut, iCount);
+			break;
+		default:
+			noise.Fbm(NX::Noise::NOISE_GRADIENT, pXs, pYs, pOut, iCount);
+			break;
+		}
+		const float fBaseHeight = Generator.GetBaseHeight(), fAmplitude = Generator.GetAmplitude();
+		for (int i = 0; i < iCount; ++i) {
+			pOut[i] = fBaseHeight + fAmplitude * pOut[i];
+		}
+	}
+}
+
+NX::HeightFieldGenerator::HeightFieldGenerator() {
+	m_eType           = FRACTAL_FBM;
+	m_uSeed           = 0;
+	m_iOctaves        = 6;
+	m_fFrequency      = 0.01f;
+	m_fLacunarity     = 2.f;
+	m_fGain           = 0.5f;
+	m_fAmplitude      = 1.f;
+	m_fBaseHeight     = 0.f;
+	m_fWarpStrength   = 1.f;
+	m_iWorkerCount    = 0;
+}
+
+NX::HeightFieldGenerator::~HeightFieldGenerator() {
+	/**empty here*/
+}
+
+NX::HeightFieldGenerator& NX::HeightFieldGenerator::SetType(const FRACTAL_TYPE eType) {
+	m_eType = eType;
+	return *this;
+}
+
+NX::HeightFieldGenerator& NX::HeightFieldGenerator::SetSeed(const NXUInt32 uSeed) {
+	m_uSeed = uSeed;
+	return *this;
+}
+
+NX::HeightFieldGenerator& NX::HeightFieldGenerator::SetOctaves(const int iOctaves) {
+	m_iOctaves = NXMax(1, NXMin(iOctaves, (int)Noise::MAX_OCTAVES));
+	return *this;
+}
+
+NX::HeightFieldGenerator& NX::HeightFieldGenerator::SetFrequency(const float fFrequency) {
+	m_fFrequency = fFrequency;
+	return *this;
+}
+
+NX::HeightFieldGenerator& NX::HeightFieldGenerator::SetLacunarity(const float fLacunarity) {
+	m_fLacunarity = fLacunarity;
+	return *this;
+}
+
+NX::HeightFieldGenerator& NX::HeightFieldGenerator::SetGain(const float fGain) {
+	m_fGain = fGain;
+	return *this;
+}
+
+NX::HeightFieldGenerator& NX::HeightFieldGenerator::SetAmplitude(const float fAmplitude) {
+	m_fAmplitude = fAmplitude;
+	return *this;
+}
+
+NX::HeightFieldGenerator& NX::HeightFieldGenerator::SetBaseHeight(const float fBaseHeight) {
+	m_fBaseHeight = fBaseHeight;
+	return *this;
+}
+
+NX::HeightFieldGenerator& NX::HeightFieldGenerator::SetWarpStrength(const float fWarpStrength) {
+	m_fWarpStrength = fWarpStrength;
+	return *this;
+}
+
+NX::HeightFieldGenerator& NX::HeightFieldGenerator::SetWorkerCount(const int iWorkerCount) {
+	m_iWorkerCount = iWorkerCount;
+	return *this;
+}
+
+NX::HeightFieldGenerator::FRACTAL_TYPE NX::HeightFieldGenerator::GetType() const {
+	return m_eType;
+}
+
+NXUInt32 NX::HeightFieldGenerator::GetSeed() const {
+	return m_uSeed;
+}
+
+int NX::HeightFieldGenerator::GetOctaves() const {
+	return m_iOctaves;
+}
+
+float NX::HeightFieldGenerator::GetFrequency() const {
+	return m_fFrequency;
+}
+
+float NX::HeightFieldGenerator::GetLacunarity() const {
+	return m_fLacunarity;
+}
+
+float NX::HeightFieldGenerator::GetGain() const {
+	return m_fGain;
+}
+
+float NX::HeightFieldGenerator::GetAmplitude() const {
+	return m_fAmplitude;
+}
+
+float NX::HeightFieldGenerator::GetBaseHeight() const {
+	return m_fBaseHeight;
+}
+
+float NX::HeightFieldGenerator::GetWarpStrength() const {
+	return m_fWarpStrength;
+}
+
+int NX::HeightFieldGenerator::GetWorkerCount() const {
+	return m_iWorkerCount;
+}
+
+void NX::HeightFieldGenerator::Generate(HeightField &Field, const int _r0, const int _c0, const int _r1, const int _c1) const {
+	const int r0 = NXMax(_r0, 0), r1 = NXMin(_r1, Field.GetRowCount() - 1);
+	const int c0 = NXMax(_c0, 0), c1 = NXMin(_c1, Field.GetColCount() - 1);
+	if (r0 > r1 || c0 > c1) {
+		return;
+	}
+
+	const Noise noise = Noise(m_uSeed).SetOctaves(m_iOctaves).SetLacunarity(m_fLacunarity).SetGain(m_fGain);
+	const int   iColCount = Field.GetColCount(), iCols = c1 - c0 + 1;
+	const float fDX = Field.GetDX(), fDZ = Field.GetDZ(), fFrequency = m_fFrequency;
+	std::vector<float> Ys(iCols);
+	for (int c = c0; c <= c1; ++c) {
+		Ys[c - c0] = ((float)c * fDZ) * fFrequency;
+	}
+	float *pData = Field.GetData();
+	NX::ParallelFor(r0, r1 + 1, m_iWorkerCount, [&](int iBegin, int iEnd, int) {
+		std::vector<float> Xs(iCols);
+		for (int r = iBegin; r < iEnd; ++r) {//a row is one batch of the noise, four columns per SSE step
+			std::fill(Xs.begin(), Xs.end(), ((float)r * fDX) * fFrequency);
+			Evaluate(*this, noise, &Xs[0], &Ys[0], pData + r * iColCount + c0, iCols);
+		}
+	});
+}
+
+void NX::HeightFieldGenerator::Generate(HeightField &Field) const {
+	Generate(Field, 0, 0, Field.GetRowCount() - 1, Field.GetColCount() - 1);
+}
+
+float NX::HeightFieldGenerator::Sample(const float x, const float z) const {
+	const Noise noise = Noise(m_uSeed).SetOctaves(m_iOctaves).SetLacunarity(m_fLacunarity).SetGain(m_fGain);
+	return Evaluate(*this, noise, x * m_fFrequency, z * m_fFrequency);
+}
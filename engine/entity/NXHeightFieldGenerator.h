@@ -0,0 +1,86 @@
+/*
+ *  File:    NXHeightFieldGenerator.h
+ *
+ *  author:  张雄(zhang xiong, 1025679612@qq.com)
+ *  date:    2026_10_19
+ *  purpose: seedable fractal heightfields (fBm, ridged multifractal, domain warped fBm) built on the 2D
+ *           gradient noise of NX::Noise, so no permutation table depends on the seed. rows are spread over
+ *           the worker pool and every row is one batch of the noise, four columns per SSE step. the noise
+ *           gives bitwise the same value whatever the batch, every height is the same whatever the
+ *           worker count or region split.
+ */
+
+#pragma once
+
+#include "../common/NXType.h"
+
+namespace NX {
+	class HeightField;
+
+	class HeightFieldGenerator {
+	public:
+		enum FRACTAL_TYPE {
+			FRACTAL_FBM,             // sum of octaves, rolling hills
+			FRACTAL_RIDGED,          // 1 - |noise| squared and weighted by the previous octave, sharp crests
+			FRACTAL_DOMAIN_WARPED,   // fBm sampled at a position displaced by two more fBm fields
+		};
+
+	public:
+		HeightFieldGenerator();
+		virtual ~HeightFieldGenerator();
+
+	public:
+		/**
+		 *  fFrequency: lattice cells per world unit of the first octave
+		 *  fLacunarity/fGain: frequency and amplitude factor from one octave to the next
+		 *  fAmplitude/fBaseHeight: height = fBaseHeight + fAmplitude * fractal, the fractal is about [-1, 1]
+		 *  fWarpStrength: displacement of the domain warp in first octave lattice cells
+		 *  iWorkerCount: <= 0 means every hardware thread
+		 */
+		HeightFieldGenerator& SetType(const FRACTAL_TYPE eType);
+		HeightFieldGenerator& SetSeed(const NXUInt32 uSeed);
+		HeightFieldGenerator& SetOctaves(const int iOctaves);
+		HeightFieldGenerator& SetFrequency(const float fFrequency);
+		HeightFieldGenerator& SetLacunarity(const float fLacunarity);
+		HeightFieldGenerator& SetGain(const float fGain);
+		HeightFieldGenerator& SetAmplitude(const float fAmplitude);
+		HeightFieldGenerator& SetBaseHeight(const float fBaseHeight);
+		HeightFieldGenerator& SetWarpStrength(const float fWarpStrength);
+		HeightFieldGenerator& SetWorkerCount(const int iWorkerCount);
+		FRACTAL_TYPE          GetType() const;
+		NXUInt32              GetSeed() const;
+		int                   GetOctaves() const;
+		float                 GetFrequency() const;
+		float                 GetLacunarity() const;
+		float                 GetGain() const;
+		float                 GetAmplitude() const;
+		float                 GetBaseHeight() const;
+		float                 GetWarpStrength() const;
+		int                   GetWorkerCount() const;
+
+	public:
+		/**
+		 *  write the heights of grid rows [r0, r1] and cols [c0, c1] of Field, grid point (r, c) is sampled
+		 *  at (r * dx, c * dz) so adjacent regions and fields of the same spacing line up
+		 */
+		void  Generate(HeightField &Field, const int r0, const int c0, const int r1, const int c1) const;
+		void  Generate(HeightField &Field) const;
+
+		/**
+		 *  height at world position (x, z), the same value Generate writes at a grid point
+		 */
+		float Sample(const float x, const float z) const;
+
+	private:
+		FRACTAL_TYPE    m_eType;
+		NXUInt32        m_uSeed;
+		int             m_iOctaves;
+		float           m_fFrequency;
+		float           m_fLacunarity;
+		float           m_fGain;
+		float           m_fAmplitude;
+		float           m_fBaseHeight;
+		float           m_fWarpStrength;
+		int             m_iWorkerCount;
+	};
+}
@@ -0,0 +1,161 @@
+/*
+ *  File:    NXHeightFieldNormals.cpp
+ *
+ *  author:  张雄(zhang xiong, 1025679612@qq.com)
+ *  date:    2026_10_19
+ *  purpose: heightfield normal and tangent generation
+ */
+
+#include <cmath>
+#include <vector>
+
+#include "NXHeightFieldNormals.h"
+#include "NXHeightField.h"
+#include "../common/NXCore.h"
+#include "../common/NXParallel.h"
+#include "../math/NXMath.h"
+#include "../math/NXSIMD.h"
+
+namespace {
+	/**
+	 *  gradient (dh/dx, dh/dz) of one grid row, every column of [c0, c1] is written to pGX/pGZ[c - c0]
+	 */
+	void ComputeRowGradient(const NX::HeightField &Field, const int r, const int c0, const int c1, float *pGX, float *pGZ) {
+		const int    iRowCount = Field.GetRowCount(), iColCount = Field.GetColCount();
+		const int    rm = NX::NXMax(r - 1, 0), rp = NX::NXMin(r + 1, iRowCount - 1);
+		const float  fInvX = 1.f / ((rp - rm) * Field.GetDX());
+		const float  fInvZ = 1.f / (2 * Field.GetDZ());
+		const float *pPrev = Field.GetData() + rm * iColCount, *pNext = Field.GetData() + rp * iColCount, *pRow = Field.GetData() + r * iColCount;
+
+		int c = c0;
+		{//border col 0 is one-sided
+			for (; c <= c1 && c < 1; ++c) {
+				pGX[c - c0] = (pNext[c] - pPrev[c]) * fInvX;
+				pGZ[c - c0] = (pRow[c + 1] - pRow[c]) * (1.f / Field.GetDZ());
+			}
+		}
+#if NX_SIMD_SSE
+		{//interior cols, c - 1 and c + 4 stay inside the row
+			const __m128 InvX = _mm_set1_ps(fInvX), InvZ = _mm_set1_ps(fInvZ);
+			const int iLast = NX::NXMin(c1, iColCount - 2);
+			for (; c + 3 <= iLast; c += 4) {
+				_mm_storeu_ps(pGX + c - c0, _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(pNext + c), _mm_loadu_ps(pPrev + c)), InvX));
+				_mm_storeu_ps(pGZ + c - c0, _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(pRow + c + 1), _mm_loadu_ps(pRow + c - 1)), InvZ));
+			}
+		}
+#endif
+		for (; c <= c1; ++c) {
+			pGX[c - c0] = (pNext[c] - pPrev[c]) * fInvX;
+			if (c == iColCount - 1) {
+				pGZ[c - c0] = (pRow[c] - pRow[c - 1]) * (1.f / Field.GetDZ());
+			} else {
+				pGZ[c - c0] = (pRow[c + 1] - pRow[c - 1]) * fInvZ;
+			}
+		}
+	}
+
+	void ComputeRow(const NX::HeightField &Field, const int r, const int c0, const int c1, float *pGX, float *pGZ, NX::float3 *pNormals, NX::float3 *pTangents) {
+		ComputeRowGradient(Field, r, c0, c1, pGX, pGZ);
+		const int iCount = c1 - c0 + 1;
+		int i = 0;
+#if NX_SIMD_SSE
+		const __m128 One = _mm_set1_ps(1.f);
+		for (; i + 4 <= iCount; i += 4) {//normal (-gx, 1, -gz) and tangent (1, gx, 0), normalized
+			const __m128 gx = _mm_loadu_ps(pGX + i), gz = _mm_loadu_ps(pGZ + i);
+			const __m128 gx2 = _mm_mul_ps(gx, gx);
+			const __m128 InvN = _mm_div_ps(One, _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(gx2, _mm_mul_ps(gz, gz)), One)));
+			NX_ALIGN(16) float NormalX[4], NormalY[4], NormalZ[4];
+			_mm_store_ps(NormalX, _mm_mul_ps(_mm_sub_ps(_mm_setzero_ps(), gx), InvN));
+			_mm_store_ps(NormalY, InvN);
+			_mm_store_ps(NormalZ, _mm_mul_ps(_mm_sub_ps(_mm_setzero_ps(), gz), InvN));
+			for (int k = 0; k < 4; ++k) {
+				pNormals[i + k].x = NormalX[k], pNormals[i + k].y = NormalY[k], pNormals[i + k].z = NormalZ[k];
+			}
+			if (pTangents) {
+				const __m128 InvT = _mm_div_ps(One, _mm_sqrt_ps(_mm_add_ps(gx2, One)));
+				NX_ALIGN(16) float TangentX[4], TangentY[4];
+				_mm_store_ps(TangentX, InvT);
+				_mm_store_ps(TangentY, _mm_mul_ps(gx, InvT));
+				for (int k = 0; k < 4; ++k) {
+					pTangents[i + k].x = TangentX[k], pTangents[i + k].y = TangentY[k], pTangents[i + k].z = 0.f;
+				}
+			}
+		}
+#endif
+		for (; i < iCount; ++i) {
+			const float gx = pGX[i], gz = pGZ[i], gx2 = gx * gx;
+			const float fInvN = 1.f / std::sqrt((gx2 + gz * gz) + 1.f);
+			pNormals[i].x = (0.f - gx) * fInvN, pNormals[i].y = fInvN, pNormals[i].z = (0.f - gz) * fInvN;
+			if (pTangents) {
+				const float fInvT = 1.f / std::sqrt(gx2 + 1.f);
+				pTangents[i].x = fInvT, pTangents[i].y = gx * fInvT, pTangents[i].z = 0.f;
+			}
+		}
+	}
+
+	void ComputeRowEncoded(const NX::HeightField &Field, const int r, const int c0, const int c1, float *pGX, float *pGZ, NXUInt16 *pNormals) {
+		//normals of a heightfield always point up, so the octahedral code needs no fold: (x, z) / (|x| + y + |z|)
+		ComputeRowGradient(Field, r, c0, c1, pGX, pGZ);
+		const int iCount = c1 - c0 + 1;
+		int i = 0;
+#if NX_SIMD_SSE
+		const __m128 One = _mm_set1_ps(1.f), Scale = _mm_set1_ps(127.f), Bias = _mm_set1_ps(127.5f);
+		for (; i + 4 <= iCount; i += 4) {
+			const __m128 gx = _mm_loadu_ps(pGX + i), gz = _mm_loadu_ps(pGZ + i);
+			const __m128 InvS = _mm_div_ps(One, _mm_add_ps(_mm_add_ps(NX::SIMDAbs(gx), NX::SIMDAbs(gz)), One));
+			const __m128i qu = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(_mm_mul_ps(_mm_sub_ps(_mm_setzero_ps(), gx), InvS), Scale), Bias));
+			const __m128i qw = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(_mm_mul_ps(_mm_sub_ps(_mm_setzero_ps(), gz), InvS), Scale), Bias));
+			NX_ALIGN(16) int Codes[4];
+			_mm_store_si128((__m128i*)Codes, _mm_or_si128(qu, _mm_slli_epi32(qw, 8)));
+			for (int k = 0; k < 4; ++k) {
+				pNormals[i + k] = (NXUInt16)Codes[k];
+			}
+		}
+#endif
+		for (; i < iCount; ++i) {
+			const float fInvS = 1.f / ((NX::NXAbs(pGX[i]) + NX::NXAbs(pGZ[i])) + 1.f);
+			const int qu = (int)(((0.f - pGX[i]) * fInvS) * 127.f + 127.5f);
+			const int qw = (int)(((0.f - pGZ[i]) * fInvS) * 127.f + 127.5f);
+			pNormals[i] = (NXUInt16)(qu | (qw << 8));
+		}
+	}
+
+	template<typename Kernel>
+	void ForEachRow(const NX::HeightField &Field, const int _r0, const int _c0, const int _r1, const int _c1, const int iPartCount, const Kernel &Run) {
+		const int r0 = NX::NXMax(_r0, 0), r1 = NX::NXMin(_r1, Field.GetRowCount() - 1);
+		const int c0 = NX::NXMax(_c0, 0), c1 = NX::NXMin(_c1, Field.GetColCount() - 1);
+		if (r0 > r1 || c0 > c1) {
+			return;
+		}
+		NX::ParallelFor(r0, r1 + 1, iPartCount, [&](int iBegin, int iEnd, int) {
+			std::vector<float> Gradient(2 * (c1 - c0 + 1));
+			for (int r = iBegin; r < iEnd; ++r) {
+				Run(r, c0, c1, &Gradient[0], &Gradient[c1 - c0 + 1]);
+			}
+		});
+	}
+}
+
+void NX::HeightFieldNormals::Compute(const HeightField &Field, const int r0, const int c0, const int r1, const int c1, float3 *pNormals, float3 *pTangents, const int iPartCount) {
+	NXAssert(pNormals != nullptr);
+	const int iColCount = Field.GetColCount();
+	ForEachRow(Field, r0, c0, r1, c1, iPartCount, [&](int r, int cb, int ce, float *pGX, float *pGZ) {
+		ComputeRow(Field, r, cb, ce, pGX, pGZ, pNormals + r * iColCount + cb, pTangents ? pTangents + r * iColCount + cb : nullptr);
+	});
+}
+
+void NX::HeightFieldNormals::ComputeEncoded(const HeightField &Field, const int r0, const int c0, const int r1, const int c1, NXUInt16 *pNormals, const int iPartCount) {
+	NXAssert(pNormals != nullptr);
+	const int iColCount = Field.GetColCount();
+	ForEachRow(Field, r0, c0, r1, c1, iPartCount, [&](int r, int cb, int ce, float *pGX, float *pGZ) {
+		ComputeRowEncoded(Field, r, cb, ce, pGX, pGZ, pNormals + r * iColCount + cb);
+	});
+}
+
+void NX::HeightFieldNormals::Compute(const HeightField &Field, float3 *pNormals, float3 *pTangents, const int iPartCount) {
+	Compute(Field, 0, 0, Field.GetRowCount() - 1, Field.GetColCount() - 1, pNormals, pTangents, iPartCount);
+}
+
+void NX::HeightFieldNormals::ComputeEncoded(const HeightField &Field, NXUInt16 *pNormals, const int iPartCount) {
+	ComputeEncoded(Field, 0, 0, Field.GetRowCount() - 1, Field.GetColCount() - 1, pNormals, iPartCount);
+}
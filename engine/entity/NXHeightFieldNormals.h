@@ -0,0 +1,39 @@
+/*
+ *  File:    NXHeightFieldNormals.h
+ *
+ *  author:  张雄(zhang xiong, 1025679612@qq.com)
+ *  date:    2026_10_19
+ *  purpose: surface normals and tangents of a HeightField from central differences (one-sided on the border).
+ *           rows are spread over the worker pool, columns go through SSE four at a time, results don't
+ *           depend on the number of parts.
+ */
+
+#pragma once
+
+#include "../math/NXVector.h"
+#include "../common/NXType.h"
+
+namespace NX {
+	class HeightField;
+
+	class HeightFieldNormals {
+	public:
+		/**
+		 *  normals and +x tangents of grid rows [r0, r1] and cols [c0, c1], both arrays are row-major
+		 *  with the field's col count and only the region is written. pTangents may be nullptr.
+		 *  iPartCount <= 0 uses every hardware thread.
+		 */
+		static void Compute(const HeightField &Field, const int r0, const int c0, const int r1, const int c1, float3 *pNormals, float3 *pTangents, const int iPartCount = 0);
+
+		/**
+		 *  same region rules as Compute, writes EncodeOctahedral16 codes of the normals
+		 */
+		static void ComputeEncoded(const HeightField &Field, const int r0, const int c0, const int r1, const int c1, NXUInt16 *pNormals, const int iPartCount = 0);
+
+		/**
+		 *  whole field versions
+		 */
+		static void Compute(const HeightField &Field, float3 *pNormals, float3 *pTangents, const int iPartCount = 0);
+		static void ComputeEncoded(const HeightField &Field, NXUInt16 *pNormals, const int iPartCount = 0);
+	};
+}
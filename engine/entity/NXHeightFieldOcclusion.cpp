@@ -0,0 +1,326 @@
+/*
+ *  File:    NXHeightFieldOcclusion.cpp
+ *
+ *  author:  张雄(zhang xiong, 1025679612@qq.com)
+ *  date:    2026_10_19
+ *  purpose: horizon based ambient occlusion baking
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "NXHeightFieldOcclusion.h"
+#include "NXHeightField.h"
+#include "../common/NXCore.h"
+#include "../common/NXLog.h"
+#include "../common/NXParallel.h"
+#include "../math/NXMath.h"
+
+namespace {
+	const float    PI              = 3.14159265358979f;
+	const NXUInt32 VISIBILITY_ONE  = 0xffff;   // fixed point scale of the per direction visibility, integer sums keep the bake independent of the worker count
+
+	/**
+	 *  a sweep direction expressed on the grid: lines advance one vertex along the major axis per step and
+	 *  fSlope vertices along the minor axis
+	 */
+	struct SweepAxis {
+		bool    bRowMajor;
+		int     iMajorCount, iMinorCount;
+		int     iMajorStride, iMinorStride;
+		int     iMajorStart, iMajorStep;
+		float   fSlope;
+		float   fStepLength;       // world distance of one step
+	};
+
+	SweepAxis GetSweepAxis(const NX::HeightField &Field, const float fAngle) {
+		const float cx = std::cos(fAngle), cz = std::sin(fAngle);
+		const bool  bRowMajor = NX::NXAbs(cx) >= NX::NXAbs(cz);
+		const float a = bRowMajor ? cx : cz, b = bRowMajor ? cz : cx;
+		const float fMajorSpacing = bRowMajor ? Field.GetDX() : Field.GetDZ(), fMinorSpacing = bRowMajor ? Field.GetDZ() : Field.GetDX();
+		SweepAxis axis;
+		axis.bRowMajor    = bRowMajor;
+		axis.iMajorCount  = bRowMajor ? Field.GetRowCount() : Field.GetColCount();
+		axis.iMinorCount  = bRowMajor ? Field.GetColCount() : Field.GetRowCount();
+		axis.iMajorStride = bRowMajor ? Field.GetColCount() : 1;
+		axis.iMinorStride = bRowMajor ? 1 : Field.GetColCount();
+		axis.iMajorStep   = a > 0.f ? 1 : -1;
+		axis.iMajorStart  = a > 0.f ? 0 : axis.iMajorCount - 1;
+		axis.fSlope       = b / NX::NXAbs(a) * fMajorSpacing / fMinorSpacing;
+		axis.fStepLength  = fMajorSpacing / NX::NXAbs(a);
+		return axis;
+	}
+
+	NXUInt64 HashWords(NXUInt64 uHash, const void *pData, const size_t uWordCount) {
+		const NXUInt32 *pWords = (const NXUInt32*)pData;
+		for (size_t i = 0; i < uWordCount; ++i) {
+			uHash = (uHash ^ pWords[i]) * 0x100000001B3ull;
+		}
+		return uHash;
+	}
+}
+
+NX::HeightFieldOcclusion::HeightFieldOcclusion() {
+	m_iDirectionCount = 8;
+	m_iWorkerCount    = 0;
+	m_iEditRadius     = 32;
+}
+
+NX::HeightFieldOcclusion::~HeightFieldOcclusion() {
+	/**empty here*/
+}
+
+NX::HeightFieldOcclusion& NX::HeightFieldOcclusion::SetDirectionCount(const int iDirectionCount) {
+	m_iDirectionCount = NXMax(1, NXMin(iDirectionCount, (int)MAX_DIRECTION_COUNT));
+	return *this;
+}
+
+NX::HeightFieldOcclusion& NX::HeightFieldOcclusion::SetWorkerCount(const int iWorkerCount) {
+	m_iWorkerCount = iWorkerCount;
+	return *this;
+}
+
+NX::HeightFieldOcclusion& NX::HeightFieldOcclusion::SetEditRadius(const int iEditRadius) {
+	m_iEditRadius = NXMax(0, iEditRadius);
+	return *this;
+}
+
+int NX::HeightFieldOcclusion::GetDirectionCount() const {
+	return m_iDirectionCount;
+}
+
+int NX::HeightFieldOcclusion::GetWorkerCount() const {
+	return m_iWorkerCount;
+}
+
+int NX::HeightFieldOcclusion::GetEditRadius() const {
+	return m_iEditRadius;
+}
+
+void NX::HeightFieldOcclusion::Bake(const HeightField &Field, NXUInt8 *pOut) const {
+	BakeRegion(Field, 0, 0, Field.GetRowCount() - 1, Field.GetColCount() - 1, pOut);
+}
+
+void NX::HeightFieldOcclusion::BakeRegion(const HeightField &Field, const int _r0, const int _c0, const int _r1, const int _c1, NXUInt8 *pOut) const {
+	const int r0 = NXMax(_r0, 0), r1 = NXMin(_r1, Field.GetRowCount() - 1);
+	const int c0 = NXMax(_c0, 0), c1 = NXMin(_c1, Field.GetColCount() - 1);
+	if (r0 > r1 || c0 > c1) {
+		return;
+	}
+	const int    iRegionCols = c1 - c0 + 1;
+	const float  *pHeights   = Field.GetData();
+	const int    iPartCount  = m_iWorkerCount > 0 ? m_iWorkerCount : GetHardwareThreadCount();
+	std::vector<NXUInt32> Visibility((r1 - r0 + 1) * iRegionCols, 0);
+
+	for (int d = 0; d < m_iDirectionCount; ++d) {
+		const SweepAxis axis  = GetSweepAxis(Field, 2.f * PI * d / m_iDirectionCount);
+
+		//the region in sweep terms: steps [iStepBegin, iStepEnd] along the major axis, vertices [m0, m1] across it
+		const int g0 = axis.bRowMajor ? r0 : c0, g1 = axis.bRowMajor ? r1 : c1;
+		const int m0 = axis.bRowMajor ? c0 : r0, m1 = axis.bRowMajor ? c1 : r1;
+		const int iStepBegin = NXMin((g0 - axis.iMajorStart) * axis.iMajorStep, (g1 - axis.iMajorStart) * axis.iMajorStep);
+		const int iStepEnd   = NXMax((g0 - axis.iMajorStart) * axis.iMajorStep, (g1 - axis.iMajorStart) * axis.iMajorStep);
+		const int iRegionMajorStride = axis.bRowMajor ? iRegionCols : 1, iRegionMinorStride = axis.bRowMajor ? 1 : iRegionCols;
+
+		//line o passes (step i, minor o + fSlope * i), only lines that reach [m0 - 1, m1] inside the region's steps
+		//write to it. every line still starts at the border, the horizon comes from everything it passed.
+		const float fSpan      = axis.fSlope * (axis.iMajorCount - 1);
+		const int   iFloorA    = (int)std::floor(axis.fSlope * iStepBegin), iFloorB = (int)std::floor(axis.fSlope * iStepEnd);
+		const int   iFirstLine = NXMax((int)std::floor(-1.f - NXMax(fSpan, 0.f)), m0 - 1 - NXMax(iFloorA, iFloorB));
+		const int   iLastLine  = NXMin((int)std::ceil(axis.iMinorCount - NXMin(fSpan, 0.f)), m1 - NXMin(iFloorA, iFloorB));
+		const int   iLineCount = iLastLine - iFirstLine + 1;
+		if (iLineCount <= 0) {
+			continue;
+		}
+
+		//neighbouring lines share the vertices between them, so lines are cut into bands and every other band
+		//runs at a time
+		const int iBandCount = NXMin(2 * iPartCount, iLineCount);
+		auto SweepBand = [&](const int iBand) {
+			int iBegin, iEnd;
+			GetParallelRange(iFirstLine, iLastLine + 1, iBandCount, iBand, 1, iBegin, iEnd);
+			std::vector<float> HullS(axis.iMajorCount), HullH(axis.iMajorCount);
+			for (int o = iBegin; o < iEnd; ++o) {
+				int iHullSize = 0;
+				for (int i = 0; i <= iStepEnd; ++i) {
+					const float fOffset = axis.fSlope * i, fFloor = std::floor(fOffset);
+					const int   k0 = o + (int)fFloor;
+					const float t  = fOffset - fFloor;
+					if (k0 < -1 || k0 >= axis.iMinorCount || (k0 == -1 && t == 0.f)) {
+						continue;
+					}
+
+					const int   g  = axis.iMajorStart + i * axis.iMajorStep;
+					const float *pMajor = pHeights + g * axis.iMajorStride;
+					const float h0 = pMajor[NXMax(k0, 0) * axis.iMinorStride], h1 = pMajor[NXMin(k0 + 1, axis.iMinorCount - 1) * axis.iMinorStride];
+					const float s  = i * axis.fStepLength, h = h0 + (h1 - h0) * t;
+
+					{//drop hull points the new sample sees below the line to the point before them, the top is the horizon
+						while (iHullSize >= 2 && (HullH[iHullSize - 1] - h) * (s - HullS[iHullSize - 2]) <= (HullH[iHullSize - 2] - h) * (s - HullS[iHullSize - 1])) {
+							--iHullSize;
+						}
+					}
+					float fVisibility = 1.f;
+					if (iHullSize > 0 && HullH[iHullSize - 1] > h) {
+						const float dh = HullH[iHullSize - 1] - h, ds = s - HullS[iHullSize - 1];
+						fVisibility = 1.f - dh / std::sqrt(ds * ds + dh * dh);
+					}
+					HullS[iHullSize] = s, HullH[iHullSize] = h, ++iHullSize;
+
+					if (i < iStepBegin) {
+						continue;
+					}
+					NXUInt32 *pTarget = &Visibility[(g - g0) * iRegionMajorStride];
+					if (k0 >= m0 && k0 <= m1) {
+						pTarget[(k0 - m0) * iRegionMinorStride] += (NXUInt32)((1.f - t) * fVisibility * VISIBILITY_ONE + 0.5f);
+					}
+					if (k0 + 1 >= m0 && k0 + 1 <= m1 && t > 0.f) {
+						pTarget[(k0 + 1 - m0) * iRegionMinorStride] += (NXUInt32)(t * fVisibility * VISIBILITY_ONE + 0.5f);
+					}
+				}
+			}
+		};
+		for (int iPhase = 0; iPhase < 2; ++iPhase) {
+			const int iPhaseBands = (iBandCount - iPhase + 1) / 2;
+			if (iPhaseBands == 0) {
+				continue;
+			}
+			ParallelFor(0, iPhaseBands, NXMin(iPartCount, iPhaseBands), [&](int iBegin, int iEnd, int) {
+				for (int b = iBegin; b < iEnd; ++b) {
+					SweepBand(2 * b + iPhase);
+				}
+			});
+		}
+	}
+
+	const NXUInt64 uFull = (NXUInt64)m_iDirectionCount * VISIBILITY_ONE;
+	for (int r = r0; r <= r1; ++r) {
+		const NXUInt32 *pVisibility = &Visibility[(r - r0) * iRegionCols];
+		NXUInt8        *pRow        = pOut + r * Field.GetColCount();
+		for (int c = c0; c <= c1; ++c) {
+			pRow[c] = (NXUInt8)NXMin((NXUInt64)255, (pVisibility[c - c0] * 255ull + uFull / 2) / uFull);
+		}
+	}
+}
+
+void NX::HeightFieldOcclusion::BakeBruteForce(const HeightField &Field, NXUInt8 *pOut) const {
+	const int   iRowCount = Field.GetRowCount(), iColCount = Field.GetColCount();
+	const float dx = Field.GetDX(), dz = Field.GetDZ(), fEpsilon = 1e-3f * NXMin(dx, dz);
+	ParallelFor(0, iRowCount, m_iWorkerCount, [&](int iBegin, int iEnd, int) {
+		for (int r = iBegin; r < iEnd; ++r) {
+			for (int c = 0; c < iColCount; ++c) {
+				const float h = Field.GetHeight(r, c);
+				float fVisibility = 0.f;
+				for (int d = 0; d < m_iDirectionCount; ++d) {//march back against the sweep direction with the sweep's step length
+					const float fAngle = 2.f * PI * d / m_iDirectionCount;
+					const float cx = std::cos(fAngle), cz = std::sin(fAngle);
+					const float fStep = NXAbs(cx) >= NXAbs(cz) ? dx / NXAbs(cx) : dz / NXAbs(cz);
+					float fMaxSin = 0.f;
+					for (int i = 1; ; ++i) {
+						const float x = r * dx - cx * fStep * i, z = c * dz - cz * fStep * i;
+						if (x < -fEpsilon || z < -fEpsilon || x > Field.GetMaxX() + fEpsilon || z > Field.GetMaxZ() + fEpsilon) {
+							break;
+						}
+						const float dh = Field.GetHeight(x, z) - h, ds = fStep * i;
+						if (dh > 0.f) {
+							fMaxSin = NXMax(fMaxSin, dh / std::sqrt(ds * ds + dh * dh));
+						}
+					}
+					fVisibility += 1.f - fMaxSin;
+				}
+				pOut[r * iColCount + c] = (NXUInt8)(fVisibility / m_iDirectionCount * 255.f + 0.5f);
+			}
+		}
+	});
+}
+
+bool NX::HeightFieldOcclusion::BakeCached(const HeightField &Field, const std::string &strCacheDirectory, NXUInt8 *pOut) const {
+	//hashing the heights is the expensive part of a cache hit, do it once
+	const NXUInt64    uKey        = GetCacheKey(Field);
+	const std::string strFilePath = GetCacheFilePath(uKey, strCacheDirectory);
+	if (Load(strFilePath, Field, uKey, pOut)) {
+		return true;
+	}
+	Bake(Field, pOut);
+	Save(strFilePath, Field, uKey, pOut);
+	return false;
+}
+
+NXUInt64 NX::HeightFieldOcclusion::GetCacheKey(const HeightField &Field) const {
+	const struct {
+		NXInt32 iRowCount, iColCount, iDirectionCount, iVersion;
+		float   fDX, fDZ;
+	} Shape = { Field.GetRowCount(), Field.GetColCount(), m_iDirectionCount, VERSION, Field.GetDX(), Field.GetDZ() };
+	const NXUInt64 uHash = HashWords(0xCBF29CE484222325ull, &Shape, sizeof(Shape) / sizeof(NXUInt32));
+	return HashWords(uHash, Field.GetData(), (size_t)Field.GetRowCount() * Field.GetColCount());
+}
+
+std::string NX::HeightFieldOcclusion::GetCacheFilePath(const HeightField &Field, const std::string &strCacheDirectory) const {
+	return GetCacheFilePath(GetCacheKey(Field), strCacheDirectory);
+}
+
+bool NX::HeightFieldOcclusion::Load(const std::string &strFilePath, const HeightField &Field, NXUInt8 *pOut) const {
+	return Load(strFilePath, Field, GetCacheKey(Field), pOut);
+}
+
+bool NX::HeightFieldOcclusion::Save(const std::string &strFilePath, const HeightField &Field, const NXUInt8 *pOcclusion) const {
+	return Save(strFilePath, Field, GetCacheKey(Field), pOcclusion);
+}
+
+std::string NX::HeightFieldOcclusion::GetCacheFilePath(const NXUInt64 uKey, const std::string &strCacheDirectory) const {
+	char szName[32];
+	sprintf(szName, "%016llx.nxao", (unsigned long long)uKey);
+	if (strCacheDirectory.empty()) {
+		return szName;
+	}
+	const char cLast = strCacheDirectory[strCacheDirectory.size() - 1];
+	return strCacheDirectory + (cLast == '/' || cLast == '\\' ? "" : "/") + szName;
+}
+
+bool NX::HeightFieldOcclusion::Load(const std::string &strFilePath, const HeightField &Field, const NXUInt64 uKey, NXUInt8 *pOut) const {
+	FILE *pFile = fopen(strFilePath.c_str(), "rb");
+	if (!pFile) {
+		return false;
+	}
+	bool bSuccess = false;
+	do {
+		Header header;
+		if (fread(&header, sizeof(header), 1, pFile) != 1) {
+			break;
+		}
+		if (header.uMagic != MAGIC || header.uVersion != VERSION || header.iRowCount != Field.GetRowCount() || header.iColCount != Field.GetColCount() || header.iDirectionCount != m_iDirectionCount) {
+			break;
+		}
+		if (header.uKey != uKey) {
+			break;
+		}
+		bSuccess = fread(pOut, (size_t)header.iRowCount * header.iColCount, 1, pFile) == 1;
+	} while (false);
+	fclose(pFile);
+	return bSuccess;
+}
+
+bool NX::HeightFieldOcclusion::Save(const std::string &strFilePath, const HeightField &Field, const NXUInt64 uKey, const NXUInt8 *pOcclusion) const {
+	Header header;
+	NXClearStruct(header);
+	header.uMagic          = MAGIC;
+	header.uVersion        = VERSION;
+	header.iRowCount       = Field.GetRowCount();
+	header.iColCount       = Field.GetColCount();
+	header.iDirectionCount = m_iDirectionCount;
+	header.uKey            = uKey;
+
+	FILE *pFile = fopen(strFilePath.c_str(), "wb");
+	if (!pFile) {
+		glb_GetLog().logToConsole("Create occlusion cache %s failed", strFilePath.c_str());
+		return false;
+	}
+	const bool bSuccess = fwrite(&header, sizeof(header), 1, pFile) == 1 && fwrite(pOcclusion, (size_t)header.iRowCount * header.iColCount, 1, pFile) == 1;
+	fclose(pFile);
+	if (!bSuccess) {
+		glb_GetLog().logToConsole("Write occlusion cache %s failed", strFilePath.c_str());
+	}
+	return bSuccess;
+}
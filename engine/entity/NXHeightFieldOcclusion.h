@@ -0,0 +1,104 @@
+/*
+ *  File:    NXHeightFieldOcclusion.h
+ *
+ *  author:  张雄(zhang xiong, 1025679612@qq.com)
+ *  date:    2026_10_19
+ *  purpose: horizon based ambient occlusion of a HeightField baked on the CPU. for every direction the grid
+ *           is swept by parallel lines one cell apart, each line keeps the upper convex hull of the samples
+ *           it has passed so the horizon of the next sample is found in amortized O(1), that makes a bake
+ *           O(vertices * directions) instead of marching a ray from every vertex. a vertex takes the linear
+ *           blend of the two line samples beside it. visibility per direction is 1 - sin(horizon angle),
+ *           the average over the directions is stored as one byte per vertex, 255 means unoccluded.
+ */
+
+#pragma once
+
+#include <string>
+
+#include "../common/NXType.h"
+
+namespace NX {
+	class HeightField;
+
+	class HeightFieldOcclusion {
+	public:
+		enum {
+			MAGIC                = 0x4F41584E,   // "NXAO"
+			VERSION              = 1,
+			MAX_DIRECTION_COUNT  = 64,
+		};
+
+		struct Header {
+			NXUInt32    uMagic;
+			NXUInt32    uVersion;
+			NXInt32     iRowCount;
+			NXInt32     iColCount;
+			NXInt32     iDirectionCount;
+			NXUInt32    uReserved;
+			NXUInt64    uKey;                // GetCacheKey of the baked field
+		};
+
+	public:
+		HeightFieldOcclusion();
+		virtual ~HeightFieldOcclusion();
+
+	public:
+		/**
+		 *  iDirectionCount: horizon directions evenly spread over the circle, in [1, MAX_DIRECTION_COUNT]
+		 *  iWorkerCount: <= 0 means every hardware thread, the result doesn't depend on it
+		 */
+		HeightFieldOcclusion& SetDirectionCount(const int iDirectionCount);
+		HeightFieldOcclusion& SetWorkerCount(const int iWorkerCount);
+		/**
+		 *  cells around an edited region that Terrain bakes again after the edit, occlusion farther out keeps
+		 *  its old bytes until the next full bake
+		 */
+		HeightFieldOcclusion& SetEditRadius(const int iEditRadius);
+		int                   GetDirectionCount() const;
+		int                   GetWorkerCount() const;
+		int                   GetEditRadius() const;
+
+	public:
+		/**
+		 *  pOut receives one byte per grid vertex, row-major
+		 */
+		void  Bake(const HeightField &Field, NXUInt8 *pOut) const;
+
+		/**
+		 *  bake only rows [r0, r1] and cols [c0, c1] into the full size pOut, the bytes equal a whole Bake's there.
+		 *  lines crossing the region are still swept from the border, so the cost is the region's width times the
+		 *  field's length rather than the region's area.
+		 */
+		void  BakeRegion(const HeightField &Field, const int r0, const int c0, const int r1, const int c1, NXUInt8 *pOut) const;
+
+		/**
+		 *  reference bake marching from every vertex, for validation and benchmarks
+		 */
+		void  BakeBruteForce(const HeightField &Field, NXUInt8 *pOut) const;
+
+		/**
+		 *  load the bake of Field from strCacheDirectory, or bake and store it there. true when the cache
+		 *  answered. the file is named after GetCacheKey, an unwritable directory only costs the store.
+		 */
+		bool  BakeCached(const HeightField &Field, const std::string &strCacheDirectory, NXUInt8 *pOut) const;
+
+	public:
+		/**
+		 *  64 bit FNV-1a of the field's size, spacing, heights and the direction count
+		 */
+		NXUInt64    GetCacheKey(const HeightField &Field) const;
+		std::string GetCacheFilePath(const HeightField &Field, const std::string &strCacheDirectory) const;
+		bool        Load(const std::string &strFilePath, const HeightField &Field, NXUInt8 *pOut) const;
+		bool        Save(const std::string &strFilePath, const HeightField &Field, const NXUInt8 *pOcclusion) const;
+
+	private:
+		std::string GetCacheFilePath(const NXUInt64 uKey, const std::string &strCacheDirectory) const;
+		bool        Load(const std::string &strFilePath, const HeightField &Field, const NXUInt64 uKey, NXUInt8 *pOut) const;
+		bool        Save(const std::string &strFilePath, const HeightField &Field, const NXUInt64 uKey, const NXUInt8 *pOcclusion) const;
+
+	private:
+		int         m_iDirectionCount;
+		int         m_iWorkerCount;
+		int         m_iEditRadius;
+	};
+}
@@ -0,0 +1,262 @@
+/*
+ *  File:    NXHeightFieldRaycast.cpp
+ *
+ *  author:  张雄(zhang xiong, 1025679612@qq.com)
+ *  date:    2026_10_19
+ *  purpose: hierarchical DDA ray queries against a heightfield
+ */
+
+#include <cmath>
+#include <cfloat>
+#include <vector>
+
+#include "NXHeightFieldRaycast.h"
+#include "NXHeightField.h"
+#include "NXTerrainQuadTree.h"
+#include "../common/NXCore.h"
+#include "../common/NXParallel.h"
+#include "../math/NXAlgorithm.h"
+#include "../math/NXMath.h"
+
+namespace {
+	const float BARYCENTRIC_EPSILON = 1e-6f;   // widens triangles so rays through a shared edge don't slip between them
+	const float VISIBILITY_EPSILON  = 1e-4f;   // part of a sight line left out at each end, so end points on the surface see each other
+
+	/**
+	 *  clip [t0, t1] to the part of the ray inside Box, false when nothing is left
+	 */
+	bool ClipToBox(const NX::float3 &Origin, const NX::float3 &Direction, const NX::AABB &Box, float &t0, float &t1) {
+		const float *pOrigin = &Origin.x, *pDirection = &Direction.x, *pMin = &Box.m_vMinPoint.x, *pMax = &Box.m_vMaxPoint.x;
+		for (int i = 0; i < 3; ++i) {
+			if (pDirection[i] == 0.f) {
+				if (pOrigin[i] < pMin[i] || pOrigin[i] > pMax[i]) {
+					return false;
+				}
+				continue;
+			}
+			const float fInv = 1.f / pDirection[i];
+			float ta = (pMin[i] - pOrigin[i]) * fInv, tb = (pMax[i] - pOrigin[i]) * fInv;
+			if (ta > tb) {
+				std::swap(ta, tb);
+			}
+			t0 = NX::NXMax(t0, ta);
+			t1 = NX::NXMin(t1, tb);
+			if (t0 > t1) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	/**
+	 *  double sided Moller-Trumbore, t of the hit or -1
+	 */
+	float IntersectTriangle(const NX::float3 &Origin, const NX::float3 &Direction, const NX::float3 &A, const NX::float3 &B, const NX::float3 &C) {
+		const NX::float3 e1 = B - A, e2 = C - A;
+		const NX::float3 p  = NX::Cross(Direction, e2);
+		const float fDet = NX::Dot(e1, p);
+		if (fDet == 0.f) {
+			return -1.f;
+		}
+		const float fInvDet = 1.f / fDet;
+		const NX::float3 s = Origin - A;
+		const float u = NX::Dot(s, p) * fInvDet;
+		if (u < -BARYCENTRIC_EPSILON || u > 1.f + BARYCENTRIC_EPSILON) {
+			return -1.f;
+		}
+		const NX::float3 q = NX::Cross(s, e1);
+		const float v = NX::Dot(Direction, q) * fInvDet;
+		if (v < -BARYCENTRIC_EPSILON || u + v > 1.f + BARYCENTRIC_EPSILON) {
+			return -1.f;
+		}
+		return NX::Dot(e2, q) * fInvDet;
+	}
+
+	void AddStatistics(NX::HeightFieldRaycast::Statistics *pTotal, const NX::HeightFieldRaycast::Statistics &Part) {
+		if (pTotal) {
+			pTotal->iNodeVisits    += Part.iNodeVisits;
+			pTotal->iCellVisits    += Part.iCellVisits;
+			pTotal->iTriangleTests += Part.iTriangleTests;
+		}
+	}
+}
+
+NX::HeightFieldRaycast::HeightFieldRaycast(const HeightField &Field, const TerrainQuadTree &Tree): m_Field(Field), m_Tree(Tree) {
+	/**empty here*/
+}
+
+NX::HeightFieldRaycast::~HeightFieldRaycast() {
+	/**empty here*/
+}
+
+bool NX::HeightFieldRaycast::Intersect(const float3 &Origin, const float3 &Direction, const float fMaxT, Hit &result, Statistics *pStatistics) const {
+	Statistics statistics;
+	NXClearStruct(statistics);
+	const int iRoot = m_Tree.GetPyramidLevelCount() - 1;
+	float t0 = 0.f, t1 = fMaxT;
+	bool  bHit = false;
+	if (ClipToBox(Origin, Direction, m_Tree.GetNodeAABB(iRoot, 0, 0), t0, t1)) {
+		bHit = IntersectNode(Origin, Direction, iRoot, 0, 0, t0, t1, result, statistics);
+	}
+	AddStatistics(pStatistics, statistics);
+	return bHit;
+}
+
+bool NX::HeightFieldRaycast::IntersectNode(const float3 &Origin, const float3 &Direction, const int iLevel, const int iNodeRow, const int iNodeCol, float t0, float t1, Hit &result, Statistics &statistics) const {
+	++statistics.iNodeVisits;
+	if (iLevel == 0) {
+		return IntersectChunk(Origin, Direction, iNodeRow, iNodeCol, t0, t1, result, statistics);
+	}
+
+	struct Child {
+		int     iRow, iCol;
+		float   t0, t1;
+	} Children[4];
+	int iChildCount = 0, iRows, iCols;
+	m_Tree.GetPyramidSize(iLevel - 1, iRows, iCols);
+	for (int i = 0; i < 4; ++i) {
+		Child child = { 2 * iNodeRow + (i >> 1), 2 * iNodeCol + (i & 1), t0, t1 };
+		if (child.iRow >= iRows || child.iCol >= iCols || !ClipToBox(Origin, Direction, m_Tree.GetNodeAABB(iLevel - 1, child.iRow, child.iCol), child.t0, child.t1)) {
+			continue;
+		}
+		int j = iChildCount++;
+		for (; j > 0 && Children[j - 1].t0 > child.t0; --j) {//front to back, so the first hit is the nearest
+			Children[j] = Children[j - 1];
+		}
+		Children[j] = child;
+	}
+
+	for (int i = 0; i < iChildCount; ++i) {
+		if (IntersectNode(Origin, Direction, iLevel - 1, Children[i].iRow, Children[i].iCol, Children[i].t0, Children[i].t1, result, statistics)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+bool NX::HeightFieldRaycast::IntersectChunk(const float3 &Origin, const float3 &Direction, const int iChunkRow, const int iChunkCol, const float t0, const float t1, Hit &result, Statistics &statistics) const {
+	int iFirstRow, iFirstCol, iCellRows, iCellCols;
+	m_Tree.GetChunkCellRange(iChunkRow, iChunkCol, iFirstRow, iFirstCol, iCellRows, iCellCols);
+	const float dx = m_Field.GetDX(), dz = m_Field.GetDZ();
+	const int   iColCount = m_Field.GetColCount();
+	const float *pHeights = m_Field.GetData();
+
+	//2D DDA over the chunk's cells starting where the ray enters the chunk bound
+	const float fEnterX = Origin.x + Direction.x * t0, fEnterZ = Origin.z + Direction.z * t0;
+	int r = NXMax(iFirstRow, NXMin((int)std::floor(fEnterX / dx), iFirstRow + iCellRows - 1));
+	int c = NXMax(iFirstCol, NXMin((int)std::floor(fEnterZ / dz), iFirstCol + iCellCols - 1));
+	const int   iStepR = Direction.x > 0.f ? 1 : -1, iStepC = Direction.z > 0.f ? 1 : -1;
+	const float fDeltaR = Direction.x != 0.f ? dx / NXAbs(Direction.x) : FLT_MAX;
+	const float fDeltaC = Direction.z != 0.f ? dz / NXAbs(Direction.z) : FLT_MAX;
+	float fNextR = Direction.x != 0.f ? ((r + (iStepR > 0 ? 1 : 0)) * dx - Origin.x) / Direction.x : FLT_MAX;
+	float fNextC = Direction.z != 0.f ? ((c + (iStepC > 0 ? 1 : 0)) * dz - Origin.z) / Direction.z : FLT_MAX;
+
+	float t = t0;
+	for (;;) {
+		++statistics.iCellVisits;
+		const float fExit = NXMin(t1, NXMin(fNextR, fNextC));
+		{//test the triangles only when the ray's height over the cell overlaps the cell's height range
+			const float *p0 = pHeights + r * iColCount + c, *p1 = p0 + iColCount;
+			const float fMinH = NXMin(NXMin(p0[0], p0[1]), NXMin(p1[0], p1[1]));
+			const float fMaxH = NXMax(NXMax(p0[0], p0[1]), NXMax(p1[0], p1[1]));
+			const float ya = Origin.y + Direction.y * t, yb = Origin.y + Direction.y * fExit;
+			const float fPad = 1e-4f * (1.f + NXAbs(fMaxH));
+			if (NXMin(ya, yb) <= fMaxH + fPad && NXMax(ya, yb) >= fMinH - fPad) {
+				statistics.iTriangleTests += 2;
+				if (IntersectCell(Origin, Direction, r, c, t1, result)) {
+					return true;
+				}
+			}
+		}
+		if (fExit >= t1) {
+			return false;
+		}
+		if (fNextR < fNextC) {
+			r += iStepR;
+			if (r < iFirstRow || r >= iFirstRow + iCellRows) {
+				return false;
+			}
+			t = fNextR;
+			fNextR += fDeltaR;
+		} else {
+			c += iStepC;
+			if (c < iFirstCol || c >= iFirstCol + iCellCols) {
+				return false;
+			}
+			t = fNextC;
+			fNextC += fDeltaC;
+		}
+	}
+}
+
+bool NX::HeightFieldRaycast::IntersectCell(const float3 &Origin, const float3 &Direction, const int r, const int c, const float fMaxT, Hit &result) const {
+	const float dx = m_Field.GetDX(), dz = m_Field.GetDZ();
+	const float3 p00(r * dx, m_Field.GetHeight(r, c), c * dz), p01(r * dx, m_Field.GetHeight(r, c + 1), (c + 1) * dz);
+	const float3 p10((r + 1) * dx, m_Field.GetHeight(r + 1, c), c * dz), p11((r + 1) * dx, m_Field.GetHeight(r + 1, c + 1), (c + 1) * dz);
+
+	//same split as the mesh: (r, c), (r, c + 1), (r + 1, c) and (r + 1, c), (r, c + 1), (r + 1, c + 1)
+	const float ta = IntersectTriangle(Origin, Direction, p00, p01, p10);
+	const float tb = IntersectTriangle(Origin, Direction, p10, p01, p11);
+	const bool  bA = ta >= 0.f && ta <= fMaxT, bB = tb >= 0.f && tb <= fMaxT;
+	if (!bA && !bB) {
+		return false;
+	}
+
+	const bool bFirst = bA && (!bB || ta <= tb);
+	const float3 Normal = bFirst ? Cross(p01 - p00, p10 - p00) : Cross(p01 - p10, p11 - p10);
+	result.fT       = bFirst ? ta : tb;
+	result.Position = Origin + Direction * result.fT;
+	result.Normal   = GetNormalized(Normal.y < 0.f ? GetNegative(Normal) : Normal);
+	result.iRow     = r;
+	result.iCol     = c;
+	return true;
+}
+
+void NX::HeightFieldRaycast::Intersect(const float3 *pOrigins, const float3 *pDirections, const float fMaxT, const int iCount, float *pT, const int iPartCount, Statistics *pStatistics) const {
+	const int iParts = iPartCount > 0 ? iPartCount : GetHardwareThreadCount();
+	std::vector<Statistics> PartStatistics(iParts);
+	NX::ParallelFor(0, iCount, iParts, [&](int iBegin, int iEnd, int iPart) {
+		Statistics &statistics = PartStatistics[iPart];
+		NXClearStruct(statistics);
+		Hit hit;
+		for (int i = iBegin; i < iEnd; ++i) {
+			pT[i] = Intersect(pOrigins[i], pDirections[i], fMaxT, hit, &statistics) ? hit.fT : -1.f;
+		}
+	});
+	for (int i = 0; i < iParts; ++i) {
+		AddStatistics(pStatistics, PartStatistics[i]);
+	}
+}
+
+void NX::HeightFieldRaycast::TestVisibility(const float3 *pFrom, const float3 *pTo, const int iCount, NXUInt8 *pVisible, const int iPartCount, Statistics *pStatistics) const {
+	const int iParts = iPartCount > 0 ? iPartCount : GetHardwareThreadCount();
+	std::vector<Statistics> PartStatistics(iParts);
+	NX::ParallelFor(0, iCount, iParts, [&](int iBegin, int iEnd, int iPart) {
+		Statistics &statistics = PartStatistics[iPart];
+		NXClearStruct(statistics);
+		Hit hit;
+		for (int i = iBegin; i < iEnd; ++i) {
+			const float3 Direction = pTo[i] - pFrom[i];
+			pVisible[i] = Intersect(pFrom[i] + Direction * VISIBILITY_EPSILON, Direction, 1.f - 2.f * VISIBILITY_EPSILON, hit, &statistics) ? 0 : 1;
+		}
+	});
+	for (int i = 0; i < iParts; ++i) {
+		AddStatistics(pStatistics, PartStatistics[i]);
+	}
+}
+
+bool NX::HeightFieldRaycast::IntersectBruteForce(const float3 &Origin, const float3 &Direction, const float fMaxT, Hit &result) const {
+	float fBest = fMaxT;
+	bool  bHit  = false;
+	Hit   hit;
+	for (int r = 0; r + 1 < m_Field.GetRowCount(); ++r) {
+		for (int c = 0; c + 1 < m_Field.GetColCount(); ++c) {
+			if (IntersectCell(Origin, Direction, r, c, fBest, hit)) {
+				fBest  = hit.fT;
+				result = hit;
+				bHit   = true;
+			}
+		}
+	}
+	return bHit;
+}
@@ -0,0 +1,77 @@
+/*
+ *  File:    NXHeightFieldRaycast.h
+ *
+ *  author:  张雄(zhang xiong, 1025679612@qq.com)
+ *  date:    2026_10_19
+ *  purpose: ray queries against a HeightField. the min/max pyramid of a TerrainQuadTree is walked front to
+ *           back so whole regions the ray passes above or below are skipped, inside a chunk a 2D DDA visits
+ *           the cells along the ray and only the two triangles of a cell whose height range the ray crosses
+ *           are tested. the first hit found is the nearest one. positions are in terrain space.
+ */
+
+#pragma once
+
+#include "../math/NXVector.h"
+#include "../common/NXType.h"
+
+namespace NX {
+	class HeightField;
+	class TerrainQuadTree;
+
+	class HeightFieldRaycast {
+	public:
+		struct Hit {
+			float       fT;           // Origin + fT * Direction is the hit
+			float3      Position;
+			float3      Normal;       // of the hit triangle, facing up
+			int         iRow;         // cell of the hit
+			int         iCol;
+		};
+
+		struct Statistics {
+			int         iNodeVisits;      // pyramid nodes whose bound the ray touched
+			int         iCellVisits;      // cells stepped through by the DDA
+			int         iTriangleTests;
+		};
+
+	public:
+		/**
+		 *  Tree must have been built from Field, both are referenced and must outlive this object
+		 */
+		HeightFieldRaycast(const HeightField &Field, const TerrainQuadTree &Tree);
+		virtual ~HeightFieldRaycast();
+
+	public:
+		/**
+		 *  nearest hit with fT in [0, fMaxT], Direction needn't be normalized. pStatistics (may be nullptr)
+		 *  is added to.
+		 */
+		bool  Intersect(const float3 &Origin, const float3 &Direction, const float fMaxT, Hit &result, Statistics *pStatistics = nullptr) const;
+
+		/**
+		 *  pT[i] receives the hit parameter of ray i or -1, rays are spread over iPartCount parts (<= 0
+		 *  means every hardware thread)
+		 */
+		void  Intersect(const float3 *pOrigins, const float3 *pDirections, const float fMaxT, const int iCount, float *pT, const int iPartCount = 0, Statistics *pStatistics = nullptr) const;
+
+		/**
+		 *  line of sight, pVisible[i] is 1 when the segment pFrom[i] - pTo[i] doesn't touch the surface. the
+		 *  ends are left out, so points lying on the surface can see each other
+		 */
+		void  TestVisibility(const float3 *pFrom, const float3 *pTo, const int iCount, NXUInt8 *pVisible, const int iPartCount = 0, Statistics *pStatistics = nullptr) const;
+
+		/**
+		 *  reference answer testing both triangles of every cell, for validation and benchmarks
+		 */
+		bool  IntersectBruteForce(const float3 &Origin, const float3 &Direction, const float fMaxT, Hit &result) const;
+
+	private:
+		bool  IntersectNode(const float3 &Origin, const float3 &Direction, const int iLevel, const int iNodeRow, const int iNodeCol, float t0, float t1, Hit &result, Statistics &statistics) const;
+		bool  IntersectChunk(const float3 &Origin, const float3 &Direction, const int iChunkRow, const int iChunkCol, const float t0, const float t1, Hit &result, Statistics &statistics) const;
+		bool  IntersectCell(const float3 &Origin, const float3 &Direction, const int r, const int c, const float fMaxT, Hit &result) const;
+
+	private:
+		const HeightField         &m_Field;
+		const TerrainQuadTree     &m_Tree;
+	};
+}
@@ -0,0 +1,138 @@
+/*
+ *  File:    NXHeightFieldTileFile.cpp
+ *
+ *  author:  张雄(zhang xiong, 1025679612@qq.com)
+ *  date:    2026_10_19
+ *  purpose: tiled heightfield file
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "NXHeightFieldTileFile.h"
+#include "NXHeightField.h"
+#include "../common/NXCore.h"
+#include "../common/NXLog.h"
+#include "../math/NXMath.h"
+
+namespace {
+	const int MAX_TILE_CELLS = 46339;   // (MAX_TILE_CELLS + 1)^2 samples of a tile still fit an int
+
+	NXInt64 GetTileCount(const NXInt64 iCount, const NXInt64 iTileCells) {
+		return (iCount - 1 + iTileCells - 1) / iTileCells;
+	}
+}
+
+NX::HeightFieldTileFile::HeightFieldTileFile() {
+	NXClearStruct(m_Header);
+}
+
+NX::HeightFieldTileFile::~HeightFieldTileFile() {
+	Close();
+}
+
+bool NX::HeightFieldTileFile::Write(const std::string &strFilePath, const int iRowCount, const int iColCount, const float dx, const float dz, const int iTileCells, const Generator &Generate) {
+	NXAssert(iRowCount > 1 && iColCount > 1 && iTileCells > 0 && iTileCells <= MAX_TILE_CELLS);
+	Header header;
+	NXClearStruct(header);
+	header.uMagic          = MAGIC;
+	header.uVersion        = VERSION;
+	header.iRowCount       = iRowCount;
+	header.iColCount       = iColCount;
+	header.iTileCells      = iTileCells;
+	header.iTileRowCount   = (NXInt32)GetTileCount(iRowCount, iTileCells);
+	header.iTileColCount   = (NXInt32)GetTileCount(iColCount, iTileCells);
+	header.fDX             = dx;
+	header.fDZ             = dz;
+
+	FILE *pFile = fopen(strFilePath.c_str(), "wb");
+	if (!pFile) {
+		glb_GetLog().logToConsole("Create heightfield tile file %s failed", strFilePath.c_str());
+		return false;
+	}
+
+	bool bSuccess = fwrite(&header, sizeof(header), 1, pFile) == 1;
+	const int iSide = iTileCells + 1;
+	std::vector<float> Tile(iSide * iSide), Source;
+	for (int tr = 0; tr < header.iTileRowCount && bSuccess; ++tr) {
+		for (int tc = 0; tc < header.iTileColCount && bSuccess; ++tc) {
+			const int r0 = tr * iTileCells, c0 = tc * iTileCells;
+			const int iRows = NXMin(iSide, iRowCount - r0), iCols = NXMin(iSide, iColCount - c0);
+			Source.resize(iRows * iCols);
+			Generate(r0, c0, iRows, iCols, &Source[0]);
+			for (int r = 0; r < iSide; ++r) {//repeat the border past the end of the grid
+				const float *pRow = &Source[NXMin(r, iRows - 1) * iCols];
+				for (int c = 0; c < iSide; ++c) {
+					Tile[r * iSide + c] = pRow[NXMin(c, iCols - 1)];
+				}
+			}
+			bSuccess = fwrite(&Tile[0], sizeof(float) * Tile.size(), 1, pFile) == 1;
+		}
+	}
+	fclose(pFile);
+	if (!bSuccess) {
+		glb_GetLog().logToConsole("Write heightfield tile file %s failed", strFilePath.c_str());
+	}
+	return bSuccess;
+}
+
+bool NX::HeightFieldTileFile::Write(const std::string &strFilePath, const HeightField &Field, const int iTileCells) {
+	return Write(strFilePath, Field.GetRowCount(), Field.GetColCount(), Field.GetDX(), Field.GetDZ(), iTileCells, [&Field](int r0, int c0, int iRows, int iCols, float *pOut) {
+		for (int r = 0; r < iRows; ++r) {
+			memcpy(pOut + r * iCols, Field.GetData() + (r0 + r) * Field.GetColCount() + c0, sizeof(float) * iCols);
+		}
+	});
+}
+
+bool NX::HeightFieldTileFile::Open(const std::string &strFilePath) {
+	Close();
+	do {
+		if (!m_File.Open(strFilePath) || m_File.GetSize() < sizeof(Header)) {
+			break;
+		}
+		memcpy(&m_Header, m_File.GetData(), sizeof(Header));
+		if (m_Header.uMagic != MAGIC || m_Header.uVersion != VERSION) {
+			break;
+		}
+		//a corrupt header would send GetTileData outside the mapping, the tile counts must be the ones Write derives
+		if (m_Header.iRowCount < 2 || m_Header.iColCount < 2 || m_Header.iTileCells <= 0 || m_Header.iTileCells > MAX_TILE_CELLS) {
+			break;
+		}
+		if (m_Header.iTileRowCount != GetTileCount(m_Header.iRowCount, m_Header.iTileCells) || m_Header.iTileColCount != GetTileCount(m_Header.iColCount, m_Header.iTileCells)) {
+			break;
+		}
+		const NXUInt64 uExpected = sizeof(Header) + (NXUInt64)m_Header.iTileRowCount * m_Header.iTileColCount * GetTileSampleCount() * sizeof(float);
+		if (m_File.GetSize() < uExpected) {
+			break;
+		}
+		return true;
+	} while (false);
+
+	glb_GetLog().logToConsole("Open heightfield tile file %s failed", strFilePath.c_str());
+	Close();
+	return false;
+}
+
+void NX::HeightFieldTileFile::Close() {
+	m_File.Close();
+	NXClearStruct(m_Header);
+}
+
+bool NX::HeightFieldTileFile::IsOpen() const {
+	return m_File.IsOpen();
+}
+
+const NX::HeightFieldTileFile::Header& NX::HeightFieldTileFile::GetHeader() const {
+	return m_Header;
+}
+
+int NX::HeightFieldTileFile::GetTileSampleCount() const {
+	return (m_Header.iTileCells + 1) * (m_Header.iTileCells + 1);
+}
+
+const float* NX::HeightFieldTileFile::GetTileData(const int iTileRow, const int iTileCol) const {
+	NXAssert(iTileRow >= 0 && iTileRow < m_Header.iTileRowCount && iTileCol >= 0 && iTileCol < m_Header.iTileColCount);
+	const NXUInt64 uOffset = sizeof(Header) + ((NXUInt64)iTileRow * m_Header.iTileColCount + iTileCol) * GetTileSampleCount() * sizeof(float);
+	return (const float*)(m_File.GetData() + uOffset);
+}
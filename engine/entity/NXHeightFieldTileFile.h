@@ -0,0 +1,76 @@
+/*
+ *  File:    NXHeightFieldTileFile.h
+ *
+ *  author:  张雄(zhang xiong, 1025679612@qq.com)
+ *  date:    2026_10_19
+ *  purpose: a tiled heightfield file, a header followed by fixed size tiles so that any tile can be
+ *           addressed straight from a memory mapping. tile (tr, tc) stores the (cells + 1) x (cells + 1)
+ *           heights of grid rows [tr * cells, tr * cells + cells] and cols [tc * cells, tc * cells + cells],
+ *           the shared border makes every cell of the tile answerable without its neighbours. samples
+ *           past the last grid row/col repeat the border.
+ */
+
+#pragma once
+
+#include <string>
+#include <functional>
+
+#include "../common/NXType.h"
+#include "../common/File/NXMappedFile.h"
+
+namespace NX {
+	class HeightField;
+
+	class HeightFieldTileFile {
+	public:
+		enum {
+			MAGIC   = 0x5448584E,   // "NXHT"
+			VERSION = 1,
+		};
+
+		struct Header {
+			NXUInt32    uMagic;
+			NXUInt32    uVersion;
+			NXInt32     iRowCount;           // grid vertices along x
+			NXInt32     iColCount;           // grid vertices along z
+			NXInt32     iTileCells;          // cells per tile side
+			NXInt32     iTileRowCount;
+			NXInt32     iTileColCount;
+			float       fDX;
+			float       fDZ;
+			NXUInt32    uReserved;
+		};
+
+		/**
+		 *  fill pOut with the iRows x iCols heights starting at grid (r0, c0), row-major
+		 */
+		typedef std::function<void(int r0, int c0, int iRows, int iCols, float *pOut)> Generator;
+
+	public:
+		HeightFieldTileFile();
+		virtual ~HeightFieldTileFile();
+
+	public:
+		/**
+		 *  write a tile file one tile at a time, so maps larger than memory can be produced
+		 */
+		static bool Write(const std::string &strFilePath, const int iRowCount, const int iColCount, const float dx, const float dz, const int iTileCells, const Generator &Generate);
+		static bool Write(const std::string &strFilePath, const HeightField &Field, const int iTileCells);
+
+	public:
+		bool          Open(const std::string &strFilePath);
+		void          Close();
+		bool          IsOpen() const;
+		const Header& GetHeader() const;
+		int           GetTileSampleCount() const;
+
+		/**
+		 *  heights of tile (iTileRow, iTileCol) inside the mapping, touching them may fault pages in
+		 */
+		const float*  GetTileData(const int iTileRow, const int iTileCol) const;
+
+	private:
+		MappedFile    m_File;
+		Header        m_Header;
+	};
+}
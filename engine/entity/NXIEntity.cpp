@@ -11,6 +11,7 @@
 NX::IEntity::IEntity() {
 	m_CanEverTick = false;
 	m_Visible = true;
+	m_iLOD    = 0;
 }
 
 NX::IEntity::~IEntity() {
@@ -59,4 +60,37 @@ std::string NX::IEntity::GetObjName() const {
 
 std::string& NX::IEntity::GetObjName() {
 	return m_strObjName;
+}
+
+int NX::IEntity::GetLODCount() const {
+	return 1;
+}
+
+float NX::IEntity::GetLODGeometricError(const int iLOD) const {
+	return 0.f;
+}
+
+int NX::IEntity::GetLODTriangleCount(const int iLOD) const {
+	return 0;
+}
+
+float NX::IEntity::GetBoundingRadius() const {
+	return 0.f;
+}
+
+int NX::IEntity::GetLOD() const {
+	return m_iLOD;
+}
+
+NX::IEntity& NX::IEntity::SetLOD(const int iLOD) {
+	m_iLOD = iLOD < 0 ? 0 : (iLOD < GetLODCount() ? iLOD : GetLODCount() - 1);
+	return *this;
+}
+
+void NX::IEntity::OnLostDevice() {
+	/**empty here*/
+}
+
+void NX::IEntity::OnResetDevice() {
+	/**empty here*/
 }
\ No newline at end of file
@@ -46,10 +46,23 @@ namespace NX {
 		IEntity&      SetCanEverTick(const bool EverTick);
 		IEntity&      SetObjectName(const std::string &ObjName);
 
+	public://level of detail, level 0 is the finest one, entities with a single level keep the defaults
+		virtual int   GetLODCount() const;
+		virtual float GetLODGeometricError(const int iLOD) const;   // world space, not decreasing with iLOD
+		virtual int   GetLODTriangleCount(const int iLOD) const;
+		virtual float GetBoundingRadius() const;                     // world space, around the transform translation
+		int           GetLOD() const;
+		IEntity&      SetLOD(const int iLOD);
+
+	public://device loss, D3DPOOL_DEFAULT resources are released in OnLostDevice and created again in OnResetDevice
+		virtual void  OnLostDevice();
+		virtual void  OnResetDevice();
+
 	private:
 		Transform			  m_Transform;	
 		bool				  m_Visible;
 		bool				  m_CanEverTick;
 		std::string           m_strObjName;
+		int                   m_iLOD;
 	};
 }
\ No newline at end of file
@@ -25,82 +25,143 @@ NX::Sphere::Sphere(const std::string &_TextureFilePath, const int _iStacks, cons
 		shaderMacros.SetMacro("ENABLE_BASIC_LIGHTING", "1");
 	}
 	m_pEffect         = NX::EffectManager::Instance().GetEffect("Shaders/DirectX/Sphere_Effect.hlsl", shaderMacros);
-	CreateTriangles();
+	CreateLODMeshes();
 }
 
 NX::Sphere::~Sphere() {
-	NX::NXSafeRelease(m_pVertexBuffer);
-	NX::NXSafeRelease(m_pIndexBuffer);
+	for (size_t i = 0; i < m_LODMeshes.size(); ++i) {
+		NX::NXSafeRelease(m_LODMeshes[i].pVertexBuffer);
+		NX::NXSafeRelease(m_LODMeshes[i].pIndexBuffer);
+	}
 	NX::NXSafeRelease(m_pVertexDesc);
 	NX::NXSafeDeleteArray(m_pVertexs);
 }
 
-void NX::Sphere::CreateTriangles() {
-	int nV = (m_iStacks - 1) * (m_iSlices + 1) + 2, r, c;
-	int nI = (m_iStacks - 2) * (m_iSlices + 1) * 2 + (m_iSlices + 2) * 2;
-	float rr = kfPiOver2, rc, dr = kfPi / m_iStacks, dc = kf2Pi / m_iSlices;
+void NX::Sphere::CreateLODMeshes() {
+	IDirect3DDevice9 *pDevice = glb_GetD3DDevice();
+	{//vertex desc
+		D3DVERTEXELEMENT9 VertexDesc[] = {
+			{ 0, CLS_MEM_OFFSET(Vertex, x), D3DDECLTYPE_FLOAT3, D3DDECLMETHOD_DEFAULT, D3DDECLUSAGE_POSITION, 0 },
+			{ 0, CLS_MEM_OFFSET(Vertex, u), D3DDECLTYPE_FLOAT2, D3DDECLMETHOD_DEFAULT, D3DDECLUSAGE_TEXCOORD, 0 },
+			{ 0, CLS_MEM_OFFSET(Vertex,nx), D3DDECLTYPE_FLOAT3, D3DDECLMETHOD_DEFAULT, D3DDECLUSAGE_NORMAL,   0 },
+			D3DDECL_END(),
+		};
+		pDevice->CreateVertexDeclaration(VertexDesc, &m_pVertexDesc);
+	}
+
+	{//level 0 uses the stacks and slices asked for, coarser levels halve both while the mesh still looks like a sphere
+		int iStacks = m_iStacks, iSlices = m_iSlices;
+		do {
+			LODMesh mesh;
+			mesh.iStacks = iStacks;
+			mesh.iSlices = iSlices;
+			mesh.pVertexBuffer = nullptr;
+			mesh.pIndexBuffer  = nullptr;
+			//sagitta of the longest chord, along a meridian (pi / stacks) or along the equator (2pi / slices)
+			mesh.fError  = m_fRadius * (1.f - std::cos(0.5f * NXMax(kfPi / iStacks, kf2Pi / iSlices)));
+			Vertex *pVertexs = new Vertex[(iStacks - 1) * (iSlices + 1) + 2];
+			CreateTriangles(mesh, pVertexs);
+			if (m_LODMeshes.empty()) {
+				m_pVertexs = pVertexs;
+			} else {
+				NX::NXSafeDeleteArray(pVertexs);
+			}
+			m_LODMeshes.push_back(mesh);
+			iStacks /= 2;
+			iSlices /= 2;
+		} while (iStacks >= 4 && iSlices >= 6);
+	}
+}
+
+void NX::Sphere::CreateTriangles(LODMesh &mesh, Vertex *pVertexs) {
+	const int iStacks = mesh.iStacks, iSlices = mesh.iSlices;
+	int nV = (iStacks - 1) * (iSlices + 1) + 2, r, c;
+	float rr = kfPiOver2, rc, dr = kfPi / iStacks, dc = kf2Pi / iSlices;
 	float sr, cr, sc, cc;
 	IDirect3DDevice9 *pDevice = glb_GetD3DDevice();
-	m_pVertexs = new Vertex[nV];
 	{//calculate vertex data 
-		Vertex *pVertex = m_pVertexs;
+		Vertex *pVertex = pVertexs;
 		*pVertex++ = { 0.f, m_fRadius, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f };
-		for (r = 1; r < m_iStacks; ++r) {
+		for (r = 1; r < iStacks; ++r) {
 			rr -= dr;
 			rc = 0.f;
 			cr = std::cosf(rr), sr = std::sinf(rr);
-			for (c = 0; c <= m_iSlices; ++c) {
+			for (c = 0; c <= iSlices; ++c) {
 				sc = std::sinf(rc);
 				cc = std::cosf(rc);
-				*pVertex++ = { m_fRadius * cr * cc, m_fRadius * sr, m_fRadius * cr * sc, c * 1.f / m_iSlices, r * 1.f / m_iStacks,  cr * cc, sr, cr * sc };
+				*pVertex++ = { m_fRadius * cr * cc, m_fRadius * sr, m_fRadius * cr * sc, c * 1.f / iSlices, r * 1.f / iStacks,  cr * cc, sr, cr * sc };
 				rc += dc;
 			}
 		}
 		*pVertex = { 0.f, -m_fRadius, 0.f, 0.f, 1.f, 0.f, -1.f, 0.f };
-		pDevice->CreateVertexBuffer(sizeof(Vertex) * nV, D3DUSAGE_WRITEONLY, 0, D3DPOOL_DEFAULT, &m_pVertexBuffer, nullptr);
-
-		void *pBase = nullptr;
-		m_pVertexBuffer->Lock(0, 0, &pBase, D3DLOCK_DISCARD);
-		memcpy(pBase, m_pVertexs, sizeof(Vertex) * nV);
-		m_pVertexBuffer->Unlock();
 	}
 
-
-	{//vertex desc
-		D3DVERTEXELEMENT9 VertexDesc[] = {
-			{ 0, CLS_MEM_OFFSET(Vertex, x), D3DDECLTYPE_FLOAT3, D3DDECLMETHOD_DEFAULT, D3DDECLUSAGE_POSITION, 0 },
-			{ 0, CLS_MEM_OFFSET(Vertex, u), D3DDECLTYPE_FLOAT2, D3DDECLMETHOD_DEFAULT, D3DDECLUSAGE_TEXCOORD, 0 },
-			{ 0, CLS_MEM_OFFSET(Vertex,nx), D3DDECLTYPE_FLOAT3, D3DDECLMETHOD_DEFAULT, D3DDECLUSAGE_NORMAL,   0 },
-			D3DDECL_END(),
-		};
-		pDevice->CreateVertexDeclaration(VertexDesc, &m_pVertexDesc);
-	}
-
-	{//calculate index data
-		pDevice->CreateIndexBuffer(nI * sizeof(int), D3DUSAGE_WRITEONLY, D3DFMT_INDEX32, D3DPOOL_DEFAULT, &m_pIndexBuffer, nullptr);
-		int *pBase = nullptr;
-		m_pIndexBuffer->Lock(0, 0, (void**)&pBase, D3DLOCK_DISCARD);
-		for (int i = 0; i <= m_iSlices + 1; ++i) {//first stack, triangle_fan
-			*pBase++ = i;
+	std::vector<NXUInt32> Indexs;
+	{//calculate index data, a triangle list with the winding of the old fan + strip + fan layout
+		Indexs.reserve(iSlices * (iStacks - 1) * 6);
+		for (int i = 0; i < iSlices; ++i) {//first stack
+			const NXUInt32 Triangle[] = { 0, (NXUInt32)i + 1, (NXUInt32)i + 2 };
+			Indexs.insert(Indexs.end(), Triangle, Triangle + 3);
 		}
-		int a = 1;
-		for (int i = 1; i < m_iStacks - 1; ++i) {//inner stacks, triangle_list
-			for (int j = 0; j <= m_iSlices; ++j) {
-				*pBase++ = a;
-				*pBase++ = a + m_iSlices + 1;
-				++a;
+		for (int i = 1; i < iStacks - 1; ++i) {//inner stacks
+			const NXUInt32 a = (i - 1) * (iSlices + 1) + 1, b = a + iSlices + 1;
+			for (int j = 0; j < iSlices; ++j) {
+				const NXUInt32 Triangles[] = { a + j, b + j, a + j + 1, a + j + 1, b + j, b + j + 1 };
+				Indexs.insert(Indexs.end(), Triangles, Triangles + 6);
 			}
 		}
+		const NXUInt32 uSouth = nV - 1, uRing = (iStacks - 2) * (iSlices + 1) + 1;
+		for (int i = 0; i < iSlices; ++i) {//last stack
+			const NXUInt32 Triangle[] = { uSouth, uRing + i, uRing + i + 1 };
+			Indexs.insert(Indexs.end(), Triangle, Triangle + 3);
+		}
+	}
 
-		*pBase++ = (m_iStacks - 1) * (m_iSlices + 1) + 1;
-		for (int i = 0; i <= m_iSlices; ++i) {
-			*pBase++ = (m_iStacks - 2) * (m_iSlices + 1) + 1 + i;
+	mesh.Report = MeshOptimizer::Optimize(pVertexs, sizeof(Vertex), nV, &Indexs[0], (int)Indexs.size());
+	std::vector<NXUInt16> Indexs16;
+	std::vector<NXUInt32> Sources;
+	MeshOptimizer::SplitIndex16(&Indexs[0], (int)Indexs.size(), nV, mesh.Chunks, Indexs16, Sources);
+
+	{//upload, chunks past the first repeat the vertices they share with earlier ones
+		pDevice->CreateVertexBuffer(sizeof(Vertex) * Sources.size(), D3DUSAGE_WRITEONLY, 0, D3DPOOL_DEFAULT, &mesh.pVertexBuffer, nullptr);
+		Vertex *pBase = nullptr;
+		mesh.pVertexBuffer->Lock(0, 0, (void**)&pBase, D3DLOCK_DISCARD);
+		for (size_t i = 0; i < Sources.size(); ++i) {
+			pBase[i] = pVertexs[Sources[i]];
 		}
+		mesh.pVertexBuffer->Unlock();
+	}
 
-		m_pIndexBuffer->Unlock();
+	{
+		pDevice->CreateIndexBuffer(Indexs16.size() * sizeof(NXUInt16), D3DUSAGE_WRITEONLY, D3DFMT_INDEX16, D3DPOOL_DEFAULT, &mesh.pIndexBuffer, nullptr);
+		void *pBase = nullptr;
+		mesh.pIndexBuffer->Lock(0, 0, &pBase, D3DLOCK_DISCARD);
+		memcpy(pBase, &Indexs16[0], sizeof(NXUInt16) * Indexs16.size());
+		mesh.pIndexBuffer->Unlock();
 	}
 }
 
+int NX::Sphere::GetLODCount() const {
+	return (int)m_LODMeshes.size();
+}
+
+float NX::Sphere::GetLODGeometricError(const int iLOD) const {
+	return m_LODMeshes[iLOD].fError * GetMaxScale();
+}
+
+int NX::Sphere::GetLODTriangleCount(const int iLOD) const {
+	const LODMesh &mesh = m_LODMeshes[iLOD];
+	return mesh.iSlices * (mesh.iStacks - 1) * 2;
+}
+
+float NX::Sphere::GetBoundingRadius() const {
+	return m_fRadius * GetMaxScale();
+}
+
+float NX::Sphere::GetMaxScale() const {
+	const float3 &Scale = GetTransform().GetScale();
+	return NXMax(NXAbs(Scale.x), NXMax(NXAbs(Scale.y), NXAbs(Scale.z)));
+}
 
 const std::string& NX::Sphere::GetTextureFilePath() const{
 	return m_TextureFilePath;
@@ -115,12 +176,16 @@ NX::Sphere& NX::Sphere::SetTextureFilePath(const std::string &_TextureFilePath)
 	return *this;
 }
 
+const NX::MeshOptimizer::Report& NX::Sphere::GetIndexCacheReport(const int iLOD) const {
+	return m_LODMeshes[iLOD].Report;
+}
+
 void NX::Sphere::Render(struct NX::RenderParameter &renderer) {
 	if (!m_pVertexs) {
 		return;
 	}
 	SetupLightingInfo(renderer);
-	int nV = (m_iStacks - 1) * (m_iSlices + 1) + 2;
+	const LODMesh &mesh = m_LODMeshes[GetLOD()];
 
 	IDirect3DDevice9 *pDevice = renderer.pDXDevice;
 	m_pEffect->SetMatrix(m_pEffect->GetParameterByName(NULL, "PVMMatrix"), (D3DXMATRIX*)&(renderer.pProjectController->GetWatchMatrix() * GetTransform().GetTransformMatrix()));
@@ -130,13 +195,14 @@ void NX::Sphere::Render(struct NX::RenderParameter &renderer) {
 	m_pEffect->Begin(&uPasses, 0);
 	for (int i = 0; i < uPasses; ++i) {
 		pDevice->SetVertexDeclaration(m_pVertexDesc);
-		pDevice->SetStreamSource(0, m_pVertexBuffer, 0, sizeof(Vertex));
-		pDevice->SetIndices(m_pIndexBuffer);
+		pDevice->SetStreamSource(0, mesh.pVertexBuffer, 0, sizeof(Vertex));
+		pDevice->SetIndices(mesh.pIndexBuffer);
 
 		m_pEffect->BeginPass(i);
-		pDevice->DrawIndexedPrimitive(D3DPT_TRIANGLEFAN,   0, 0, m_iSlices + 2, 0, m_iSlices);
-		pDevice->DrawIndexedPrimitive(D3DPT_TRIANGLESTRIP, 0, 0, (m_iStacks - 2) * (m_iSlices + 1) * 2, m_iSlices + 2, (m_iStacks - 2) * (m_iSlices + 1) * 2);
-		pDevice->DrawIndexedPrimitive(D3DPT_TRIANGLEFAN,   0, 0, m_iSlices + 2, (m_iStacks - 2) * (m_iSlices + 1) * 2 + m_iSlices + 2, m_iSlices);
+		for (size_t j = 0; j < mesh.Chunks.size(); ++j) {
+			const MeshOptimizer::Chunk &chunk = mesh.Chunks[j];
+			pDevice->DrawIndexedPrimitive(D3DPT_TRIANGLELIST, chunk.iBaseVertex, 0, chunk.iVertexCount, chunk.iStartIndex, chunk.iPrimitiveCount);
+		}
 		m_pEffect->EndPass();
 	}
 	m_pEffect->End();
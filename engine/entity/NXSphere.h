@@ -10,8 +10,10 @@
 
 #include <d3d9.h>
 #include <d3dx9.h>
+#include <vector>
 
 #include "NXIEntity.h"
+#include "../render/NXMeshOptimizer.h"
 
 namespace NX {
 	IDirect3DDevice9* glb_GetD3DDevice();
@@ -26,10 +28,20 @@ namespace NX {
 		virtual ENTITY_TYPE GetEntityType() override;
 		virtual void OnTick(const float fDeleta) override;
 
+	public:
+		virtual int   GetLODCount() const override;
+		virtual float GetLODGeometricError(const int iLOD) const override;
+		virtual int   GetLODTriangleCount(const int iLOD) const override;
+		virtual float GetBoundingRadius() const override;
+
 	public:
 		const std::string& GetTextureFilePath() const;
 		std::string& GetTextureFilePath();
 		Sphere& SetTextureFilePath(const std::string &_TextureFilePath);
+		/**
+		 *  simulated post transform cache of one level, before and after its triangles were reordered
+		 */
+		const MeshOptimizer::Report& GetIndexCacheReport(const int iLOD) const;
 
 	public:
 		struct Vertex {
@@ -48,15 +60,27 @@ namespace NX {
 		};
 
 	private:
-		void CreateTriangles();
+		struct LODMesh {//every level halves stacks and slices of the previous one
+			int                             iStacks;
+			int                             iSlices;
+			float                           fError;          // largest distance between the mesh and the true sphere, model space
+			IDirect3DVertexBuffer9          *pVertexBuffer;
+			IDirect3DIndexBuffer9           *pIndexBuffer;    // 16 bit triangle list
+			std::vector<MeshOptimizer::Chunk> Chunks;        // one unless the level has more than 65535 vertices
+			MeshOptimizer::Report           Report;
+		};
+
+	private:
+		void CreateLODMeshes();
+		void CreateTriangles(LODMesh &mesh, Vertex *pVertexs);
 		void SetupLightingInfo(struct RenderParameter &renderer);
+		float GetMaxScale() const;
 
 	private:
 		int                                 m_iStacks;
 		int                                 m_iSlices;
-		IDirect3DVertexBuffer9              *m_pVertexBuffer;
+		std::vector<LODMesh>                m_LODMeshes;
 		IDirect3DVertexDeclaration9         *m_pVertexDesc;
-		IDirect3DIndexBuffer9               *m_pIndexBuffer;
 		ID3DXEffect                         *m_pEffect;
 		Vertex                              *m_pVertexs;
 		float                               m_fRadius;
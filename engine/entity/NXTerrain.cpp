@@ -8,6 +8,13 @@
 
 
 #include "NXTerrain.h"
+#include "NXChunkDirtyRegion.h"
+#include "NXHeightField.h"
+#include "NXHeightFieldNormals.h"
+#include "NXHeightFieldGenerator.h"
+#include "NXHeightFieldOcclusion.h"
+#include "NXHeightFieldDelta.h"
+#include "NXTerrainBrush.h"
 #include "../math/NXAlgorithm.h"
 #include "../../engine/entity/NXTerrain.h"
 #include "../../engine/render/NXCamera.h"
@@ -15,6 +22,7 @@
 #include "../render/NXEngine.h"
 #include "../render/NXEffectManager.h"
 #include "../common/NXLog.h"
+#include "../render/NXViewFrustum.h"
 
 namespace NX {
 	extern IDirect3DDevice9 * glb_GetD3DDevice();
@@ -28,11 +36,19 @@ NX::Terrain::Terrain(const int Row, const int Col, const float dx, const float d
 	m_Width                     =     m_dx * (m_RowCount - 1);
 	m_Height                    =     m_dz * (m_ColCount - 1);
 	m_strTextureFilePath        =     strTextureFilePath;
-	m_pVertexData               =     nullptr;
 	m_pVertexDesc               =     nullptr;
 	m_pEffect                   =     nullptr;
 	m_pVertexBuffer             =     nullptr;
 	m_pIndexBuffer              =     nullptr;
+	m_pQuadTree                 =     nullptr;
+	m_pDirtyRegion              =     nullptr;
+	m_pErrorRegion              =     nullptr;
+	m_pHeightField              =     nullptr;
+	m_pOcclusionBaker           =     nullptr;
+	m_pEditHistory              =     new HeightFieldEditHistory();
+	m_fPixelError               =     2.f;
+	NXClearStruct(m_UploadStatistics);
+	NXClearStruct(m_IndexCacheReport);
 
 	CreateVertexs();
 	CompileEffectFile();
@@ -40,37 +56,33 @@ NX::Terrain::Terrain(const int Row, const int Col, const float dx, const float d
 }
 
 NX::Terrain::~Terrain() {
-	NX::NXSafeDeleteArray(m_pVertexData);
-	NX::NXSafeDeleteArray(m_pVertexData);
 	NX::NXSafeRelease(m_pVertexDesc);
 	NX::NXSafeRelease(m_pEffect);
 	NX::NXSafeRelease(m_pVertexBuffer);
 	NX::NXSafeRelease(m_pIndexBuffer);
+	NX::NXSafeDelete(m_pQuadTree);
+	NX::NXSafeDelete(m_pDirtyRegion);
+	NX::NXSafeDelete(m_pErrorRegion);
+	NX::NXSafeDelete(m_pHeightField);
+	NX::NXSafeDelete(m_pOcclusionBaker);
+	NX::NXSafeDelete(m_pEditHistory);
 }
 
-float NX::Terrain::GetHeight(const float x, const float y) const {
-	NXAssert(x >= 0 && x <= m_Width && y >=0 && y <= m_Height);
-	int r = x / m_dx, c = y / m_dz;
-	float dr = x - r * m_dx, dc = y - c * m_dz;
-	int idx = r * m_RowCount + c;
-	if (dr / m_dx + dc / m_dz >= 1.0f) {
-		return GetHeight(m_pVertexData[idx + m_RowCount].Position, m_pVertexData[idx + m_RowCount + 1].Position, m_pVertexData[idx + 1].Position, x, y);
-	} else {
-		return GetHeight(m_pVertexData[idx + m_RowCount].Position, m_pVertexData[idx].Position, m_pVertexData[idx + 1].Position, x, y);
-	}
+float NX::Terrain::GetHeight(const float x, const float z) const {
+	NXAssert(x >= 0 && x <= m_Width && z >= 0 && z <= m_Height);
+	return m_pHeightField->GetHeight(x, z);
 }
 
-float NX::Terrain::GetHeight(float3 &pA, float3 &pB, float3 &pC, const float x, const float z) const{
-	Matrix<float, 2, 2> M;
-	float2 V;
-	{
-		M[0][0] = pA.x - pC.x, M[0][1] = pB.x - pC.x;
-		M[1][0] = pA.z - pC.z, M[1][1] = pB.z - pC.z;
-		V[0] = x - pC.x, V[1] = z - pC.z;
-		auto result = SolveEquation(M, V);
-		auto cof = result.second;
-		return cof[0] * pA.y + cof[1] * pB.y + (1.f - cof[0] - cof[1]) * pC.y;
-	}
+void NX::Terrain::GetHeights(const float *pXs, const float *pZs, float *pOut, const int iCount) const {
+	m_pHeightField->GetHeights(pXs, pZs, pOut, iCount);
+}
+
+const NX::HeightField& NX::Terrain::GetHeightField() const {
+	return *m_pHeightField;
+}
+
+NX::HeightField& NX::Terrain::GetHeightField() {
+	return *m_pHeightField;
 }
 
 void NX::Terrain::Render(struct RenderParameter &renderer) {
@@ -79,69 +91,397 @@ void NX::Terrain::Render(struct RenderParameter &renderer) {
 	m_pEffect->SetMatrixTranspose(m_pEffect->GetParameterByName(NULL, "ViewMatrix"),    (D3DXMATRIX*)&renderer.pMVController->GetMVMatrix());
 	m_pEffect->SetMatrixTranspose(m_pEffect->GetParameterByName(NULL, "ProjectMatrix"), (D3DXMATRIX*)&renderer.pProjectController->GetProjectMatrix());
 
-	{//commit data
-		if (m_pVertexBuffer) {
-			void *pBase = nullptr;
-			m_pVertexBuffer->Lock(0, 0, &pBase, D3DLOCK_DISCARD);
-			if (pBase != NULL) {
-				memcpy(pBase, m_pVertexData, sizeof(Vertex) * m_RowCount *m_ColCount);
-			}
-			m_pVertexBuffer->Unlock();
-		}
+	{//commit edited rows only, an idle terrain uploads nothing
+		FlushDirtyRegions();
+	}
+
+	{//select chunks and levels in terrain space, the frustum comes straight from Project * View * Model
+		const float4x4 &ModelMatrix = GetTransform().GetTransformMatrix();
+		const float4x4 ProjectMatrix = renderer.pProjectController->GetProjectMatrix();
+		const float4x4 InvModel = NX::GetReverse(ModelMatrix);
+		const float3   Eye = renderer.pMVController->GetEyePosition();
+		D3DVIEWPORT9   Viewport;
+		renderer.pDXDevice->GetViewport(&Viewport);
+
+		TerrainQuadTree::SelectParameter Parameter;
+		Parameter.Eye.x        = InvModel.m_Element[0][0] * Eye.x + InvModel.m_Element[0][1] * Eye.y + InvModel.m_Element[0][2] * Eye.z + InvModel.m_Element[0][3];
+		Parameter.Eye.y        = InvModel.m_Element[1][0] * Eye.x + InvModel.m_Element[1][1] * Eye.y + InvModel.m_Element[1][2] * Eye.z + InvModel.m_Element[1][3];
+		Parameter.Eye.z        = InvModel.m_Element[2][0] * Eye.x + InvModel.m_Element[2][1] * Eye.y + InvModel.m_Element[2][2] * Eye.z + InvModel.m_Element[2][3];
+		Parameter.fErrorScale  = 0.5f * Viewport.Height * ProjectMatrix.m_Element[1][1];
+		Parameter.fPixelError  = m_fPixelError;
+		Parameter.iMinLOD      = 0;
+		Parameter.iMaxLOD      = m_pQuadTree->GetLODCount() - 1;
+		m_pQuadTree->Select(ViewFrustum(renderer.pProjectController->GetWatchMatrix() * ModelMatrix), Parameter, m_Selections);
 	}
 
 	{//set HLSL variable
 		m_pEffect->SetTexture(m_pEffect->GetParameterByName(NULL, "RoadTexture"), DX9TextureManager::Instance().GetTexture("EngineResouces/Road/terrainstone.jpg"));
 		m_pEffect->SetTexture(m_pEffect->GetParameterByName(NULL, "GrassTexture"), DX9TextureManager::Instance().GetTexture("EngineResouces/Grass/Grass01.jpg"));
+		const float GridSpacing[2] = { m_dx, m_dz };
+		m_pEffect->SetFloatArray(m_pEffect->GetParameterByName(NULL, "GridSpacing"), GridSpacing, 2);
 	}
 
-	{//render
+	{//render, one draw per selected chunk
 		m_pEffect->SetTechnique(m_pEffect->GetTechniqueByName("TerrainShader"));
+		const D3DXHANDLE hChunkParameter = m_pEffect->GetParameterByName(NULL, "ChunkParameter");
 		UINT uPass;
 		m_pEffect->Begin(&uPass, 0);
 		for(int i = 0; i < uPass; ++i){
 			m_pEffect->BeginPass(i);
-			renderer.pDXDevice->SetStreamSource(0, m_pVertexBuffer, 0, sizeof(Vertex));
+			renderer.pDXDevice->SetStreamSource(0, m_pVertexBuffer, 0, sizeof(CompactVertex));
 			renderer.pDXDevice->SetIndices(m_pIndexBuffer);
-			renderer.pDXDevice->DrawIndexedPrimitive(D3DPT_TRIANGLELIST, 0, 0, (m_RowCount - 1) * (m_ColCount - 1) * 6, 0, (m_RowCount - 1) * (m_ColCount - 1) * 2);
+			for (size_t j = 0; j < m_Selections.size(); ++j) {
+				const TerrainQuadTree::ChunkSelection &selection = m_Selections[j];
+				int iFirstRow, iFirstCol, iCellRows, iCellCols;
+				m_pQuadTree->GetChunkCellRange(selection.iChunkRow, selection.iChunkCol, iFirstRow, iFirstCol, iCellRows, iCellCols);
+				const int iSizeClass = GetChunkSizeClass(selection.iChunkRow, selection.iChunkCol);
+				const IndexRange &range = m_IndexRanges[(iSizeClass * m_pQuadTree->GetLODCount() + selection.iLOD) * TerrainQuadTree::STITCH_COMBINATION + selection.iStitchMask];
+				if (range.iPrimitiveCount > 0) {
+					const int iChunk = selection.iChunkRow * m_pQuadTree->GetChunkColCount() + selection.iChunkCol;
+					const float ChunkParameter[4] = { (float)iFirstRow, (float)iFirstCol, m_ChunkQuantization[iChunk].fOffset, m_ChunkQuantization[iChunk].fScale };
+					m_pEffect->SetFloatArray(hChunkParameter, ChunkParameter, 4);
+					m_pEffect->CommitChanges();
+					renderer.pDXDevice->DrawIndexedPrimitive(D3DPT_TRIANGLELIST, m_ChunkVertexOffsets[iChunk], 0, (iCellRows + 1) * (iCellCols + 1), range.iStartIndex, range.iPrimitiveCount);
+				}
+			}
 			m_pEffect->EndPass();
 		}
 		m_pEffect->End();
 	}
 }
 
-NX::Terrain::Vertex&	NX::Terrain::GetVertex(const int r, const int c) {
-	NXAssert(r >= 0 && r < m_RowCount && c >= 0 && c< m_ColCount);
-	return m_pVertexData[r * m_RowCount + c];
+void NX::Terrain::UploadChunkRows(const int iChunkRow, const int iChunkCol, const int iFirstRow, const int iLastRow, CompactVertex *pDst) {
+	//pDst points at vertex row iFirstRow of the chunk
+	int iFirstGridRow, iFirstGridCol, iCellRows, iCellCols;
+	m_pQuadTree->GetChunkCellRange(iChunkRow, iChunkCol, iFirstGridRow, iFirstGridCol, iCellRows, iCellCols);
+	const QuantizeRange &range = m_ChunkQuantization[iChunkRow * m_pQuadTree->GetChunkColCount() + iChunkCol];
+	const float *pHeights = m_pHeightField->GetData();
+	for (int r = iFirstRow; r <= iLastRow; ++r) {
+		const int idx = (iFirstGridRow + r) * m_ColCount + iFirstGridCol;
+		for (int c = 0; c <= iCellCols; ++c, ++pDst) {
+			pDst->Row       = (NXUInt8)r;
+			pDst->Col       = (NXUInt8)c;
+			pDst->Normal    = m_Normals[idx + c];
+			pDst->Height    = QuantizeToInt16(pHeights[idx + c], range);
+			pDst->Occlusion = m_Occlusion[idx + c];
+			pDst->Reserved  = 0;
+		}
+	}
 }
 
-void NX::Terrain::CreateVertexs() {
-	NXAssert(m_RowCount > 0 && m_ColCount > 0);
+bool NX::Terrain::UpdateChunkQuantization(const int iChunk) {
+	//keep the range while the chunk's heights still fit, a new range means every row must be encoded again
+	const AABB Bound = m_pQuadTree->GetChunkAABB(iChunk / m_pQuadTree->GetChunkColCount(), iChunk % m_pQuadTree->GetChunkColCount());
+	if (InQuantizeRange(m_ChunkQuantization[iChunk], Bound.m_vMinPoint.y, Bound.m_vMaxPoint.y)) {
+		return false;
+	}
+	m_ChunkQuantization[iChunk] = GetQuantizeRange(Bound.m_vMinPoint.y, Bound.m_vMaxPoint.y);
+	return true;
+}
 
-	{//create vertex data
-		m_pVertexData = new Vertex[m_RowCount * m_ColCount];
-		Vertex *pVertex = m_pVertexData;
-		for (int r = 0; r < m_RowCount; ++r) {
-			for (int c = 0; c < m_ColCount; ++c) {
-				*pVertex++ = Vertex(r * m_dx, 0, c * m_dz, r & 1, c & 1, .0f, 0.f, .0f);
-			}
+void NX::Terrain::FlushDirtyRegions() {
+	m_UploadStatistics.iFrameLocks = 0;
+	m_UploadStatistics.uFrameBytes = 0;
+	if (m_pDirtyRegion->IsEmpty() || (!m_pVertexBuffer && m_SystemVertexs.empty())) {
+		return;
+	}
+
+	//level errors only depend on the heights, chunks with nothing but normal or occlusion edits keep theirs
+	m_pQuadTree->UpdateChunks(m_pHeightField->GetData(), 1, m_ColCount, m_pErrorRegion->GetDirtyChunks());
+	m_pErrorRegion->Clear();
+
+	const std::vector<int> &DirtyChunks = m_pDirtyRegion->GetDirtyChunks();
+
+	for (size_t i = 0; i < DirtyChunks.size(); ++i) {
+		const int iChunk    = DirtyChunks[i];
+		const int iChunkRow = iChunk / m_pQuadTree->GetChunkColCount(), iChunkCol = iChunk % m_pQuadTree->GetChunkColCount();
+		int iFirstGridRow, iFirstGridCol, iCellRows, iCellCols, iFirstRow, iLastRow;
+		m_pQuadTree->GetChunkCellRange(iChunkRow, iChunkCol, iFirstGridRow, iFirstGridCol, iCellRows, iCellCols);
+		m_pDirtyRegion->GetDirtyRows(iChunk, iFirstRow, iLastRow);
+		if (UpdateChunkQuantization(iChunk)) {
+			iFirstRow = 0, iLastRow = iCellRows;
+		}
+
+		//dirty rows of a chunk are contiguous in the chunk-major buffer, one lock per chunk
+		const UINT uOffset = (m_ChunkVertexOffsets[iChunk] + iFirstRow * (iCellCols + 1)) * sizeof(CompactVertex);
+		const UINT uSize   = (iLastRow - iFirstRow + 1) * (iCellCols + 1) * sizeof(CompactVertex);
+		CompactVertex *pBase = LockVertexs(uOffset, uSize);
+		if (pBase) {
+			UploadChunkRows(iChunkRow, iChunkCol, iFirstRow, iLastRow, pBase);
+			m_UploadStatistics.iFrameLocks += 1;
+			m_UploadStatistics.uFrameBytes += uSize;
+			UnlockVertexs();
 		}
 	}
+	m_UploadStatistics.uTotalBytes += m_UploadStatistics.uFrameBytes;
+	m_pDirtyRegion->Clear();
+}
+
+void NX::Terrain::MarkDirty(const int r0, const int c0, const int r1, const int c1) {
+	//bounds right away for culling and RayCast, the level errors wait for FlushDirtyRegions
+	m_pQuadTree->UpdateBounds(m_pHeightField->GetData(), 1, m_ColCount, r0, c0, r1, c1);
+	m_pDirtyRegion->Mark(r0, c0, r1, c1);
+	m_pErrorRegion->Mark(r0, c0, r1, c1);
+}
+
+NX::Terrain::CompactVertex* NX::Terrain::LockVertexs(const UINT uOffset, const UINT uSize) {
+	if (!m_pVertexBuffer) {
+		return m_SystemVertexs.empty() ? nullptr : (CompactVertex*)(&m_SystemVertexs[0] + uOffset);
+	}
+	void *pBase = nullptr;
+	if (FAILED(m_pVertexBuffer->Lock(uOffset, uSize, &pBase, 0))) {
+		return nullptr;
+	}
+	if (!pBase) {
+		m_pVertexBuffer->Unlock();
+	}
+	return (CompactVertex*)pBase;
+}
+
+void NX::Terrain::UnlockVertexs() {
+	if (m_pVertexBuffer) {
+		m_pVertexBuffer->Unlock();
+	}
+}
+
+const NX::Terrain::UploadStatistics& NX::Terrain::GetUploadStatistics() const {
+	return m_UploadStatistics;
+}
+
+NX::Terrain::MemoryStatistics NX::Terrain::GetMemoryStatistics() const {
+	const NXUInt64 uGridCount = (NXUInt64)m_RowCount * m_ColCount, uVertexCount = GetVertexBufferCount();
+	MemoryStatistics Statistics;
+	Statistics.uCPUBytes          = uGridCount * (sizeof(float) + sizeof(NXUInt16) + sizeof(NXUInt8));
+	Statistics.uVertexBufferBytes = uVertexCount * sizeof(CompactVertex);
+	Statistics.uIndexBufferBytes  = 0;
+	if (!m_IndexRanges.empty()) {
+		for (size_t i = 0; i < m_IndexRanges.size(); ++i) {
+			Statistics.uIndexBufferBytes = NXMax(Statistics.uIndexBufferBytes, (NXUInt64)(m_IndexRanges[i].iStartIndex + m_IndexRanges[i].iPrimitiveCount * 3) * sizeof(NXUInt16));
+		}
+	}
+	Statistics.uLegacyBytes       = 2 * uGridCount * sizeof(Vertex);   // a Vertex per grid point in system memory and again in the vertex buffer
+	return Statistics;
+}
+
+const NX::MeshOptimizer::Report& NX::Terrain::GetIndexCacheReport() const {
+	return m_IndexCacheReport;
+}
+
+int NX::Terrain::GetVertexBufferCount() const {
+	int iVertexCount = 0;
+	for (int cr = 0; cr < m_pQuadTree->GetChunkRowCount(); ++cr) {
+		for (int cc = 0; cc < m_pQuadTree->GetChunkColCount(); ++cc) {
+			int iFirstRow, iFirstCol, iCellRows, iCellCols;
+			m_pQuadTree->GetChunkCellRange(cr, cc, iFirstRow, iFirstCol, iCellRows, iCellCols);
+			iVertexCount += (iCellRows + 1) * (iCellCols + 1);
+		}
+	}
+	return iVertexCount;
+}
+
+int NX::Terrain::GetChunkSizeClass(const int iChunkRow, const int iChunkCol) const {
+	//full chunks and the shorter last chunk row/col get their own index patterns
+	int iFirstRow, iFirstCol, iCellRows, iCellCols;
+	m_pQuadTree->GetChunkCellRange(iChunkRow, iChunkCol, iFirstRow, iFirstCol, iCellRows, iCellCols);
+	return (iCellRows != m_pQuadTree->GetChunkCells() ? 2 : 0) + (iCellCols != m_pQuadTree->GetChunkCells() ? 1 : 0);
+}
+
+NX::Terrain::Vertex NX::Terrain::GetVertex(const int r, const int c) const {
+	NXAssert(r >= 0 && r < m_RowCount && c >= 0 && c < m_ColCount);
+	const float3 Normal = DecodeOctahedral16(m_Normals[r * m_ColCount + c]);
+	return Vertex(r * m_dx, m_pHeightField->GetHeight(r, c), c * m_dz, r * 1.f, c * 1.f, Normal.x, Normal.y, Normal.z);
+}
+
+NX::Terrain::VertexReference NX::Terrain::GetVertex(const int r, const int c) {
+	NXAssert(r >= 0 && r < m_RowCount && c >= 0 && c < m_ColCount);
+	return VertexReference(this, r, c);
+}
+
+NX::Terrain::VertexReference::operator NX::Terrain::Vertex() const {
+	return static_cast<const Terrain*>(m_pTerrain)->GetVertex(m_r, m_c);
+}
+
+NX::Terrain::VertexReference& NX::Terrain::VertexReference::operator = (const Vertex &rhs) {
+	m_pTerrain->SetHeight(m_r, m_c, rhs.y);
+	m_pTerrain->SetNormal(m_r, m_c, rhs.Normal);
+	return *this;
+}
+
+NX::Terrain::VertexReference& NX::Terrain::VertexReference::operator = (const VertexReference &rhs) {
+	return *this = (Vertex)rhs;
+}
+
+NX::Terrain::VertexReference::HeightReference::operator float() const {
+	return m_pTerrain->m_pHeightField->GetHeight(m_r, m_c);
+}
+
+NX::Terrain::VertexReference::HeightReference& NX::Terrain::VertexReference::HeightReference::operator = (const float h) {
+	m_pTerrain->SetHeight(m_r, m_c, h);
+	return *this;
+}
+
+NX::Terrain::VertexReference::HeightReference& NX::Terrain::VertexReference::HeightReference::operator = (const HeightReference &rhs) {
+	return *this = (float)rhs;
+}
+
+NX::Terrain::VertexReference::HeightReference& NX::Terrain::VertexReference::HeightReference::operator += (const float h) {
+	return *this = (float)*this + h;
+}
+
+NX::Terrain::VertexReference::HeightReference& NX::Terrain::VertexReference::HeightReference::operator -= (const float h) {
+	return *this = (float)*this - h;
+}
+
+NX::Terrain::VertexReference::PositionReference::operator NX::float3() const {
+	return float3(m_r * m_pTerrain->m_dx, m_pTerrain->m_pHeightField->GetHeight(m_r, m_c), m_c * m_pTerrain->m_dz);
+}
+
+NX::Terrain::VertexReference::PositionReference& NX::Terrain::VertexReference::PositionReference::operator = (const float3 &Position) {
+	m_pTerrain->SetHeight(m_r, m_c, Position.y);
+	return *this;
+}
+
+NX::Terrain::VertexReference::PositionReference& NX::Terrain::VertexReference::PositionReference::operator = (const PositionReference &rhs) {
+	return *this = (float3)rhs;
+}
+
+NX::Terrain::VertexReference::NormalReference::operator NX::float3() const {
+	return DecodeOctahedral16(m_pTerrain->m_Normals[m_r * m_pTerrain->m_ColCount + m_c]);
+}
+
+NX::Terrain::VertexReference::NormalReference& NX::Terrain::VertexReference::NormalReference::operator = (const float3 &Normal) {
+	m_pTerrain->SetNormal(m_r, m_c, Normal);
+	return *this;
+}
+
+NX::Terrain::VertexReference::NormalReference& NX::Terrain::VertexReference::NormalReference::operator = (const NormalReference &rhs) {
+	return *this = (float3)rhs;
+}
+
+NX::Terrain& NX::Terrain::SetHeight(const int r, const int c, const float h) {
+	m_pHeightField->SetHeight(r, c, h);
+	m_pQuadTree->ExpandBounds(r, c, h);
+	m_pDirtyRegion->Mark(r, c, r, c);
+	m_pErrorRegion->Mark(r, c, r, c);
+	return *this;
+}
+
+NX::Terrain& NX::Terrain::SetNormal(const int r, const int c, const float3 &Normal) {
+	NXAssert(r >= 0 && r < m_RowCount && c >= 0 && c < m_ColCount);
+	m_Normals[r * m_ColCount + c] = EncodeOctahedral16(Normal);
+	m_pDirtyRegion->Mark(r, c, r, c);
+	return *this;
+}
+
+NX::Terrain& NX::Terrain::RecomputeNormals(const int r0, const int c0, const int r1, const int c1) {
+	//central differences reach one vertex out, so the normals around the edited vertices change too
+	HeightFieldNormals::ComputeEncoded(*m_pHeightField, r0 - 1, c0 - 1, r1 + 1, c1 + 1, &m_Normals[0]);
+	m_pDirtyRegion->Mark(r0 - 1, c0 - 1, r1 + 1, c1 + 1);
+	return *this;
+}
+
+NX::Terrain& NX::Terrain::Generate(const HeightFieldGenerator &Generator) {
+	Generator.Generate(*m_pHeightField);
+	HeightFieldNormals::ComputeEncoded(*m_pHeightField, &m_Normals[0]);
+	m_pQuadTree->Build(m_pHeightField->GetData(), 1, m_ColCount);
+	m_pDirtyRegion->Mark(0, 0, m_RowCount - 1, m_ColCount - 1);
+	m_pEditHistory->Clear();
+	return *this;
+}
+
+NX::Terrain& NX::Terrain::Sculpt(const TerrainBrush &Brush, const float x, const float z) {
+	HeightFieldDelta Delta;
+	int r0, c0, r1, c1;
+	if (Brush.Apply(*m_pHeightField, x, z, r0, c0, r1, c1, &Delta)) {
+		OnHeightsEdited(r0, c0, r1, c1);
+		m_pEditHistory->Push(Delta);
+	}
+	return *this;
+}
+
+bool NX::Terrain::Undo() {
+	int r0, c0, r1, c1;
+	if (!m_pEditHistory->Undo(*m_pHeightField, r0, c0, r1, c1)) {
+		return false;
+	}
+	OnHeightsEdited(r0, c0, r1, c1);
+	return true;
+}
+
+bool NX::Terrain::Redo() {
+	int r0, c0, r1, c1;
+	if (!m_pEditHistory->Redo(*m_pHeightField, r0, c0, r1, c1)) {
+		return false;
+	}
+	OnHeightsEdited(r0, c0, r1, c1);
+	return true;
+}
+
+NX::HeightFieldEditHistory& NX::Terrain::GetEditHistory() {
+	return *m_pEditHistory;
+}
+
+NX::Terrain& NX::Terrain::BakeOcclusion(const HeightFieldOcclusion &Baker, const std::string &strCacheDirectory) {
+	if (strCacheDirectory.empty()) {
+		Baker.Bake(*m_pHeightField, &m_Occlusion[0]);
+	} else {
+		Baker.BakeCached(*m_pHeightField, strCacheDirectory, &m_Occlusion[0]);
+	}
+	NX::NXSafeDelete(m_pOcclusionBaker);
+	m_pOcclusionBaker = new HeightFieldOcclusion(Baker);
+	m_pDirtyRegion->Mark(0, 0, m_RowCount - 1, m_ColCount - 1);
+	return *this;
+}
+
+NXUInt8 NX::Terrain::GetOcclusion(const int r, const int c) const {
+	NXAssert(r >= 0 && r < m_RowCount && c >= 0 && c < m_ColCount);
+	return m_Occlusion[r * m_ColCount + c];
+}
+
+bool NX::Terrain::RayCast(const float3 &Origin, const float3 &Direction, const float fMaxT, HeightFieldRaycast::Hit &result) const {
+	return HeightFieldRaycast(*m_pHeightField, *m_pQuadTree).Intersect(Origin, Direction, fMaxT, result);
+}
+
+void NX::Terrain::OnHeightsEdited(const int r0, const int c0, const int r1, const int c1) {
+	//bounds are needed for culling right away, the level errors follow with the vertex upload in FlushDirtyRegions
+	m_pQuadTree->UpdateBounds(m_pHeightField->GetData(), 1, m_ColCount, r0, c0, r1, c1);
+	m_pErrorRegion->Mark(r0, c0, r1, c1);
+	RecomputeNormals(r0, c0, r1, c1);
+
+	if (m_pOcclusionBaker) {//the horizon of vertices around the edit moved as well
+		const int R = m_pOcclusionBaker->GetEditRadius();
+		m_pOcclusionBaker->BakeRegion(*m_pHeightField, r0 - R, c0 - R, r1 + R, c1 + R, &m_Occlusion[0]);
+		m_pDirtyRegion->Mark(r0 - R, c0 - R, r1 + R, c1 + R);
+	}
+}
+
+void NX::Terrain::CreateVertexs() {
+	NXAssert(m_RowCount > 1 && m_ColCount > 1);
+
+	{//chunk bounds live in the quad tree, heights in the height field, normals as octahedral codes
+		m_pQuadTree    = new TerrainQuadTree(m_RowCount, m_ColCount, m_dx, m_dz);
+		m_pDirtyRegion = new ChunkDirtyRegion(m_RowCount, m_ColCount, m_pQuadTree->GetChunkCells());
+		m_pErrorRegion = new ChunkDirtyRegion(m_RowCount, m_ColCount, m_pQuadTree->GetChunkCells());
+		m_pHeightField = new HeightField(m_RowCount, m_ColCount, m_dx, m_dz);
+		m_Normals.resize(m_RowCount * m_ColCount);
+		m_Occlusion.assign(m_RowCount * m_ColCount, 255);
+		NXAssert(m_pQuadTree->GetChunkCells() < 256);
+	}
 
 	{//set height
 		for (int r = 0; r < m_RowCount; ++r) {
 			for (int c = 0; c < m_ColCount; ++c) {
-				GetVertex(r, c).y = 0.f;//NX::RandFloatInRange(0.2, 0.6);
+				m_pHeightField->SetHeight(r, c, 0.f);//flat until Generate or the editing functions shape it
 			}
 		}
 	}
 
 	{//calculate normals
-		for (int r = 0; r < m_RowCount; ++r) {
-			for (int c = 0; c < m_ColCount; ++c) {
-				GetVertex(r, c).Normal = GetNormalized(GetVertex(r, c).Position);
-			}
-		}
+		HeightFieldNormals::ComputeEncoded(*m_pHeightField, &m_Normals[0]);
+	}
+
+	{//chunk bounds and per level errors
+		m_pQuadTree->Build(m_pHeightField->GetData(), 1, m_ColCount);
 	}
 }
 
@@ -155,14 +495,16 @@ void NX::Terrain::OnTick(const float fDelta) {
 }
 
 bool NX::Terrain::CompileEffectFile() {
+	if (!glb_GetD3DDevice()) {//tools and tests build terrains without device
+		return false;
+	}
 	const char *pszEffectFilePath = "Shaders/DirectX/Terrain_Effect.hlsl";
 	m_pEffect = NX::EffectManager::Instance().GetEffect(pszEffectFilePath);
 
 	{
-		D3DVERTEXELEMENT9 VertexDescs[] = {
-			{ 0, 0,                                D3DDECLTYPE_FLOAT3, D3DDECLMETHOD_DEFAULT,  D3DDECLUSAGE_POSITION, 0 },
-			{ 0, CLS_MEM_OFFSET(Vertex, TexCoord), D3DDECLTYPE_FLOAT2, D3DDECLMETHOD_DEFAULT,  D3DDECLUSAGE_TEXCOORD, 0 },
-			{ 0, CLS_MEM_OFFSET(Vertex, Normal),   D3DDECLTYPE_FLOAT3, D3DDECLMETHOD_DEFAULT,  D3DDECLUSAGE_NORMAL,   0 },
+		D3DVERTEXELEMENT9 VertexDescs[] = {//(row, col, normal.x, normal.z) bytes, then (height, occlusion) shorts
+			{ 0, 0,                                       D3DDECLTYPE_UBYTE4, D3DDECLMETHOD_DEFAULT,  D3DDECLUSAGE_TEXCOORD, 0 },
+			{ 0, CLS_MEM_OFFSET(CompactVertex, Height),   D3DDECLTYPE_SHORT2, D3DDECLMETHOD_DEFAULT,  D3DDECLUSAGE_POSITION, 0 },
 			D3DDECL_END(),
 		};
 		glb_GetD3DDevice()->CreateVertexDeclaration(VertexDescs, &m_pVertexDesc);
@@ -173,38 +515,92 @@ bool NX::Terrain::CompileEffectFile() {
 void NX::Terrain::CreateVertexAndIndexBuffer() {
 	HRESULT hr;
 	do {
-		hr = glb_GetD3DDevice()->CreateVertexBuffer(sizeof(Vertex) * m_RowCount *m_ColCount, D3DUSAGE_WRITEONLY, 0, D3DPOOL_MANAGED, &m_pVertexBuffer, NULL);
-		if (FAILED(hr) || !m_pVertexBuffer) {
-			glb_GetLog().logToConsole("Create terrain vertex buffer failed");
-			break;
+		{//chunk-major layout, every chunk stores its own (rows + 1) x (cols + 1) vertices so 16 bit indexs are enough
+			int iVertexCount = 0;
+			for (int cr = 0; cr < m_pQuadTree->GetChunkRowCount(); ++cr) {
+				for (int cc = 0; cc < m_pQuadTree->GetChunkColCount(); ++cc) {
+					int iFirstRow, iFirstCol, iCellRows, iCellCols;
+					m_pQuadTree->GetChunkCellRange(cr, cc, iFirstRow, iFirstCol, iCellRows, iCellCols);
+					m_ChunkVertexOffsets.push_back(iVertexCount);
+					iVertexCount += (iCellRows + 1) * (iCellCols + 1);
+				}
+			}
+			QuantizeRange Empty = { 0.f, 0.f };
+			m_ChunkQuantization.assign(m_ChunkVertexOffsets.size(), Empty);
+			for (size_t i = 0; i < m_ChunkQuantization.size(); ++i) {
+				UpdateChunkQuantization((int)i);
+			}
+			if (glb_GetD3DDevice()) {
+				hr = glb_GetD3DDevice()->CreateVertexBuffer(sizeof(CompactVertex) * iVertexCount, D3DUSAGE_WRITEONLY, 0, D3DPOOL_MANAGED, &m_pVertexBuffer, NULL);
+				if (FAILED(hr) || !m_pVertexBuffer) {
+					glb_GetLog().logToConsole("Create terrain vertex buffer failed");
+					break;
+				}
+			} else {
+				m_SystemVertexs.resize(sizeof(CompactVertex) * iVertexCount);
+			}
+
+			//initial fill, later frames only upload what SetHeight/SetNormal/MarkDirty touched
+			CompactVertex *pBase = LockVertexs(0, 0);
+			if (pBase != NULL) {
+				for (int cr = 0; cr < m_pQuadTree->GetChunkRowCount(); ++cr) {
+					for (int cc = 0; cc < m_pQuadTree->GetChunkColCount(); ++cc) {
+						int iFirstRow, iFirstCol, iCellRows, iCellCols;
+						m_pQuadTree->GetChunkCellRange(cr, cc, iFirstRow, iFirstCol, iCellRows, iCellCols);
+						UploadChunkRows(cr, cc, 0, iCellRows, pBase + m_ChunkVertexOffsets[cr * m_pQuadTree->GetChunkColCount() + cc]);
+					}
+				}
+				m_UploadStatistics.uTotalBytes = sizeof(CompactVertex) * iVertexCount;
+				UnlockVertexs();
+			}
+			m_pDirtyRegion->Clear();
+			m_pErrorRegion->Clear();
+		}
+
+		std::vector<NXUInt16> Indexs, Pattern;
+		{//every (size class, lod, stitch mask) pattern the selection can ask for, packed in one index buffer
+			const int iLODCount = m_pQuadTree->GetLODCount();
+			const int iLastRow  = m_pQuadTree->GetChunkRowCount() - 1, iLastCol = m_pQuadTree->GetChunkColCount() - 1;
+			const int SampleChunks[4][2] = { { 0, 0 }, { 0, iLastCol }, { iLastRow, 0 }, { iLastRow, iLastCol } };
+			IndexRange Empty = { 0, 0 };
+			m_IndexRanges.assign(4 * iLODCount * TerrainQuadTree::STITCH_COMBINATION, Empty);
+			NXClearStruct(m_IndexCacheReport);
+			for (int i = 0; i < 4; ++i) {
+				if (GetChunkSizeClass(SampleChunks[i][0], SampleChunks[i][1]) != i) {
+					continue;
+				}
+				int iFirstRow, iFirstCol, iCellRows, iCellCols;
+				m_pQuadTree->GetChunkCellRange(SampleChunks[i][0], SampleChunks[i][1], iFirstRow, iFirstCol, iCellRows, iCellCols);
+				for (int l = 0; l < iLODCount; ++l) {
+					for (int m = 0; m < TerrainQuadTree::STITCH_COMBINATION; ++m) {
+						MeshOptimizer::Report Report;
+						TerrainQuadTree::BuildChunkIndexs(iCellRows, iCellCols, l, m, Pattern, &Report);
+						MeshOptimizer::Accumulate(m_IndexCacheReport.Before, Report.Before);
+						MeshOptimizer::Accumulate(m_IndexCacheReport.After, Report.After);
+						IndexRange &range = m_IndexRanges[(i * iLODCount + l) * TerrainQuadTree::STITCH_COMBINATION + m];
+						range.iStartIndex     = (int)Indexs.size();
+						range.iPrimitiveCount = (int)Pattern.size() / 3;
+						Indexs.insert(Indexs.end(), Pattern.begin(), Pattern.end());
+					}
+				}
+			}
 		}
 
-		hr = glb_GetD3DDevice()->CreateIndexBuffer(sizeof(int) * (m_RowCount - 1) * (m_ColCount - 1) * 6, D3DUSAGE_WRITEONLY, D3DFMT_INDEX32, D3DPOOL_MANAGED, &m_pIndexBuffer, NULL);
+		if (!glb_GetD3DDevice()) {//the patterns and their cache report are all a terrain without device needs
+			break;
+		}
+		hr = glb_GetD3DDevice()->CreateIndexBuffer(sizeof(NXUInt16) * Indexs.size(), D3DUSAGE_WRITEONLY, D3DFMT_INDEX16, D3DPOOL_MANAGED, &m_pIndexBuffer, NULL);
 		if (FAILED(hr) || !m_pIndexBuffer) {
 			glb_GetLog().logToConsole("Create terrain index buffer failed");
 			break;
 		}
 
-		NXUInt32 *pIndex  = new NXUInt32[(m_RowCount - 1) * (m_ColCount - 1) * 6];
-		NXUInt32 *pWriter = pIndex;
-		for (int r = 0; r < m_RowCount - 1; ++r) {
-			for (int c = 0; c < m_ColCount - 1; ++c) {
-				int idx = r * m_RowCount + c;
-				*pWriter++ = idx;
-				*pWriter++ = idx + 1;
-				*pWriter++ = idx + m_RowCount;
-				*pWriter++ = idx + m_RowCount;
-				*pWriter++ = idx + 1;
-				*pWriter++ = idx + m_RowCount + 1;
-			}
-		}
 		void *pBase = NULL;
 		m_pIndexBuffer->Lock(0, 0, &pBase, D3DLOCK_DISCARD);
 		if(pBase != NULL){
-			memcpy(pBase, pIndex, sizeof(int) * (m_RowCount - 1) * (m_ColCount - 1) * 6);
+			memcpy(pBase, &Indexs[0], sizeof(NXUInt16) * Indexs.size());
 		}
 		m_pIndexBuffer->Unlock();
-		delete[] pIndex;
 	}while(false);
 }
 
@@ -214,4 +610,21 @@ float NX::Terrain::GetMaxRangeByXAxis() const {
 
 float NX::Terrain::GetMaxRangeByZAxis() const {
 	return m_Height;
+}
+
+NX::Terrain& NX::Terrain::SetPixelError(const float fPixelError) {
+	m_fPixelError = fPixelError;
+	return *this;
+}
+
+float NX::Terrain::GetPixelError() const {
+	return m_fPixelError;
+}
+
+const NX::TerrainQuadTree& NX::Terrain::GetQuadTree() const {
+	return *m_pQuadTree;
+}
+
+const std::vector<NX::TerrainQuadTree::ChunkSelection>& NX::Terrain::GetChunkSelections() const {
+	return m_Selections;
 }
\ No newline at end of file
@@ -9,13 +9,40 @@
 #pragma once
 
 #include "NXIEntity.h"
+#include "NXTerrainQuadTree.h"
+#include "NXHeightFieldRaycast.h"
+#include "../math/NXQuantize.h"
 #include <d3d9.h>
 #include <d3dx9.h>
+#include <vector>
+#include <cstring>
 
 namespace NX {
+	class ChunkDirtyRegion;
+	class HeightField;
+	class HeightFieldGenerator;
+	class HeightFieldOcclusion;
+	class HeightFieldEditHistory;
+	class TerrainBrush;
+
 	class Terrain : public IEntity {
 	public:
 		struct Vertex;
+		struct CompactVertex;
+		class  VertexReference;
+
+		struct UploadStatistics {
+			int         iFrameLocks;         // vertex buffer locks issued by the last FlushDirtyRegions
+			NXUInt64    uFrameBytes;         // bytes copied to the vertex buffer by the last FlushDirtyRegions
+			NXUInt64    uTotalBytes;         // bytes copied since creation, including the initial fill
+		};
+
+		struct MemoryStatistics {
+			NXUInt64    uCPUBytes;           // heights, encoded normals and occlusion kept in system memory
+			NXUInt64    uVertexBufferBytes;  // compact chunk-major vertex buffer
+			NXUInt64    uIndexBufferBytes;   // every (size class, lod, stitch mask) pattern
+			NXUInt64    uLegacyBytes;        // system memory plus vertex buffer with the 32 byte Vertex layout
+		};
 
 	public:
 		Terrain(const int Row, const int Col, const float dx, const float dz, const std::string &strTextureFilePath);
@@ -23,7 +50,70 @@ namespace NX {
 
 	public:
 		float GetHeight(const float x, const float z) const;
-		Vertex&	GetVertex(const int r, const int c);
+		/**
+		 *  batched GetHeight, positions outside the terrain are clamped to its border
+		 */
+		void  GetHeights(const float *pXs, const float *pZs, float *pOut, const int iCount) const;
+		/**
+		 *  heights are the authoritative terrain data, call MarkDirty after writing through the non-const field
+		 */
+		const HeightField& GetHeightField() const;
+		HeightField&       GetHeightField();
+		/**
+		 *  decode grid point (r, c), position and uv follow from the grid, the normal from its octahedral code.
+		 *  the non-const one writes height and normal back through SetHeight/SetNormal.
+		 */
+		Vertex	        GetVertex(const int r, const int c) const;
+		VertexReference GetVertex(const int r, const int c);
+		/**
+		 *  edits are marked dirty and reach the GPU on the next Render or FlushDirtyRegions
+		 */
+		Terrain& SetHeight(const int r, const int c, const float h);
+		Terrain& SetNormal(const int r, const int c, const float3 &Normal);
+		/**
+		 *  rebuild the normals affected by height edits of rows [r0, r1] and cols [c0, c1]
+		 */
+		Terrain& RecomputeNormals(const int r0, const int c0, const int r1, const int c1);
+		/**
+		 *  replace every height with the generator's fractal, normals and chunk bounds follow
+		 */
+		Terrain& Generate(const HeightFieldGenerator &Generator);
+		/**
+		 *  one brush stroke at (x, z), only the normals, chunk bounds and vertex rows under the brush are
+		 *  refreshed, the change is recorded for Undo
+		 */
+		Terrain& Sculpt(const TerrainBrush &Brush, const float x, const float z);
+		/**
+		 *  write back the heights a stroke recorded, cells the stroke changed lose whatever SetHeight or the
+		 *  height field wrote into them since
+		 */
+		bool     Undo();
+		bool     Redo();
+		HeightFieldEditHistory& GetEditHistory();
+		/**
+		 *  nearest surface hit along Origin + t * Direction for t in [0, fMaxT], for picking and brush placement.
+		 *  SetHeight, Sculpt and MarkDirty refresh the chunk bounds right away, with or without rendering.
+		 */
+		bool     RayCast(const float3 &Origin, const float3 &Direction, const float fMaxT, HeightFieldRaycast::Hit &result) const;
+		/**
+		 *  bake horizon occlusion of the current heights, through the cache in strCacheDirectory when it isn't
+		 *  empty. Sculpt, Undo and Redo bake the edited region plus the baker's edit radius again.
+		 */
+		Terrain& BakeOcclusion(const HeightFieldOcclusion &Baker, const std::string &strCacheDirectory = std::string());
+		NXUInt8  GetOcclusion(const int r, const int c) const;
+		void     MarkDirty(const int r0, const int c0, const int r1, const int c1);
+		/**
+		 *  upload the vertex rows edited since the last flush, Render calls it before drawing. level errors are
+		 *  rebuilt only for chunks whose heights changed, normal and occlusion edits just upload rows.
+		 *  a terrain created without device keeps its vertices in system memory and flushes there.
+		 */
+		void     FlushDirtyRegions();
+		const UploadStatistics& GetUploadStatistics() const;
+		MemoryStatistics        GetMemoryStatistics() const;
+		/**
+		 *  simulated post transform cache over every index pattern, before and after reordering
+		 */
+		const MeshOptimizer::Report& GetIndexCacheReport() const;
 
 	public:
 		virtual void Render(struct RenderParameter &renderer) override;
@@ -34,11 +124,29 @@ namespace NX {
 		float GetMaxRangeByXAxis() const;
 		float GetMaxRangeByZAxis() const;
 
+	public://chunked level of detail
+		Terrain& SetPixelError(const float fPixelError);
+		float    GetPixelError() const;
+		const TerrainQuadTree& GetQuadTree() const;
+		const std::vector<TerrainQuadTree::ChunkSelection>& GetChunkSelections() const;
+
 	private:
 		void   CreateVertexs();
-		float  GetHeight(float3 &pA, float3 &pB, float3 &pC, const float x, const float z) const;
 		bool   CompileEffectFile();
 		void   CreateVertexAndIndexBuffer();
+		void   UploadChunkRows(const int iChunkRow, const int iChunkCol, const int iFirstRow, const int iLastRow, CompactVertex *pDst);
+		bool   UpdateChunkQuantization(const int iChunk);
+		int    GetVertexBufferCount() const;
+		CompactVertex* LockVertexs(const UINT uOffset, const UINT uSize);
+		void   UnlockVertexs();
+		void   OnHeightsEdited(const int r0, const int c0, const int r1, const int c1);
+		int    GetChunkSizeClass(const int iChunkRow, const int iChunkCol) const;
+
+	private:
+		struct IndexRange {
+			int                                  iStartIndex;
+			int                                  iPrimitiveCount;
+		};
 
 	private:
 		int						                 m_RowCount;
@@ -47,12 +155,27 @@ namespace NX {
 		float					                 m_Height;
 		float					                 m_dx;
 		float					                 m_dz;
-		Vertex					                 *m_pVertexData;
+		std::vector<NXUInt16>                    m_Normals;              // octahedral normal of every grid point, row-major
+		std::vector<NXUInt8>                     m_Occlusion;            // ambient visibility of every grid point, 255 is unoccluded
 		std::string				                 m_strTextureFilePath;
 		IDirect3DVertexDeclaration9              *m_pVertexDesc;
 		ID3DXEffect                              *m_pEffect;
 		IDirect3DVertexBuffer9                   *m_pVertexBuffer;
 		IDirect3DIndexBuffer9                    *m_pIndexBuffer;
+		TerrainQuadTree                          *m_pQuadTree;
+		ChunkDirtyRegion                         *m_pDirtyRegion;        // vertex rows to upload
+		ChunkDirtyRegion                         *m_pErrorRegion;        // chunks whose heights changed, their level errors are stale
+		HeightField                              *m_pHeightField;        // authoritative heights, row-major
+		HeightFieldOcclusion                     *m_pOcclusionBaker;     // settings of the last BakeOcclusion, nullptr before
+		HeightFieldEditHistory                   *m_pEditHistory;
+		UploadStatistics                         m_UploadStatistics;
+		MeshOptimizer::Report                    m_IndexCacheReport;
+		float                                    m_fPixelError;
+		std::vector<NXUInt8>                     m_SystemVertexs;        // vertex buffer image of a terrain created without device
+		std::vector<int>                         m_ChunkVertexOffsets;   // chunk-major vertex buffer, first vertex of every chunk
+		std::vector<QuantizeRange>               m_ChunkQuantization;    // height offset/scale of every chunk in the vertex buffer
+		std::vector<IndexRange>                  m_IndexRanges;          // [size class][lod][stitch mask]
+		std::vector<TerrainQuadTree::ChunkSelection> m_Selections;
 	};
 
 	struct Terrain::Vertex {
@@ -67,6 +190,15 @@ namespace NX {
 			/**trival*/
 		}
 
+		Vertex(const Vertex &rhs) {
+			memcpy(this, &rhs, sizeof(Vertex));
+		}
+
+		Vertex& operator = (const Vertex &rhs) {
+			memcpy(this, &rhs, sizeof(Vertex));
+			return *this;
+		}
+
 		union {// position
 			float3 Position;
 			struct {
@@ -93,4 +225,82 @@ namespace NX {
 			};
 		};
 	};
+
+	/**
+	 *  grid point (r, c) of a non-const Terrain, reads like a Vertex. y, Position and Normal write through
+	 *  SetHeight/SetNormal, so the edit is marked dirty and reaches the GPU on the next Render. x/z and uv
+	 *  follow from the grid, only the y of an assigned Position or Vertex is taken.
+	 */
+	class Terrain::VertexReference {
+	public:
+		class HeightReference {
+		public:
+			operator float() const;
+			HeightReference& operator = (const float h);
+			HeightReference& operator = (const HeightReference &rhs);
+			HeightReference& operator += (const float h);
+			HeightReference& operator -= (const float h);
+
+		private:
+			friend class VertexReference;
+			HeightReference(Terrain *pTerrain, const int r, const int c) : m_pTerrain(pTerrain), m_r(r), m_c(c) {}
+			Terrain     *m_pTerrain;
+			int         m_r, m_c;
+		};
+
+		class PositionReference {
+		public:
+			operator float3() const;
+			PositionReference& operator = (const float3 &Position);
+			PositionReference& operator = (const PositionReference &rhs);
+
+		private:
+			friend class VertexReference;
+			PositionReference(Terrain *pTerrain, const int r, const int c) : m_pTerrain(pTerrain), m_r(r), m_c(c) {}
+			Terrain     *m_pTerrain;
+			int         m_r, m_c;
+		};
+
+		class NormalReference {
+		public:
+			operator float3() const;
+			NormalReference& operator = (const float3 &Normal);
+			NormalReference& operator = (const NormalReference &rhs);
+
+		private:
+			friend class VertexReference;
+			NormalReference(Terrain *pTerrain, const int r, const int c) : m_pTerrain(pTerrain), m_r(r), m_c(c) {}
+			Terrain     *m_pTerrain;
+			int         m_r, m_c;
+		};
+
+	public:
+		operator Vertex() const;
+		VertexReference& operator = (const Vertex &rhs);
+		VertexReference& operator = (const VertexReference &rhs);
+
+	public:
+		HeightReference      y;
+		PositionReference    Position;
+		NormalReference      Normal;
+
+	private:
+		friend class Terrain;
+		VertexReference(Terrain *pTerrain, const int r, const int c) : y(pTerrain, r, c), Position(pTerrain, r, c), Normal(pTerrain, r, c), m_pTerrain(pTerrain), m_r(r), m_c(c) {}
+		Terrain     *m_pTerrain;
+		int         m_r, m_c;
+	};
+
+	/**
+	 *  8 bytes per vertex in the vertex buffer, position and uv are rebuilt in the vertex shader from the
+	 *  chunk's first grid row/col, the grid spacing and the chunk's height offset/scale
+	 */
+	struct Terrain::CompactVertex {
+		NXUInt8     Row;                 // grid row inside the chunk
+		NXUInt8     Col;                 // grid col inside the chunk
+		NXUInt16    Normal;              // EncodeOctahedral16
+		NXInt16     Height;              // QuantizeToInt16 with the chunk's range
+		NXUInt8     Occlusion;           // 255 is unoccluded, read with Reserved as the second short
+		NXUInt8     Reserved;
+	};
 }
\ No newline at end of file
@@ -0,0 +1,155 @@
+/*
+ *  File:    NXTerrainBrush.cpp
+ *
+ *  author:  张雄(zhang xiong, 1025679612@qq.com)
+ *  date:    2026_10_19
+ *  purpose: heightfield sculpting brushes
+ */
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include "NXTerrainBrush.h"
+#include "NXHeightField.h"
+#include "NXHeightFieldDelta.h"
+#include "../common/NXCore.h"
+#include "../math/NXMath.h"
+
+NX::TerrainBrush::TerrainBrush() {
+	m_eMode            = BRUSH_RAISE;
+	m_fRadius          = 1.f;
+	m_fStrength        = 0.1f;
+	m_fHardness        = 0.5f;
+	m_fFlattenHeight   = 0.f;
+}
+
+NX::TerrainBrush::~TerrainBrush() {
+	/**empty here*/
+}
+
+NX::TerrainBrush& NX::TerrainBrush::SetMode(const BRUSH_MODE eMode) {
+	m_eMode = eMode;
+	return *this;
+}
+
+NX::TerrainBrush& NX::TerrainBrush::SetRadius(const float fRadius) {
+	m_fRadius = NXMax(fRadius, 0.f);
+	return *this;
+}
+
+NX::TerrainBrush& NX::TerrainBrush::SetStrength(const float fStrength) {
+	m_fStrength = fStrength;
+	return *this;
+}
+
+NX::TerrainBrush& NX::TerrainBrush::SetHardness(const float fHardness) {
+	m_fHardness = NXMax(0.f, NXMin(fHardness, 1.f));
+	return *this;
+}
+
+NX::TerrainBrush& NX::TerrainBrush::SetFlattenHeight(const float fFlattenHeight) {
+	m_fFlattenHeight = fFlattenHeight;
+	return *this;
+}
+
+NX::TerrainBrush::BRUSH_MODE NX::TerrainBrush::GetMode() const {
+	return m_eMode;
+}
+
+float NX::TerrainBrush::GetRadius() const {
+	return m_fRadius;
+}
+
+float NX::TerrainBrush::GetStrength() const {
+	return m_fStrength;
+}
+
+float NX::TerrainBrush::GetHardness() const {
+	return m_fHardness;
+}
+
+float NX::TerrainBrush::GetFlattenHeight() const {
+	return m_fFlattenHeight;
+}
+
+float NX::TerrainBrush::GetWeight(const float fDistanceSquared) const {
+	if (fDistanceSquared >= m_fRadius * m_fRadius) {
+		return 0.f;
+	}
+	const float t = std::sqrt(fDistanceSquared) / m_fRadius;
+	if (t <= m_fHardness) {
+		return 1.f;
+	}
+	const float s = (t - m_fHardness) / (1.f - m_fHardness);
+	return 1.f - s * s * (3.f - 2.f * s);
+}
+
+bool NX::TerrainBrush::GetRegion(const HeightField &Field, const float x, const float z, int &r0, int &c0, int &r1, int &c1) const {
+	r0 = NXMax((int)std::ceil((x - m_fRadius) / Field.GetDX()), 0);
+	r1 = NXMin((int)std::floor((x + m_fRadius) / Field.GetDX()), Field.GetRowCount() - 1);
+	c0 = NXMax((int)std::ceil((z - m_fRadius) / Field.GetDZ()), 0);
+	c1 = NXMin((int)std::floor((z + m_fRadius) / Field.GetDZ()), Field.GetColCount() - 1);
+	return r0 <= r1 && c0 <= c1;
+}
+
+bool NX::TerrainBrush::Apply(HeightField &Field, const float x, const float z, int &r0, int &c0, int &r1, int &c1, HeightFieldDelta *pDelta) const {
+	if (!GetRegion(Field, x, z, r0, c0, r1, c1)) {
+		return false;
+	}
+
+	//smooth reads the neighbours as they were before the stroke, so keep a one vertex border around the rectangle
+	const int iColCount = Field.GetColCount();
+	const int br0 = NXMax(r0 - 1, 0), br1 = NXMin(r1 + 1, Field.GetRowCount() - 1);
+	const int bc0 = NXMax(c0 - 1, 0), bc1 = NXMin(c1 + 1, iColCount - 1);
+	const int iStride = bc1 - bc0 + 1;
+	std::vector<float> BeforeHeights((br1 - br0 + 1) * iStride);
+	for (int r = br0; r <= br1; ++r) {
+		memcpy(&BeforeHeights[(r - br0) * iStride], Field.GetData() + r * iColCount + bc0, sizeof(float) * iStride);
+	}
+	auto Before = [&](const int r, const int c) -> float {
+		return BeforeHeights[(r - br0) * iStride + (c - bc0)];
+	};
+
+	const float dx = Field.GetDX(), dz = Field.GetDZ();
+	for (int r = r0; r <= r1; ++r) {
+		const float fOffsetX = r * dx - x;
+		float *pRow = Field.GetData() + r * iColCount;
+		for (int c = c0; c <= c1; ++c) {
+			const float fOffsetZ = c * dz - z;
+			const float w = GetWeight(fOffsetX * fOffsetX + fOffsetZ * fOffsetZ);
+			if (w <= 0.f) {
+				continue;
+			}
+			const float h = Before(r, c);
+			switch (m_eMode) {
+			case BRUSH_RAISE:
+				pRow[c] = h + m_fStrength * w;
+				break;
+			case BRUSH_LOWER:
+				pRow[c] = h - m_fStrength * w;
+				break;
+			case BRUSH_SMOOTH: {
+				const int nr0 = NXMax(r - 1, br0), nr1 = NXMin(r + 1, br1), nc0 = NXMax(c - 1, bc0), nc1 = NXMin(c + 1, bc1);
+				float fSum = 0.f;
+				for (int nr = nr0; nr <= nr1; ++nr) {
+					for (int nc = nc0; nc <= nc1; ++nc) {
+						fSum += Before(nr, nc);
+					}
+				}
+				const float fAverage = fSum / ((nr1 - nr0 + 1) * (nc1 - nc0 + 1));
+				pRow[c] = h + (fAverage - h) * NXMin(m_fStrength * w, 1.f);
+				break;
+			}
+			case BRUSH_FLATTEN:
+				pRow[c] = h + (m_fFlattenHeight - h) * NXMin(m_fStrength * w, 1.f);
+				break;
+			}
+		}
+	}
+
+	if (pDelta) {
+		pDelta->Record(Field, r0, c0, r1, c1, &BeforeHeights[(r0 - br0) * iStride + (c0 - bc0)], iStride);
+	}
+	return true;
+}
@@ -0,0 +1,69 @@
+/*
+ *  File:    NXTerrainBrush.h
+ *
+ *  author:  张雄(zhang xiong, 1025679612@qq.com)
+ *  date:    2026_10_19
+ *  purpose: round sculpting brushes for a HeightField. one application only reads and writes the grid
+ *           rectangle under the brush and hands back that rectangle, so the caller can refresh just the
+ *           normals, chunk bounds and vertex rows it covers.
+ */
+
+#pragma once
+
+namespace NX {
+	class HeightField;
+	class HeightFieldDelta;
+
+	class TerrainBrush {
+	public:
+		enum BRUSH_MODE {
+			BRUSH_RAISE,      // add fStrength * weight
+			BRUSH_LOWER,      // subtract fStrength * weight
+			BRUSH_SMOOTH,     // move towards the 3x3 average by fStrength * weight
+			BRUSH_FLATTEN,    // move towards the flatten height by fStrength * weight
+		};
+
+	public:
+		TerrainBrush();
+		virtual ~TerrainBrush();
+
+	public:
+		/**
+		 *  fRadius: world units
+		 *  fStrength: height units per application for raise/lower, blend factor in [0, 1] for smooth/flatten
+		 *  fHardness: in [0, 1], the weight is 1 inside fHardness * fRadius and falls smoothly to 0 at fRadius
+		 */
+		TerrainBrush& SetMode(const BRUSH_MODE eMode);
+		TerrainBrush& SetRadius(const float fRadius);
+		TerrainBrush& SetStrength(const float fStrength);
+		TerrainBrush& SetHardness(const float fHardness);
+		TerrainBrush& SetFlattenHeight(const float fFlattenHeight);
+		BRUSH_MODE    GetMode() const;
+		float         GetRadius() const;
+		float         GetStrength() const;
+		float         GetHardness() const;
+		float         GetFlattenHeight() const;
+
+	public:
+		/**
+		 *  grid rectangle a stroke at (x, z) may change, false when the brush misses the field
+		 */
+		bool  GetRegion(const HeightField &Field, const float x, const float z, int &r0, int &c0, int &r1, int &c1) const;
+
+		/**
+		 *  apply one stroke centered at (x, z), the changed rectangle is returned through r0..c1 and recorded
+		 *  into pDelta for undo (may be nullptr). false when the brush misses the field.
+		 */
+		bool  Apply(HeightField &Field, const float x, const float z, int &r0, int &c0, int &r1, int &c1, HeightFieldDelta *pDelta = nullptr) const;
+
+	private:
+		float GetWeight(const float fDistanceSquared) const;
+
+	private:
+		BRUSH_MODE                  m_eMode;
+		float                       m_fRadius;
+		float                       m_fStrength;
+		float                       m_fHardness;
+		float                       m_fFlattenHeight;
+	};
+}
@@ -0,0 +1,446 @@
+/*
+ *  File:    NXTerrainQuadTree.cpp
+ *
+ *  author:  张雄(zhang xiong, 1025679612@qq.com)
+ *  date:    2026_10_19
+ *  purpose: chunked terrain level of detail selection
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include "NXTerrainQuadTree.h"
+#include "../render/NXViewFrustum.h"
+#include "../common/NXParallel.h"
+#include "../common/NXCore.h"
+#include "../math/NXMath.h"
+
+namespace {
+	/**
+	 *  coarse grid segment [i0, i1] holding fine coordinate i at step s over n cells, the last segment may be shorter
+	 */
+	inline void GetSegment(const int i, const int s, const int n, int &i0, int &i1) {
+		if (i >= n) {
+			i0 = i1 = n;
+			return;
+		}
+		i0 = (i / s) * s;
+		i1 = std::min(i0 + s, n);
+	}
+
+	inline int SnapToStep(const int i, const int s, const int n) {
+		return i >= n ? n : (i / s) * s;
+	}
+}
+
+NX::TerrainQuadTree::TerrainQuadTree(const int iRowCount, const int iColCount, const float dx, const float dz, const int iChunkCells) {
+	NXAssert(iRowCount > 1 && iColCount > 1);
+	NXAssert(iChunkCells > 0 && iChunkCells <= 128 && (iChunkCells & (iChunkCells - 1)) == 0);
+	m_iRowCount        = iRowCount;
+	m_iColCount        = iColCount;
+	m_dx               = dx;
+	m_dz               = dz;
+	m_iChunkCells      = iChunkCells;
+	m_iChunkRowCount   = (iRowCount - 1 + iChunkCells - 1) / iChunkCells;
+	m_iChunkColCount   = (iColCount - 1 + iChunkCells - 1) / iChunkCells;
+	m_iLODCount        = 1;
+	while ((1 << (m_iLODCount - 1)) < iChunkCells) {
+		++m_iLODCount;
+	}
+
+	const int iChunkCount = m_iChunkRowCount * m_iChunkColCount;
+	m_ChunkErrors.resize(iChunkCount * m_iLODCount, 0.f);
+	m_SelectedLOD.resize(iChunkCount, -1);
+	m_SelectedErrors.resize(iChunkCount, 0.f);
+
+	{//min/max pyramid, halving until a single root node is left
+		int iRows = m_iChunkRowCount, iCols = m_iChunkColCount;
+		m_PyramidSize.push_back(std::make_pair(iRows, iCols));
+		while (iRows > 1 || iCols > 1) {
+			iRows = (iRows + 1) >> 1;
+			iCols = (iCols + 1) >> 1;
+			m_PyramidSize.push_back(std::make_pair(iRows, iCols));
+		}
+		m_Pyramid.resize(m_PyramidSize.size());
+		for (size_t i = 0; i < m_PyramidSize.size(); ++i) {
+			Bound bound = { 0.f, 0.f };
+			m_Pyramid[i].resize(m_PyramidSize[i].first * m_PyramidSize[i].second, bound);
+		}
+	}
+	NXClearStruct(m_Statistics);
+}
+
+NX::TerrainQuadTree::~TerrainQuadTree() {
+	/**empty here*/
+}
+
+int NX::TerrainQuadTree::GetChunkIndex(const int iChunkRow, const int iChunkCol) const {
+	return iChunkRow * m_iChunkColCount + iChunkCol;
+}
+
+void NX::TerrainQuadTree::Build(const float *pHeights, const int iColStride, const int iRowStride) {
+	ParallelFor(0, m_iChunkRowCount * m_iChunkColCount, 0, [=](int iBegin, int iEnd, int) {
+		for (int i = iBegin; i < iEnd; ++i) {
+			BuildChunk(pHeights, iColStride, iRowStride, i / m_iChunkColCount, i % m_iChunkColCount);
+		}
+	});
+	BuildPyramid(0, 0, m_iChunkRowCount - 1, m_iChunkColCount - 1);
+}
+
+void NX::TerrainQuadTree::UpdateRegion(const float *pHeights, const int iColStride, const int iRowStride, const int r0, const int c0, const int r1, const int c1) {
+	//a vertex on a chunk border belongs to both chunks, so widen by one vertex before mapping to chunks
+	const int cr0 = NXMax(0, (r0 - 1) / m_iChunkCells), cr1 = NXMin(m_iChunkRowCount - 1, r1 / m_iChunkCells);
+	const int cc0 = NXMax(0, (c0 - 1) / m_iChunkCells), cc1 = NXMin(m_iChunkColCount - 1, c1 / m_iChunkCells);
+	if (cr0 > cr1 || cc0 > cc1) {
+		return;
+	}
+	const int iCols = cc1 - cc0 + 1;
+	ParallelFor(0, (cr1 - cr0 + 1) * iCols, 0, [=](int iBegin, int iEnd, int) {
+		for (int i = iBegin; i < iEnd; ++i) {
+			BuildChunk(pHeights, iColStride, iRowStride, cr0 + i / iCols, cc0 + i % iCols);
+		}
+	});
+	BuildPyramid(cr0, cc0, cr1, cc1);
+}
+
+void NX::TerrainQuadTree::UpdateBounds(const float *pHeights, const int iColStride, const int iRowStride, const int r0, const int c0, const int r1, const int c1) {
+	const int cr0 = NXMax(0, (r0 - 1) / m_iChunkCells), cr1 = NXMin(m_iChunkRowCount - 1, r1 / m_iChunkCells);
+	const int cc0 = NXMax(0, (c0 - 1) / m_iChunkCells), cc1 = NXMin(m_iChunkColCount - 1, c1 / m_iChunkCells);
+	if (cr0 > cr1 || cc0 > cc1) {
+		return;
+	}
+	for (int cr = cr0; cr <= cr1; ++cr) {
+		for (int cc = cc0; cc <= cc1; ++cc) {
+			BuildChunkBound(pHeights, iColStride, iRowStride, cr, cc);
+		}
+	}
+	BuildPyramid(cr0, cc0, cr1, cc1);
+}
+
+void NX::TerrainQuadTree::ExpandBounds(const int r, const int c, const float h) {
+	//every level holds the union of its children, so widening each ancestor by h keeps the pyramid consistent
+	const int cr0 = NXMax(0, (r - 1) / m_iChunkCells), cr1 = NXMin(m_iChunkRowCount - 1, r / m_iChunkCells);
+	const int cc0 = NXMax(0, (c - 1) / m_iChunkCells), cc1 = NXMin(m_iChunkColCount - 1, c / m_iChunkCells);
+	for (size_t l = 0; l < m_Pyramid.size(); ++l) {
+		const int iCols = m_PyramidSize[l].second;
+		for (int pr = cr0 >> l; pr <= (cr1 >> l); ++pr) {
+			for (int pc = cc0 >> l; pc <= (cc1 >> l); ++pc) {
+				Bound &bound = m_Pyramid[l][pr * iCols + pc];
+				bound.fMinY = NXMin(bound.fMinY, h);
+				bound.fMaxY = NXMax(bound.fMaxY, h);
+			}
+		}
+	}
+}
+
+void NX::TerrainQuadTree::UpdateChunks(const float *pHeights, const int iColStride, const int iRowStride, const std::vector<int> &Chunks) {
+	if (Chunks.empty()) {
+		return;
+	}
+	ParallelFor(0, (int)Chunks.size(), Chunks.size() > 4 ? 0 : 1, [&](int iBegin, int iEnd, int) {
+		for (int i = iBegin; i < iEnd; ++i) {
+			BuildChunk(pHeights, iColStride, iRowStride, Chunks[i] / m_iChunkColCount, Chunks[i] % m_iChunkColCount);
+		}
+	});
+	for (size_t i = 0; i < Chunks.size(); ++i) {
+		const int cr = Chunks[i] / m_iChunkColCount, cc = Chunks[i] % m_iChunkColCount;
+		BuildPyramid(cr, cc, cr, cc);
+	}
+}
+
+void NX::TerrainQuadTree::BuildChunkBound(const float *pHeights, const int iColStride, const int iRowStride, const int iChunkRow, const int iChunkCol) {
+	int iFirstRow, iFirstCol, iCellRows, iCellCols;
+	GetChunkCellRange(iChunkRow, iChunkCol, iFirstRow, iFirstCol, iCellRows, iCellCols);
+	const float *pBase = pHeights + iFirstRow * iRowStride + iFirstCol * iColStride;
+	Bound &bound = m_Pyramid[0][GetChunkIndex(iChunkRow, iChunkCol)];
+	bound.fMinY = bound.fMaxY = pBase[0];
+	for (int r = 0; r <= iCellRows; ++r) {
+		const float *pRow = pBase + r * iRowStride;
+		for (int c = 0; c <= iCellCols; ++c) {
+			const float h = pRow[c * iColStride];
+			bound.fMinY = NXMin(bound.fMinY, h);
+			bound.fMaxY = NXMax(bound.fMaxY, h);
+		}
+	}
+}
+
+void NX::TerrainQuadTree::BuildChunk(const float *pHeights, const int iColStride, const int iRowStride, const int iChunkRow, const int iChunkCol) {
+	int iFirstRow, iFirstCol, iCellRows, iCellCols;
+	GetChunkCellRange(iChunkRow, iChunkCol, iFirstRow, iFirstCol, iCellRows, iCellCols);
+	const float *pBase = pHeights + iFirstRow * iRowStride + iFirstCol * iColStride;
+	auto H = [=](const int r, const int c) -> float {
+		return pBase[r * iRowStride + c * iColStride];
+	};
+
+	BuildChunkBound(pHeights, iColStride, iRowStride, iChunkRow, iChunkCol);
+
+	{//largest vertical distance between the full mesh and every coarser level, kept monotonic
+		float *pErrors = &m_ChunkErrors[GetChunkIndex(iChunkRow, iChunkCol) * m_iLODCount];
+		pErrors[0] = 0.f;
+		int   Row0[129], Row1[129], Col0[129], Col1[129];
+		float V[129], U[129];
+		for (int l = 1; l < m_iLODCount; ++l) {
+			const int s = 1 << l;
+			{//segment of every fine row/col at this level, computed once instead of per vertex
+				for (int r = 0; r <= iCellRows; ++r) {
+					GetSegment(r, s, iCellRows, Row0[r], Row1[r]);
+					V[r] = Row1[r] > Row0[r] ? (r - Row0[r]) * 1.f / (Row1[r] - Row0[r]) : 0.f;
+				}
+				for (int c = 0; c <= iCellCols; ++c) {
+					GetSegment(c, s, iCellCols, Col0[c], Col1[c]);
+					U[c] = Col1[c] > Col0[c] ? (c - Col0[c]) * 1.f / (Col1[c] - Col0[c]) : 0.f;
+				}
+			}
+			float fError = 0.f;
+			for (int r = 0; r <= iCellRows; ++r) {
+				const int r0 = Row0[r], r1 = Row1[r];
+				const float v = V[r];
+				for (int c = 0; c <= iCellCols; ++c) {
+					const int c0 = Col0[c], c1 = Col1[c];
+					const float u = U[c];
+					//same diagonal as the index pattern: (r0, c1) - (r1, c0)
+					float h;
+					if (u + v <= 1.f) {
+						const float h00 = H(r0, c0);
+						h = h00 + u * (H(r0, c1) - h00) + v * (H(r1, c0) - h00);
+					} else {
+						const float h11 = H(r1, c1);
+						h = h11 + (1.f - u) * (H(r1, c0) - h11) + (1.f - v) * (H(r0, c1) - h11);
+					}
+					fError = NXMax(fError, NXAbs(h - H(r, c)));
+				}
+			}
+			pErrors[l] = NXMax(fError, pErrors[l - 1]);
+		}
+	}
+}
+
+void NX::TerrainQuadTree::BuildPyramid(const int cr0, const int cc0, const int cr1, const int cc1) {
+	int r0 = cr0, c0 = cc0, r1 = cr1, c1 = cc1;
+	for (size_t l = 1; l < m_Pyramid.size(); ++l) {
+		r0 >>= 1, c0 >>= 1, r1 >>= 1, c1 >>= 1;
+		const int iSrcRows = m_PyramidSize[l - 1].first, iSrcCols = m_PyramidSize[l - 1].second;
+		const int iCols    = m_PyramidSize[l].second;
+		for (int r = r0; r <= r1; ++r) {
+			for (int c = c0; c <= c1; ++c) {
+				Bound bound = m_Pyramid[l - 1][(2 * r) * iSrcCols + 2 * c];
+				for (int i = 0; i < 4; ++i) {
+					const int sr = 2 * r + (i >> 1), sc = 2 * c + (i & 1);
+					if (sr < iSrcRows && sc < iSrcCols) {
+						const Bound &child = m_Pyramid[l - 1][sr * iSrcCols + sc];
+						bound.fMinY = NXMin(bound.fMinY, child.fMinY);
+						bound.fMaxY = NXMax(bound.fMaxY, child.fMaxY);
+					}
+				}
+				m_Pyramid[l][r * iCols + c] = bound;
+			}
+		}
+	}
+}
+
+int NX::TerrainQuadTree::GetPyramidLevelCount() const {
+	return (int)m_Pyramid.size();
+}
+
+void NX::TerrainQuadTree::GetPyramidSize(const int iLevel, int &iNodeRows, int &iNodeCols) const {
+	NXAssert(iLevel >= 0 && iLevel < (int)m_Pyramid.size());
+	iNodeRows = m_PyramidSize[iLevel].first;
+	iNodeCols = m_PyramidSize[iLevel].second;
+}
+
+NX::AABB NX::TerrainQuadTree::GetNodeAABB(const int iLevel, const int iNodeRow, const int iNodeCol) const {
+	const int   iSpan = m_iChunkCells << iLevel;
+	const int   r0    = iNodeRow * iSpan, r1 = NXMin(r0 + iSpan, m_iRowCount - 1);
+	const int   c0    = iNodeCol * iSpan, c1 = NXMin(c0 + iSpan, m_iColCount - 1);
+	const Bound &bound = m_Pyramid[iLevel][iNodeRow * m_PyramidSize[iLevel].second + iNodeCol];
+	return AABB(float3(r0 * m_dx, bound.fMinY, c0 * m_dz), float3(r1 * m_dx, bound.fMaxY, c1 * m_dz));
+}
+
+void NX::TerrainQuadTree::Select(const ViewFrustum &Frustum, const SelectParameter &Parameter, std::vector<ChunkSelection> &Selections) {
+	Selections.clear();
+	NXClearStruct(m_Statistics);
+	for (size_t i = 0; i < m_SelectedChunks.size(); ++i) {
+		m_SelectedLOD[m_SelectedChunks[i]] = -1;
+	}
+	m_SelectedChunks.clear();
+
+	SelectNode(Frustum, Parameter, (int)m_Pyramid.size() - 1, 0, 0);
+	std::sort(m_SelectedChunks.begin(), m_SelectedChunks.end());
+
+	{//restrict neighbours to one level apart, only ever refining so the error bound still holds
+		bool bChanged = true;
+		while (bChanged) {
+			bChanged = false;
+			for (size_t i = 0; i < m_SelectedChunks.size(); ++i) {
+				const int iChunk = m_SelectedChunks[i];
+				const int cr = iChunk / m_iChunkColCount, cc = iChunk % m_iChunkColCount;
+				int &iLOD = m_SelectedLOD[iChunk];
+				const int Neighbours[4] = {
+					cr > 0                    ? m_SelectedLOD[iChunk - m_iChunkColCount] : -1,
+					cr < m_iChunkRowCount - 1 ? m_SelectedLOD[iChunk + m_iChunkColCount] : -1,
+					cc > 0                    ? m_SelectedLOD[iChunk - 1] : -1,
+					cc < m_iChunkColCount - 1 ? m_SelectedLOD[iChunk + 1] : -1,
+				};
+				for (int n = 0; n < 4; ++n) {
+					if (Neighbours[n] >= 0 && iLOD > Neighbours[n] + 1) {
+						iLOD = Neighbours[n] + 1;
+						bChanged = true;
+					}
+				}
+			}
+		}
+	}
+
+	Selections.reserve(m_SelectedChunks.size());
+	for (size_t i = 0; i < m_SelectedChunks.size(); ++i) {
+		const int iChunk = m_SelectedChunks[i];
+		const int cr = iChunk / m_iChunkColCount, cc = iChunk % m_iChunkColCount;
+		ChunkSelection selection;
+		selection.iChunkRow    = cr;
+		selection.iChunkCol    = cc;
+		selection.iLOD         = m_SelectedLOD[iChunk];
+		selection.fScreenError = m_ChunkErrors[iChunk * m_iLODCount + selection.iLOD] * m_SelectedErrors[iChunk];
+		selection.iStitchMask  = 0;
+		if (cr > 0 && m_SelectedLOD[iChunk - m_iChunkColCount] > selection.iLOD) {
+			selection.iStitchMask |= STITCH_ROW_MIN;
+		}
+		if (cr < m_iChunkRowCount - 1 && m_SelectedLOD[iChunk + m_iChunkColCount] > selection.iLOD) {
+			selection.iStitchMask |= STITCH_ROW_MAX;
+		}
+		if (cc > 0 && m_SelectedLOD[iChunk - 1] > selection.iLOD) {
+			selection.iStitchMask |= STITCH_COL_MIN;
+		}
+		if (cc < m_iChunkColCount - 1 && m_SelectedLOD[iChunk + 1] > selection.iLOD) {
+			selection.iStitchMask |= STITCH_COL_MAX;
+		}
+		Selections.push_back(selection);
+		m_Statistics.iTriangleCount += GetChunkTriangleCount(cr, cc, selection.iLOD);
+	}
+	m_Statistics.iSelectedChunks = (int)Selections.size();
+}
+
+void NX::TerrainQuadTree::SelectNode(const ViewFrustum &Frustum, const SelectParameter &Parameter, const int iLevel, const int iNodeRow, const int iNodeCol) {
+	++m_Statistics.iVisitedNodes;
+	const AABB box = GetNodeAABB(iLevel, iNodeRow, iNodeCol);
+	if (!Frustum.Visible(box)) {
+		++m_Statistics.iCulledNodes;
+		return;
+	}
+
+	if (iLevel > 0) {
+		const int iRows = m_PyramidSize[iLevel - 1].first, iCols = m_PyramidSize[iLevel - 1].second;
+		for (int i = 0; i < 4; ++i) {
+			const int r = 2 * iNodeRow + (i >> 1), c = 2 * iNodeCol + (i & 1);
+			if (r < iRows && c < iCols) {
+				SelectNode(Frustum, Parameter, iLevel - 1, r, c);
+			}
+		}
+		return;
+	}
+
+	{//leaf chunk: coarsest level whose projected error stays below the threshold
+		const float3 MinPoint = box.GetMinPoint(), MaxPoint = box.GetMaxPoint();
+		const float  ex = NXMax(NXMax(MinPoint.x - Parameter.Eye.x, 0.f), Parameter.Eye.x - MaxPoint.x);
+		const float  ey = NXMax(NXMax(MinPoint.y - Parameter.Eye.y, 0.f), Parameter.Eye.y - MaxPoint.y);
+		const float  ez = NXMax(NXMax(MinPoint.z - Parameter.Eye.z, 0.f), Parameter.Eye.z - MaxPoint.z);
+		const float  fScale = Parameter.fErrorScale / NXMax(std::sqrt(ex * ex + ey * ey + ez * ez), 1e-4f);
+
+		const int    iChunk  = GetChunkIndex(iNodeRow, iNodeCol);
+		const float *pErrors = &m_ChunkErrors[iChunk * m_iLODCount];
+		const int    iMaxLOD = NXMin(Parameter.iMaxLOD, m_iLODCount - 1);
+		int iLOD = NXMax(0, NXMin(Parameter.iMinLOD, iMaxLOD));
+		while (iLOD < iMaxLOD && pErrors[iLOD + 1] * fScale <= Parameter.fPixelError) {
+			++iLOD;
+		}
+		m_SelectedLOD[iChunk]    = iLOD;
+		m_SelectedErrors[iChunk] = fScale;
+		m_SelectedChunks.push_back(iChunk);
+	}
+}
+
+void NX::TerrainQuadTree::BuildChunkIndexs(const int iCellRows, const int iCellCols, const int iLOD, const int iStitchMask, std::vector<NXUInt16> &Indexs, MeshOptimizer::Report *pReport) {
+	NXAssert((iCellRows + 1) * (iCellCols + 1) <= 65536);
+	Indexs.clear();
+	const int s = 1 << iLOD, S = s << 1;
+	auto Index = [&](int r, int c) -> NXUInt16 {
+		if ((r == 0 && (iStitchMask & STITCH_ROW_MIN)) || (r == iCellRows && (iStitchMask & STITCH_ROW_MAX))) {
+			c = SnapToStep(c, S, iCellCols);
+		}
+		if ((c == 0 && (iStitchMask & STITCH_COL_MIN)) || (c == iCellCols && (iStitchMask & STITCH_COL_MAX))) {
+			r = SnapToStep(r, S, iCellRows);
+		}
+		return (NXUInt16)(r * (iCellCols + 1) + c);
+	};
+	auto Emit = [&](const NXUInt16 a, const NXUInt16 b, const NXUInt16 c) {
+		if (a != b && b != c && a != c) {
+			Indexs.push_back(a);
+			Indexs.push_back(b);
+			Indexs.push_back(c);
+		}
+	};
+
+	for (int r0 = 0; r0 < iCellRows; r0 += s) {
+		const int r1 = NXMin(r0 + s, iCellRows);
+		for (int c0 = 0; c0 < iCellCols; c0 += s) {
+			const int c1 = NXMin(c0 + s, iCellCols);
+			const NXUInt16 i00 = Index(r0, c0), i01 = Index(r0, c1), i10 = Index(r1, c0), i11 = Index(r1, c1);
+			Emit(i00, i01, i10);
+			Emit(i10, i01, i11);
+		}
+	}
+
+	if (!Indexs.empty()) {//row by row order misses on every vertex of the previous row once a row outgrows the cache
+		const int iVertexCount = (iCellRows + 1) * (iCellCols + 1);
+		if (pReport) {
+			pReport->Before = MeshOptimizer::AnalyzeVertexCache(&Indexs[0], (int)Indexs.size(), iVertexCount);
+		}
+		MeshOptimizer::OptimizeVertexCache(&Indexs[0], (int)Indexs.size(), iVertexCount);
+		if (pReport) {
+			pReport->After  = MeshOptimizer::AnalyzeVertexCache(&Indexs[0], (int)Indexs.size(), iVertexCount);
+		}
+	}
+}
+
+int NX::TerrainQuadTree::GetChunkCells() const {
+	return m_iChunkCells;
+}
+
+int NX::TerrainQuadTree::GetChunkRowCount() const {
+	return m_iChunkRowCount;
+}
+
+int NX::TerrainQuadTree::GetChunkColCount() const {
+	return m_iChunkColCount;
+}
+
+int NX::TerrainQuadTree::GetLODCount() const {
+	return m_iLODCount;
+}
+
+void NX::TerrainQuadTree::GetChunkCellRange(const int iChunkRow, const int iChunkCol, int &iFirstRow, int &iFirstCol, int &iCellRows, int &iCellCols) const {
+	NXAssert(iChunkRow >= 0 && iChunkRow < m_iChunkRowCount && iChunkCol >= 0 && iChunkCol < m_iChunkColCount);
+	iFirstRow = iChunkRow * m_iChunkCells;
+	iFirstCol = iChunkCol * m_iChunkCells;
+	iCellRows = NXMin(m_iChunkCells, m_iRowCount - 1 - iFirstRow);
+	iCellCols = NXMin(m_iChunkCells, m_iColCount - 1 - iFirstCol);
+}
+
+NX::AABB NX::TerrainQuadTree::GetChunkAABB(const int iChunkRow, const int iChunkCol) const {
+	return GetNodeAABB(0, iChunkRow, iChunkCol);
+}
+
+float NX::TerrainQuadTree::GetChunkError(const int iChunkRow, const int iChunkCol, const int iLOD) const {
+	NXAssert(iLOD >= 0 && iLOD < m_iLODCount);
+	return m_ChunkErrors[GetChunkIndex(iChunkRow, iChunkCol) * m_iLODCount + iLOD];
+}
+
+int NX::TerrainQuadTree::GetChunkTriangleCount(const int iChunkRow, const int iChunkCol, const int iLOD) const {
+	int iFirstRow, iFirstCol, iCellRows, iCellCols;
+	GetChunkCellRange(iChunkRow, iChunkCol, iFirstRow, iFirstCol, iCellRows, iCellCols);
+	const int s = 1 << iLOD;
+	return 2 * ((iCellRows + s - 1) / s) * ((iCellCols + s - 1) / s);
+}
+
+const NX::TerrainQuadTree::Statistics& NX::TerrainQuadTree::GetStatistics() const {
+	return m_Statistics;
+}
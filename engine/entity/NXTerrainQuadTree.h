@@ -0,0 +1,155 @@
+/*
+ *  File:    NXTerrainQuadTree.h
+ *
+ *  author:  张雄(zhang xiong, 1025679612@qq.com)
+ *  date:    2026_10_19
+ *  purpose: split a heightfield into fixed size chunks and pick a geomipmap level for every visible chunk,
+ *           a min/max quadtree over the chunks culls whole regions against the view frustum. no D3D in here,
+ *           so the selection can be driven and inspected without a device.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "../math/NXVector.h"
+#include "../math/NXAABB.h"
+#include "../common/NXType.h"
+#include "../render/NXMeshOptimizer.h"
+
+namespace NX {
+	class ViewFrustum;
+
+	class TerrainQuadTree {
+	public:
+		enum STITCH_EDGE {//an edge flagged here borders a chunk one level coarser
+			STITCH_ROW_MIN     = 1 << 0,     // neighbour at chunk row - 1 (smaller x)
+			STITCH_ROW_MAX     = 1 << 1,     // neighbour at chunk row + 1 (larger x)
+			STITCH_COL_MIN     = 1 << 2,     // neighbour at chunk col - 1 (smaller z)
+			STITCH_COL_MAX     = 1 << 3,     // neighbour at chunk col + 1 (larger z)
+			STITCH_COMBINATION = 16,
+		};
+
+		struct ChunkSelection {
+			int     iChunkRow;
+			int     iChunkCol;
+			int     iLOD;                    // 0 draws every cell, level l steps 2^l cells
+			int     iStitchMask;             // STITCH_EDGE bits
+			float   fScreenError;            // projected error of iLOD in pixels
+		};
+
+		struct SelectParameter {
+			float3  Eye;                     // in terrain space
+			float   fErrorScale;             // pixels per unit of error at distance 1, 0.5 * viewport height * Project[1][1]
+			float   fPixelError;             // largest accepted projected error
+			int     iMinLOD;                 // clamp range for the chosen levels
+			int     iMaxLOD;
+		};
+
+		struct Statistics {
+			int     iVisitedNodes;
+			int     iCulledNodes;
+			int     iSelectedChunks;
+			int     iTriangleCount;
+		};
+
+	public:
+		/**
+		 *  iRowCount x iColCount vertices, vertex (r, c) lies at (r * dx, height, c * dz),
+		 *  iChunkCells must be a power of 2, every chunk owns iChunkCells x iChunkCells cells
+		 *  (the last chunk row/col keeps the remainder)
+		 */
+		TerrainQuadTree(const int iRowCount, const int iColCount, const float dx, const float dz, const int iChunkCells = 64);
+		virtual ~TerrainQuadTree();
+
+	public:
+		/**
+		 *  compute chunk bounds and per level geometric errors, height of vertex (r, c) is
+		 *  pHeights[r * iRowStride + c * iColStride]. chunks are processed in parallel.
+		 */
+		void  Build(const float *pHeights, const int iColStride, const int iRowStride);
+
+		/**
+		 *  refresh every chunk touching vertex rows [r0, r1] and cols [c0, c1] after an edit
+		 */
+		void  UpdateRegion(const float *pHeights, const int iColStride, const int iRowStride, const int r0, const int c0, const int r1, const int c1);
+
+		/**
+		 *  refresh only the min/max bounds of the chunks touching vertex rows [r0, r1] and cols [c0, c1],
+		 *  cheap enough for interactive edits, the level errors keep their old values until UpdateRegion/UpdateChunks
+		 */
+		void  UpdateBounds(const float *pHeights, const int iColStride, const int iRowStride, const int r0, const int c0, const int r1, const int c1);
+
+		/**
+		 *  widen the bounds of the chunks holding vertex (r, c) so they contain h, for single height writes.
+		 *  the bounds may stay looser than needed until the chunks are rebuilt
+		 */
+		void  ExpandBounds(const int r, const int c, const float h);
+
+		/**
+		 *  refresh a list of chunks (chunk row * chunk col count + chunk col)
+		 */
+		void  UpdateChunks(const float *pHeights, const int iColStride, const int iRowStride, const std::vector<int> &Chunks);
+
+		/**
+		 *  cull and pick levels, the result is ordered by chunk row then col,
+		 *  neighbouring selected chunks never differ by more than one level
+		 */
+		void  Select(const ViewFrustum &Frustum, const SelectParameter &Parameter, std::vector<ChunkSelection> &Selections);
+
+	public:
+		int    GetChunkCells() const;
+		int    GetChunkRowCount() const;
+		int    GetChunkColCount() const;
+		int    GetLODCount() const;
+		void   GetChunkCellRange(const int iChunkRow, const int iChunkCol, int &iFirstRow, int &iFirstCol, int &iCellRows, int &iCellCols) const;
+		AABB   GetChunkAABB(const int iChunkRow, const int iChunkCol) const;
+		float  GetChunkError(const int iChunkRow, const int iChunkCol, const int iLOD) const;
+		int    GetChunkTriangleCount(const int iChunkRow, const int iChunkCol, const int iLOD) const;
+		const Statistics& GetStatistics() const;
+
+	public://min/max pyramid over the chunks, level 0 has one node per chunk, every level halves rows and cols
+		int    GetPyramidLevelCount() const;
+		void   GetPyramidSize(const int iLevel, int &iNodeRows, int &iNodeCols) const;
+		AABB   GetNodeAABB(const int iLevel, const int iNodeRow, const int iNodeCol) const;
+
+	public:
+		/**
+		 *  triangle list for one chunk of iCellRows x iCellCols cells at level iLOD, indexs address the
+		 *  chunk's own (iCellRows + 1) x (iCellCols + 1) row-major vertices. vertices on a stitched edge
+		 *  collapse onto the next coarser level so no crack opens, degenerate triangles are dropped.
+		 *  the triangles are reordered for the post transform cache, pReport (may be nullptr) receives
+		 *  the simulated cache statistics before and after.
+		 */
+		static void BuildChunkIndexs(const int iCellRows, const int iCellCols, const int iLOD, const int iStitchMask, std::vector<NXUInt16> &Indexs, MeshOptimizer::Report *pReport = nullptr);
+
+	private:
+		struct Bound {
+			float    fMinY;
+			float    fMaxY;
+		};
+
+		void   BuildChunk(const float *pHeights, const int iColStride, const int iRowStride, const int iChunkRow, const int iChunkCol);
+		void   BuildChunkBound(const float *pHeights, const int iColStride, const int iRowStride, const int iChunkRow, const int iChunkCol);
+		void   BuildPyramid(const int cr0, const int cc0, const int cr1, const int cc1);
+		void   SelectNode(const ViewFrustum &Frustum, const SelectParameter &Parameter, const int iLevel, const int iNodeRow, const int iNodeCol);
+		int    GetChunkIndex(const int iChunkRow, const int iChunkCol) const;
+
+	private:
+		int                                  m_iRowCount;
+		int                                  m_iColCount;
+		float                                m_dx;
+		float                                m_dz;
+		int                                  m_iChunkCells;
+		int                                  m_iChunkRowCount;
+		int                                  m_iChunkColCount;
+		int                                  m_iLODCount;
+		std::vector<float>                   m_ChunkErrors;      // [chunk * m_iLODCount + lod]
+		std::vector<std::vector<Bound> >     m_Pyramid;          // level 0 holds one bound per chunk
+		std::vector<std::pair<int, int> >    m_PyramidSize;      // (rows, cols) of every level
+		std::vector<int>                     m_SelectedLOD;      // scratch for Select, -1 when not selected
+		std::vector<int>                     m_SelectedChunks;   // scratch for Select
+		std::vector<float>                   m_SelectedErrors;   // scratch for Select
+		Statistics                           m_Statistics;
+	};
+}
@@ -0,0 +1,358 @@
+/*
+ *  File:    NXTerrainStreamer.cpp
+ *
+ *  author:  张雄(zhang xiong, 1025679612@qq.com)
+ *  date:    2026_10_19
+ *  purpose: heightfield tile streaming
+ */
+
+#include <cmath>
+#include <algorithm>
+
+#include "NXTerrainStreamer.h"
+#include "../common/NXCore.h"
+#include "../math/NXMath.h"
+
+NX::TerrainStreamer::TerrainStreamer(const int iCacheTiles, const int iResidentRadius, const int iPrefetchDepth) {
+	NXAssert(iResidentRadius >= 0 && iPrefetchDepth >= 0);
+	m_iResidentRadius         = iResidentRadius;
+	m_iPrefetchDepth          = iPrefetchDepth;
+	m_iCacheTiles             = NXMax(iCacheTiles, (2 * iResidentRadius + 1) * (2 * iResidentRadius + 1));
+	m_uFrame                  = 0;
+	m_bHasLastEye             = false;
+	m_MoveDirection           = float2(0.f, 0.f);
+	m_iLoadingTile            = -1;
+	m_bQuit                   = false;
+	m_fTotalLoadMilliseconds  = 0.0;
+	NXClearStruct(m_Statistics);
+}
+
+NX::TerrainStreamer::~TerrainStreamer() {
+	Close();
+}
+
+bool NX::TerrainStreamer::Open(const std::string &strFilePath) {
+	Close();
+	if (!m_File.Open(strFilePath)) {
+		return false;
+	}
+
+	Slot Empty;
+	Empty.iTile    = -1;
+	Empty.uLastUse = 0;
+	m_Slots.assign(m_iCacheTiles, Empty);
+	for (size_t i = 0; i < m_Slots.size(); ++i) {
+		m_Slots[i].Heights.resize(m_File.GetTileSampleCount());
+	}
+	m_TileToSlot.clear();
+	m_uFrame      = 0;
+	m_bHasLastEye = false;
+	StartLoader();
+	return true;
+}
+
+void NX::TerrainStreamer::Close() {
+	StopLoader();
+	m_Slots.clear();
+	m_TileToSlot.clear();
+	m_Pending.clear();
+	m_Loaded.clear();
+	m_FreeBuffers.clear();
+	m_File.Close();
+}
+
+const NX::HeightFieldTileFile& NX::TerrainStreamer::GetFile() const {
+	return m_File;
+}
+
+void NX::TerrainStreamer::StartLoader() {
+	m_bQuit        = false;
+	m_iLoadingTile = -1;
+	m_Loader       = std::thread(&TerrainStreamer::LoaderMain, this);
+}
+
+void NX::TerrainStreamer::StopLoader() {
+	if (!m_Loader.joinable()) {
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> Lock(m_Mutex);
+		m_bQuit = true;
+	}
+	m_WakeUp.notify_all();
+	m_Loader.join();
+}
+
+void NX::TerrainStreamer::LoaderMain() {
+	std::unique_lock<std::mutex> Lock(m_Mutex);
+	for (;;) {
+		m_WakeUp.wait(Lock, [this]() { return m_bQuit || !m_Pending.empty(); });
+		if (m_bQuit) {
+			break;
+		}
+
+		LoadedTile Loaded;
+		Loaded.Source  = m_Pending.front();
+		m_Pending.pop_front();
+		m_iLoadingTile = Loaded.Source.iTile;
+		if (!m_FreeBuffers.empty()) {
+			Loaded.Heights.swap(m_FreeBuffers.back());
+			m_FreeBuffers.pop_back();
+		}
+		Lock.unlock();
+
+		{//copy out of the mapping, the page faults happen here instead of on the owner thread
+			const int iTileColCount = m_File.GetHeader().iTileColCount;
+			const float *pSource = m_File.GetTileData(Loaded.Source.iTile / iTileColCount, Loaded.Source.iTile % iTileColCount);
+			Loaded.Heights.assign(pSource, pSource + m_File.GetTileSampleCount());
+		}
+
+		Lock.lock();
+		m_Loaded.push_back(LoadedTile());
+		m_Loaded.back().Source = Loaded.Source;
+		m_Loaded.back().Heights.swap(Loaded.Heights);
+		m_iLoadingTile = -1;
+		m_Idle.notify_all();
+	}
+}
+
+void NX::TerrainStreamer::CommitLoadedTiles() {
+	std::vector<LoadedTile> Loaded;
+	{
+		std::lock_guard<std::mutex> Lock(m_Mutex);
+		Loaded.swap(m_Loaded);
+	}
+
+	const Clock::time_point Now = Clock::now();
+	for (size_t i = 0; i < Loaded.size(); ++i) {
+		LoadedTile &tile = Loaded[i];
+		if (GetResidentSlot(tile.Source.iTile) < 0) {
+			const int iSlot = FindVictimSlot();
+			if (iSlot < 0) {
+				m_Statistics.uDroppedLoads += 1;
+			} else {
+				Slot &slot = m_Slots[iSlot];
+				if (slot.iTile >= 0) {
+					m_TileToSlot.erase(slot.iTile);
+					m_Statistics.uEvictions += 1;
+				}
+				slot.iTile    = tile.Source.iTile;
+				slot.uLastUse = m_uFrame;
+				slot.Heights.swap(tile.Heights);
+				m_TileToSlot[slot.iTile] = iSlot;
+
+				const float fMilliseconds = std::chrono::duration<float, std::milli>(Now - tile.Source.Time).count();
+				m_Statistics.uLoads                   += 1;
+				m_Statistics.uPrefetchLoads           += tile.Source.bPrefetch ? 1 : 0;
+				m_Statistics.fLastLoadMilliseconds     = fMilliseconds;
+				m_Statistics.fMaxLoadMilliseconds      = NXMax(m_Statistics.fMaxLoadMilliseconds, fMilliseconds);
+				m_fTotalLoadMilliseconds              += fMilliseconds;
+				m_Statistics.fAverageLoadMilliseconds  = (float)(m_fTotalLoadMilliseconds / m_Statistics.uLoads);
+			}
+		}
+	}
+
+	{//hand the buffers back to the loader
+		std::lock_guard<std::mutex> Lock(m_Mutex);
+		for (size_t i = 0; i < Loaded.size(); ++i) {
+			m_FreeBuffers.push_back(std::vector<float>());
+			m_FreeBuffers.back().swap(Loaded[i].Heights);
+		}
+	}
+	m_Statistics.iResidentTiles = (int)m_TileToSlot.size();
+}
+
+int NX::TerrainStreamer::FindVictimSlot() const {
+	//an empty slot first, otherwise the least recently used tile that the current frame doesn't need
+	int iVictim = -1;
+	for (size_t i = 0; i < m_Slots.size(); ++i) {
+		if (m_Slots[i].iTile < 0) {
+			return (int)i;
+		}
+		if (m_Slots[i].uLastUse < m_uFrame && (iVictim < 0 || m_Slots[i].uLastUse < m_Slots[iVictim].uLastUse)) {
+			iVictim = (int)i;
+		}
+	}
+	return iVictim;
+}
+
+int NX::TerrainStreamer::GetResidentSlot(const int iTile) const {
+	std::unordered_map<int, int>::const_iterator it = m_TileToSlot.find(iTile);
+	return it == m_TileToSlot.end() ? -1 : it->second;
+}
+
+bool NX::TerrainStreamer::IsRequested(const int iTile) const {
+	//m_Mutex held by the caller
+	if (m_iLoadingTile == iTile) {
+		return true;
+	}
+	for (size_t i = 0; i < m_Pending.size(); ++i) {
+		if (m_Pending[i].iTile == iTile) {
+			return true;
+		}
+	}
+	for (size_t i = 0; i < m_Loaded.size(); ++i) {
+		if (m_Loaded[i].Source.iTile == iTile) {
+			return true;
+		}
+	}
+	return false;
+}
+
+void NX::TerrainStreamer::RequestMissingTile(const int iTile) {
+	{
+		std::lock_guard<std::mutex> Lock(m_Mutex);
+		if (IsRequested(iTile)) {
+			return;
+		}
+		Request request = { iTile, false, true, Clock::now() };
+		m_Pending.push_front(request);
+		m_Statistics.iPendingRequests = (int)m_Pending.size();
+	}
+	m_WakeUp.notify_one();
+}
+
+void NX::TerrainStreamer::Update(const float3 &Eye) {
+	if (!m_File.IsOpen()) {
+		return;
+	}
+	m_uFrame += 1;
+	CommitLoadedTiles();
+
+	const HeightFieldTileFile::Header &header = m_File.GetHeader();
+	const float fTileSizeX = header.iTileCells * header.fDX, fTileSizeZ = header.iTileCells * header.fDZ;
+	{//movement direction, kept while the camera stands still
+		if (m_bHasLastEye) {
+			const float fMoveX = Eye.x - m_LastEye.x, fMoveZ = Eye.z - m_LastEye.z;
+			const float fLength = std::sqrt(fMoveX * fMoveX + fMoveZ * fMoveZ);
+			if (fLength > 1e-4f * NXMin(fTileSizeX, fTileSizeZ)) {
+				m_MoveDirection = float2(fMoveX / fLength, fMoveZ / fLength);
+			}
+		}
+		m_LastEye     = Eye;
+		m_bHasLastEye = true;
+	}
+
+	struct Wanted {
+		int     iTile;
+		bool    bPrefetch;
+		float   fDistance;
+		bool operator < (const Wanted &rhs) const {
+			return bPrefetch != rhs.bPrefetch ? !bPrefetch : fDistance < rhs.fDistance;
+		}
+	};
+	std::vector<Wanted> WantedTiles;
+	{//resident square around the camera tile, then the rings ahead of the movement
+		const float fTileRow = Eye.x / fTileSizeX, fTileCol = Eye.z / fTileSizeZ;
+		const int   iEyeRow  = NXMin(NXMax((int)std::floor(fTileRow), 0), header.iTileRowCount - 1);
+		const int   iEyeCol  = NXMin(NXMax((int)std::floor(fTileCol), 0), header.iTileColCount - 1);
+		const int   iRadius  = m_iResidentRadius + m_iPrefetchDepth;
+		for (int tr = NXMax(iEyeRow - iRadius, 0); tr <= NXMin(iEyeRow + iRadius, header.iTileRowCount - 1); ++tr) {
+			for (int tc = NXMax(iEyeCol - iRadius, 0); tc <= NXMin(iEyeCol + iRadius, header.iTileColCount - 1); ++tc) {
+				const float fDeltaRow = tr + 0.5f - fTileRow, fDeltaCol = tc + 0.5f - fTileCol;
+				const float fDistance = std::sqrt(fDeltaRow * fDeltaRow + fDeltaCol * fDeltaCol);
+				Wanted wanted = { tr * header.iTileColCount + tc, NXMax(NXAbs(tr - iEyeRow), NXAbs(tc - iEyeCol)) > m_iResidentRadius, fDistance };
+				if (wanted.bPrefetch && (fDistance <= 0.f || (fDeltaRow * m_MoveDirection.x + fDeltaCol * m_MoveDirection.y) < 0.7f * fDistance)) {
+					continue;
+				}
+				WantedTiles.push_back(wanted);
+			}
+		}
+		std::sort(WantedTiles.begin(), WantedTiles.end());
+	}
+
+	{//keep wanted tiles alive, queue the missing ones nearest first after the misses, drop stale requests
+		std::lock_guard<std::mutex> Lock(m_Mutex);
+		std::deque<Request> Previous;
+		Previous.swap(m_Pending);
+		std::unordered_map<int, Clock::time_point> RequestTimes;
+		for (size_t i = 0; i < Previous.size(); ++i) {
+			if (Previous[i].bMiss) {
+				m_Pending.push_back(Previous[i]);
+			} else {
+				RequestTimes[Previous[i].iTile] = Previous[i].Time;
+			}
+		}
+
+		const Clock::time_point Now = Clock::now();
+		for (size_t i = 0; i < WantedTiles.size(); ++i) {
+			const int iSlot = GetResidentSlot(WantedTiles[i].iTile);
+			if (iSlot >= 0) {
+				m_Slots[iSlot].uLastUse = m_uFrame;
+			} else if (!IsRequested(WantedTiles[i].iTile) && (int)m_Pending.size() < m_iCacheTiles) {
+				std::unordered_map<int, Clock::time_point>::const_iterator it = RequestTimes.find(WantedTiles[i].iTile);
+				Request request = { WantedTiles[i].iTile, WantedTiles[i].bPrefetch, false, it == RequestTimes.end() ? Now : it->second };
+				m_Pending.push_back(request);
+			}
+		}
+		m_Statistics.iPendingRequests = (int)m_Pending.size();
+	}
+	m_WakeUp.notify_one();
+}
+
+void NX::TerrainStreamer::Flush() {
+	{
+		std::unique_lock<std::mutex> Lock(m_Mutex);
+		m_Idle.wait(Lock, [this]() { return m_Pending.empty() && m_iLoadingTile < 0; });
+		m_Statistics.iPendingRequests = 0;
+	}
+	CommitLoadedTiles();
+}
+
+bool NX::TerrainStreamer::GetHeight(const float x, const float z, float &fHeight) {
+	if (!m_File.IsOpen()) {
+		return false;
+	}
+	const HeightFieldTileFile::Header &header = m_File.GetHeader();
+	const float fr = NXMin(NXMax(x / header.fDX, 0.f), (float)(header.iRowCount - 1));
+	const float fc = NXMin(NXMax(z / header.fDZ, 0.f), (float)(header.iColCount - 1));
+	const int   tr = NXMin((int)fr / header.iTileCells, header.iTileRowCount - 1);
+	const int   tc = NXMin((int)fc / header.iTileCells, header.iTileColCount - 1);
+	const float *pTile = GetTile(tr, tc);
+	if (!pTile) {
+		return false;
+	}
+
+	//same split as HeightField::GetHeight, in tile local grid coordinates
+	const int   iSide = header.iTileCells + 1;
+	const float lr = fr - tr * header.iTileCells, lc = fc - tc * header.iTileCells;
+	const int   r  = NXMin((int)lr, header.iTileCells - 1), c = NXMin((int)lc, header.iTileCells - 1);
+	const float u  = lr - r, v = lc - c;
+	const float *p = pTile + r * iSide + c;
+	const float h00 = p[0], h01 = p[1], h10 = p[iSide], h11 = p[iSide + 1];
+	if (u + v <= 1.f) {
+		fHeight = h00 + u * (h10 - h00) + v * (h01 - h00);
+	} else {
+		fHeight = h11 + (1.f - u) * (h01 - h11) + (1.f - v) * (h10 - h11);
+	}
+	return true;
+}
+
+const float* NX::TerrainStreamer::GetTile(const int iTileRow, const int iTileCol) {
+	const int iTile = iTileRow * m_File.GetHeader().iTileColCount + iTileCol;
+	const int iSlot = GetResidentSlot(iTile);
+	if (iSlot < 0) {
+		m_Statistics.uMisses += 1;
+		RequestMissingTile(iTile);
+		return nullptr;
+	}
+	m_Statistics.uHits += 1;
+	m_Slots[iSlot].uLastUse = m_uFrame;
+	return &m_Slots[iSlot].Heights[0];
+}
+
+bool NX::TerrainStreamer::IsResident(const int iTileRow, const int iTileCol) const {
+	return GetResidentSlot(iTileRow * m_File.GetHeader().iTileColCount + iTileCol) >= 0;
+}
+
+const NX::TerrainStreamer::Statistics& NX::TerrainStreamer::GetStatistics() const {
+	return m_Statistics;
+}
+
+void NX::TerrainStreamer::ResetStatistics() {
+	const int iResident = m_Statistics.iResidentTiles, iPending = m_Statistics.iPendingRequests;
+	NXClearStruct(m_Statistics);
+	m_Statistics.iResidentTiles   = iResident;
+	m_Statistics.iPendingRequests = iPending;
+	m_fTotalLoadMilliseconds      = 0.0;
+}
@@ -0,0 +1,141 @@
+/*
+ *  File:    NXTerrainStreamer.h
+ *
+ *  author:  张雄(zhang xiong, 1025679612@qq.com)
+ *  date:    2026_10_19
+ *  purpose: page heightfield tiles of a memory mapped HeightFieldTileFile in and out around the camera.
+ *           a background thread copies requested tiles out of the mapping (taking the page faults),
+ *           the owner thread commits finished tiles into a fixed number of cache slots during Update
+ *           and evicts the least recently used ones. except for the loader thread every method must be
+ *           called from the owner thread, tiles are only written during Update.
+ */
+
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <chrono>
+#include <unordered_map>
+#include <condition_variable>
+
+#include "NXHeightFieldTileFile.h"
+#include "../math/NXVector.h"
+
+namespace NX {
+	class TerrainStreamer {
+	public:
+		struct Statistics {
+			NXUInt64    uHits;                     // GetHeight/GetTile calls served by a resident tile
+			NXUInt64    uMisses;                   // GetHeight/GetTile calls on a tile that was not resident
+			NXUInt64    uLoads;                    // tiles committed to the cache
+			NXUInt64    uPrefetchLoads;            // of those, loaded by the prefetch ring
+			NXUInt64    uEvictions;                // resident tiles replaced by another tile
+			NXUInt64    uDroppedLoads;             // finished loads thrown away because every slot was in use this frame
+			int         iResidentTiles;
+			int         iPendingRequests;          // waiting for the loader thread
+			float       fLastLoadMilliseconds;     // request to commit of the last committed tile
+			float       fAverageLoadMilliseconds;
+			float       fMaxLoadMilliseconds;
+		};
+
+	public:
+		/**
+		 *  iCacheTiles slots are allocated up front, tiles within iResidentRadius (in tiles, chebyshev distance)
+		 *  of the camera tile are requested every Update, tiles up to iPrefetchDepth rings further out are
+		 *  prefetched when they lie ahead of the movement direction. iCacheTiles is raised to at least
+		 *  (2 * iResidentRadius + 1)^2 so the resident square always fits.
+		 */
+		TerrainStreamer(const int iCacheTiles = 64, const int iResidentRadius = 2, const int iPrefetchDepth = 2);
+		virtual ~TerrainStreamer();
+
+	public:
+		bool  Open(const std::string &strFilePath);
+		void  Close();
+		const HeightFieldTileFile& GetFile() const;
+
+		/**
+		 *  commit finished loads and queue the tiles around Eye (terrain space, y is ignored),
+		 *  requests that are no longer wanted and not yet started are dropped
+		 */
+		void  Update(const float3 &Eye);
+
+		/**
+		 *  block until every queued request is loaded, then commit them, for loading screens and tools
+		 */
+		void  Flush();
+
+	public:
+		/**
+		 *  height at (x, z) if its tile is resident, otherwise the tile is requested and false returned
+		 */
+		bool  GetHeight(const float x, const float z, float &fHeight);
+
+		/**
+		 *  (cells + 1)^2 row-major heights of a resident tile or nullptr after requesting it,
+		 *  the pointer stays valid until the next Update
+		 */
+		const float* GetTile(const int iTileRow, const int iTileCol);
+		bool  IsResident(const int iTileRow, const int iTileCol) const;
+
+	public:
+		const Statistics& GetStatistics() const;
+		void  ResetStatistics();
+
+	private:
+		typedef std::chrono::steady_clock Clock;
+
+		struct Slot {
+			int                    iTile;         // -1 when empty
+			NXUInt64               uLastUse;      // frame of the last Update/GetHeight that needed the tile
+			std::vector<float>     Heights;
+		};
+
+		struct Request {
+			int                    iTile;
+			bool                   bPrefetch;
+			bool                   bMiss;         // asked for by GetHeight/GetTile, survives Update
+			Clock::time_point      Time;          // first time the tile was asked for
+		};
+
+		struct LoadedTile {
+			Request                Source;
+			std::vector<float>     Heights;
+		};
+
+	private:
+		void  LoaderMain();
+		void  StartLoader();
+		void  StopLoader();
+		void  CommitLoadedTiles();
+		void  RequestMissingTile(const int iTile);
+		bool  IsRequested(const int iTile) const;
+		int   FindVictimSlot() const;
+		int   GetResidentSlot(const int iTile) const;
+
+	private:
+		HeightFieldTileFile                  m_File;
+		int                                  m_iCacheTiles;
+		int                                  m_iResidentRadius;
+		int                                  m_iPrefetchDepth;
+		std::vector<Slot>                    m_Slots;
+		std::unordered_map<int, int>         m_TileToSlot;
+		NXUInt64                             m_uFrame;
+		float3                               m_LastEye;
+		float2                               m_MoveDirection;     // normalized xz, zero until the camera moved
+		bool                                 m_bHasLastEye;
+		Statistics                           m_Statistics;
+		double                               m_fTotalLoadMilliseconds;
+
+		std::thread                          m_Loader;
+		mutable std::mutex                   m_Mutex;            // guards everything below
+		std::condition_variable              m_WakeUp;
+		std::condition_variable              m_Idle;
+		std::deque<Request>                  m_Pending;
+		std::vector<LoadedTile>              m_Loaded;
+		std::vector<std::vector<float> >     m_FreeBuffers;
+		int                                  m_iLoadingTile;
+		bool                                 m_bQuit;
+	};
+}
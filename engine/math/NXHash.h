@@ -0,0 +1,86 @@
+/*
+ *  File:    NXHash.h
+ *  author:  张雄
+ *  date:    2026_10_19
+ *  purpose: integer hashes shared by the procedural code (noise, heightfield generation, foliage scatter).
+ *           a lattice point is hashed from its integer coordinates and a seed, so no permutation table
+ *           depends on the seed. the SSE overloads give the same bits as the scalar ones in every lane.
+ */
+
+#ifndef __ZX_NXENGINE_HASH_H__
+#define __ZX_NXENGINE_HASH_H__
+
+#include "NXSIMD.h"
+#include "../common/NXType.h"
+
+namespace NX {
+    /**
+     *  full avalanche of a 32 bit value
+     */
+    inline NXUInt32 HashMix(NXUInt32 h){
+        h ^= h >> 16, h *= 0x7feb352du;
+        h ^= h >> 15, h *= 0x846ca68bu;
+        return h ^ (h >> 16);
+    }
+
+    /**
+     *  independent seed of stream uStream (an octave, a noise field...) derived from uSeed
+     */
+    inline NXUInt32 HashSeed(const NXUInt32 uSeed, const NXUInt32 uStream){
+        return HashMix(uSeed ^ HashMix(uStream));
+    }
+
+    inline NXUInt32 HashFinalize(NXUInt32 h){
+        h ^= h >> 15, h *= 0x2c1b3c6du;
+        h ^= h >> 12, h *= 0x297a2d39u;
+        return h ^ (h >> 15);
+    }
+
+    /**
+     *  lattice hashes, the multiplies keep neighbouring points and seeds uncorrelated
+     */
+    inline NXUInt32 HashLattice(const NXUInt32 ix, const NXUInt32 iy, const NXUInt32 uSeed){
+        return HashFinalize((ix * 0x8da6b343u) ^ (iy * 0xd8163841u) ^ uSeed);
+    }
+
+    inline NXUInt32 HashLattice(const NXUInt32 ix, const NXUInt32 iy, const NXUInt32 iz, const NXUInt32 uSeed){
+        return HashFinalize((ix * 0x8da6b343u) ^ (iy * 0xd8163841u) ^ (iz * 0xcb1ab31fu) ^ uSeed);
+    }
+
+    inline NXUInt32 HashLattice(const NXUInt32 ix, const NXUInt32 iy, const NXUInt32 iz, const NXUInt32 iw, const NXUInt32 uSeed){
+        return HashFinalize((ix * 0x8da6b343u) ^ (iy * 0xd8163841u) ^ (iz * 0xcb1ab31fu) ^ (iw * 0x165667b1u) ^ uSeed);
+    }
+
+    /**
+     *  top 24 bits of a hash to [0, 1)
+     */
+    inline float HashToUnitFloat(const NXUInt32 h){
+        return (h >> 8) * (1.f / 16777216.f);
+    }
+
+#if NX_SIMD_SSE
+    inline __m128i HashFinalize(__m128i h){
+        h = SIMDMulLo32(_mm_xor_si128(h, _mm_srli_epi32(h, 15)), _mm_set1_epi32(0x2c1b3c6d));
+        h = SIMDMulLo32(_mm_xor_si128(h, _mm_srli_epi32(h, 12)), _mm_set1_epi32(0x297a2d39));
+        return _mm_xor_si128(h, _mm_srli_epi32(h, 15));
+    }
+
+    inline __m128i HashLattice(const __m128i ix, const __m128i iy, const __m128i Seed){
+        const __m128i h = _mm_xor_si128(SIMDMulLo32(ix, _mm_set1_epi32((int)0x8da6b343u)), SIMDMulLo32(iy, _mm_set1_epi32((int)0xd8163841u)));
+        return HashFinalize(_mm_xor_si128(h, Seed));
+    }
+
+    inline __m128i HashLattice(const __m128i ix, const __m128i iy, const __m128i iz, const __m128i Seed){
+        const __m128i h = _mm_xor_si128(SIMDMulLo32(ix, _mm_set1_epi32((int)0x8da6b343u)), SIMDMulLo32(iy, _mm_set1_epi32((int)0xd8163841u)));
+        return HashFinalize(_mm_xor_si128(_mm_xor_si128(h, SIMDMulLo32(iz, _mm_set1_epi32((int)0xcb1ab31fu))), Seed));
+    }
+
+    inline __m128i HashLattice(const __m128i ix, const __m128i iy, const __m128i iz, const __m128i iw, const __m128i Seed){
+        const __m128i h = _mm_xor_si128(SIMDMulLo32(ix, _mm_set1_epi32((int)0x8da6b343u)), SIMDMulLo32(iy, _mm_set1_epi32((int)0xd8163841u)));
+        const __m128i g = _mm_xor_si128(SIMDMulLo32(iz, _mm_set1_epi32((int)0xcb1ab31fu)), SIMDMulLo32(iw, _mm_set1_epi32((int)0x165667b1u)));
+        return HashFinalize(_mm_xor_si128(_mm_xor_si128(h, g), Seed));
+    }
+#endif
+}
+
+#endif //!__ZX_NXENGINE_HASH_H__
@@ -0,0 +1,971 @@
+/*
+ *  File:    NXNoise.cpp
+ *  author:  张雄
+ *  date:    2026_10_19
+ *  purpose: simplex, value and curl noise
+ */
+
+#include "NXNoise.h"
+#include "NXHash.h"
+#include "NXSIMD.h"
+#include "../common/NXCore.h"
+#include <cmath>
+
+namespace {
+    const float kSkew2          = 0.36602540378f;     // (sqrt(3) - 1) / 2
+    const float kUnskew2        = 0.21132486540f;     // (3 - sqrt(3)) / 6
+    const float kSkew3          = 1.f / 3.f;
+    const float kUnskew3        = 1.f / 6.f;
+    const float kSkew4          = 0.30901699437f;     // (sqrt(5) - 1) / 4
+    const float kUnskew4        = 0.13819660113f;     // (5 - sqrt(5)) / 20
+    const float kSimplexScale2  = 45.23f;             // 1 / largest sum found by searching many seeds, keeps [-1, 1]
+    const float kSimplexScale3  = 76.88f;
+    const float kSimplexScale4  = 62.77f;
+    const float kGradientScale2 = 0.5f;               // the scale HeightFieldGenerator's heights were made with
+    const float kGradientScale3 = 0.96f;              // 1 / largest value found the same way, rounded down
+    const float kGradientScale4 = 0.78f;
+    const float kWarpOffsetX    = 5.2f;               // the second warp field is read away from the first
+    const float kWarpOffsetY    = 1.3f;
+    const float kLatticeScale   = 2.f / 16777216.f;   // 24 hash bits to [0, 2)
+
+    /**
+     *  the lane types the kernels are written over. every operation of the SSE lanes does what the float
+     *  one does, ties and signed zeros included, so both give the same bits
+     */
+    struct ScalarLanes {
+        typedef float       F;
+        typedef NXUInt32    I;
+        typedef bool        M;
+    };
+
+    inline float    Floor(const float v) {//same steps as NX::SIMDFloor
+        const float t = (float)(int)v;
+        return t > v ? t - 1.f : t;
+    }
+
+    inline float    Max(const float a, const float b) {//b on ties like maxps
+        return a > b ? a : b;
+    }
+
+    inline float    Min(const float a, const float b) {//b on ties like minps
+        return a < b ? a : b;
+    }
+
+    inline float    Abs(const float v) {//clears the sign bit like SIMDAbs
+        return std::fabs(v);
+    }
+
+    inline float    Select(const bool m, const float a, const float b) {
+        return m ? a : b;
+    }
+
+    inline float    Negate(const bool m, const float a) {//m ? -a : a
+        return m ? -a : a;
+    }
+
+    inline bool     GreaterEqual(const float a, const float b) {
+        return a >= b;
+    }
+
+    inline bool     And(const bool a, const bool b) {
+        return a && b;
+    }
+
+    inline bool     Or(const bool a, const bool b) {
+        return a || b;
+    }
+
+    inline bool     Not(const bool a) {
+        return !a;
+    }
+
+    inline NXUInt32 ToInt(const float v) {
+        return (NXUInt32)(int)v;
+    }
+
+    inline float    ToFloat(const NXUInt32 v) {
+        return (float)(int)v;
+    }
+
+    inline NXUInt32 MaskToInt(const bool m) {
+        return m ? 1u : 0u;
+    }
+
+    inline bool     TestBit(const NXUInt32 h, const NXUInt32 uBit) {
+        return (h & uBit) != 0;
+    }
+
+#if NX_SIMD_SSE
+    struct F4 {
+        __m128      v;
+        F4() {}
+        F4(const __m128 _v) : v(_v) {}
+        explicit F4(const float f) : v(_mm_set1_ps(f)) {}
+    };
+
+    struct I4 {
+        __m128i     v;
+        I4() {}
+        I4(const __m128i _v) : v(_v) {}
+        explicit I4(const NXUInt32 u) : v(_mm_set1_epi32((int)u)) {}
+    };
+
+    struct M4 {
+        __m128      v;
+        M4() {}
+        M4(const __m128 _v) : v(_v) {}
+    };
+
+    struct SSELanes {
+        typedef F4          F;
+        typedef I4          I;
+        typedef M4          M;
+    };
+
+    inline F4 operator + (const F4 a, const F4 b) { return _mm_add_ps(a.v, b.v); }
+    inline F4 operator - (const F4 a, const F4 b) { return _mm_sub_ps(a.v, b.v); }
+    inline F4 operator * (const F4 a, const F4 b) { return _mm_mul_ps(a.v, b.v); }
+    inline F4 operator - (const F4 a)             { return _mm_xor_ps(a.v, _mm_set1_ps(-0.f)); }
+    inline I4 operator + (const I4 a, const I4 b) { return _mm_add_epi32(a.v, b.v); }
+    inline I4 operator - (const I4 a, const I4 b) { return _mm_sub_epi32(a.v, b.v); }
+    inline I4 operator * (const I4 a, const I4 b) { return NX::SIMDMulLo32(a.v, b.v); }
+    inline I4 operator ^ (const I4 a, const I4 b) { return _mm_xor_si128(a.v, b.v); }
+    inline I4 operator >> (const I4 a, const int n) { return _mm_srli_epi32(a.v, n); }
+
+    inline F4 Floor(const F4 v)                                { return NX::SIMDFloor(v.v); }
+    inline F4 Max(const F4 a, const F4 b)                      { return _mm_max_ps(a.v, b.v); }
+    inline F4 Min(const F4 a, const F4 b)                      { return _mm_min_ps(a.v, b.v); }
+    inline F4 Abs(const F4 v)                                  { return NX::SIMDAbs(v.v); }
+    inline F4 Select(const M4 m, const F4 a, const F4 b)       { return NX::SIMDSelect(m.v, a.v, b.v); }
+    inline F4 Negate(const M4 m, const F4 a)                   { return _mm_xor_ps(a.v, _mm_and_ps(m.v, _mm_set1_ps(-0.f))); }
+    inline M4 GreaterEqual(const F4 a, const F4 b)             { return _mm_cmpge_ps(a.v, b.v); }
+    inline M4 And(const M4 a, const M4 b)                      { return _mm_and_ps(a.v, b.v); }
+    inline M4 Or(const M4 a, const M4 b)                       { return _mm_or_ps(a.v, b.v); }
+    inline M4 Not(const M4 a)                                  { return _mm_xor_ps(a.v, _mm_castsi128_ps(_mm_set1_epi32(-1))); }
+    inline I4 ToInt(const F4 v)                                { return _mm_cvttps_epi32(v.v); }
+    inline F4 ToFloat(const I4 v)                              { return _mm_cvtepi32_ps(v.v); }
+    inline I4 MaskToInt(const M4 m)                            { return _mm_and_si128(_mm_castps_si128(m.v), _mm_set1_epi32(1)); }
+    inline M4 TestBit(const I4 h, const NXUInt32 uBit) {
+        const __m128i Bit = _mm_set1_epi32((int)uBit);
+        return _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(h.v, Bit), Bit));
+    }
+#endif
+
+    /**
+     *  lattice hashes of NXHash.h for both lane types
+     */
+    inline NXUInt32 Hash(const NXUInt32 ix, const NXUInt32 iy, const NXUInt32 uSeed) {
+        return NX::HashLattice(ix, iy, uSeed);
+    }
+
+    inline NXUInt32 Hash(const NXUInt32 ix, const NXUInt32 iy, const NXUInt32 iz, const NXUInt32 uSeed) {
+        return NX::HashLattice(ix, iy, iz, uSeed);
+    }
+
+    inline NXUInt32 Hash(const NXUInt32 ix, const NXUInt32 iy, const NXUInt32 iz, const NXUInt32 iw, const NXUInt32 uSeed) {
+        return NX::HashLattice(ix, iy, iz, iw, uSeed);
+    }
+
+#if NX_SIMD_SSE
+    inline I4 Hash(const I4 ix, const I4 iy, const I4 Seed) {
+        return NX::HashLattice(ix.v, iy.v, Seed.v);
+    }
+
+    inline I4 Hash(const I4 ix, const I4 iy, const I4 iz, const I4 Seed) {
+        return NX::HashLattice(ix.v, iy.v, iz.v, Seed.v);
+    }
+
+    inline I4 Hash(const I4 ix, const I4 iy, const I4 iz, const I4 iw, const I4 Seed) {
+        return NX::HashLattice(ix.v, iy.v, iz.v, iw.v, Seed.v);
+    }
+#endif
+
+    template<typename F>
+    inline F Fade(const F t) {
+        return t * t * t * (t * (t * F(6.f) - F(15.f)) + F(10.f));
+    }
+
+    template<typename F>
+    inline F Lerp(const F a, const F b, const F t) {
+        return a + t * (b - a);
+    }
+
+    template<typename L>
+    inline typename L::F Lattice(const typename L::I h) {//[-1, 1)
+        typedef typename L::F F;
+        return ToFloat(h >> 8) * F(kLatticeScale) - F(1.f);
+    }
+
+    template<typename L>
+    inline typename L::F Gradient2(const typename L::I h, const typename L::F x, const typename L::F y) {//one of 8 directions
+        typedef typename L::F F;
+        const typename L::M Swap = TestBit(h, 4);
+        F u = Select(Swap, y, x), v = Select(Swap, x, y);
+        u = Negate(TestBit(h, 1), u);
+        v = v + v;
+        v = Negate(TestBit(h, 2), v);
+        return u + v;
+    }
+
+    template<typename L>
+    inline void Gradient3(const typename L::I h, typename L::F &gx, typename L::F &gy, typename L::F &gz) {//the 12 cube edges, 4 of them twice
+        typedef typename L::F F;
+        typedef typename L::M M;
+        const F Zero(0.f);
+        const F su = Select(TestBit(h, 1), F(-1.f), F(1.f)), sv = Select(TestBit(h, 2), F(-1.f), F(1.f));
+        const M b8 = TestBit(h, 8), b4 = TestBit(h, 4);
+        const M vx = And(And(b8, b4), Not(TestBit(h, 1))), vy = Not(Or(b8, b4)), vz = Not(Or(vx, vy));
+        gx = Select(b8, Zero, su) + Select(vx, sv, Zero);
+        gy = Select(b8, su, Zero) + Select(vy, sv, Zero);
+        gz = Select(vz, sv, Zero);
+    }
+
+    template<typename L>
+    inline typename L::F Gradient4(const typename L::I h, const typename L::F x, const typename L::F y, const typename L::F z, const typename L::F w) {//32 directions
+        typedef typename L::F F;
+        const typename L::M b16 = TestBit(h, 16), b8 = TestBit(h, 8);
+        F u = Select(And(b16, b8), y, x), v = Select(b16, z, y), s = Select(Or(b16, b8), w, z);
+        u = Negate(TestBit(h, 1), u);
+        v = Negate(TestBit(h, 2), v);
+        s = Negate(TestBit(h, 4), s);
+        return u + v + s;
+    }
+
+    template<typename L>
+    typename L::F Simplex2(const typename L::F x, const typename L::F y, const typename L::I Seed) {
+        typedef typename L::F F;
+        typedef typename L::I I;
+        const F s  = (x + y) * F(kSkew2);
+        const F fi = Floor(x + s), fj = Floor(y + s);
+        const F t  = (fi + fj) * F(kUnskew2);
+        const F x0 = x - (fi - t), y0 = y - (fj - t);
+        const I ii = ToInt(fi), jj = ToInt(fj), One(1);
+        const I i1 = MaskToInt(GreaterEqual(x0, y0)), j1 = One - i1;    // the lower triangle steps along x first
+        const F xs[3] = { x0, x0 - ToFloat(i1) + F(kUnskew2), x0 + F(2.f * kUnskew2 - 1.f) };
+        const F ys[3] = { y0, y0 - ToFloat(j1) + F(kUnskew2), y0 + F(2.f * kUnskew2 - 1.f) };
+        const I hs[3] = { Hash(ii, jj, Seed), Hash(ii + i1, jj + j1, Seed), Hash(ii + One, jj + One, Seed) };
+        F n(0.f);
+        for (int k = 0; k < 3; ++k) {
+            F r = Max(F(0.5f) - xs[k] * xs[k] - ys[k] * ys[k], F(0.f));
+            r = r * r;
+            n = n + r * r * Gradient2<L>(hs[k], xs[k], ys[k]);
+        }
+        return n * F(kSimplexScale2);
+    }
+
+    /**
+     *  the four corners of the 3D simplex around a point, offsets from the point and lattice hashes
+     */
+    template<typename L>
+    struct Simplex3Cell {
+        typename L::F   x[4], y[4], z[4];
+        typename L::I   h[4];
+    };
+
+    template<typename L>
+    void FindSimplex3(const typename L::F x, const typename L::F y, const typename L::F z, const typename L::I Seed, Simplex3Cell<L> &Cell) {
+        typedef typename L::F F;
+        typedef typename L::I I;
+        const F s  = (x + y + z) * F(kSkew3);
+        const F fi = Floor(x + s), fj = Floor(y + s), fk = Floor(z + s);
+        const F t  = (fi + fj + fk) * F(kUnskew3);
+        const F x0 = x - (fi - t), y0 = y - (fj - t), z0 = z - (fk - t);
+        const I ii = ToInt(fi), jj = ToInt(fj), kk = ToInt(fk), One(1);
+
+        //rank of every axis among the offsets, ties go to the earlier axis. the largest steps first
+        const I xy = MaskToInt(GreaterEqual(x0, y0)), xz = MaskToInt(GreaterEqual(x0, z0)), yz = MaskToInt(GreaterEqual(y0, z0));
+        const I rx = xy + xz, ry = (One - xy) + yz, rz = (One - xz) + (One - yz);
+        const I i1 = rx >> 1, j1 = ry >> 1, k1 = rz >> 1;
+        const I i2 = (rx + One) >> 1, j2 = (ry + One) >> 1, k2 = (rz + One) >> 1;
+
+        Cell.x[0] = x0, Cell.y[0] = y0, Cell.z[0] = z0;
+        Cell.x[1] = x0 - ToFloat(i1) + F(kUnskew3), Cell.y[1] = y0 - ToFloat(j1) + F(kUnskew3), Cell.z[1] = z0 - ToFloat(k1) + F(kUnskew3);
+        Cell.x[2] = x0 - ToFloat(i2) + F(2.f * kUnskew3), Cell.y[2] = y0 - ToFloat(j2) + F(2.f * kUnskew3), Cell.z[2] = z0 - ToFloat(k2) + F(2.f * kUnskew3);
+        Cell.x[3] = x0 + F(3.f * kUnskew3 - 1.f), Cell.y[3] = y0 + F(3.f * kUnskew3 - 1.f), Cell.z[3] = z0 + F(3.f * kUnskew3 - 1.f);
+        Cell.h[0] = Hash(ii, jj, kk, Seed);
+        Cell.h[1] = Hash(ii + i1, jj + j1, kk + k1, Seed);
+        Cell.h[2] = Hash(ii + i2, jj + j2, kk + k2, Seed);
+        Cell.h[3] = Hash(ii + One, jj + One, kk + One, Seed);
+    }
+
+    template<typename L>
+    typename L::F Simplex3(const typename L::F x, const typename L::F y, const typename L::F z, const typename L::I Seed) {
+        typedef typename L::F F;
+        Simplex3Cell<L> Cell;
+        FindSimplex3<L>(x, y, z, Seed, Cell);
+        F n(0.f);
+        for (int k = 0; k < 4; ++k) {
+            F r = Max(F(0.5f) - Cell.x[k] * Cell.x[k] - Cell.y[k] * Cell.y[k] - Cell.z[k] * Cell.z[k], F(0.f));
+            r = r * r;
+            F gx, gy, gz;
+            Gradient3<L>(Cell.h[k], gx, gy, gz);
+            n = n + r * r * (gx * Cell.x[k] + gy * Cell.y[k] + gz * Cell.z[k]);
+        }
+        return n * F(kSimplexScale3);
+    }
+
+    /**
+     *  analytic gradient of Simplex3, each corner adds r^4 g - 8 r^3 (g . d) d
+     */
+    template<typename L>
+    void SimplexGradient3(const typename L::F x, const typename L::F y, const typename L::F z, const typename L::I Seed, typename L::F &dx, typename L::F &dy, typename L::F &dz) {
+        typedef typename L::F F;
+        Simplex3Cell<L> Cell;
+        FindSimplex3<L>(x, y, z, Seed, Cell);
+        dx = dy = dz = F(0.f);
+        for (int k = 0; k < 4; ++k) {
+            const F r  = Max(F(0.5f) - Cell.x[k] * Cell.x[k] - Cell.y[k] * Cell.y[k] - Cell.z[k] * Cell.z[k], F(0.f));
+            const F r2 = r * r, r4 = r2 * r2;
+            F gx, gy, gz;
+            Gradient3<L>(Cell.h[k], gx, gy, gz);
+            const F Slope = r2 * r * (gx * Cell.x[k] + gy * Cell.y[k] + gz * Cell.z[k]) * F(8.f);
+            dx = dx + (r4 * gx - Slope * Cell.x[k]);
+            dy = dy + (r4 * gy - Slope * Cell.y[k]);
+            dz = dz + (r4 * gz - Slope * Cell.z[k]);
+        }
+        dx = dx * F(kSimplexScale3), dy = dy * F(kSimplexScale3), dz = dz * F(kSimplexScale3);
+    }
+
+    template<typename L>
+    typename L::F Simplex4(const typename L::F x, const typename L::F y, const typename L::F z, const typename L::F w, const typename L::I Seed) {
+        typedef typename L::F F;
+        typedef typename L::I I;
+        const F s  = (x + y + z + w) * F(kSkew4);
+        const F fi = Floor(x + s), fj = Floor(y + s), fk = Floor(z + s), fl = Floor(w + s);
+        const F t  = (fi + fj + fk + fl) * F(kUnskew4);
+        const F x0 = x - (fi - t), y0 = y - (fj - t), z0 = z - (fk - t), w0 = w - (fl - t);
+        const I ii = ToInt(fi), jj = ToInt(fj), kk = ToInt(fk), ll = ToInt(fl), One(1), Three(3);
+
+        const I xy = MaskToInt(GreaterEqual(x0, y0)), xz = MaskToInt(GreaterEqual(x0, z0)), xw = MaskToInt(GreaterEqual(x0, w0));
+        const I yz = MaskToInt(GreaterEqual(y0, z0)), yw = MaskToInt(GreaterEqual(y0, w0)), zw = MaskToInt(GreaterEqual(z0, w0));
+        const I Ranks[4] = { xy + xz + xw, (One - xy) + yz + yw, (One - xz) + (One - yz) + zw, (One - xw) + (One - yw) + (One - zw) };
+        const F Origin[4] = { x0, y0, z0, w0 };
+
+        //corner k steps along the axes of rank >= 4 - k
+        F Offsets[5][4];
+        I Steps[5][4];
+        for (int a = 0; a < 4; ++a) {
+            Steps[0][a] = I(0u);
+            Steps[1][a] = (Ranks[a] + One) >> 2;
+            Steps[2][a] = Ranks[a] >> 1;
+            Steps[3][a] = (Ranks[a] + Three) >> 2;
+            Steps[4][a] = One;
+            Offsets[0][a] = Origin[a];
+            Offsets[1][a] = Origin[a] - ToFloat(Steps[1][a]) + F(kUnskew4);
+            Offsets[2][a] = Origin[a] - ToFloat(Steps[2][a]) + F(2.f * kUnskew4);
+            Offsets[3][a] = Origin[a] - ToFloat(Steps[3][a]) + F(3.f * kUnskew4);
+            Offsets[4][a] = Origin[a] + F(4.f * kUnskew4 - 1.f);
+        }
+
+        F n(0.f);
+        for (int k = 0; k < 5; ++k) {
+            const F *d = Offsets[k];
+            F r = Max(F(0.5f) - d[0] * d[0] - d[1] * d[1] - d[2] * d[2] - d[3] * d[3], F(0.f));
+            r = r * r;
+            const I h = Hash(ii + Steps[k][0], jj + Steps[k][1], kk + Steps[k][2], ll + Steps[k][3], Seed);
+            n = n + r * r * Gradient4<L>(h, d[0], d[1], d[2], d[3]);
+        }
+        return n * F(kSimplexScale4);
+    }
+
+    template<typename L>
+    typename L::F Value2(const typename L::F x, const typename L::F y, const typename L::I Seed) {
+        typedef typename L::F F;
+        typedef typename L::I I;
+        const F fx = Floor(x), fy = Floor(y);
+        const I ix = ToInt(fx), iy = ToInt(fy), One(1);
+        const F u = Fade(x - fx), v = Fade(y - fy);
+        const F a = Lerp(Lattice<L>(Hash(ix, iy, Seed)),       Lattice<L>(Hash(ix + One, iy, Seed)),       u);
+        const F b = Lerp(Lattice<L>(Hash(ix, iy + One, Seed)), Lattice<L>(Hash(ix + One, iy + One, Seed)), u);
+        return Lerp(a, b, v);
+    }
+
+    template<typename L>
+    typename L::F Value3(const typename L::F x, const typename L::F y, const typename L::F z, const typename L::I Seed) {
+        typedef typename L::F F;
+        typedef typename L::I I;
+        const F fx = Floor(x), fy = Floor(y), fz = Floor(z);
+        const I ix = ToInt(fx), iy = ToInt(fy), iz = ToInt(fz), One(1);
+        const F u = Fade(x - fx), v = Fade(y - fy), s = Fade(z - fz);
+        F Planes[2];
+        for (int c = 0; c < 2; ++c) {
+            const I iz1 = c ? iz + One : iz;
+            const F a = Lerp(Lattice<L>(Hash(ix, iy, iz1, Seed)),       Lattice<L>(Hash(ix + One, iy, iz1, Seed)),       u);
+            const F b = Lerp(Lattice<L>(Hash(ix, iy + One, iz1, Seed)), Lattice<L>(Hash(ix + One, iy + One, iz1, Seed)), u);
+            Planes[c] = Lerp(a, b, v);
+        }
+        return Lerp(Planes[0], Planes[1], s);
+    }
+
+    template<typename L>
+    typename L::F Value4(const typename L::F x, const typename L::F y, const typename L::F z, const typename L::F w, const typename L::I Seed) {
+        typedef typename L::F F;
+        typedef typename L::I I;
+        const F fx = Floor(x), fy = Floor(y), fz = Floor(z), fw = Floor(w);
+        const I ix = ToInt(fx), iy = ToInt(fy), iz = ToInt(fz), iw = ToInt(fw), One(1);
+        const F u = Fade(x - fx), v = Fade(y - fy), s = Fade(z - fz), q = Fade(w - fw);
+        F Cubes[2];
+        for (int d = 0; d < 2; ++d) {
+            const I iw1 = d ? iw + One : iw;
+            F Planes[2];
+            for (int c = 0; c < 2; ++c) {
+                const I iz1 = c ? iz + One : iz;
+                const F a = Lerp(Lattice<L>(Hash(ix, iy, iz1, iw1, Seed)),       Lattice<L>(Hash(ix + One, iy, iz1, iw1, Seed)),       u);
+                const F b = Lerp(Lattice<L>(Hash(ix, iy + One, iz1, iw1, Seed)), Lattice<L>(Hash(ix + One, iy + One, iz1, iw1, Seed)), u);
+                Planes[c] = Lerp(a, b, v);
+            }
+            Cubes[d] = Lerp(Planes[0], Planes[1], s);
+        }
+        return Lerp(Cubes[0], Cubes[1], q);
+    }
+
+    /**
+     *  gradient noise on the square lattice, the corner gradients are dotted with the offsets and blended
+     *  with the quintic fade. 2D is the noise of HeightFieldGenerator
+     */
+    template<typename L>
+    typename L::F GradientNoise2(const typename L::F x, const typename L::F y, const typename L::I Seed) {
+        typedef typename L::F F;
+        typedef typename L::I I;
+        const F fx = Floor(x), fy = Floor(y);
+        const I ix = ToInt(fx), iy = ToInt(fy), One(1);
+        const F tx = x - fx, ty = y - fy, tx1 = tx - F(1.f), ty1 = ty - F(1.f);
+        const F u = Fade(tx), v = Fade(ty);
+        const F a = Lerp(Gradient2<L>(Hash(ix, iy, Seed), tx, ty),        Gradient2<L>(Hash(ix + One, iy, Seed), tx1, ty),        u);
+        const F b = Lerp(Gradient2<L>(Hash(ix, iy + One, Seed), tx, ty1), Gradient2<L>(Hash(ix + One, iy + One, Seed), tx1, ty1), u);
+        return Lerp(a, b, v) * F(kGradientScale2);
+    }
+
+    template<typename L>
+    typename L::F GradientNoise3(const typename L::F x, const typename L::F y, const typename L::F z, const typename L::I Seed) {
+        typedef typename L::F F;
+        typedef typename L::I I;
+        const F fx = Floor(x), fy = Floor(y), fz = Floor(z);
+        const I ix = ToInt(fx), iy = ToInt(fy), iz = ToInt(fz), One(1);
+        const F tx = x - fx, ty = y - fy, tz = z - fz;
+        const F u = Fade(tx), v = Fade(ty), s = Fade(tz);
+        F Corners[8];
+        for (int k = 0; k < 8; ++k) {
+            const F dx = (k & 1) ? tx - F(1.f) : tx, dy = (k & 2) ? ty - F(1.f) : ty, dz = (k & 4) ? tz - F(1.f) : tz;
+            F gx, gy, gz;
+            Gradient3<L>(Hash((k & 1) ? ix + One : ix, (k & 2) ? iy + One : iy, (k & 4) ? iz + One : iz, Seed), gx, gy, gz);
+            Corners[k] = gx * dx + gy * dy + gz * dz;
+        }
+        const F a = Lerp(Lerp(Corners[0], Corners[1], u), Lerp(Corners[2], Corners[3], u), v);
+        const F b = Lerp(Lerp(Corners[4], Corners[5], u), Lerp(Corners[6], Corners[7], u), v);
+        return Lerp(a, b, s) * F(kGradientScale3);
+    }
+
+    template<typename L>
+    typename L::F GradientNoise4(const typename L::F x, const typename L::F y, const typename L::F z, const typename L::F w, const typename L::I Seed) {
+        typedef typename L::F F;
+        typedef typename L::I I;
+        const F fx = Floor(x), fy = Floor(y), fz = Floor(z), fw = Floor(w);
+        const I ix = ToInt(fx), iy = ToInt(fy), iz = ToInt(fz), iw = ToInt(fw), One(1);
+        const F tx = x - fx, ty = y - fy, tz = z - fz, tw = w - fw;
+        const F u = Fade(tx), v = Fade(ty), s = Fade(tz), q = Fade(tw);
+        F Corners[16];
+        for (int k = 0; k < 16; ++k) {
+            const F dx = (k & 1) ? tx - F(1.f) : tx, dy = (k & 2) ? ty - F(1.f) : ty;
+            const F dz = (k & 4) ? tz - F(1.f) : tz, dw = (k & 8) ? tw - F(1.f) : tw;
+            const I h = Hash((k & 1) ? ix + One : ix, (k & 2) ? iy + One : iy, (k & 4) ? iz + One : iz, (k & 8) ? iw + One : iw, Seed);
+            Corners[k] = Gradient4<L>(h, dx, dy, dz, dw);
+        }
+        F Cubes[2];
+        for (int d = 0; d < 2; ++d) {
+            const F *c = Corners + d * 8;
+            const F a = Lerp(Lerp(c[0], c[1], u), Lerp(c[2], c[3], u), v);
+            const F b = Lerp(Lerp(c[4], c[5], u), Lerp(c[6], c[7], u), v);
+            Cubes[d] = Lerp(a, b, s);
+        }
+        return Lerp(Cubes[0], Cubes[1], q) * F(kGradientScale4);
+    }
+
+    struct SimplexKernel {
+        template<typename L>
+        static typename L::F Sample(const typename L::F x, const typename L::F y, const typename L::I Seed) {
+            return Simplex2<L>(x, y, Seed);
+        }
+
+        template<typename L>
+        static typename L::F Sample(const typename L::F x, const typename L::F y, const typename L::F z, const typename L::I Seed) {
+            return Simplex3<L>(x, y, z, Seed);
+        }
+
+        template<typename L>
+        static typename L::F Sample(const typename L::F x, const typename L::F y, const typename L::F z, const typename L::F w, const typename L::I Seed) {
+            return Simplex4<L>(x, y, z, w, Seed);
+        }
+    };
+
+    struct ValueKernel {
+        template<typename L>
+        static typename L::F Sample(const typename L::F x, const typename L::F y, const typename L::I Seed) {
+            return Value2<L>(x, y, Seed);
+        }
+
+        template<typename L>
+        static typename L::F Sample(const typename L::F x, const typename L::F y, const typename L::F z, const typename L::I Seed) {
+            return Value3<L>(x, y, z, Seed);
+        }
+
+        template<typename L>
+        static typename L::F Sample(const typename L::F x, const typename L::F y, const typename L::F z, const typename L::F w, const typename L::I Seed) {
+            return Value4<L>(x, y, z, w, Seed);
+        }
+    };
+
+    struct GradientKernel {
+        template<typename L>
+        static typename L::F Sample(const typename L::F x, const typename L::F y, const typename L::I Seed) {
+            return GradientNoise2<L>(x, y, Seed);
+        }
+
+        template<typename L>
+        static typename L::F Sample(const typename L::F x, const typename L::F y, const typename L::F z, const typename L::I Seed) {
+            return GradientNoise3<L>(x, y, z, Seed);
+        }
+
+        template<typename L>
+        static typename L::F Sample(const typename L::F x, const typename L::F y, const typename L::F z, const typename L::F w, const typename L::I Seed) {
+            return GradientNoise4<L>(x, y, z, w, Seed);
+        }
+    };
+
+    /**
+     *  octaves of one call, a single octave has iOctaves 1 and fInvNorm 1
+     */
+    struct Octaves {
+        int              iOctaves;
+        float            fLacunarity;
+        float            fGain;
+        float            fInvNorm;
+        const NXUInt32   *pSeeds;
+    };
+
+    template<typename KERNEL, typename L>
+    typename L::F Fbm(typename L::F x, typename L::F y, const Octaves &o) {
+        typedef typename L::F F;
+        typedef typename L::I I;
+        const F Lacunarity(o.fLacunarity);
+        F Sum(0.f);
+        float fAmplitude = 1.f;
+        for (int k = 0; k < o.iOctaves; ++k) {
+            Sum = Sum + F(fAmplitude) * KERNEL::template Sample<L>(x, y, I(o.pSeeds[k]));
+            x = x * Lacunarity, y = y * Lacunarity;
+            fAmplitude = fAmplitude * o.fGain;
+        }
+        return Sum * F(o.fInvNorm);
+    }
+
+    template<typename KERNEL, typename L>
+    typename L::F Fbm(typename L::F x, typename L::F y, typename L::F z, const Octaves &o) {
+        typedef typename L::F F;
+        typedef typename L::I I;
+        const F Lacunarity(o.fLacunarity);
+        F Sum(0.f);
+        float fAmplitude = 1.f;
+        for (int k = 0; k < o.iOctaves; ++k) {
+            Sum = Sum + F(fAmplitude) * KERNEL::template Sample<L>(x, y, z, I(o.pSeeds[k]));
+            x = x * Lacunarity, y = y * Lacunarity, z = z * Lacunarity;
+            fAmplitude = fAmplitude * o.fGain;
+        }
+        return Sum * F(o.fInvNorm);
+    }
+
+    template<typename KERNEL, typename L>
+    typename L::F Fbm(typename L::F x, typename L::F y, typename L::F z, typename L::F w, const Octaves &o) {
+        typedef typename L::F F;
+        typedef typename L::I I;
+        const F Lacunarity(o.fLacunarity);
+        F Sum(0.f);
+        float fAmplitude = 1.f;
+        for (int k = 0; k < o.iOctaves; ++k) {
+            Sum = Sum + F(fAmplitude) * KERNEL::template Sample<L>(x, y, z, w, I(o.pSeeds[k]));
+            x = x * Lacunarity, y = y * Lacunarity, z = z * Lacunarity, w = w * Lacunarity;
+            fAmplitude = fAmplitude * o.fGain;
+        }
+        return Sum * F(o.fInvNorm);
+    }
+
+    /**
+     *  ridged multifractal, 1 - |noise| squared and weighted by the previous octave, shifted to about [-1, 1]
+     */
+    template<typename KERNEL, typename L>
+    typename L::F Ridged(typename L::F x, typename L::F y, const Octaves &o) {
+        typedef typename L::F F;
+        typedef typename L::I I;
+        const F Lacunarity(o.fLacunarity), One(1.f), Two(2.f);
+        F Sum(0.f), Weight(1.f);
+        float fAmplitude = 1.f;
+        for (int k = 0; k < o.iOctaves; ++k) {
+            F n = One - Abs(KERNEL::template Sample<L>(x, y, I(o.pSeeds[k])));
+            n = n * n;
+            n = n * Weight;
+            Weight = Min(n * Two, One);
+            Sum = Sum + F(fAmplitude) * n;
+            x = x * Lacunarity, y = y * Lacunarity;
+            fAmplitude = fAmplitude * o.fGain;
+        }
+        return Sum * F(o.fInvNorm) * Two - One;
+    }
+
+    /**
+     *  fBm 0 at a position displaced by fBm 1 and fBm 2
+     */
+    template<typename KERNEL, typename L>
+    typename L::F Warp(const typename L::F x, const typename L::F y, const typename L::F Strength, const Octaves Fields[NX::Noise::POTENTIAL_COUNT]) {
+        typedef typename L::F F;
+        const F qx = Fbm<KERNEL, L>(x, y, Fields[1]);
+        const F qy = Fbm<KERNEL, L>(x + F(kWarpOffsetX), y + F(kWarpOffsetY), Fields[2]);
+        return Fbm<KERNEL, L>(x + Strength * qx, y + Strength * qy, Fields[0]);
+    }
+
+    /**
+     *  curl of (fBm 0, fBm 1, fBm 2), an octave of frequency f and amplitude a adds a * f * gradient
+     */
+    template<typename L>
+    void Curl(const typename L::F x, const typename L::F y, const typename L::F z, const Octaves Potentials[NX::Noise::POTENTIAL_COUNT], typename L::F &cx, typename L::F &cy, typename L::F &cz) {
+        typedef typename L::F F;
+        typedef typename L::I I;
+        F Gradients[NX::Noise::POTENTIAL_COUNT][3];
+        for (int p = 0; p < NX::Noise::POTENTIAL_COUNT; ++p) {
+            const Octaves &o = Potentials[p];
+            const F Lacunarity(o.fLacunarity);
+            F px = x, py = y, pz = z, gx(0.f), gy(0.f), gz(0.f);
+            float fScale = 1.f;
+            for (int k = 0; k < o.iOctaves; ++k) {
+                F dx, dy, dz;
+                SimplexGradient3<L>(px, py, pz, I(o.pSeeds[k]), dx, dy, dz);
+                gx = gx + F(fScale) * dx, gy = gy + F(fScale) * dy, gz = gz + F(fScale) * dz;
+                px = px * Lacunarity, py = py * Lacunarity, pz = pz * Lacunarity;
+                fScale = fScale * o.fGain * o.fLacunarity;
+            }
+            Gradients[p][0] = gx * F(o.fInvNorm), Gradients[p][1] = gy * F(o.fInvNorm), Gradients[p][2] = gz * F(o.fInvNorm);
+        }
+        cx = Gradients[2][1] - Gradients[1][2];
+        cy = Gradients[0][2] - Gradients[2][0];
+        cz = Gradients[1][0] - Gradients[0][1];
+    }
+
+    /**
+     *  four points per SSE step, the tail through the float lanes
+     */
+    template<typename KERNEL>
+    void Batch(const float *pXs, const float *pYs, float *pOut, const int iCount, const Octaves &o) {
+        int i = 0;
+#if NX_SIMD_SSE
+        for (; i + 4 <= iCount; i += 4) {
+            _mm_storeu_ps(pOut + i, Fbm<KERNEL, SSELanes>(F4(_mm_loadu_ps(pXs + i)), F4(_mm_loadu_ps(pYs + i)), o).v);
+        }
+#endif
+        for (; i < iCount; ++i) {
+            pOut[i] = Fbm<KERNEL, ScalarLanes>(pXs[i], pYs[i], o);
+        }
+    }
+
+    template<typename KERNEL>
+    void Batch(const float *pXs, const float *pYs, const float *pZs, float *pOut, const int iCount, const Octaves &o) {
+        int i = 0;
+#if NX_SIMD_SSE
+        for (; i + 4 <= iCount; i += 4) {
+            _mm_storeu_ps(pOut + i, Fbm<KERNEL, SSELanes>(F4(_mm_loadu_ps(pXs + i)), F4(_mm_loadu_ps(pYs + i)), F4(_mm_loadu_ps(pZs + i)), o).v);
+        }
+#endif
+        for (; i < iCount; ++i) {
+            pOut[i] = Fbm<KERNEL, ScalarLanes>(pXs[i], pYs[i], pZs[i], o);
+        }
+    }
+
+    template<typename KERNEL>
+    void Batch(const float *pXs, const float *pYs, const float *pZs, const float *pWs, float *pOut, const int iCount, const Octaves &o) {
+        int i = 0;
+#if NX_SIMD_SSE
+        for (; i + 4 <= iCount; i += 4) {
+            _mm_storeu_ps(pOut + i, Fbm<KERNEL, SSELanes>(F4(_mm_loadu_ps(pXs + i)), F4(_mm_loadu_ps(pYs + i)), F4(_mm_loadu_ps(pZs + i)), F4(_mm_loadu_ps(pWs + i)), o).v);
+        }
+#endif
+        for (; i < iCount; ++i) {
+            pOut[i] = Fbm<KERNEL, ScalarLanes>(pXs[i], pYs[i], pZs[i], pWs[i], o);
+        }
+    }
+
+    template<typename KERNEL>
+    void BatchRidged(const float *pXs, const float *pYs, float *pOut, const int iCount, const Octaves &o) {
+        int i = 0;
+#if NX_SIMD_SSE
+        for (; i + 4 <= iCount; i += 4) {
+            _mm_storeu_ps(pOut + i, Ridged<KERNEL, SSELanes>(F4(_mm_loadu_ps(pXs + i)), F4(_mm_loadu_ps(pYs + i)), o).v);
+        }
+#endif
+        for (; i < iCount; ++i) {
+            pOut[i] = Ridged<KERNEL, ScalarLanes>(pXs[i], pYs[i], o);
+        }
+    }
+
+    template<typename KERNEL>
+    void BatchWarp(const float *pXs, const float *pYs, const float fStrength, float *pOut, const int iCount, const Octaves Fields[NX::Noise::POTENTIAL_COUNT]) {
+        int i = 0;
+#if NX_SIMD_SSE
+        for (; i + 4 <= iCount; i += 4) {
+            _mm_storeu_ps(pOut + i, Warp<KERNEL, SSELanes>(F4(_mm_loadu_ps(pXs + i)), F4(_mm_loadu_ps(pYs + i)), F4(fStrength), Fields).v);
+        }
+#endif
+        for (; i < iCount; ++i) {
+            pOut[i] = Warp<KERNEL, ScalarLanes>(pXs[i], pYs[i], fStrength, Fields);
+        }
+    }
+
+    /**
+     *  fBm of the kernel eType selects, for one point or a batch
+     */
+    float Evaluate(const NX::Noise::NOISE_TYPE eType, const float x, const float y, const Octaves &o) {
+        switch (eType) {
+        case NX::Noise::NOISE_VALUE:    return Fbm<ValueKernel, ScalarLanes>(x, y, o);
+        case NX::Noise::NOISE_GRADIENT: return Fbm<GradientKernel, ScalarLanes>(x, y, o);
+        default:                        return Fbm<SimplexKernel, ScalarLanes>(x, y, o);
+        }
+    }
+
+    float Evaluate(const NX::Noise::NOISE_TYPE eType, const float x, const float y, const float z, const Octaves &o) {
+        switch (eType) {
+        case NX::Noise::NOISE_VALUE:    return Fbm<ValueKernel, ScalarLanes>(x, y, z, o);
+        case NX::Noise::NOISE_GRADIENT: return Fbm<GradientKernel, ScalarLanes>(x, y, z, o);
+        default:                        return Fbm<SimplexKernel, ScalarLanes>(x, y, z, o);
+        }
+    }
+
+    float Evaluate(const NX::Noise::NOISE_TYPE eType, const float x, const float y, const float z, const float w, const Octaves &o) {
+        switch (eType) {
+        case NX::Noise::NOISE_VALUE:    return Fbm<ValueKernel, ScalarLanes>(x, y, z, w, o);
+        case NX::Noise::NOISE_GRADIENT: return Fbm<GradientKernel, ScalarLanes>(x, y, z, w, o);
+        default:                        return Fbm<SimplexKernel, ScalarLanes>(x, y, z, w, o);
+        }
+    }
+
+    void Evaluate(const NX::Noise::NOISE_TYPE eType, const float *pXs, const float *pYs, float *pOut, const int iCount, const Octaves &o) {
+        switch (eType) {
+        case NX::Noise::NOISE_VALUE:    Batch<ValueKernel>(pXs, pYs, pOut, iCount, o);    break;
+        case NX::Noise::NOISE_GRADIENT: Batch<GradientKernel>(pXs, pYs, pOut, iCount, o); break;
+        default:                        Batch<SimplexKernel>(pXs, pYs, pOut, iCount, o);  break;
+        }
+    }
+
+    void Evaluate(const NX::Noise::NOISE_TYPE eType, const float *pXs, const float *pYs, const float *pZs, float *pOut, const int iCount, const Octaves &o) {
+        switch (eType) {
+        case NX::Noise::NOISE_VALUE:    Batch<ValueKernel>(pXs, pYs, pZs, pOut, iCount, o);    break;
+        case NX::Noise::NOISE_GRADIENT: Batch<GradientKernel>(pXs, pYs, pZs, pOut, iCount, o); break;
+        default:                        Batch<SimplexKernel>(pXs, pYs, pZs, pOut, iCount, o);  break;
+        }
+    }
+
+    void Evaluate(const NX::Noise::NOISE_TYPE eType, const float *pXs, const float *pYs, const float *pZs, const float *pWs, float *pOut, const int iCount, const Octaves &o) {
+        switch (eType) {
+        case NX::Noise::NOISE_VALUE:    Batch<ValueKernel>(pXs, pYs, pZs, pWs, pOut, iCount, o);    break;
+        case NX::Noise::NOISE_GRADIENT: Batch<GradientKernel>(pXs, pYs, pZs, pWs, pOut, iCount, o); break;
+        default:                        Batch<SimplexKernel>(pXs, pYs, pZs, pWs, pOut, iCount, o);  break;
+        }
+    }
+}
+
+namespace NX {
+    Noise::Noise(const NXUInt32 uSeed){
+        m_iOctaves    = 4;
+        m_fLacunarity = 2.f;
+        m_fGain       = 0.5f;
+        m_fInvNorm    = 1.f;
+        SetSeed(uSeed);
+        SetOctaves(m_iOctaves);
+    }
+
+    Noise::~Noise(){
+        /*empty*/
+    }
+
+    Noise& Noise::SetSeed(const NXUInt32 uSeed){
+        m_uSeed = uSeed;
+        for (int p = 0; p < POTENTIAL_COUNT; ++p) {//every octave of every field gets its own lattice
+            for (int o = 0; o < MAX_OCTAVES; ++o) {
+                m_Seeds[p][o] = HashSeed(uSeed, (NXUInt32)(p * MAX_OCTAVES + o + 1));
+            }
+        }
+        return *this;
+    }
+
+    Noise& Noise::SetOctaves(const int iOctaves){
+        NXAssert(iOctaves >= 1 && iOctaves <= MAX_OCTAVES);
+        m_iOctaves = iOctaves < 1 ? 1 : (iOctaves > MAX_OCTAVES ? MAX_OCTAVES : iOctaves);
+        return SetGain(m_fGain);
+    }
+
+    Noise& Noise::SetLacunarity(const float fLacunarity){
+        m_fLacunarity = fLacunarity;
+        return *this;
+    }
+
+    Noise& Noise::SetGain(const float fGain){
+        m_fGain = fGain;
+        float fNorm = 0.f, fAmplitude = 1.f;
+        for (int o = 0; o < m_iOctaves; ++o) {
+            fNorm      = fNorm + fAmplitude;
+            fAmplitude = fAmplitude * fGain;
+        }
+        m_fInvNorm = 1.f / fNorm;
+        return *this;
+    }
+
+    NXUInt32 Noise::GetSeed() const{
+        return m_uSeed;
+    }
+
+    int Noise::GetOctaves() const{
+        return m_iOctaves;
+    }
+
+    float Noise::GetLacunarity() const{
+        return m_fLacunarity;
+    }
+
+    float Noise::GetGain() const{
+        return m_fGain;
+    }
+
+    /**
+     *  a single octave goes through the fBm loop too, so Sample and the first octave of Fbm agree on every bit
+     */
+    float Noise::Sample(const NOISE_TYPE eType, const float x, const float y) const{
+        const Octaves o = { 1, m_fLacunarity, m_fGain, 1.f, m_Seeds[0] };
+        return Evaluate(eType, x, y, o);
+    }
+
+    float Noise::Sample(const NOISE_TYPE eType, const float x, const float y, const float z) const{
+        const Octaves o = { 1, m_fLacunarity, m_fGain, 1.f, m_Seeds[0] };
+        return Evaluate(eType, x, y, z, o);
+    }
+
+    float Noise::Sample(const NOISE_TYPE eType, const float x, const float y, const float z, const float w) const{
+        const Octaves o = { 1, m_fLacunarity, m_fGain, 1.f, m_Seeds[0] };
+        return Evaluate(eType, x, y, z, w, o);
+    }
+
+    void Noise::Sample(const NOISE_TYPE eType, const float *pXs, const float *pYs, float *pOut, const int iCount) const{
+        const Octaves o = { 1, m_fLacunarity, m_fGain, 1.f, m_Seeds[0] };
+        Evaluate(eType, pXs, pYs, pOut, iCount, o);
+    }
+
+    void Noise::Sample(const NOISE_TYPE eType, const float *pXs, const float *pYs, const float *pZs, float *pOut, const int iCount) const{
+        const Octaves o = { 1, m_fLacunarity, m_fGain, 1.f, m_Seeds[0] };
+        Evaluate(eType, pXs, pYs, pZs, pOut, iCount, o);
+    }
+
+    void Noise::Sample(const NOISE_TYPE eType, const float *pXs, const float *pYs, const float *pZs, const float *pWs, float *pOut, const int iCount) const{
+        const Octaves o = { 1, m_fLacunarity, m_fGain, 1.f, m_Seeds[0] };
+        Evaluate(eType, pXs, pYs, pZs, pWs, pOut, iCount, o);
+    }
+
+    float Noise::Fbm(const NOISE_TYPE eType, const float x, const float y) const{
+        const Octaves o = { m_iOctaves, m_fLacunarity, m_fGain, m_fInvNorm, m_Seeds[0] };
+        return Evaluate(eType, x, y, o);
+    }
+
+    float Noise::Fbm(const NOISE_TYPE eType, const float x, const float y, const float z) const{
+        const Octaves o = { m_iOctaves, m_fLacunarity, m_fGain, m_fInvNorm, m_Seeds[0] };
+        return Evaluate(eType, x, y, z, o);
+    }
+
+    float Noise::Fbm(const NOISE_TYPE eType, const float x, const float y, const float z, const float w) const{
+        const Octaves o = { m_iOctaves, m_fLacunarity, m_fGain, m_fInvNorm, m_Seeds[0] };
+        return Evaluate(eType, x, y, z, w, o);
+    }
+
+    void Noise::Fbm(const NOISE_TYPE eType, const float *pXs, const float *pYs, float *pOut, const int iCount) const{
+        const Octaves o = { m_iOctaves, m_fLacunarity, m_fGain, m_fInvNorm, m_Seeds[0] };
+        Evaluate(eType, pXs, pYs, pOut, iCount, o);
+    }
+
+    void Noise::Fbm(const NOISE_TYPE eType, const float *pXs, const float *pYs, const float *pZs, float *pOut, const int iCount) const{
+        const Octaves o = { m_iOctaves, m_fLacunarity, m_fGain, m_fInvNorm, m_Seeds[0] };
+        Evaluate(eType, pXs, pYs, pZs, pOut, iCount, o);
+    }
+
+    void Noise::Fbm(const NOISE_TYPE eType, const float *pXs, const float *pYs, const float *pZs, const float *pWs, float *pOut, const int iCount) const{
+        const Octaves o = { m_iOctaves, m_fLacunarity, m_fGain, m_fInvNorm, m_Seeds[0] };
+        Evaluate(eType, pXs, pYs, pZs, pWs, pOut, iCount, o);
+    }
+
+    float Noise::Ridged(const NOISE_TYPE eType, const float x, const float y) const{
+        const Octaves o = { m_iOctaves, m_fLacunarity, m_fGain, m_fInvNorm, m_Seeds[0] };
+        switch (eType) {
+        case NOISE_VALUE:    return ::Ridged<ValueKernel, ScalarLanes>(x, y, o);
+        case NOISE_GRADIENT: return ::Ridged<GradientKernel, ScalarLanes>(x, y, o);
+        default:             return ::Ridged<SimplexKernel, ScalarLanes>(x, y, o);
+        }
+    }
+
+    void Noise::Ridged(const NOISE_TYPE eType, const float *pXs, const float *pYs, float *pOut, const int iCount) const{
+        const Octaves o = { m_iOctaves, m_fLacunarity, m_fGain, m_fInvNorm, m_Seeds[0] };
+        switch (eType) {
+        case NOISE_VALUE:    BatchRidged<ValueKernel>(pXs, pYs, pOut, iCount, o);    break;
+        case NOISE_GRADIENT: BatchRidged<GradientKernel>(pXs, pYs, pOut, iCount, o); break;
+        default:             BatchRidged<SimplexKernel>(pXs, pYs, pOut, iCount, o);  break;
+        }
+    }
+
+    float Noise::Warp(const NOISE_TYPE eType, const float x, const float y, const float fStrength) const{
+        Octaves Fields[POTENTIAL_COUNT];
+        for (int p = 0; p < POTENTIAL_COUNT; ++p) {
+            const Octaves o = { m_iOctaves, m_fLacunarity, m_fGain, m_fInvNorm, m_Seeds[p] };
+            Fields[p] = o;
+        }
+        switch (eType) {
+        case NOISE_VALUE:    return ::Warp<ValueKernel, ScalarLanes>(x, y, fStrength, Fields);
+        case NOISE_GRADIENT: return ::Warp<GradientKernel, ScalarLanes>(x, y, fStrength, Fields);
+        default:             return ::Warp<SimplexKernel, ScalarLanes>(x, y, fStrength, Fields);
+        }
+    }
+
+    void Noise::Warp(const NOISE_TYPE eType, const float *pXs, const float *pYs, const float fStrength, float *pOut, const int iCount) const{
+        Octaves Fields[POTENTIAL_COUNT];
+        for (int p = 0; p < POTENTIAL_COUNT; ++p) {
+            const Octaves o = { m_iOctaves, m_fLacunarity, m_fGain, m_fInvNorm, m_Seeds[p] };
+            Fields[p] = o;
+        }
+        switch (eType) {
+        case NOISE_VALUE:    BatchWarp<ValueKernel>(pXs, pYs, fStrength, pOut, iCount, Fields);    break;
+        case NOISE_GRADIENT: BatchWarp<GradientKernel>(pXs, pYs, fStrength, pOut, iCount, Fields); break;
+        default:             BatchWarp<SimplexKernel>(pXs, pYs, fStrength, pOut, iCount, Fields);  break;
+        }
+    }
+
+    float3 Noise::Curl(const float3 &Position) const{
+        Octaves Potentials[POTENTIAL_COUNT];
+        for (int p = 0; p < POTENTIAL_COUNT; ++p) {
+            const Octaves o = { m_iOctaves, m_fLacunarity, m_fGain, m_fInvNorm, m_Seeds[p] };
+            Potentials[p] = o;
+        }
+        float3 Result;
+        ::Curl<ScalarLanes>(Position.x, Position.y, Position.z, Potentials, Result.x, Result.y, Result.z);
+        return Result;
+    }
+
+    void Noise::Curl(const float *pXs, const float *pYs, const float *pZs, float *pOutXs, float *pOutYs, float *pOutZs, const int iCount) const{
+        Octaves Potentials[POTENTIAL_COUNT];
+        for (int p = 0; p < POTENTIAL_COUNT; ++p) {
+            const Octaves o = { m_iOctaves, m_fLacunarity, m_fGain, m_fInvNorm, m_Seeds[p] };
+            Potentials[p] = o;
+        }
+        int i = 0;
+#if NX_SIMD_SSE
+        for (; i + 4 <= iCount; i += 4) {
+            F4 cx, cy, cz;
+            ::Curl<SSELanes>(F4(_mm_loadu_ps(pXs + i)), F4(_mm_loadu_ps(pYs + i)), F4(_mm_loadu_ps(pZs + i)), Potentials, cx, cy, cz);
+            _mm_storeu_ps(pOutXs + i, cx.v);
+            _mm_storeu_ps(pOutYs + i, cy.v);
+            _mm_storeu_ps(pOutZs + i, cz.v);
+        }
+#endif
+        for (; i < iCount; ++i) {
+            ::Curl<ScalarLanes>(pXs[i], pYs[i], pZs[i], Potentials, pOutXs[i], pOutYs[i], pOutZs[i]);
+        }
+    }
+}
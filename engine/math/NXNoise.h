@@ -0,0 +1,106 @@
+/*
+ *  File:    NXNoise.h
+ *  author:  张雄
+ *  date:    2026_10_19
+ *  purpose: seedable 2D/3D/4D simplex, value and gradient noise, fBm sums of them, 2D ridged and domain
+ *           warped fractals and divergence free curl noise. lattice points go through the hashes of
+ *           NXHash.h, so there is no permutation table and any seed costs the same. every kernel is
+ *           written once over a lane type and instantiated for float and for SSE, the batched entry
+ *           points run four points per step and the scalar ones and the batch tails give bitwise the
+ *           same values. results don't depend on the batch size or split, only on the seed, as long as
+ *           the compiler neither contracts multiply-adds (/fp:precise without /arch:AVX2,
+ *           -ffp-contract=off) nor falls back to x87. coordinates must stay within +-2^23, where floats
+ *           still resolve the lattice.
+ */
+
+#ifndef __ZX_NXENGINE_NOISE_H__
+#define __ZX_NXENGINE_NOISE_H__
+
+#include "NXVector.h"
+#include "../common/NXType.h"
+
+namespace NX {
+    class Noise {
+    public:
+        enum NOISE_TYPE {
+            NOISE_SIMPLEX,               // gradient noise on a simplex grid, about [-1, 1]
+            NOISE_VALUE,                 // quintic interpolation of lattice values, [-1, 1]
+            NOISE_GRADIENT,              // gradient noise on the square lattice (Perlin), about [-1, 1]
+        };
+
+        enum {
+            MAX_OCTAVES     = 16,
+            POTENTIAL_COUNT = 3,         // curl noise takes the curl of three fBm fields
+        };
+
+    public:
+        explicit Noise(const NXUInt32 uSeed = 0);
+        ~Noise();
+
+    public:
+        /**
+         *  fLacunarity/fGain: frequency and amplitude factor from one octave to the next. fBm is divided by
+         *  the sum of the amplitudes, its first octave is the single octave noise of the same seed.
+         */
+        Noise&   SetSeed(const NXUInt32 uSeed);
+        Noise&   SetOctaves(const int iOctaves);
+        Noise&   SetLacunarity(const float fLacunarity);
+        Noise&   SetGain(const float fGain);
+        NXUInt32 GetSeed() const;
+        int      GetOctaves() const;
+        float    GetLacunarity() const;
+        float    GetGain() const;
+
+    public://one octave
+        float  Sample(const NOISE_TYPE eType, const float x, const float y) const;
+        float  Sample(const NOISE_TYPE eType, const float x, const float y, const float z) const;
+        float  Sample(const NOISE_TYPE eType, const float x, const float y, const float z, const float w) const;
+
+        /**
+         *  pOut[i] = Sample(eType, pXs[i], pYs[i], ...) for i in [0, iCount)
+         */
+        void   Sample(const NOISE_TYPE eType, const float *pXs, const float *pYs, float *pOut, const int iCount) const;
+        void   Sample(const NOISE_TYPE eType, const float *pXs, const float *pYs, const float *pZs, float *pOut, const int iCount) const;
+        void   Sample(const NOISE_TYPE eType, const float *pXs, const float *pYs, const float *pZs, const float *pWs, float *pOut, const int iCount) const;
+
+    public://GetOctaves() octaves
+        float  Fbm(const NOISE_TYPE eType, const float x, const float y) const;
+        float  Fbm(const NOISE_TYPE eType, const float x, const float y, const float z) const;
+        float  Fbm(const NOISE_TYPE eType, const float x, const float y, const float z, const float w) const;
+        void   Fbm(const NOISE_TYPE eType, const float *pXs, const float *pYs, float *pOut, const int iCount) const;
+        void   Fbm(const NOISE_TYPE eType, const float *pXs, const float *pYs, const float *pZs, float *pOut, const int iCount) const;
+        void   Fbm(const NOISE_TYPE eType, const float *pXs, const float *pYs, const float *pZs, const float *pWs, float *pOut, const int iCount) const;
+
+    public://2D fractals for heightfields, GetOctaves() octaves
+        /**
+         *  ridged multifractal, 1 - |noise| squared and weighted by the previous octave, about [-1, 1]
+         */
+        float  Ridged(const NOISE_TYPE eType, const float x, const float y) const;
+        void   Ridged(const NOISE_TYPE eType, const float *pXs, const float *pYs, float *pOut, const int iCount) const;
+
+        /**
+         *  Fbm sampled at (x, y) displaced by fStrength times two more fBm fields of their own seeds
+         */
+        float  Warp(const NOISE_TYPE eType, const float x, const float y, const float fStrength) const;
+        void   Warp(const NOISE_TYPE eType, const float *pXs, const float *pYs, const float fStrength, float *pOut, const int iCount) const;
+
+    public:
+        /**
+         *  curl of a vector potential whose components are simplex fBm fields of their own seeds. the
+         *  derivatives are analytic, so the field has no divergence and makes particles swirl without
+         *  gathering or thinning out. magnitudes are a few units per unit of frequency.
+         */
+        float3 Curl(const float3 &Position) const;
+        void   Curl(const float *pXs, const float *pYs, const float *pZs, float *pOutXs, float *pOutYs, float *pOutZs, const int iCount) const;
+
+    private:
+        NXUInt32    m_uSeed;
+        int         m_iOctaves;
+        float       m_fLacunarity;
+        float       m_fGain;
+        float       m_fInvNorm;                              // 1 / sum of the octave amplitudes
+        NXUInt32    m_Seeds[POTENTIAL_COUNT][MAX_OCTAVES];   // lattice of every octave, [0] also for Sample, Fbm and Ridged
+    };
+}
+
+#endif //!__ZX_NXENGINE_NOISE_H__
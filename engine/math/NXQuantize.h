@@ -0,0 +1,87 @@
+/*
+ *  File:    NXQuantize.h
+ *  author:  张雄
+ *  date:    2026_10_19
+ *  purpose: compact encodings for vertex data, 16 bit quantized scalars with an offset/scale range
+ *           and 16 bit octahedral unit vectors
+ */
+
+#ifndef __ZX_NXENGINE_QUANTIZE_H__
+#define __ZX_NXENGINE_QUANTIZE_H__
+
+#include <cmath>
+
+#include "NXVector.h"
+#include "../common/NXType.h"
+
+namespace NX {
+    /**
+     *  value = fOffset + q * fScale, q in [-32767, 32767]
+     */
+    struct QuantizeRange {
+        float   fOffset;
+        float   fScale;
+    };
+
+    /**
+     *  <fMin> smallest value the range must hold
+     *  <fMax> largest value the range must hold
+     *  return the tightest range covering [fMin, fMax]
+     */
+    inline QuantizeRange GetQuantizeRange(const float fMin, const float fMax){
+        QuantizeRange range;
+        range.fOffset = (fMin + fMax) * 0.5f;
+        range.fScale  = (fMax - fMin) / 65534.f;
+        if(!(range.fScale > 1e-7f)){// flat range, any positive scale reproduces the offset
+            range.fScale = 1e-7f;
+        }
+        return range;
+    }
+
+    inline bool InQuantizeRange(const QuantizeRange &range, const float fMin, const float fMax){
+        const float fHalf = range.fScale * 32767.f;
+        return fMin >= range.fOffset - fHalf && fMax <= range.fOffset + fHalf;
+    }
+
+    inline NXInt16 QuantizeToInt16(const float fValue, const QuantizeRange &range){
+        const float q = std::floor((fValue - range.fOffset) / range.fScale + 0.5f);
+        return (NXInt16)(q < -32767.f ? -32767.f : (q > 32767.f ? 32767.f : q));
+    }
+
+    inline float DequantizeFromInt16(const NXInt16 q, const QuantizeRange &range){
+        return range.fOffset + q * range.fScale;
+    }
+
+    /**
+     *  octahedral projection around +y, the low byte holds x and the high byte z, each quantized
+     *  to [0, 254] so that 127 decodes to exactly 0. a zero vector encodes as +y.
+     */
+    inline NXUInt16 EncodeOctahedral16(const vector<float, 3> &v){
+        const float s = std::abs(v.x) + std::abs(v.y) + std::abs(v.z);
+        if(!(s > 0.f)){
+            return (NXUInt16)(127 | (127 << 8));
+        }
+        float u = v.x / s, w = v.z / s;
+        if(v.y < 0.f){// fold the lower hemisphere onto the corners
+            const float fu = (1.f - std::abs(w)) * (u >= 0.f ? 1.f : -1.f);
+            const float fw = (1.f - std::abs(u)) * (w >= 0.f ? 1.f : -1.f);
+            u = fu, w = fw;
+        }
+        const int qu = (int)std::floor(u * 127.f + 127.5f), qw = (int)std::floor(w * 127.f + 127.5f);
+        return (NXUInt16)(qu | (qw << 8));
+    }
+
+    inline vector<float, 3> DecodeOctahedral16(const NXUInt16 e){
+        float u = ((e & 0xff) - 127) / 127.f, w = ((e >> 8) - 127) / 127.f;
+        const float y = 1.f - std::abs(u) - std::abs(w);
+        if(y < 0.f){
+            const float fu = (1.f - std::abs(w)) * (u >= 0.f ? 1.f : -1.f);
+            const float fw = (1.f - std::abs(u)) * (w >= 0.f ? 1.f : -1.f);
+            u = fu, w = fw;
+        }
+        const float fInvLength = 1.f / std::sqrt(u * u + y * y + w * w);
+        return vector<float, 3>(u * fInvLength, y * fInvLength, w * fInvLength);
+    }
+}
+
+#endif // !__ZX_NXENGINE_QUANTIZE_H__
@@ -0,0 +1,75 @@
+/*
+ *  File:    NXRandom.h
+ *  author:  张雄
+ *  date:    2026_10_19
+ *  purpose: a small random generator with independent streams (pcg32). unlike RandInt/RandUnitFloat it
+ *           holds no global state, so every worker thread can own one and a given (seed, stream) pair
+ *           always yields the same sequence.
+ */
+
+#ifndef __ZX_NXENGINE_RANDOM_H__
+#define __ZX_NXENGINE_RANDOM_H__
+
+#include "../common/NXCore.h"
+#include "../common/NXType.h"
+
+namespace NX {
+    class Random {
+    public:
+        Random(){
+            Seed(0, 0);
+        }
+
+        Random(const NXUInt64 uSeed, const NXUInt64 uStream){
+            Seed(uSeed, uStream);
+        }
+
+    public:
+        /**
+         *  streams with the same seed never overlap, use the worker index as uStream
+         */
+        void Seed(const NXUInt64 uSeed, const NXUInt64 uStream){
+            m_uState     = 0;
+            m_uIncrement = (uStream << 1) | 1;
+            NextUInt32();
+            m_uState    += uSeed;
+            NextUInt32();
+        }
+
+        NXUInt32 NextUInt32(){
+            const NXUInt64 uOld = m_uState;
+            m_uState = uOld * 6364136223846793005ULL + m_uIncrement;
+            const NXUInt32 uXorShifted = (NXUInt32)(((uOld >> 18) ^ uOld) >> 27);
+            const NXUInt32 uRotate     = (NXUInt32)(uOld >> 59);
+            return (uXorShifted >> uRotate) | (uXorShifted << ((0u - uRotate) & 31));
+        }
+
+        /**
+         *  [0, 1) with 24 random bits
+         */
+        float NextFloat(){
+            return (NextUInt32() >> 8) * (1.f / 16777216.f);
+        }
+
+        /**
+         *  [fLeft, fRight)
+         */
+        float FloatInRange(const float fLeft, const float fRight){
+            return fLeft + (fRight - fLeft) * NextFloat();
+        }
+
+        /**
+         *  [iLeft, iRight], both ends included like RandIntInRange
+         */
+        int IntInRange(const int iLeft, const int iRight){
+            NXAssert(iLeft <= iRight);
+            return iLeft + (int)(((NXUInt64)NextUInt32() * (NXUInt64)((NXInt64)iRight - iLeft + 1)) >> 32);
+        }
+
+    private:
+        NXUInt64    m_uState;
+        NXUInt64    m_uIncrement;
+    };
+}
+
+#endif //!__ZX_NXENGINE_RANDOM_H__
@@ -0,0 +1,93 @@
+/*
+ *  File:    NXSIMD.h
+ *  author:  张雄
+ *  date:    2026_10_19
+ *  purpose: SIMD switches and a few helpers shared by the vectorized kernels,
+ *           every kernel keeps a scalar path so platforms without SSE still build
+ */
+
+#ifndef __ZX_NXENGINE_SIMD_H__
+#define __ZX_NXENGINE_SIMD_H__
+
+#include "../common/NXCore.h"
+
+#ifndef NX_SIMD_SSE
+#if defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define NX_SIMD_SSE 1
+#else
+#define NX_SIMD_SSE 0
+#endif
+#endif
+
+#if NX_SIMD_SSE
+#include <xmmintrin.h>
+#include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <malloc.h>
+#define NX_ALIGN(n) __declspec(align(n))
+#else
+#define NX_ALIGN(n) __attribute__((aligned(n)))
+#endif
+
+namespace NX {
+    /**
+     *  size of the cache line we pad shared data to, also the alignment of all SIMD arrays
+     */
+    static const int kSIMDAlignment = 64;
+
+    inline void* NXAlignedAlloc(const size_t uSize, const size_t uAlignment = kSIMDAlignment){
+#if defined(_MSC_VER)
+        return _aligned_malloc(uSize, uAlignment);
+#else
+        void *ptr = nullptr;
+        if(posix_memalign(&ptr, uAlignment, uSize) != 0){
+            return nullptr;
+        }
+        return ptr;
+#endif
+    }
+
+    inline void NXAlignedFree(void *ptr){
+#if defined(_MSC_VER)
+        _aligned_free(ptr);
+#else
+        std::free(ptr);
+#endif
+    }
+
+    /**
+     *  round iCount up to a multiple of iMultiple, iMultiple must be a power of 2
+     */
+    inline int NXAlignCount(const int iCount, const int iMultiple){
+        return (iCount + iMultiple - 1) & ~(iMultiple - 1);
+    }
+
+#if NX_SIMD_SSE
+    inline __m128 SIMDAbs(const __m128 v){
+        return _mm_and_ps(v, _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff)));
+    }
+
+    inline __m128 SIMDSelect(const __m128 mask, const __m128 a, const __m128 b){//mask ? a : b
+        return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+    }
+
+    inline __m128 SIMDFloor(const __m128 v){//valid for |v| < 2^31
+        const __m128 t = _mm_cvtepi32_ps(_mm_cvttps_epi32(v));
+        return _mm_sub_ps(t, _mm_and_ps(_mm_cmpgt_ps(t, v), _mm_set1_ps(1.f)));
+    }
+
+    inline __m128 SIMDClamp(const __m128 v, const __m128 lo, const __m128 hi){
+        return _mm_min_ps(_mm_max_ps(v, lo), hi);
+    }
+
+    inline __m128i SIMDMulLo32(const __m128i a, const __m128i b){//low 32 bits of a * b per lane, SSE2 has no _mm_mullo_epi32
+        const __m128i even = _mm_mul_epu32(a, b);
+        const __m128i odd  = _mm_mul_epu32(_mm_srli_si128(a, 4), _mm_srli_si128(b, 4));
+        return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+    }
+#endif
+}
+
+#endif //!__ZX_NXENGINE_SIMD_H__
@@ -79,4 +79,15 @@ void NX::EffectManager::DeleteEffect(const ID3DXEffect *pEffect) {
 		}
 	}
 	DeleteEffect(strEffectFilePath);
-}
\ No newline at end of file
+}
+void NX::EffectManager::OnLostDevice() {
+	for (auto it : m_Effects) {
+		it.second->OnLostDevice();
+	}
+}
+
+void NX::EffectManager::OnResetDevice() {
+	for (auto it : m_Effects) {
+		it.second->OnResetDevice();
+	}
+}
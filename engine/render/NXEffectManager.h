@@ -26,6 +26,13 @@ namespace NX {
 		void DeleteEffect(const std::string &strEffectFilePath);
 		void DeleteEffect(const ID3DXEffect *pEffect);
 
+	public:
+		/**
+		 *  forwarded to every effect, the device owner calls them around IDirect3DDevice9::Reset
+		 */
+		void OnLostDevice();
+		void OnResetDevice();
+
 	private:
 		std::unordered_map<std::string, ID3DXEffect*>     m_Effects;
 	};
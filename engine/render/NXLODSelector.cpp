@@ -0,0 +1,170 @@
+/*
+ *  File:    NXLODSelector.cpp
+ *
+ *  author:  张雄(zhang xiong, 1025679612@qq.com)
+ *  date:    2026_10_19
+ *  purpose: screen space error driven level of detail selection
+ */
+
+#include <algorithm>
+#include <queue>
+#include <functional>
+
+#include "NXLODSelector.h"
+#include "NXCamera.h"
+#include "../entity/NXIEntity.h"
+#include "../math/NXAlgorithm.h"
+
+NX::LODSelector::LODSelector() {
+	m_fPixelError      = 1.f;
+	m_fHysteresis      = 0.2f;
+	m_iTriangleBudget  = 0;
+	m_fViewportHeight  = 600.f;
+	NXClearStruct(m_Statistics);
+}
+
+NX::LODSelector::~LODSelector() {
+	/**empty here*/
+}
+
+NX::LODSelector& NX::LODSelector::AddEntity(IEntity *pEntity) {
+	NXAssert(pEntity);
+	if (std::find(m_Entitys.begin(), m_Entitys.end(), pEntity) == m_Entitys.end()) {
+		m_Entitys.push_back(pEntity);
+	}
+	return *this;
+}
+
+NX::LODSelector& NX::LODSelector::RemoveEntity(IEntity *pEntity) {
+	m_Entitys.erase(std::remove(m_Entitys.begin(), m_Entitys.end(), pEntity), m_Entitys.end());
+	return *this;
+}
+
+NX::LODSelector& NX::LODSelector::Clear() {
+	m_Entitys.clear();
+	return *this;
+}
+
+NX::LODSelector& NX::LODSelector::SetPixelError(const float fPixelError) {
+	m_fPixelError = fPixelError;
+	return *this;
+}
+
+NX::LODSelector& NX::LODSelector::SetHysteresis(const float fHysteresis) {
+	m_fHysteresis = fHysteresis < 0.f ? 0.f : (fHysteresis > 0.99f ? 0.99f : fHysteresis);
+	return *this;
+}
+
+NX::LODSelector& NX::LODSelector::SetTriangleBudget(const int iTriangleBudget) {
+	m_iTriangleBudget = iTriangleBudget;
+	return *this;
+}
+
+NX::LODSelector& NX::LODSelector::SetViewportHeight(const float fViewportHeight) {
+	m_fViewportHeight = fViewportHeight;
+	return *this;
+}
+
+float NX::LODSelector::GetPixelError() const {
+	return m_fPixelError;
+}
+
+float NX::LODSelector::GetHysteresis() const {
+	return m_fHysteresis;
+}
+
+int NX::LODSelector::GetTriangleBudget() const {
+	return m_iTriangleBudget;
+}
+
+float NX::LODSelector::GetViewportHeight() const {
+	return m_fViewportHeight;
+}
+
+const NX::LODSelector::Statistics& NX::LODSelector::GetStatistics() const {
+	return m_Statistics;
+}
+
+float NX::LODSelector::GetErrorScale(const IEntity *pEntity, const float3 &Eye, const float4x4 &ProjectMatrix) const {
+	//pixels per world unit: half viewport height * P[1][1], divided by the distance for perspective projections
+	float fScale = 0.5f * m_fViewportHeight * ProjectMatrix.m_Element[1][1];
+	if (ProjectMatrix.m_Element[3][2] != 0.f) {
+		const float fDistance = NX::Length(pEntity->GetTransform().GetTranslation() - Eye) - pEntity->GetBoundingRadius();
+		fScale /= std::max(fDistance, 1e-4f);
+	}
+	return fScale;
+}
+
+float NX::LODSelector::GetScreenSpaceError(const IEntity *pEntity, const int iLOD, const float3 &Eye, const float4x4 &ProjectMatrix) const {
+	return pEntity->GetLODGeometricError(iLOD) * GetErrorScale(pEntity, Eye, ProjectMatrix);
+}
+
+void NX::LODSelector::Select(MVMatrixController *pMVController, ProjectController *pProjectController) {
+	Select(pMVController->GetEyePosition(), pProjectController->GetProjectMatrix());
+}
+
+void NX::LODSelector::Select(const float3 &Eye, const float4x4 &ProjectMatrix) {
+	NXClearStruct(m_Statistics);
+
+	std::vector<int>   Levels(m_Entitys.size(), 0);
+	std::vector<float> Scales(m_Entitys.size(), 0.f);
+	const float fCoarsenError = m_fPixelError * (1.f - m_fHysteresis);
+
+	{//per entity choice, refine at once when the current level is too coarse, coarsen only below the hysteresis margin
+		for (size_t i = 0; i < m_Entitys.size(); ++i) {
+			IEntity *pEntity = m_Entitys[i];
+			if (!pEntity->IsVisible()) {
+				continue;
+			}
+			const int   iCount   = pEntity->GetLODCount();
+			const int   iCurrent = std::min(pEntity->GetLOD(), iCount - 1);
+			const float fScale   = GetErrorScale(pEntity, Eye, ProjectMatrix);
+			Scales[i] = fScale;
+
+			int iTarget = 0;
+			while (iTarget + 1 < iCount && pEntity->GetLODGeometricError(iTarget + 1) * fScale <= m_fPixelError) {
+				++iTarget;
+			}
+			int iLevel = iCurrent;
+			if (iTarget < iCurrent) {
+				iLevel = iTarget;
+			} else if (iTarget > iCurrent) {
+				while (iLevel + 1 <= iTarget && pEntity->GetLODGeometricError(iLevel + 1) * fScale <= fCoarsenError) {
+					++iLevel;
+				}
+			}
+			Levels[i] = iLevel;
+			m_Statistics.iEntityCount   += 1;
+			m_Statistics.iTriangleCount += pEntity->GetLODTriangleCount(iLevel);
+		}
+	}
+
+	if (m_iTriangleBudget > 0 && m_Statistics.iTriangleCount > m_iTriangleBudget) {
+		//over budget: repeatedly coarsen the entity whose next level shows the smallest projected error
+		typedef std::pair<float, int> Candidate;
+		std::priority_queue<Candidate, std::vector<Candidate>, std::greater<Candidate> > Queue;
+		for (size_t i = 0; i < m_Entitys.size(); ++i) {
+			if (m_Entitys[i]->IsVisible() && Levels[i] + 1 < m_Entitys[i]->GetLODCount()) {
+				Queue.push(Candidate(m_Entitys[i]->GetLODGeometricError(Levels[i] + 1) * Scales[i], (int)i));
+			}
+		}
+		while (m_Statistics.iTriangleCount > m_iTriangleBudget && !Queue.empty()) {
+			const int i = Queue.top().second;
+			Queue.pop();
+			IEntity *pEntity = m_Entitys[i];
+			m_Statistics.iTriangleCount += pEntity->GetLODTriangleCount(Levels[i] + 1) - pEntity->GetLODTriangleCount(Levels[i]);
+			m_Statistics.iBudgetDowngrades += 1;
+			if (++Levels[i] + 1 < pEntity->GetLODCount()) {
+				Queue.push(Candidate(pEntity->GetLODGeometricError(Levels[i] + 1) * Scales[i], i));
+			}
+		}
+		m_Statistics.bOverBudget = m_Statistics.iTriangleCount > m_iTriangleBudget;
+	}
+
+	for (size_t i = 0; i < m_Entitys.size(); ++i) {
+		if (m_Entitys[i]->IsVisible() && m_Entitys[i]->GetLOD() != Levels[i]) {
+			m_Entitys[i]->SetLOD(Levels[i]);
+			m_Statistics.iSwitchCount += 1;
+		}
+	}
+}
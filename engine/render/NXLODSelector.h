@@ -0,0 +1,81 @@
+/*
+ *  File:    NXLODSelector.h
+ *
+ *  author:  张雄(zhang xiong, 1025679612@qq.com)
+ *  date:    2026_10_19
+ *  purpose: pick a detail level for every registered entity from its projected screen space error,
+ *           coarsening only after a hysteresis margin to avoid popping, then degrade the cheapest
+ *           entities further until the global triangle budget holds
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "../math/NXVector.h"
+#include "../math/NXMatrix.h"
+
+namespace NX {
+	class IEntity;
+
+	class LODSelector {
+	public:
+		struct Statistics {
+			int    iEntityCount;        // visible entities taking part in this selection
+			int    iTriangleCount;      // triangles of the selected levels
+			int    iSwitchCount;        // entities whose level changed
+			int    iBudgetDowngrades;   // extra coarsening steps taken to honor the triangle budget
+			bool   bOverBudget;         // every entity is at its coarsest level and the budget still fails
+		};
+
+	public:
+		LODSelector();
+		virtual ~LODSelector();
+
+	public:
+		LODSelector& AddEntity(IEntity *pEntity);
+		LODSelector& RemoveEntity(IEntity *pEntity);
+		LODSelector& Clear();
+
+	public:
+		/**
+		 *  fPixelError: largest allowed projected error in pixels
+		 *  fHysteresis: in [0, 1), a coarser level is taken only when its error is below fPixelError * (1 - fHysteresis)
+		 *  iTriangleBudget: <= 0 means no budget
+		 */
+		LODSelector& SetPixelError(const float fPixelError);
+		LODSelector& SetHysteresis(const float fHysteresis);
+		LODSelector& SetTriangleBudget(const int iTriangleBudget);
+		LODSelector& SetViewportHeight(const float fViewportHeight);
+		float        GetPixelError() const;
+		float        GetHysteresis() const;
+		int          GetTriangleBudget() const;
+		float        GetViewportHeight() const;
+
+	public:
+		/**
+		 *  select levels for the camera at Eye with the given projection matrix, the result is written
+		 *  to the entities with IEntity::SetLOD
+		 */
+		void  Select(const float3 &Eye, const float4x4 &ProjectMatrix);
+		void  Select(class MVMatrixController *pMVController, class ProjectController *pProjectController);
+
+		/**
+		 *  projected error in pixels of one level of pEntity seen from Eye
+		 */
+		float GetScreenSpaceError(const IEntity *pEntity, const int iLOD, const float3 &Eye, const float4x4 &ProjectMatrix) const;
+
+		const Statistics& GetStatistics() const;
+
+	private:
+		float  GetErrorScale(const IEntity *pEntity, const float3 &Eye, const float4x4 &ProjectMatrix) const;
+
+	private:
+		std::vector<IEntity*>     m_Entitys;
+		float                     m_fPixelError;
+		float                     m_fHysteresis;
+		int                       m_iTriangleBudget;
+		float                     m_fViewportHeight;
+		Statistics                m_Statistics;
+	};
+}
@@ -0,0 +1,268 @@
+/*
+ *  File:    NXMeshOptimizer.cpp
+ *
+ *  author:  张雄(zhang xiong, 1025679612@qq.com)
+ *  date:    2026_10_19
+ *  purpose: index and vertex order optimization of generated meshes
+ */
+
+#include <cmath>
+#include <cstring>
+
+#include "NXMeshOptimizer.h"
+#include "../common/NXCore.h"
+#include "../math/NXMath.h"
+
+namespace {
+	const int   MAX_CACHE_SIZE      = 64;
+	const float CACHE_DECAY_POWER   = 1.5f;
+	const float LAST_TRIANGLE_SCORE = 0.75f;
+	const float VALENCE_BOOST_SCALE = 2.f;
+	const float VALENCE_BOOST_POWER = 0.5f;
+
+	/**
+	 *  Forsyth's vertex score: the three most recent vertices share a fixed score so the next triangle
+	 *  doesn't prefer strip order, older entries decay with their LRU position and vertices with few
+	 *  remaining triangles get a boost so they are finished off instead of left behind
+	 */
+	float GetVertexScore(const int iCachePosition, const int iLiveTriangles, const int iCacheSize) {
+		if (iLiveTriangles == 0) {
+			return -1.f;
+		}
+
+		float fScore = 0.f;
+		if (iCachePosition >= 0) {
+			if (iCachePosition < 3) {
+				fScore = LAST_TRIANGLE_SCORE;
+			} else {
+				const float fScale = 1.f / (iCacheSize - 3);
+				fScore = std::pow(1.f - (iCachePosition - 3) * fScale, CACHE_DECAY_POWER);
+			}
+		}
+		return fScore + VALENCE_BOOST_SCALE * std::pow((float)iLiveTriangles, -VALENCE_BOOST_POWER);
+	}
+
+	template<typename Index>
+	NX::MeshOptimizer::CacheStatistics AnalyzeFIFO(const Index *pIndexs, const int iIndexCount, const int iVertexCount, const int iCacheSize) {
+		NX::MeshOptimizer::CacheStatistics Result;
+		NXClearStruct(Result);
+		Result.iTriangleCount = iIndexCount / 3;
+		if (Result.iTriangleCount == 0) {
+			return Result;
+		}
+
+		//a vertex is in the FIFO while less than iCacheSize misses happened since its own miss
+		std::vector<int> Stamps(iVertexCount, -1);
+		int iTime = 0;
+		for (int i = 0; i < Result.iTriangleCount * 3; ++i) {
+			const Index v = pIndexs[i];
+			NXAssert((int)v < iVertexCount);
+			if (Stamps[v] < 0) {
+				++Result.iVertexCount;
+			}
+			if (Stamps[v] < 0 || iTime - Stamps[v] >= iCacheSize) {
+				Stamps[v] = iTime++;
+			}
+		}
+		Result.iTransformCount = iTime;
+		Result.fACMR           = (float)Result.iTransformCount / Result.iTriangleCount;
+		Result.fATVR           = (float)Result.iTransformCount / Result.iVertexCount;
+		return Result;
+	}
+
+	template<typename Index>
+	void OptimizeForsyth(Index *pIndexs, const int iIndexCount, const int iVertexCount, const int _iCacheSize) {
+		const int iTriangleCount = iIndexCount / 3;
+		const int iCacheSize     = NX::NXMin(NX::NXMax(_iCacheSize, 4), MAX_CACHE_SIZE);
+		if (iTriangleCount < 2) {
+			return;
+		}
+
+		//triangles around every vertex, the live ones are kept in front of each range
+		std::vector<int> Offsets(iVertexCount + 1, 0), LiveCounts(iVertexCount, 0);
+		for (int i = 0; i < iTriangleCount * 3; ++i) {
+			NXAssert((int)pIndexs[i] < iVertexCount);
+			++LiveCounts[pIndexs[i]];
+		}
+		for (int v = 0; v < iVertexCount; ++v) {
+			Offsets[v + 1] = Offsets[v] + LiveCounts[v];
+		}
+		std::vector<int> Adjacency(Offsets[iVertexCount]), Fill(Offsets.begin(), Offsets.end() - 1);
+		for (int t = 0; t < iTriangleCount; ++t) {
+			for (int k = 0; k < 3; ++k) {
+				Adjacency[Fill[pIndexs[t * 3 + k]]++] = t;
+			}
+		}
+
+		std::vector<int>   CachePositions(iVertexCount, -1);
+		std::vector<float> VertexScores(iVertexCount), TriangleScores(iTriangleCount);
+		std::vector<char>  Emitted(iTriangleCount, 0);
+		for (int v = 0; v < iVertexCount; ++v) {
+			VertexScores[v] = GetVertexScore(-1, LiveCounts[v], iCacheSize);
+		}
+		for (int t = 0; t < iTriangleCount; ++t) {
+			TriangleScores[t] = VertexScores[pIndexs[t * 3]] + VertexScores[pIndexs[t * 3 + 1]] + VertexScores[pIndexs[t * 3 + 2]];
+		}
+
+		std::vector<Index> Output(iTriangleCount * 3);
+		int Cache[MAX_CACHE_SIZE + 3], NewCache[MAX_CACHE_SIZE + 3];
+		int iCacheCount = 0, iBest = 0, iCursor = 0;
+		for (int iOut = 0; iOut < iTriangleCount; ++iOut) {
+			if (iBest < 0) {//nothing in the cache has live triangles left, continue in input order
+				while (Emitted[iCursor]) {
+					++iCursor;
+				}
+				iBest = iCursor;
+			}
+
+			const Index *pTriangle = pIndexs + iBest * 3;
+			Output[iOut * 3]     = pTriangle[0];
+			Output[iOut * 3 + 1] = pTriangle[1];
+			Output[iOut * 3 + 2] = pTriangle[2];
+			Emitted[iBest] = 1;
+
+			int iNewCount = 0;
+			for (int k = 0; k < 3; ++k) {//the emitted triangle leaves the live lists of its vertices
+				const int v = pTriangle[k];
+				int *pBegin = &Adjacency[0] + Offsets[v], *pEnd = pBegin + LiveCounts[v];
+				for (int *p = pBegin; p < pEnd; ++p) {
+					if (*p == iBest) {
+						*p = pEnd[-1], pEnd[-1] = iBest;
+						break;
+					}
+				}
+				--LiveCounts[v];
+				NewCache[iNewCount++] = v;
+			}
+			for (int i = 0; i < iCacheCount; ++i) {
+				const int v = Cache[i];
+				if (v != (int)pTriangle[0] && v != (int)pTriangle[1] && v != (int)pTriangle[2]) {
+					NewCache[iNewCount++] = v;
+				}
+			}
+
+			//rescore the vertices that moved, including the ones pushed out of the cache
+			for (int i = 0; i < iNewCount; ++i) {
+				const int v = NewCache[i];
+				CachePositions[v] = i < iCacheSize ? i : -1;
+				VertexScores[v]   = GetVertexScore(CachePositions[v], LiveCounts[v], iCacheSize);
+			}
+
+			iBest = -1;
+			float fBestScore = -1.f;
+			for (int i = 0; i < iNewCount; ++i) {
+				const int v = NewCache[i];
+				for (int j = Offsets[v], iEnd = Offsets[v] + LiveCounts[v]; j < iEnd; ++j) {
+					const int t = Adjacency[j];
+					const Index *p = pIndexs + t * 3;
+					TriangleScores[t] = VertexScores[p[0]] + VertexScores[p[1]] + VertexScores[p[2]];
+					if (TriangleScores[t] > fBestScore) {
+						fBestScore = TriangleScores[t], iBest = t;
+					}
+				}
+			}
+
+			iCacheCount = NX::NXMin(iNewCount, iCacheSize);
+			memcpy(Cache, NewCache, sizeof(int) * iCacheCount);
+		}
+		memcpy(pIndexs, &Output[0], sizeof(Index) * Output.size());
+	}
+}
+
+NX::MeshOptimizer::CacheStatistics NX::MeshOptimizer::AnalyzeVertexCache(const NXUInt32 *pIndexs, const int iIndexCount, const int iVertexCount, const int iCacheSize) {
+	return AnalyzeFIFO(pIndexs, iIndexCount, iVertexCount, iCacheSize);
+}
+
+NX::MeshOptimizer::CacheStatistics NX::MeshOptimizer::AnalyzeVertexCache(const NXUInt16 *pIndexs, const int iIndexCount, const int iVertexCount, const int iCacheSize) {
+	return AnalyzeFIFO(pIndexs, iIndexCount, iVertexCount, iCacheSize);
+}
+
+void NX::MeshOptimizer::Accumulate(CacheStatistics &Total, const CacheStatistics &Part) {
+	Total.iTriangleCount  += Part.iTriangleCount;
+	Total.iVertexCount    += Part.iVertexCount;
+	Total.iTransformCount += Part.iTransformCount;
+	Total.fACMR = Total.iTriangleCount > 0 ? (float)Total.iTransformCount / Total.iTriangleCount : 0.f;
+	Total.fATVR = Total.iVertexCount > 0 ? (float)Total.iTransformCount / Total.iVertexCount : 0.f;
+}
+
+void NX::MeshOptimizer::OptimizeVertexCache(NXUInt32 *pIndexs, const int iIndexCount, const int iVertexCount, const int iCacheSize) {
+	OptimizeForsyth(pIndexs, iIndexCount, iVertexCount, iCacheSize);
+}
+
+void NX::MeshOptimizer::OptimizeVertexCache(NXUInt16 *pIndexs, const int iIndexCount, const int iVertexCount, const int iCacheSize) {
+	OptimizeForsyth(pIndexs, iIndexCount, iVertexCount, iCacheSize);
+}
+
+int NX::MeshOptimizer::OptimizeVertexFetch(void *pVertexs, const int iVertexSize, const int iVertexCount, NXUInt32 *pIndexs, const int iIndexCount, std::vector<NXUInt32> *pRemap) {
+	std::vector<NXUInt32> Remap(iVertexCount, ~0u);
+	NXUInt32 uNext = 0;
+	for (int i = 0; i < iIndexCount; ++i) {
+		NXUInt32 &uNew = Remap[pIndexs[i]];
+		if (uNew == ~0u) {
+			uNew = uNext++;
+		}
+		pIndexs[i] = uNew;
+	}
+
+	if (pVertexs && iVertexSize > 0) {
+		std::vector<NXUInt8> Source((NXUInt8*)pVertexs, (NXUInt8*)pVertexs + iVertexSize * iVertexCount);
+		for (int v = 0; v < iVertexCount; ++v) {
+			if (Remap[v] != ~0u) {
+				memcpy((NXUInt8*)pVertexs + Remap[v] * iVertexSize, &Source[v * iVertexSize], iVertexSize);
+			}
+		}
+	}
+
+	if (pRemap) {
+		pRemap->swap(Remap);
+	}
+	return (int)uNext;
+}
+
+void NX::MeshOptimizer::SplitIndex16(const NXUInt32 *pIndexs, const int iIndexCount, const int iVertexCount, std::vector<Chunk> &Chunks, std::vector<NXUInt16> &Indexs16, std::vector<NXUInt32> &Vertexs, const int _iMaxVertexs) {
+	const int iMaxVertexs = NXMin(NXMax(_iMaxVertexs, 3), (int)MAX_INDEX16_VERTEX);
+	Chunks.clear(), Indexs16.clear(), Vertexs.clear();
+	Indexs16.reserve(iIndexCount);
+
+	//Locals[v] is the chunk-local index of v, valid only while Owners[v] is the current chunk
+	std::vector<int> Locals(iVertexCount, 0), Owners(iVertexCount, -1);
+	Chunk Current = { 0, 0, 0, 0 };
+	for (int t = 0; t < iIndexCount / 3; ++t) {
+		const NXUInt32 *pTriangle = pIndexs + t * 3;
+		int iNewCount = 0;
+		for (int k = 0; k < 3; ++k) {
+			iNewCount += Owners[pTriangle[k]] != (int)Chunks.size() && (k < 1 || pTriangle[k] != pTriangle[0]) && (k < 2 || pTriangle[k] != pTriangle[1]);
+		}
+		if (Current.iVertexCount + iNewCount > iMaxVertexs) {
+			Chunks.push_back(Current);
+			Current.iBaseVertex     = (int)Vertexs.size();
+			Current.iVertexCount    = 0;
+			Current.iStartIndex     = (int)Indexs16.size();
+			Current.iPrimitiveCount = 0;
+		}
+
+		const int iChunk = (int)Chunks.size();
+		for (int k = 0; k < 3; ++k) {
+			const NXUInt32 v = pTriangle[k];
+			if (Owners[v] != iChunk) {
+				Owners[v] = iChunk;
+				Locals[v] = Current.iVertexCount++;
+				Vertexs.push_back(v);
+			}
+			Indexs16.push_back((NXUInt16)Locals[v]);
+		}
+		++Current.iPrimitiveCount;
+	}
+	if (Current.iPrimitiveCount > 0) {
+		Chunks.push_back(Current);
+	}
+}
+
+NX::MeshOptimizer::Report NX::MeshOptimizer::Optimize(void *pVertexs, const int iVertexSize, int &iVertexCount, NXUInt32 *pIndexs, const int iIndexCount) {
+	Report Result;
+	Result.Before = AnalyzeVertexCache(pIndexs, iIndexCount, iVertexCount);
+	OptimizeVertexCache(pIndexs, iIndexCount, iVertexCount);
+	iVertexCount  = OptimizeVertexFetch(pVertexs, iVertexSize, iVertexCount, pIndexs, iIndexCount);
+	Result.After  = AnalyzeVertexCache(pIndexs, iIndexCount, iVertexCount);
+	return Result;
+}
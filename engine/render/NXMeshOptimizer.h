@@ -0,0 +1,94 @@
+/*
+ *  File:    NXMeshOptimizer.h
+ *
+ *  author:  张雄(zhang xiong, 1025679612@qq.com)
+ *  date:    2026_10_19
+ *  purpose: post-process indexed triangle lists of generated meshes: reorder triangles for the post
+ *           transform vertex cache (Forsyth's linear-speed algorithm), reorder vertices by first use
+ *           for the pre transform fetch, split lists into chunks of at most 65535 vertices so they
+ *           can be drawn with 16 bit indices, and measure ACMR/ATVR on the CPU with a simulated cache.
+ *           nothing here touches the device.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "../common/NXType.h"
+
+namespace NX {
+	class MeshOptimizer {
+	public:
+		/**
+		 *  ACMR: transformed vertices / triangles, 0.5 is the lower bound of a regular grid, 3 means no reuse
+		 *  ATVR: transformed vertices / referenced vertices, 1 is optimal
+		 */
+		struct CacheStatistics {
+			int    iTriangleCount;
+			int    iVertexCount;       // distinct vertices referenced by the indices
+			int    iTransformCount;    // cache misses of the simulated FIFO
+			float  fACMR;
+			float  fATVR;
+		};
+
+		struct Report {
+			CacheStatistics   Before;
+			CacheStatistics   After;
+		};
+
+		/**
+		 *  a range of a 16 bit index list, drawn with
+		 *  DrawIndexedPrimitive(D3DPT_TRIANGLELIST, iBaseVertex, 0, iVertexCount, iStartIndex, iPrimitiveCount)
+		 */
+		struct Chunk {
+			int    iBaseVertex;
+			int    iVertexCount;
+			int    iStartIndex;
+			int    iPrimitiveCount;
+		};
+
+		enum {
+			FORSYTH_CACHE_SIZE  = 32,    // LRU size the triangle order is optimized for
+			ANALYZE_CACHE_SIZE  = 16,    // FIFO size of the reported ACMR/ATVR, close to the post transform cache of DX9 hardware
+			MAX_INDEX16_VERTEX  = 65535, // 0xffff is left out, some drivers treat it as a restart index
+		};
+
+	public:
+		/**
+		 *  simulate a FIFO post transform cache over a triangle list
+		 */
+		static CacheStatistics AnalyzeVertexCache(const NXUInt32 *pIndexs, const int iIndexCount, const int iVertexCount, const int iCacheSize = ANALYZE_CACHE_SIZE);
+		static CacheStatistics AnalyzeVertexCache(const NXUInt16 *pIndexs, const int iIndexCount, const int iVertexCount, const int iCacheSize = ANALYZE_CACHE_SIZE);
+
+		/**
+		 *  add the counts of Part to Total and recompute its ratios, for meshes drawn as several ranges
+		 */
+		static void Accumulate(CacheStatistics &Total, const CacheStatistics &Part);
+
+		/**
+		 *  reorder the triangles of a list in place, the triangles and their winding are kept
+		 */
+		static void OptimizeVertexCache(NXUInt32 *pIndexs, const int iIndexCount, const int iVertexCount, const int iCacheSize = FORSYTH_CACHE_SIZE);
+		static void OptimizeVertexCache(NXUInt16 *pIndexs, const int iIndexCount, const int iVertexCount, const int iCacheSize = FORSYTH_CACHE_SIZE);
+
+		/**
+		 *  renumber vertices in the order the indices first reference them and move the iVertexSize byte
+		 *  vertices of pVertexs to match, unreferenced vertices are dropped from the end.
+		 *  returns the new vertex count, pRemap (may be nullptr) receives old index -> new index, ~0u for dropped
+		 */
+		static int  OptimizeVertexFetch(void *pVertexs, const int iVertexSize, const int iVertexCount, NXUInt32 *pIndexs, const int iIndexCount, std::vector<NXUInt32> *pRemap = nullptr);
+
+		/**
+		 *  split a triangle list into consecutive chunks referencing at most iMaxVertexs vertices each.
+		 *  Indexs16 receives the local indices, Vertexs the source vertex of every chunk vertex (chunks
+		 *  are stored back to back, iBaseVertex is the offset of a chunk in Vertexs). a mesh that fits
+		 *  gives a single chunk with Vertexs being 0..iVertexCount-1 when the input is fetch optimized.
+		 */
+		static void SplitIndex16(const NXUInt32 *pIndexs, const int iIndexCount, const int iVertexCount, std::vector<Chunk> &Chunks, std::vector<NXUInt16> &Indexs16, std::vector<NXUInt32> &Vertexs, const int iMaxVertexs = MAX_INDEX16_VERTEX);
+
+		/**
+		 *  the usual pipeline for a generated mesh: vertex cache, then vertex fetch order, statistics of both ends
+		 */
+		static Report Optimize(void *pVertexs, const int iVertexSize, int &iVertexCount, NXUInt32 *pIndexs, const int iIndexCount);
+	};
+}
@@ -0,0 +1,372 @@
+/*
+ *  File:    NXOcclusionCuller.cpp
+ *
+ *  author:  张雄(zhang xiong, 1025679612@qq.com)
+ *  date:    2026_10_19
+ *  purpose: CPU depth-only rasterizer for software occlusion culling
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include "NXOcclusionCuller.h"
+#include "../math/NXAABB.h"
+#include "../math/NXMath.h"
+#include "../math/NXSIMD.h"
+#include "../common/NXParallel.h"
+
+struct NX::OcclusionCuller::ScreenTriangle {
+	float  EdgeA[3], EdgeB[3], EdgeC[3];   // E(x, y) = A * x + B * y + C, >= 0 inside for all three edges
+	float  DepthA, DepthB, DepthC;         // z(x, y) = A * x + B * y + C
+	int    MinX, MinY, MaxX, MaxY;         // pixel bounds, inclusive
+};
+
+namespace {
+	const float kNearW = 1e-5f;
+
+	inline NX::float4 TransformPoint(const NX::float4x4 &M, const float x, const float y, const float z) {
+		return NX::float4(M.m_Element[0][0] * x + M.m_Element[0][1] * y + M.m_Element[0][2] * z + M.m_Element[0][3],
+			              M.m_Element[1][0] * x + M.m_Element[1][1] * y + M.m_Element[1][2] * z + M.m_Element[1][3],
+			              M.m_Element[2][0] * x + M.m_Element[2][1] * y + M.m_Element[2][2] * z + M.m_Element[2][3],
+			              M.m_Element[3][0] * x + M.m_Element[3][1] * y + M.m_Element[3][2] * z + M.m_Element[3][3]);
+	}
+
+	inline NX::float4 LerpClip(const NX::float4 &a, const NX::float4 &b, const float t) {
+		return NX::float4(a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t, a.z + (b.z - a.z) * t, a.w + (b.w - a.w) * t);
+	}
+}
+
+NX::OcclusionCuller::OcclusionCuller(const int iWidth, const int iHeight, const int iWorkerCount) {
+	NXAssert(iWidth > 0 && iHeight > 0);
+	m_iWidth         = NXAlignCount(iWidth,  TILE_SIZE);
+	m_iHeight        = NXAlignCount(iHeight, TILE_SIZE);
+	m_iTileCountX    = m_iWidth  / TILE_SIZE;
+	m_iTileCountY    = m_iHeight / TILE_SIZE;
+	m_iWorkerCount   = iWorkerCount > 0 ? iWorkerCount : GetHardwareThreadCount();
+	m_PartTriangles.resize(m_iWorkerCount);
+	m_PartBins.resize(m_iWorkerCount);
+	for (int i = 0; i < m_iWorkerCount; ++i) {
+		m_PartBins[i].resize(m_iTileCountX * m_iTileCountY);
+	}
+
+	{//depth buffer and the hi-z chain
+		int w = m_iWidth, h = m_iHeight;
+		m_HiZSize.push_back(std::make_pair(w, h));
+		while (w > 1 || h > 1) {
+			w = (w + 1) >> 1;
+			h = (h + 1) >> 1;
+			m_HiZSize.push_back(std::make_pair(w, h));
+		}
+		m_HiZ.resize(m_HiZSize.size());
+		for (int i = 1; i < (int)m_HiZSize.size(); ++i) {
+			m_HiZ[i].resize(m_HiZSize[i].first * m_HiZSize[i].second, 1.f);
+		}
+		m_DepthBuffer.resize(m_iWidth * m_iHeight, 1.f);
+	}
+	NXClearStruct(m_Statistics);
+}
+
+NX::OcclusionCuller::~OcclusionCuller() {
+	/**empty here*/
+}
+
+void NX::OcclusionCuller::BeginFrame(const float4x4 &ViewProjectMatrix) {
+	m_ViewProjectMatrix = ViewProjectMatrix;
+	m_ClipVertexs.clear();
+	m_Indexs.clear();
+	std::fill(m_DepthBuffer.begin(), m_DepthBuffer.end(), 1.f);
+	NXClearStruct(m_Statistics);
+}
+
+void NX::OcclusionCuller::AddOccluder(const float3 *pVertexs, const int iVertexCount, const NXUInt32 *pIndexs, const int iIndexCount, const float4x4 &ModelMatrix) {
+	NXAssert(pVertexs && pIndexs && iIndexCount % 3 == 0);
+	const NXUInt32 uBase = (NXUInt32)m_ClipVertexs.size();
+	const float4x4 MVP   = m_ViewProjectMatrix * ModelMatrix;
+	m_ClipVertexs.reserve(m_ClipVertexs.size() + iVertexCount);
+	for (int i = 0; i < iVertexCount; ++i) {
+		m_ClipVertexs.push_back(TransformPoint(MVP, pVertexs[i].x, pVertexs[i].y, pVertexs[i].z));
+	}
+	m_Indexs.reserve(m_Indexs.size() + iIndexCount);
+	for (int i = 0; i < iIndexCount; ++i) {
+		NXAssert(pIndexs[i] < (NXUInt32)iVertexCount);
+		m_Indexs.push_back(uBase + pIndexs[i]);
+	}
+	m_Statistics.iOccluderTriangles += iIndexCount / 3;
+}
+
+void NX::OcclusionCuller::RenderOccluders() {
+	const int iTriangleCount = (int)m_Indexs.size() / 3;
+	const int iTileCount     = m_iTileCountX * m_iTileCountY;
+
+	for (int p = 0; p < m_iWorkerCount; ++p) {
+		m_PartTriangles[p].clear();
+		for (int t = 0; t < iTileCount; ++t) {
+			m_PartBins[p][t].clear();
+		}
+	}
+
+	{//clip, set up and bin in parallel, every part owns its own bins so nothing is shared
+		ParallelFor(0, iTriangleCount, m_iWorkerCount, [this](int iBegin, int iEnd, int iPart) {
+			SetupTriangles(iBegin, iEnd, iPart);
+		});
+	}
+
+	{//rasterize in parallel over tiles, a tile only writes its own pixels
+		ParallelFor(0, iTileCount, m_iWorkerCount, [this](int iBegin, int iEnd, int) {
+			for (int t = iBegin; t < iEnd; ++t) {
+				RasterizeTile(t);
+			}
+		});
+	}
+
+	for (int p = 0; p < m_iWorkerCount; ++p) {
+		m_Statistics.iRasterizedTriangles += (int)m_PartTriangles[p].size();
+		for (int t = 0; t < iTileCount; ++t) {
+			m_Statistics.iBinnedTriangles += (int)m_PartBins[p][t].size();
+		}
+	}
+
+	BuildHiZ();
+}
+
+void NX::OcclusionCuller::SetupTriangles(const int iBegin, const int iEnd, const int iPart) {
+	for (int t = iBegin; t < iEnd; ++t) {
+		const float4 v[3] = { m_ClipVertexs[m_Indexs[t * 3]], m_ClipVertexs[m_Indexs[t * 3 + 1]], m_ClipVertexs[m_Indexs[t * 3 + 2]] };
+		const bool   bIn[3] = { v[0].z >= 0.f && v[0].w > kNearW, v[1].z >= 0.f && v[1].w > kNearW, v[2].z >= 0.f && v[2].w > kNearW };
+		const int    iInCount = bIn[0] + bIn[1] + bIn[2];
+		if (iInCount == 3) {
+			EmitTriangle(v[0], v[1], v[2], iPart);
+		} else if (iInCount > 0) {//clip against the near plane z = 0, keeping the winding
+			float4 Poly[4];
+			int    iPolyCount = 0;
+			for (int i = 0; i < 3; ++i) {
+				const float4 &a = v[i], &b = v[(i + 1) % 3];
+				if (bIn[i]) {
+					Poly[iPolyCount++] = a;
+				}
+				if (bIn[i] != bIn[(i + 1) % 3]) {
+					const float t = a.z / (a.z - b.z);
+					Poly[iPolyCount++] = LerpClip(a, b, t);
+				}
+			}
+			for (int i = 2; i < iPolyCount; ++i) {
+				EmitTriangle(Poly[0], Poly[i - 1], Poly[i], iPart);
+			}
+		}
+	}
+}
+
+void NX::OcclusionCuller::EmitTriangle(const float4 &a, const float4 &b, const float4 &c, const int iPart) {
+	const float4 *v[3] = { &a, &b, &c };
+	float sx[3], sy[3], sz[3];
+	for (int i = 0; i < 3; ++i) {
+		const float rw = 1.f / NXMax(v[i]->w, kNearW);
+		sx[i] = (v[i]->x * rw * 0.5f + 0.5f) * m_iWidth;
+		sy[i] = (0.5f - v[i]->y * rw * 0.5f) * m_iHeight;
+		sz[i] = v[i]->z * rw;
+	}
+
+	const float fArea = (sx[1] - sx[0]) * (sy[2] - sy[0]) - (sx[2] - sx[0]) * (sy[1] - sy[0]);
+	//also rejects vertices so close to the eye that the projection overflowed
+	if (!std::isfinite(fArea) || NXAbs(fArea) < 1e-8f) {
+		return;
+	}
+
+	ScreenTriangle tri;
+	{//pixel bounds, clamped to the viewport while still float, far outside values don't fit an int
+		const float fMinX = NXMin(sx[0], NXMin(sx[1], sx[2])), fMaxX = NXMax(sx[0], NXMax(sx[1], sx[2]));
+		const float fMinY = NXMin(sy[0], NXMin(sy[1], sy[2])), fMaxY = NXMax(sy[0], NXMax(sy[1], sy[2]));
+		if (fMaxX < 0.f || fMaxY < 0.f || fMinX >= m_iWidth || fMinY >= m_iHeight) {
+			return;
+		}
+		tri.MinX = (int)std::floor(NXMax(fMinX, 0.f));
+		tri.MinY = (int)std::floor(NXMax(fMinY, 0.f));
+		tri.MaxX = (int)std::floor(NXMin(fMaxX, (float)(m_iWidth - 1)));
+		tri.MaxY = (int)std::floor(NXMin(fMaxY, (float)(m_iHeight - 1)));
+		if (tri.MinX > tri.MaxX || tri.MinY > tri.MaxY) {
+			return;
+		}
+	}
+
+	{//edge functions, oriented so that the inside is positive whatever the winding
+		const float fSign = fArea > 0.f ? 1.f : -1.f;
+		for (int i = 0; i < 3; ++i) {
+			const int j = (i + 1) % 3;
+			tri.EdgeA[i] = (sy[i] - sy[j]) * fSign;
+			tri.EdgeB[i] = (sx[j] - sx[i]) * fSign;
+			tri.EdgeC[i] = (sx[i] * sy[j] - sx[j] * sy[i]) * fSign;
+		}
+	}
+
+	{//depth plane through the three projected vertices
+		const float dx1 = sx[1] - sx[0], dy1 = sy[1] - sy[0], dz1 = sz[1] - sz[0];
+		const float dx2 = sx[2] - sx[0], dy2 = sy[2] - sy[0], dz2 = sz[2] - sz[0];
+		const float fRcp = 1.f / fArea;
+		tri.DepthA = (dz1 * dy2 - dz2 * dy1) * fRcp;
+		tri.DepthB = (dz2 * dx1 - dz1 * dx2) * fRcp;
+		tri.DepthC = sz[0] - tri.DepthA * sx[0] - tri.DepthB * sy[0];
+	}
+
+	std::vector<ScreenTriangle> &Triangles = m_PartTriangles[iPart];
+	const int iIndex = (int)Triangles.size();
+	Triangles.push_back(tri);
+
+	std::vector<std::vector<int> > &Bins = m_PartBins[iPart];
+	for (int ty = tri.MinY / TILE_SIZE, tyEnd = tri.MaxY / TILE_SIZE; ty <= tyEnd; ++ty) {
+		for (int tx = tri.MinX / TILE_SIZE, txEnd = tri.MaxX / TILE_SIZE; tx <= txEnd; ++tx) {
+			Bins[ty * m_iTileCountX + tx].push_back(iIndex);
+		}
+	}
+}
+
+void NX::OcclusionCuller::RasterizeTile(const int iTile) {
+	const int iTileX = iTile % m_iTileCountX;
+	const int iTileY = iTile / m_iTileCountX;
+	for (int p = 0; p < m_iWorkerCount; ++p) {
+		const std::vector<int> &Bin = m_PartBins[p][iTile];
+		const std::vector<ScreenTriangle> &Triangles = m_PartTriangles[p];
+		for (size_t i = 0; i < Bin.size(); ++i) {
+			RasterizeTriangleInTile(Triangles[Bin[i]], iTileX, iTileY);
+		}
+	}
+}
+
+void NX::OcclusionCuller::RasterizeTriangleInTile(const ScreenTriangle &tri, const int iTileX, const int iTileY) {
+	const int x0 = iTileX * TILE_SIZE, y0 = iTileY * TILE_SIZE;
+	const int yBegin = NXMax(y0, tri.MinY), yEnd = NXMin(y0 + TILE_SIZE - 1, tri.MaxY);
+#if NX_SIMD_SSE
+	const __m128 A0 = _mm_set1_ps(tri.EdgeA[0]), B0 = _mm_set1_ps(tri.EdgeB[0]), C0 = _mm_set1_ps(tri.EdgeC[0]);
+	const __m128 A1 = _mm_set1_ps(tri.EdgeA[1]), B1 = _mm_set1_ps(tri.EdgeB[1]), C1 = _mm_set1_ps(tri.EdgeC[1]);
+	const __m128 A2 = _mm_set1_ps(tri.EdgeA[2]), B2 = _mm_set1_ps(tri.EdgeB[2]), C2 = _mm_set1_ps(tri.EdgeC[2]);
+	const __m128 DA = _mm_set1_ps(tri.DepthA),   DB = _mm_set1_ps(tri.DepthB),   DC = _mm_set1_ps(tri.DepthC);
+	const __m128 Zero = _mm_setzero_ps();
+	const __m128 Offset = _mm_set_ps(3.5f, 2.5f, 1.5f, 0.5f);
+	for (int y = yBegin; y <= yEnd; ++y) {
+		const __m128 py = _mm_set1_ps(y + 0.5f);
+		float *pRow = &m_DepthBuffer[y * m_iWidth];
+		for (int x = x0; x < x0 + TILE_SIZE; x += 4) {
+			const __m128 px = _mm_add_ps(_mm_set1_ps((float)x), Offset);
+			const __m128 e0 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(A0, px), _mm_mul_ps(B0, py)), C0);
+			const __m128 e1 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(A1, px), _mm_mul_ps(B1, py)), C1);
+			const __m128 e2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(A2, px), _mm_mul_ps(B2, py)), C2);
+			const __m128 Inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(e0, Zero), _mm_cmpge_ps(e1, Zero)), _mm_cmpge_ps(e2, Zero));
+			if (_mm_movemask_ps(Inside) == 0) {
+				continue;
+			}
+			const __m128 z     = _mm_add_ps(_mm_add_ps(_mm_mul_ps(DA, px), _mm_mul_ps(DB, py)), DC);
+			const __m128 Old   = _mm_loadu_ps(pRow + x);
+			_mm_storeu_ps(pRow + x, SIMDSelect(Inside, _mm_min_ps(Old, _mm_max_ps(z, Zero)), Old));
+		}
+	}
+#else
+	const int xBegin = NXMax(x0, tri.MinX), xEnd = NXMin(x0 + TILE_SIZE - 1, tri.MaxX);
+	for (int y = yBegin; y <= yEnd; ++y) {
+		const float py = y + 0.5f;
+		float *pRow = &m_DepthBuffer[y * m_iWidth];
+		for (int x = xBegin; x <= xEnd; ++x) {
+			const float px = x + 0.5f;
+			if (tri.EdgeA[0] * px + tri.EdgeB[0] * py + tri.EdgeC[0] < 0.f ||
+				tri.EdgeA[1] * px + tri.EdgeB[1] * py + tri.EdgeC[1] < 0.f ||
+				tri.EdgeA[2] * px + tri.EdgeB[2] * py + tri.EdgeC[2] < 0.f) {
+				continue;
+			}
+			const float z = NXMax(tri.DepthA * px + tri.DepthB * py + tri.DepthC, 0.f);
+			pRow[x] = NXMin(pRow[x], z);
+		}
+	}
+#endif
+}
+
+void NX::OcclusionCuller::BuildHiZ() {
+	for (int l = 1; l < (int)m_HiZSize.size(); ++l) {
+		const float *pSrc = l == 1 ? &m_DepthBuffer[0] : &m_HiZ[l - 1][0];
+		const int    sw   = m_HiZSize[l - 1].first, sh = m_HiZSize[l - 1].second;
+		const int    dw   = m_HiZSize[l].first,     dh = m_HiZSize[l].second;
+		float       *pDst = &m_HiZ[l][0];
+		ParallelFor(0, dh, dh >= 64 ? m_iWorkerCount : 1, [=](int iBegin, int iEnd, int) {
+			for (int y = iBegin; y < iEnd; ++y) {
+				const float *r0 = pSrc + (2 * y) * sw;
+				const float *r1 = pSrc + NXMin(2 * y + 1, sh - 1) * sw;
+				for (int x = 0; x < dw; ++x) {
+					const int xa = 2 * x, xb = NXMin(2 * x + 1, sw - 1);
+					pDst[y * dw + x] = NXMax(NXMax(r0[xa], r0[xb]), NXMax(r1[xa], r1[xb]));
+				}
+			}
+		});
+	}
+}
+
+bool NX::OcclusionCuller::IsOccluded(const AABB &box) const {
+	const float3 Min = box.GetMinPoint(), Max = box.GetMaxPoint();
+	float fMinX = 1e30f, fMinY = 1e30f, fMaxX = -1e30f, fMaxY = -1e30f, fMinZ = 1e30f;
+	for (int i = 0; i < 8; ++i) {
+		const float4 c = TransformPoint(m_ViewProjectMatrix, (i & 1) ? Max.x : Min.x, (i & 2) ? Max.y : Min.y, (i & 4) ? Max.z : Min.z);
+		if (c.w <= kNearW || c.z < 0.f) {//touches the near plane, treat as visible
+			return false;
+		}
+		const float rw = 1.f / c.w;
+		const float sx = (c.x * rw * 0.5f + 0.5f) * m_iWidth;
+		const float sy = (0.5f - c.y * rw * 0.5f) * m_iHeight;
+		fMinX = NXMin(fMinX, sx), fMaxX = NXMax(fMaxX, sx);
+		fMinY = NXMin(fMinY, sy), fMaxY = NXMax(fMaxY, sy);
+		fMinZ = NXMin(fMinZ, c.z * rw);
+	}
+
+	if (fMaxX < 0.f || fMaxY < 0.f || fMinX >= m_iWidth || fMinY >= m_iHeight) {
+		return false;
+	}
+
+	const int x0 = NXMax(0, (int)std::floor(fMinX)), x1 = NXMin(m_iWidth - 1,  (int)std::floor(fMaxX));
+	const int y0 = NXMax(0, (int)std::floor(fMinY)), y1 = NXMin(m_iHeight - 1, (int)std::floor(fMaxY));
+
+	int iLevel = 0;
+	while (iLevel + 1 < (int)m_HiZSize.size() && ((x1 >> iLevel) - (x0 >> iLevel) > 2 || (y1 >> iLevel) - (y0 >> iLevel) > 2)) {
+		++iLevel;
+	}
+
+	const float *pLevel = iLevel == 0 ? &m_DepthBuffer[0] : &m_HiZ[iLevel][0];
+	const int    iPitch = m_HiZSize[iLevel].first;
+	for (int y = y0 >> iLevel; y <= (y1 >> iLevel); ++y) {
+		for (int x = x0 >> iLevel; x <= (x1 >> iLevel); ++x) {
+			if (pLevel[y * iPitch + x] >= fMinZ) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+void NX::OcclusionCuller::TestOcclusion(const AABB *pBoxes, const int iBoxCount, bool *pOccluded) const {
+	ParallelFor(0, iBoxCount, iBoxCount >= 256 ? m_iWorkerCount : 1, [=](int iBegin, int iEnd, int) {
+		for (int i = iBegin; i < iEnd; ++i) {
+			pOccluded[i] = IsOccluded(pBoxes[i]);
+		}
+	});
+}
+
+int NX::OcclusionCuller::GetWidth() const {
+	return m_iWidth;
+}
+
+int NX::OcclusionCuller::GetHeight() const {
+	return m_iHeight;
+}
+
+const float* NX::OcclusionCuller::GetDepthBuffer() const {
+	return &m_DepthBuffer[0];
+}
+
+int NX::OcclusionCuller::GetHiZLevelCount() const {
+	return (int)m_HiZSize.size();
+}
+
+const float* NX::OcclusionCuller::GetHiZLevel(const int iLevel, int &iLevelWidth, int &iLevelHeight) const {
+	NXAssert(iLevel >= 0 && iLevel < (int)m_HiZSize.size());
+	iLevelWidth  = m_HiZSize[iLevel].first;
+	iLevelHeight = m_HiZSize[iLevel].second;
+	return iLevel == 0 ? &m_DepthBuffer[0] : &m_HiZ[iLevel][0];
+}
+
+const NX::OcclusionCuller::Statistics& NX::OcclusionCuller::GetStatistics() const {
+	return m_Statistics;
+}
@@ -0,0 +1,95 @@
+/*
+ *  File:    NXOcclusionCuller.h
+ *
+ *  author:  张雄(zhang xiong, 1025679612@qq.com)
+ *  date:    2026_10_19
+ *  purpose: CPU depth-only rasterizer for software occlusion culling, a few big occluder meshes are
+ *           rendered into a small depth buffer split in 8x8 tiles, then entity AABBs are tested
+ *           against a max-depth (hierarchical-Z) pyramid built from it. nothing here touches the GPU.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "../math/NXVector.h"
+#include "../math/NXMatrix.h"
+
+namespace NX {
+	class AABB;
+
+	class OcclusionCuller {
+	public:
+		enum { TILE_SIZE = 8 };
+
+		struct Statistics {
+			int    iOccluderTriangles;     // triangles submitted by AddOccluder
+			int    iRasterizedTriangles;   // triangles left after near clipping and degenerate rejection
+			int    iBinnedTriangles;       // sum of triangle references over all tiles
+		};
+
+	public:
+		/**
+		 *  iWidth and iHeight are rounded up to multiples of TILE_SIZE,
+		 *  iWorkerCount <= 0 means one part per hardware thread
+		 */
+		OcclusionCuller(const int iWidth, const int iHeight, const int iWorkerCount = 0);
+		virtual ~OcclusionCuller();
+
+	public:
+		/**
+		 *  clear depth and occluders, ViewProjectMatrix maps world space to D3D clip space (column vector convention)
+		 */
+		void  BeginFrame(const float4x4 &ViewProjectMatrix);
+
+		/**
+		 *  queue a triangle list occluder, vertices are in model space
+		 */
+		void  AddOccluder(const float3 *pVertexs, const int iVertexCount, const NXUInt32 *pIndexs, const int iIndexCount, const float4x4 &ModelMatrix);
+
+		/**
+		 *  set up, bin and rasterize every queued occluder, then build the hierarchical-Z pyramid
+		 */
+		void  RenderOccluders();
+
+		/**
+		 *  true only when box is completely hidden behind the occluders, boxes crossing the near plane
+		 *  or lying outside the screen are never reported occluded (leave that to the ViewFrustum)
+		 */
+		bool  IsOccluded(const AABB &box) const;
+		void  TestOcclusion(const AABB *pBoxes, const int iBoxCount, bool *pOccluded) const;
+
+	public:
+		int                GetWidth() const;
+		int                GetHeight() const;
+		const float*       GetDepthBuffer() const;
+		int                GetHiZLevelCount() const;
+		const float*       GetHiZLevel(const int iLevel, int &iLevelWidth, int &iLevelHeight) const;
+		const Statistics&  GetStatistics() const;
+
+	private:
+		struct ScreenTriangle;
+
+		void  SetupTriangles(const int iBegin, const int iEnd, const int iPart);
+		void  EmitTriangle(const float4 &a, const float4 &b, const float4 &c, const int iPart);
+		void  RasterizeTile(const int iTile);
+		void  RasterizeTriangleInTile(const ScreenTriangle &tri, const int iTileX, const int iTileY);
+		void  BuildHiZ();
+
+	private:
+		int                                               m_iWidth;
+		int                                               m_iHeight;
+		int                                               m_iTileCountX;
+		int                                               m_iTileCountY;
+		int                                               m_iWorkerCount;
+		float4x4                                          m_ViewProjectMatrix;
+		std::vector<float4>                               m_ClipVertexs;
+		std::vector<NXUInt32>                             m_Indexs;
+		std::vector<std::vector<ScreenTriangle> >         m_PartTriangles;   // [part][triangle]
+		std::vector<std::vector<std::vector<int> > >      m_PartBins;        // [part][tile][triangle]
+		std::vector<float>                                m_DepthBuffer;
+		std::vector<std::vector<float> >                  m_HiZ;             // level 0 is the depth buffer itself
+		std::vector<std::pair<int, int> >                 m_HiZSize;
+		Statistics                                        m_Statistics;
+	};
+}
@@ -10,6 +10,7 @@
 #include "../math/NXEllipse.h"
 #include "../math/NXEllipsoid.h"
 #include "../math/NXCircle.h"
+#include "../math/NXAABB.h"
 
 NX::ViewFrustum::ViewFrustum(){
     /*empty*/
@@ -20,6 +21,16 @@ m_FrontPlane(Front), m_BackPlane(Back), m_LeftPlane(left), m_RightPlane(Right),
     /*empty*/
 }
 
+NX::ViewFrustum::ViewFrustum(const NX::float4x4 &ClipMatrix){
+    NX::float4x4 M = ClipMatrix;
+    m_LeftPlane   = NX::Plane(M.GetRow(3) + M.GetRow(0));
+    m_RightPlane  = NX::Plane(M.GetRow(3) - M.GetRow(0));
+    m_TopPlane    = NX::Plane(M.GetRow(3) - M.GetRow(1));
+    m_BottomPlane = NX::Plane(M.GetRow(3) + M.GetRow(1));
+    m_FrontPlane  = NX::Plane(M.GetRow(3) - M.GetRow(2));
+    m_BackPlane   = NX::Plane(M.GetRow(2));
+}
+
 NX::ViewFrustum::~ViewFrustum(){
     /*empty*/
 }
@@ -182,3 +193,45 @@ bool NX::ViewFrustum::Visible(const NX::Cylinder &cylinder,          const unsig
     NXAssert(0 && "not implemented");
     return false;
 }
+
+bool NX::ViewFrustum::Visible(const NX::AABB &box,                   const unsigned int mask) const{
+    const NX::vector<float, 3> MinPoint = box.GetMinPoint();
+    const NX::vector<float, 3> MaxPoint = box.GetMaxPoint();
+#undef NX_VIEWFRUSTUM_POSITIVE_SIDE_TEST
+#define NX_VIEWFRUSTUM_POSITIVE_SIDE_TEST(plane) \
+    {\
+        const NX::vector<float, 3> N = plane.GetNormal();\
+        const NX::vector<float, 3> P(N.x >= 0.f ? MaxPoint.x : MinPoint.x, N.y >= 0.f ? MaxPoint.y : MinPoint.y, N.z >= 0.f ? MaxPoint.z : MinPoint.z);\
+        if(NX::Dot(N, P) + plane.GetDistFromOriginal() < 0.f){\
+            return false;\
+        }\
+    }
+
+    if(mask & NX::VF_VT_LEFT){
+        NX_VIEWFRUSTUM_POSITIVE_SIDE_TEST(GetLeftPlane());
+    }
+
+    if(mask & NX::VF_VT_RIGHT){
+        NX_VIEWFRUSTUM_POSITIVE_SIDE_TEST(GetRightPlane());
+    }
+
+    if(mask & NX::VF_VT_FRONT){
+        NX_VIEWFRUSTUM_POSITIVE_SIDE_TEST(GetFrontPlane());
+    }
+
+    if(mask & NX::VF_VT_BACK){
+        NX_VIEWFRUSTUM_POSITIVE_SIDE_TEST(GetBackPlane());
+    }
+
+    if(mask & NX::VF_VT_TOP){
+        NX_VIEWFRUSTUM_POSITIVE_SIDE_TEST(GetTopPlane());
+    }
+
+    if(mask & NX::VF_VT_BOTTOM){
+        NX_VIEWFRUSTUM_POSITIVE_SIDE_TEST(GetBottomPlane());
+    }
+
+    return true;
+
+#undef NX_VIEWFRUSTUM_POSITIVE_SIDE_TEST
+}
@@ -15,6 +15,7 @@ namespace NX {
     class Ellipse;
     class Ellipsoid;
     class Cylinder;
+    class AABB;
     
     enum FRUSTUM_VISIBLE_TEST_BIT_MASK{
         VF_VT_FRONT     = 1 << 0,
@@ -30,6 +31,11 @@ namespace NX {
     public:
         ViewFrustum();
         ViewFrustum(const NX::Plane &Front, const NX::Plane &Back, const NX::Plane &left, const NX::Plane &Right, const NX::Plane &Top, const NX::Plane &Bottom);
+        /**
+         *  planes extracted from the rows of a D3D style clip matrix (z/w in [0, 1]),
+         *  pass Project * View * Model to get the frustum in model space
+         */
+        explicit ViewFrustum(const NX::float4x4 &ClipMatrix);
         virtual ~ViewFrustum();
         
     public:
@@ -46,6 +52,7 @@ namespace NX {
         bool Visible(const NX::Ellipse &ellipse,            const unsigned int mask = NX::VF_VT_ALL);
         bool Visible(const NX::Ellipsoid &ellipsoid,        const unsigned int mask = NX::VF_VT_ALL);
         bool Visible(const NX::Cylinder &cylinder,          const unsigned int mask = NX::VF_VT_ALL);
+        bool Visible(const NX::AABB &box,                   const unsigned int mask = NX::VF_VT_ALL) const;
     private:
         NX::Plane     m_FrontPlane;
         NX::Plane     m_BackPlane;